@@ -0,0 +1,577 @@
+/*
+ * Scalable benchmark problems. The families follow the problem classes of
+ * the OSQP benchmarks, with fewer data points per feature so that the
+ * default sizes solve in a fraction of a second. All the problems are
+ * generated from a seeded generator and are identical across platforms.
+ */
+#include <math.h>
+
+#include "bench_problems.h"
+#include "lin_alg.h"
+
+
+/*********************************
+*  Random number generation     *
+*********************************/
+
+/// xorshift64* generator
+typedef struct {
+  unsigned long long s;
+} BenchRng;
+
+static void rng_seed(BenchRng *r, unsigned long seed) {
+  r->s = 0x9E3779B97F4A7C15ULL ^ ((unsigned long long)seed * 2654435761ULL);
+  if (!r->s) r->s = 1;
+}
+
+// Uniform in (0, 1)
+static c_float rng_uniform(BenchRng *r) {
+  r->s ^= r->s >> 12;
+  r->s ^= r->s << 25;
+  r->s ^= r->s >> 27;
+  return (c_float)((((r->s * 2685821657736338717ULL) >> 11) + 0.5) /
+                   9007199254740992.0);
+}
+
+// Standard normal (Box-Muller)
+static c_float rng_normal(BenchRng *r) {
+  c_float u = rng_uniform(r);
+  c_float v = rng_uniform(r);
+
+  return (c_float)(sqrt(-2.0 * log(u)) * cos(6.283185307179586 * v));
+}
+
+// Distance to the next nonzero element of a random sparse vector
+static c_int rng_skip(BenchRng *r, c_float density) {
+  if (density >= 1.0) return 1;
+  return 1 + (c_int)floor(log(rng_uniform(r)) / log(1.0 - density));
+}
+
+
+/*********************************
+*  Matrix assembly              *
+*********************************/
+
+/// Matrix in triplet form that grows as elements are added
+typedef struct {
+  c_int    m, n;
+  c_int    nnz, nzmax;
+  c_int   *i, *j;
+  c_float *x;
+  c_int    failed; ///< an allocation failed
+} Triplets;
+
+static void trip_init(Triplets *T, c_int m, c_int n) {
+  T->m      = m;
+  T->n      = n;
+  T->nnz    = 0;
+  T->nzmax  = 64;
+  T->i      = (c_int *)c_malloc(T->nzmax * sizeof(c_int));
+  T->j      = (c_int *)c_malloc(T->nzmax * sizeof(c_int));
+  T->x      = (c_float *)c_malloc(T->nzmax * sizeof(c_float));
+  T->failed = !T->i || !T->j || !T->x;
+}
+
+static void trip_free(Triplets *T) {
+  if (T->i) c_free(T->i);
+  if (T->j) c_free(T->j);
+  if (T->x) c_free(T->x);
+  T->i = OSQP_NULL;
+  T->j = OSQP_NULL;
+  T->x = OSQP_NULL;
+}
+
+static void trip_add(Triplets *T, c_int i, c_int j, c_float x) {
+  c_int   *ti, *tj;
+  c_float *tx;
+
+  if (T->failed) return;
+
+  if (T->nnz == T->nzmax) {
+    T->nzmax *= 2;
+    ti = (c_int *)c_realloc(T->i, T->nzmax * sizeof(c_int));
+    if (ti) T->i = ti;
+    tj = (c_int *)c_realloc(T->j, T->nzmax * sizeof(c_int));
+    if (tj) T->j = tj;
+    tx = (c_float *)c_realloc(T->x, T->nzmax * sizeof(c_float));
+    if (tx) T->x = tx;
+    if (!ti || !tj || !tx) {
+      T->failed = 1;
+      return;
+    }
+  }
+  T->i[T->nnz] = i;
+  T->j[T->nnz] = j;
+  T->x[T->nnz] = x;
+  T->nnz++;
+}
+
+// Add normal elements with the given density to rows r0..r0+len-1 of column j
+static void trip_add_randn(Triplets *T, BenchRng *r, c_int r0, c_int len,
+                           c_int j, c_float density, c_float mean,
+                           c_float stdev) {
+  c_int i;
+
+  for (i = rng_skip(r, density) - 1; i < len; i += rng_skip(r, density)) {
+    trip_add(T, r0 + i, j, mean + stdev * rng_normal(r));
+  }
+}
+
+// Add the matrix M scaled by the rows with d (if given) at position (r0, c0)
+static void trip_add_csc(Triplets *T, const csc *M, c_int r0, c_int c0,
+                         const c_float *d) {
+  c_int j, ptr;
+
+  for (j = 0; j < M->n; j++) {
+    for (ptr = M->p[j]; ptr < M->p[j + 1]; ptr++) {
+      trip_add(T, r0 + M->i[ptr], c0 + j,
+               d ? d[M->i[ptr]] * M->x[ptr] : M->x[ptr]);
+    }
+  }
+}
+
+/**
+ * Convert the triplets to a CSC matrix with sorted row indices and free them.
+ * The triplets must not contain duplicates.
+ */
+static csc* trip_to_csc(Triplets *T) {
+  c_int k, q;
+  c_int *rows = OSQP_NULL, *order = OSQP_NULL, *cols = OSQP_NULL;
+  csc   *M    = OSQP_NULL;
+
+  if (!T->failed) {
+    M     = csc_spalloc(T->m, T->n, T->nnz, 1, 0);
+    rows  = (c_int *)c_calloc(T->m + 1, sizeof(c_int));
+    cols  = (c_int *)c_calloc(c_max(T->m, T->n) + 1, sizeof(c_int));
+    order = (c_int *)c_malloc((T->nnz + 1) * sizeof(c_int));
+  }
+
+  if (M && rows && cols && order) {
+    // Sort the elements by row and then stably by column
+    for (k = 0; k < T->nnz; k++) rows[T->i[k]]++;
+    csc_cumsum(cols, rows, T->m);
+    for (k = 0; k < T->nnz; k++) order[rows[T->i[k]]++] = k;
+
+    for (k = 0; k < T->n; k++) cols[k] = 0;
+    for (k = 0; k < T->nnz; k++) cols[T->j[k]]++;
+    csc_cumsum(M->p, cols, T->n);
+    for (k = 0; k < T->nnz; k++) {
+      q       = cols[T->j[order[k]]]++;
+      M->i[q] = T->i[order[k]];
+      M->x[q] = T->x[order[k]];
+    }
+  } else {
+    csc_spfree(M);
+    M = OSQP_NULL;
+  }
+
+  if (rows) c_free(rows);
+  if (cols) c_free(cols);
+  if (order) c_free(order);
+  trip_free(T);
+
+  return M;
+}
+
+
+/*********************************
+*  Problem data                 *
+*********************************/
+
+void bench_free_data(OSQPData *data) {
+  if (data) {
+    csc_spfree(data->P);
+    csc_spfree(data->A);
+    if (data->q) c_free(data->q);
+    if (data->l) c_free(data->l);
+    if (data->u) c_free(data->u);
+    if (data->lb) c_free(data->lb);
+    if (data->ub) c_free(data->ub);
+    c_free(data);
+  }
+}
+
+// Allocate the data and the triplets of P and A
+static OSQPData* data_init(c_int n, c_int m, Triplets *TP, Triplets *TA) {
+  OSQPData *data = (OSQPData *)c_calloc(1, sizeof(OSQPData));
+
+  trip_init(TP, n, n);
+  trip_init(TA, m, n);
+  if (!data) return OSQP_NULL;
+
+  data->n = n;
+  data->m = m;
+  data->q = (c_float *)c_calloc(n, sizeof(c_float));
+  data->l = (c_float *)c_malloc(m * sizeof(c_float));
+  data->u = (c_float *)c_malloc(m * sizeof(c_float));
+  if (!data->q || !data->l || !data->u) {
+    bench_free_data(data);
+    return OSQP_NULL;
+  }
+
+  return data;
+}
+
+// Assemble P and A. Returns OSQP_NULL and frees everything if it fails.
+static OSQPData* data_done(OSQPData *data, Triplets *TP, Triplets *TA) {
+  if (!data) {
+    trip_free(TP);
+    trip_free(TA);
+    return OSQP_NULL;
+  }
+
+  data->P = trip_to_csc(TP);
+  data->A = trip_to_csc(TA);
+  if (!data->P || !data->A) {
+    bench_free_data(data);
+    return OSQP_NULL;
+  }
+
+  return data;
+}
+
+// Random sparse m x n matrix with normal elements
+static csc* sprandn(BenchRng *r, c_int m, c_int n, c_float density,
+                    c_float mean, c_float stdev) {
+  c_int    j;
+  Triplets T;
+
+  trip_init(&T, m, n);
+  for (j = 0; j < n; j++) trip_add_randn(&T, r, 0, m, j, density, mean, stdev);
+
+  return trip_to_csc(&T);
+}
+
+
+/*********************************
+*  Problem families             *
+*********************************/
+
+/*
+ * Random QP with n variables and 10 n constraints. P is a random sparse
+ * matrix made diagonally dominant.
+ */
+static OSQPData* gen_random_qp(c_int n, unsigned long seed) {
+  c_int     i, j, k, m = 10 * n;
+  c_float  *absum;
+  Triplets  TP, TA;
+  BenchRng  r;
+  OSQPData *data = data_init(n, m, &TP, &TA);
+
+  rng_seed(&r, seed);
+  absum = (c_float *)c_calloc(n, sizeof(c_float));
+  if (!absum) TP.failed = 1;
+
+  if (data && absum) {
+    for (j = 1; j < n; j++) trip_add_randn(&TP, &r, 0, j, j, 0.15, 0., 1.);
+    for (k = 0; k < TP.nnz; k++) {
+      absum[TP.i[k]] += c_absval(TP.x[k]);
+      absum[TP.j[k]] += c_absval(TP.x[k]);
+    }
+    for (i = 0; i < n; i++) trip_add(&TP, i, i, absum[i] + 1e-02);
+
+    for (j = 0; j < n; j++) trip_add_randn(&TA, &r, 0, m, j, 0.15, 0., 1.);
+    for (i = 0; i < n; i++) data->q[i] = rng_normal(&r);
+    for (i = 0; i < m; i++) {
+      data->l[i] = -rng_uniform(&r);
+      data->u[i] = rng_uniform(&r);
+    }
+  }
+  if (absum) c_free(absum);
+
+  return data_done(data, &TP, &TA);
+}
+
+/*
+ * LASSO with n features and 10 n data points
+ *
+ *   minimize    y' y + lambda 1' t
+ *   subject to  y = Ad x - b
+ *               -t <= x <= t
+ */
+static OSQPData* gen_lasso(c_int n, unsigned long seed) {
+  c_int     i, md = 10 * n, m = md + 2 * n;
+  c_float   lambda;
+  c_float  *xt = OSQP_NULL, *b = OSQP_NULL;
+  csc      *Ad;
+  Triplets  TP, TA;
+  BenchRng  r;
+  OSQPData *data = data_init(2 * n + md, m, &TP, &TA);
+
+  rng_seed(&r, seed);
+  Ad = sprandn(&r, md, n, 0.15, 0., 1.);
+  xt = (c_float *)c_malloc(n * sizeof(c_float));
+  b  = (c_float *)c_malloc(md * sizeof(c_float));
+  if (!Ad || !xt || !b) TP.failed = 1;
+
+  if (data && Ad && xt && b) {
+    // Sparse solution and noisy observations
+    for (i = 0; i < n; i++) {
+      xt[i] = (rng_uniform(&r) < 0.5) ? 0. : rng_normal(&r) / c_sqrt((c_float)n);
+    }
+    mat_vec(Ad, xt, b, 0);
+    for (i = 0; i < md; i++) b[i] += rng_normal(&r);
+    mat_tpose_vec(Ad, b, xt, 0, 0);
+    lambda = vec_norm_inf(xt, n) / 5.;
+
+    for (i = 0; i < md; i++) trip_add(&TP, n + i, n + i, 2.);
+    for (i = 0; i < n; i++) data->q[n + md + i] = lambda;
+
+    trip_add_csc(&TA, Ad, 0, 0, OSQP_NULL);
+    for (i = 0; i < md; i++) {
+      trip_add(&TA, i, n + i, -1.);
+      data->l[i] = b[i];
+      data->u[i] = b[i];
+    }
+    for (i = 0; i < n; i++) {
+      trip_add(&TA, md + i,     i,          1.);
+      trip_add(&TA, md + i,     n + md + i, -1.);
+      trip_add(&TA, md + n + i, i,          1.);
+      trip_add(&TA, md + n + i, n + md + i, 1.);
+      data->l[md + i]     = -OSQP_INFTY;
+      data->u[md + i]     = 0.;
+      data->l[md + n + i] = 0.;
+      data->u[md + n + i] = OSQP_INFTY;
+    }
+  }
+  csc_spfree(Ad);
+  if (xt) c_free(xt);
+  if (b) c_free(b);
+
+  return data_done(data, &TP, &TA);
+}
+
+/*
+ * Huber fitting with n features and 10 n data points, 5% of them outliers
+ *
+ *   minimize    u' u + 2 1' (r + s)
+ *   subject to  Ad x - b - u = r - s
+ *               r >= 0, s >= 0
+ */
+static OSQPData* gen_huber(c_int n, unsigned long seed) {
+  c_int     i, md = 10 * n, m = 3 * md;
+  c_float  *xt = OSQP_NULL, *b = OSQP_NULL;
+  csc      *Ad;
+  Triplets  TP, TA;
+  BenchRng  r;
+  OSQPData *data = data_init(n + 3 * md, m, &TP, &TA);
+
+  rng_seed(&r, seed);
+  Ad = sprandn(&r, md, n, 0.15, 0., 1.);
+  xt = (c_float *)c_malloc(n * sizeof(c_float));
+  b  = (c_float *)c_malloc(md * sizeof(c_float));
+  if (!Ad || !xt || !b) TP.failed = 1;
+
+  if (data && Ad && xt && b) {
+    for (i = 0; i < n; i++) xt[i] = rng_normal(&r) / c_sqrt((c_float)n);
+    mat_vec(Ad, xt, b, 0);
+    for (i = 0; i < md; i++) {
+      b[i] += (rng_uniform(&r) < 0.95) ? 0.5 * rng_normal(&r) :
+              10. * rng_uniform(&r);
+    }
+
+    for (i = 0; i < md; i++) {
+      trip_add(&TP, n + i, n + i, 2.);
+      data->q[n + md + i]     = 2.;
+      data->q[n + 2 * md + i] = 2.;
+    }
+
+    trip_add_csc(&TA, Ad, 0, 0, OSQP_NULL);
+    for (i = 0; i < md; i++) {
+      trip_add(&TA, i,          n + i,          -1.);
+      trip_add(&TA, i,          n + md + i,     -1.);
+      trip_add(&TA, i,          n + 2 * md + i, 1.);
+      trip_add(&TA, md + i,     n + md + i,     1.);
+      trip_add(&TA, 2 * md + i, n + 2 * md + i, 1.);
+      data->l[i]          = b[i];
+      data->u[i]          = b[i];
+      data->l[md + i]     = 0.;
+      data->u[md + i]     = OSQP_INFTY;
+      data->l[2 * md + i] = 0.;
+      data->u[2 * md + i] = OSQP_INFTY;
+    }
+  }
+  csc_spfree(Ad);
+  if (xt) c_free(xt);
+  if (b) c_free(b);
+
+  return data_done(data, &TP, &TA);
+}
+
+/*
+ * Portfolio optimization with n assets and n / 10 factors
+ *
+ *   minimize    x' D x + y' y - mu' x
+ *   subject to  y = F' x
+ *               1' x = 1
+ *               0 <= x <= 1
+ */
+static OSQPData* gen_portfolio(c_int n, unsigned long seed) {
+  c_int     i, k = c_max(n / 10, 1), m = k + 1 + n;
+  Triplets  TP, TA;
+  BenchRng  r;
+  OSQPData *data = data_init(n + k, m, &TP, &TA);
+
+  rng_seed(&r, seed);
+
+  if (data) {
+    for (i = 0; i < n; i++) {
+      trip_add(&TP, i, i, 2. * c_sqrt((c_float)k) * rng_uniform(&r));
+      data->q[i] = -rng_normal(&r);
+    }
+    for (i = 0; i < k; i++) trip_add(&TP, n + i, n + i, 2.);
+
+    // Rows of F' in the columns of the assets
+    for (i = 0; i < n; i++) trip_add_randn(&TA, &r, 0, k, i, 0.5, 0., 1.);
+    for (i = 0; i < k; i++) {
+      trip_add(&TA, i, n + i, -1.);
+      data->l[i] = 0.;
+      data->u[i] = 0.;
+    }
+    for (i = 0; i < n; i++) {
+      trip_add(&TA, k,         i, 1.);
+      trip_add(&TA, k + 1 + i, i, 1.);
+      data->l[k + 1 + i] = 0.;
+      data->u[k + 1 + i] = 1.;
+    }
+    data->l[k] = 1.;
+    data->u[k] = 1.;
+  }
+
+  return data_done(data, &TP, &TA);
+}
+
+// Dynamics I + E of a slightly unstable system, E random with density 0.5
+static csc* mpc_dynamics(BenchRng *r, c_int nx) {
+  c_int    i, j;
+  c_float  stdev = 0.1 / c_sqrt((c_float)nx);
+  Triplets T;
+
+  trip_init(&T, nx, nx);
+  for (j = 0; j < nx; j++) {
+    for (i = rng_skip(r, 0.5) - 1; i < nx; i += rng_skip(r, 0.5)) {
+      if (i != j) trip_add(&T, i, j, stdev * rng_normal(r));
+    }
+    trip_add(&T, j, j, 1. + stdev * rng_normal(r));
+  }
+
+  return trip_to_csc(&T);
+}
+
+/*
+ * Model predictive control with nx states, nx / 2 inputs and a horizon of
+ * 10 steps
+ *
+ *   minimize    sum_t x_t' Q x_t + u_t' R u_t + x_T' Q x_T
+ *   subject to  x_{t+1} = Ad x_t + B u_t,  x_0 = x_init
+ *               |x_t| <= 10,  |u_t| <= 1
+ */
+static OSQPData* gen_mpc(c_int nx, unsigned long seed) {
+  c_int     i, t, T = 10, nu = c_max(nx / 2, 1);
+  c_int     nxs = (T + 1) * nx, n = nxs + T * nu, m = 2 * nxs + T * nu;
+  c_float  *Qd;
+  csc      *Ad, *B;
+  Triplets  TP, TA;
+  BenchRng  r;
+  OSQPData *data = data_init(n, m, &TP, &TA);
+
+  rng_seed(&r, seed);
+  Ad = mpc_dynamics(&r, nx);
+  B  = sprandn(&r, nx, nu, 0.5, 0., 1.);
+  Qd = (c_float *)c_malloc(nx * sizeof(c_float));
+  if (!Ad || !B || !Qd) TP.failed = 1;
+
+  if (data && Ad && B && Qd) {
+    for (i = 0; i < nx; i++) Qd[i] = (rng_uniform(&r) < 0.7) ? 10. * rng_uniform(&r) : 0.;
+    for (t = 0; t <= T; t++) {
+      for (i = 0; i < nx; i++) {
+        if (Qd[i] != 0.) trip_add(&TP, t * nx + i, t * nx + i, Qd[i]);
+      }
+    }
+    for (i = nxs; i < n; i++) trip_add(&TP, i, i, 0.1);
+
+    // Dynamics: -x_0 = -x_init and Ad x_t - x_{t+1} + B u_t = 0
+    for (i = 0; i < nxs; i++) {
+      trip_add(&TA, i, i, -1.);
+      data->l[i] = 0.;
+      data->u[i] = 0.;
+    }
+    for (i = 0; i < nx; i++) {
+      data->l[i] = 2. * rng_uniform(&r) - 1.;
+      data->u[i] = data->l[i];
+    }
+    for (t = 0; t < T; t++) {
+      trip_add_csc(&TA, Ad, (t + 1) * nx, t * nx,       OSQP_NULL);
+      trip_add_csc(&TA, B,  (t + 1) * nx, nxs + t * nu, OSQP_NULL);
+    }
+
+    // State and input bounds
+    for (i = 0; i < n; i++) {
+      trip_add(&TA, nxs + i, i, 1.);
+      data->l[nxs + i] = (i < nxs) ? -10. : -1.;
+      data->u[nxs + i] = (i < nxs) ?  10. :  1.;
+    }
+  }
+  csc_spfree(Ad);
+  csc_spfree(B);
+  if (Qd) c_free(Qd);
+
+  return data_done(data, &TP, &TA);
+}
+
+/*
+ * Support vector machine with n features and 10 n data points of two
+ * classes
+ *
+ *   minimize    x' x + 1' t
+ *   subject to  t >= diag(b) Ad x + 1
+ *               t >= 0
+ */
+static OSQPData* gen_svm(c_int n, unsigned long seed) {
+  c_int     i, md = 10 * n, m = 2 * md;
+  c_float  *b;
+  csc      *Ad;
+  Triplets  TP, TA;
+  BenchRng  r;
+  OSQPData *data = data_init(n + md, m, &TP, &TA);
+
+  rng_seed(&r, seed);
+  Ad = sprandn(&r, md, n, 0.15, 0., 1. / c_sqrt((c_float)n));
+  b  = (c_float *)c_malloc(md * sizeof(c_float));
+  if (!Ad || !b) TP.failed = 1;
+
+  if (data && Ad && b) {
+    // The two classes have means 1 / n and -1 / n
+    for (i = 0; i < md; i++) b[i] = (i < md / 2) ? 1. : -1.;
+    for (i = 0; i < Ad->p[n]; i++) Ad->x[i] += b[Ad->i[i]] / n;
+
+    for (i = 0; i < n; i++) trip_add(&TP, i, i, 2.);
+    for (i = 0; i < md; i++) data->q[n + i] = 1.;
+
+    trip_add_csc(&TA, Ad, 0, 0, b);
+    for (i = 0; i < md; i++) {
+      trip_add(&TA, i,      n + i, -1.);
+      trip_add(&TA, md + i, n + i, 1.);
+      data->l[i]      = -OSQP_INFTY;
+      data->u[i]      = -1.;
+      data->l[md + i] = 0.;
+      data->u[md + i] = OSQP_INFTY;
+    }
+  }
+  csc_spfree(Ad);
+  if (b) c_free(b);
+
+  return data_done(data, &TP, &TA);
+}
+
+
+const BenchFamily bench_families[] = {
+  { "random_qp", { 20,  40,  80,  160 }, "variables",   gen_random_qp },
+  { "lasso",     { 10,  20,  40,  80  }, "features",    gen_lasso     },
+  { "huber",     { 10,  20,  40,  80  }, "features",    gen_huber     },
+  { "portfolio", { 100, 200, 400, 800 }, "assets",      gen_portfolio },
+  { "mpc",       { 4,   8,   16,  32  }, "states",      gen_mpc       },
+  { "svm",       { 10,  20,  40,  80  }, "features",    gen_svm       },
+};
+
+const c_int bench_nfamilies = sizeof(bench_families) / sizeof(bench_families[0]);
@@ -0,0 +1,48 @@
+#ifndef BENCH_PROBLEMS_H
+# define BENCH_PROBLEMS_H
+
+# ifdef __cplusplus
+extern "C" {
+# endif // ifdef __cplusplus
+
+# include "osqp.h"
+
+
+/**
+ * Family of scalable benchmark problems
+ */
+typedef struct {
+  const char *name;     ///< name of the family
+  c_int       sizes[4]; ///< default sizes
+  const char *size_arg; ///< meaning of the size argument
+
+  /**
+   * Generate a problem of the family
+   * @param  size Size of the problem
+   * @param  seed Seed of the random number generator
+   * @return      Problem data (OSQP_NULL if the allocation failed)
+   */
+  OSQPData* (*generate)(c_int size, unsigned long seed);
+} BenchFamily;
+
+
+/// Benchmark problem families: random QP, LASSO, Huber fitting, portfolio
+/// optimization, model predictive control and support vector machine
+extern const BenchFamily bench_families[];
+
+/// Number of benchmark problem families
+extern const c_int bench_nfamilies;
+
+
+/**
+ * Free the data of a benchmark problem
+ * @param data Problem data
+ */
+void bench_free_data(OSQPData *data);
+
+
+# ifdef __cplusplus
+}
+# endif // ifdef __cplusplus
+
+#endif // ifndef BENCH_PROBLEMS_H
@@ -0,0 +1,329 @@
+/*
+ * OSQP benchmark suite
+ *
+ * Generates the problems of the benchmark families at several sizes, runs a
+ * setup, solve, update and refactorization cycle on each of them and writes
+ * the timings as CSV. The timings are the minimum over the repetitions.
+ *
+ * With a baseline CSV from a previous run, the results are compared with it
+ * and the program returns 1 if any timing is slower than the tolerance, the
+ * factor has more nonzeros or the solver takes more iterations.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "osqp.h"
+#include "bench_problems.h"
+
+#ifndef PROFILING
+# error "osqp_bench requires OSQP to be compiled with PROFILING"
+#endif /* ifndef PROFILING */
+
+#define BENCH_MAX_SIZES   (16)
+#define BENCH_MAX_RESULTS (256)
+#define BENCH_LINE_LEN    (512)
+#define BENCH_MIN_TIME    (1e-04) ///< timing differences below this are noise
+
+
+/// Results of a problem of a family
+typedef struct {
+  char   family[32];
+  long   size, n, m, nnz_P, nnz_A, nnz_L;
+  long   status, iter, update_iter;
+  double setup_time, factor_time, solve_time, iter_time, polish_time, update_time;
+} BenchResult;
+
+static const char *bench_header =
+  "family,size,n,m,nnz_P,nnz_A,nnz_L,status,iter,update_iter,"
+  "setup_time,factor_time,solve_time,iter_time,polish_time,update_time\n";
+
+
+static void print_usage(void) {
+  c_int k;
+
+  printf("Usage: osqp_bench [options]\n"
+         "  -f <family>     family to run (default: all)\n"
+         "  -s <s1,s2,...>  problem sizes (default: the sizes of each family)\n"
+         "  -r <reps>       repetitions, the minimum time is reported (default: 3)\n"
+         "  -S <seed>       seed of the problem generator (default: 1)\n"
+         "  -O <ordering>   KKT ordering: amd, rcm or nd (default: amd)\n"
+         "  -o <file>       write the results to file (default: stdout)\n"
+         "  -b <file>       compare with the results of a previous run\n"
+         "  -t <tol>        slowdown ratio reported as a regression (default: 1.2)\n"
+         "Families:\n");
+  for (k = 0; k < bench_nfamilies; k++) {
+    printf("  %-10s size = %s, default sizes %i %i %i %i\n",
+           bench_families[k].name, bench_families[k].size_arg,
+           (int)bench_families[k].sizes[0], (int)bench_families[k].sizes[1],
+           (int)bench_families[k].sizes[2], (int)bench_families[k].sizes[3]);
+  }
+}
+
+static void write_result(FILE *f, const BenchResult *r) {
+  fprintf(f, "%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e\n",
+          r->family, r->size, r->n, r->m, r->nnz_P, r->nnz_A, r->nnz_L,
+          r->status, r->iter, r->update_iter, r->setup_time, r->factor_time,
+          r->solve_time, r->iter_time, r->polish_time, r->update_time);
+}
+
+static c_int read_results(const char *file, BenchResult *res, c_int *nres) {
+  char  line[BENCH_LINE_LEN];
+  FILE *f = fopen(file, "r");
+
+  *nres = 0;
+  if (!f) return 1;
+
+  while (fgets(line, BENCH_LINE_LEN, f) && (*nres < BENCH_MAX_RESULTS)) {
+    BenchResult *r = &res[*nres];
+
+    if (sscanf(line, "%31[^,],%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%lf,%lf,%lf,%lf,%lf,%lf",
+               r->family, &r->size, &r->n, &r->m, &r->nnz_P, &r->nnz_A,
+               &r->nnz_L, &r->status, &r->iter, &r->update_iter,
+               &r->setup_time, &r->factor_time, &r->solve_time,
+               &r->iter_time, &r->polish_time, &r->update_time) == 16) {
+      (*nres)++;
+    }
+  }
+  fclose(f);
+
+  return 0;
+}
+
+/**
+ * Run the benchmark cycle on a problem
+ * @return Exitflag (nonzero if the problem could not be generated or set up)
+ */
+static c_int run_problem(const BenchFamily  *family,
+                         c_int               size,
+                         unsigned long       seed,
+                         c_int               reps,
+                         const OSQPSettings *settings,
+                         BenchResult        *res) {
+  c_int          rep, i, exitflag = 0;
+  c_float       *q_new;
+  OSQPData      *data;
+  OSQPWorkspace *work;
+  OSQPTimer      timer;
+  double         factor_time;
+
+  memset(res, 0, sizeof(BenchResult));
+  strncpy(res->family, family->name, sizeof(res->family) - 1);
+  res->size = (long)size;
+
+  for (rep = 0; rep < reps; rep++) {
+    data = family->generate(size, seed);
+    if (!data) return 1;
+
+    q_new = (c_float *)c_malloc(data->n * sizeof(c_float));
+    if (!q_new || osqp_setup(&work, data, settings)) {
+      if (q_new) c_free(q_new);
+      bench_free_data(data);
+      return 1;
+    }
+
+    // Solve
+    osqp_solve(work);
+
+    // Update the linear cost and solve again from the previous solution
+    for (i = 0; i < data->n; i++) {
+      q_new[i] = (c_float)1.01 * data->q[i] + (c_float)1e-03 * ((i % 7) - 3);
+    }
+    if (rep == 0) {
+      res->n      = (long)data->n;
+      res->m      = (long)data->m;
+      res->nnz_P  = (long)data->P->p[data->n];
+      res->nnz_A  = (long)data->A->p[data->n];
+      res->nnz_L  = (long)osqp_kkt_fill(work, settings->ordering);
+      res->status = (long)work->info->status_val;
+      res->iter   = (long)work->info->iter;
+    }
+    if ((rep == 0) || (work->info->setup_time < res->setup_time))
+      res->setup_time = work->info->setup_time;
+    if ((rep == 0) || (work->info->solve_time < res->solve_time))
+      res->solve_time = work->info->solve_time;
+    if ((rep == 0) || (work->info->polish_time < res->polish_time))
+      res->polish_time = work->info->polish_time;
+
+    osqp_update_lin_cost(work, q_new);
+    osqp_solve(work);
+    if (rep == 0) res->update_iter = (long)work->info->iter;
+    if ((rep == 0) || (work->info->solve_time < res->update_time))
+      res->update_time = work->info->solve_time;
+
+    // Refactor the KKT matrix with unchanged values of P and A
+    osqp_tic(&timer);
+    exitflag = osqp_update_P_A(work, data->P->x, OSQP_NULL, data->P->p[data->n],
+                               data->A->x, OSQP_NULL, data->A->p[data->n]);
+    factor_time = osqp_toc(&timer);
+    if ((rep == 0) || (factor_time < res->factor_time))
+      res->factor_time = factor_time;
+
+    osqp_cleanup(work);
+    bench_free_data(data);
+    c_free(q_new);
+    if (exitflag) return 1;
+  }
+  res->iter_time = res->solve_time / c_max(res->iter, 1);
+
+  return 0;
+}
+
+/**
+ * Compare a result with the baseline
+ * @return Number of regressions
+ */
+static c_int compare_result(const BenchResult *r,
+                            const BenchResult *base,
+                            c_int              nbase,
+                            double             tol) {
+  c_int k, j, nreg = 0;
+  const char *names[5] = { "setup_time", "factor_time", "solve_time",
+                           "iter_time", "update_time" };
+  double      t_new[5], t_old[5];
+
+  for (k = 0; k < nbase; k++) {
+    if (!strcmp(base[k].family, r->family) && (base[k].size == r->size)) break;
+  }
+  if (k == nbase) return 0;
+  base = &base[k];
+
+  t_new[0] = r->setup_time;  t_old[0] = base->setup_time;
+  t_new[1] = r->factor_time; t_old[1] = base->factor_time;
+  t_new[2] = r->solve_time;  t_old[2] = base->solve_time;
+  t_new[3] = r->iter_time;   t_old[3] = base->iter_time;
+  t_new[4] = r->update_time; t_old[4] = base->update_time;
+
+  for (j = 0; j < 5; j++) {
+    if ((t_new[j] > tol * t_old[j]) && (t_new[j] - t_old[j] > BENCH_MIN_TIME)) {
+      fprintf(stderr, "regression: %s %ld %s %.3e -> %.3e (x%.2f)\n",
+              r->family, r->size, names[j], t_old[j], t_new[j],
+              t_new[j] / t_old[j]);
+      nreg++;
+    }
+  }
+  if (r->nnz_L > base->nnz_L) {
+    fprintf(stderr, "regression: %s %ld nnz_L %ld -> %ld\n",
+            r->family, r->size, base->nnz_L, r->nnz_L);
+    nreg++;
+  }
+  if (r->iter > tol * base->iter) {
+    fprintf(stderr, "regression: %s %ld iter %ld -> %ld\n",
+            r->family, r->size, base->iter, r->iter);
+    nreg++;
+  }
+  if (r->status != base->status) {
+    fprintf(stderr, "regression: %s %ld status %ld -> %ld\n",
+            r->family, r->size, base->status, r->status);
+    nreg++;
+  }
+
+  return nreg;
+}
+
+
+int main(int argc, char **argv) {
+  c_int         k, s, a, nsizes = 0, reps = 3, nbase = 0, nreg = 0, failed = 0;
+  c_int         sizes[BENCH_MAX_SIZES];
+  unsigned long seed        = 1;
+  double        tol         = 1.2;
+  const char   *family_name = OSQP_NULL, *out_file = OSQP_NULL;
+  const char   *base_file   = OSQP_NULL;
+  char         *tok;
+  FILE         *out = stdout;
+  OSQPSettings  settings;
+  BenchResult   res;
+  BenchResult  *base = OSQP_NULL;
+
+  osqp_set_default_settings(&settings);
+  settings.verbose = 0;
+  settings.polish  = 1;
+
+  // Parse the options
+  for (a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-h")) {
+      print_usage();
+      return 0;
+    }
+    if ((argv[a][0] != '-') || (a + 1 >= argc)) {
+      print_usage();
+      return 2;
+    }
+    switch (argv[a][1]) {
+    case 'f': family_name = argv[++a]; break;
+    case 'r': reps = atoi(argv[++a]); reps = c_max(reps, 1); break;
+    case 'S': seed = strtoul(argv[++a], OSQP_NULL, 10); break;
+    case 'o': out_file = argv[++a]; break;
+    case 'b': base_file = argv[++a]; break;
+    case 't': tol = atof(argv[++a]); break;
+    case 's':
+      for (tok = strtok(argv[++a], ","); tok && (nsizes < BENCH_MAX_SIZES);
+           tok = strtok(OSQP_NULL, ",")) {
+        sizes[nsizes++] = (c_int)atoi(tok);
+      }
+      break;
+    case 'O':
+      a++;
+      if (!strcmp(argv[a], "amd")) settings.ordering = AMD_ORDERING;
+      else if (!strcmp(argv[a], "rcm")) settings.ordering = RCM_ORDERING;
+      else if (!strcmp(argv[a], "nd")) settings.ordering = ND_ORDERING;
+      else {
+        print_usage();
+        return 2;
+      }
+      break;
+    default:
+      print_usage();
+      return 2;
+    }
+  }
+
+  if (base_file) {
+    base = (BenchResult *)c_malloc(BENCH_MAX_RESULTS * sizeof(BenchResult));
+    if (!base || read_results(base_file, base, &nbase)) {
+      fprintf(stderr, "Cannot read the baseline %s\n", base_file);
+      if (base) c_free(base);
+      return 2;
+    }
+  }
+  if (out_file) {
+    out = fopen(out_file, "w");
+    if (!out) {
+      fprintf(stderr, "Cannot open %s\n", out_file);
+      if (base) c_free(base);
+      return 2;
+    }
+  }
+
+  fputs(bench_header, out);
+  for (k = 0; k < bench_nfamilies; k++) {
+    const BenchFamily *family = &bench_families[k];
+    c_int              ns     = nsizes ? nsizes : 4;
+
+    if (family_name && strcmp(family_name, family->name)) continue;
+
+    for (s = 0; s < ns; s++) {
+      c_int size = nsizes ? sizes[s] : family->sizes[s];
+
+      if (run_problem(family, size, seed, reps, &settings, &res)) {
+        fprintf(stderr, "%s %i: setup failed\n", family->name, (int)size);
+        failed = 1;
+        continue;
+      }
+      fprintf(stderr, "%-10s %6i  n %7ld  m %7ld  nnz(L) %9ld  iter %5ld  solve %.3e s\n",
+              family->name, (int)size, res.n, res.m, res.nnz_L, res.iter,
+              res.solve_time);
+      write_result(out, &res);
+      fflush(out);
+      if (base) nreg += compare_result(&res, base, nbase, tol);
+    }
+  }
+
+  if (out_file) fclose(out);
+  if (base) {
+    c_free(base);
+    fprintf(stderr, "%i regressions with respect to %s\n", (int)nreg, base_file);
+  }
+
+  return (failed || nreg) ? 1 : 0;
+}
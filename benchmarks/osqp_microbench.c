@@ -0,0 +1,686 @@
+/*
+ * OSQP kernel microbenchmarks
+ *
+ * Times the vector and matrix kernels of lin_alg.c, the forming and updating
+ * of the KKT matrix, the QDLDL factorization and solve and the projection on
+ * random data of several sizes and sparsities. For each kernel it writes the
+ * time per call, the bytes moved and the floating point operations as CSV,
+ * together with the resulting GB/s and GFLOP/s.
+ *
+ * The bytes are the compulsory traffic of the kernel: every input read once
+ * and every output written once. They are not the traffic measured on the
+ * memory bus, but they give the arithmetic intensity to place the kernel on
+ * a roofline. The data stay in the cache across the calls if they fit in it,
+ * hence the small sizes measure the cache bandwidth.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "osqp.h"
+#include "lin_alg.h"
+#include "kkt.h"
+#include "proj.h"
+#include "lin_sys.h"
+#include "cs.h"
+
+#ifndef PROFILING
+# error "osqp_microbench requires OSQP to be compiled with PROFILING"
+#endif /* ifndef PROFILING */
+
+#define MB_MAX_LIST    (16)
+#define MB_DENSE_MAX   (4000000) ///< largest dense matrix (elements)
+#define MB_FACTOR_MAX  (50000000) ///< largest factor for the QDLDL kernels (nonzeros)
+#define MB_SIGMA       (1e-06)
+#define MB_RHO         (0.1)
+
+
+/// Kernels
+enum mb_kernel {
+  MB_PREA_VEC_COPY, MB_PREA_INT_VEC_COPY, MB_VEC_SET_SCALAR,
+  MB_INT_VEC_SET_SCALAR, MB_VEC_ADD_SCALAR, MB_VEC_MULT_SCALAR,
+  MB_VEC_ADD_SCALED, MB_VEC_NORM_INF, MB_VEC_SCALED_NORM_INF,
+  MB_VEC_NORM_INF_DIFF, MB_VEC_MEAN, MB_VEC_EW_RECIPR, MB_VEC_PROD,
+  MB_VEC_EW_PROD, MB_VEC_EW_SQRT, MB_VEC_EW_MAX, MB_VEC_EW_MIN,
+  MB_VEC_EW_MAX_VEC, MB_VEC_EW_MIN_VEC,
+  MB_MAT_MULT_SCALAR, MB_MAT_PREMULT_DIAG, MB_MAT_POSTMULT_DIAG, MB_MAT_VEC,
+  MB_MAT_TPOSE_VEC, MB_MAT_INF_NORM_COLS, MB_MAT_INF_NORM_ROWS,
+  MB_MAT_INF_NORM_COLS_SYM_TRIU, MB_QUAD_FORM,
+  MB_MAT_VEC_DENSE, MB_MAT_TPOSE_VEC_DENSE, MB_MAT_VEC_DENSE_SYM_TRIU,
+  MB_BSR_MAT_VEC, MB_BSR_MAT_TPOSE_VEC,
+  MB_FORM_KKT, MB_UPDATE_KKT_P, MB_UPDATE_KKT_A, MB_UPDATE_KKT_PARAM2,
+  MB_QDLDL_SETUP, MB_QDLDL_REFACTOR, MB_QDLDL_SOLVE,
+  MB_PROJECT,
+  MB_NKERNELS
+};
+
+static const char *mb_kernel_name[MB_NKERNELS] = {
+  "prea_vec_copy", "prea_int_vec_copy", "vec_set_scalar",
+  "int_vec_set_scalar", "vec_add_scalar", "vec_mult_scalar",
+  "vec_add_scaled", "vec_norm_inf", "vec_scaled_norm_inf",
+  "vec_norm_inf_diff", "vec_mean", "vec_ew_recipr", "vec_prod",
+  "vec_ew_prod", "vec_ew_sqrt", "vec_ew_max", "vec_ew_min",
+  "vec_ew_max_vec", "vec_ew_min_vec",
+  "mat_mult_scalar", "mat_premult_diag", "mat_postmult_diag", "mat_vec",
+  "mat_tpose_vec", "mat_inf_norm_cols", "mat_inf_norm_rows",
+  "mat_inf_norm_cols_sym_triu", "quad_form",
+  "mat_vec_dense", "mat_tpose_vec_dense", "mat_vec_dense_sym_triu",
+  "bsr_mat_vec", "bsr_mat_tpose_vec",
+  "form_KKT", "update_KKT_P", "update_KKT_A", "update_KKT_param2",
+  "qdldl_setup", "qdldl_refactor", "qdldl_solve",
+  "project"
+};
+
+/// Data of the kernels for one size and sparsity
+typedef struct {
+  c_int     n, m;
+  c_float   density;               ///< nonzeros per column of A
+  csc      *P, *A;                 ///< random sparse P (upper triangular) and A
+  csc      *Pd, *Ad;               ///< dense P (upper triangular) and A
+  bsr      *Ab;                    ///< block sparse matrix of the size of A
+  csc      *KKT;                   ///< KKT matrix with the maps of P and A
+  c_int    *PtoKKT, *AtoKKT, *rhotoKKT, *Pdiag_idx, Pdiag_n;
+  LinSysSolver *s;                 ///< QDLDL factorization of the KKT matrix
+  OSQPFactorStats stats;           ///< statistics of the factorization
+  c_float  *a, *b, *c, *ones;      ///< vectors of size max(n, m)
+  c_float  *rhs, *sol;             ///< vectors of size n + m
+  c_int    *ia, *ib;               ///< integer vectors of size n
+  c_float  *rho_vec, *rho_inv_vec; ///< vectors of size m
+  OSQPData  pdata;                 ///< data of the projection
+  OSQPWorkspace pwork;             ///< workspace of the projection
+  c_float   sink;                  ///< results of the reductions
+} MbData;
+
+
+/*********************************
+*  Random data                  *
+*********************************/
+
+/// xorshift64* generator
+typedef struct {
+  unsigned long long s;
+} MbRng;
+
+static void rng_seed(MbRng *r, unsigned long seed) {
+  r->s = 0x9E3779B97F4A7C15ULL ^ ((unsigned long long)seed * 2654435761ULL);
+  if (!r->s) r->s = 1;
+}
+
+// Uniform in (0, 1)
+static c_float rng_uniform(MbRng *r) {
+  r->s ^= r->s >> 12;
+  r->s ^= r->s << 25;
+  r->s ^= r->s >> 27;
+  return (c_float)((((r->s * 2685821657736338717ULL) >> 11) + 0.5) /
+                   9007199254740992.0);
+}
+
+// Distance to the next element drawn with probability prob
+static c_int rng_skip(MbRng *r, c_float prob) {
+  if (prob >= 1.0) return 1;
+  if (prob <= 0.0) return 1 << 30;
+  return 1 + (c_int)c_min(floor(log(rng_uniform(r)) / log(1.0 - prob)), 1 << 30);
+}
+
+/**
+ * Random sparse matrix with the elements of each column drawn with
+ * probability prob. With triu, only the rows above the diagonal are drawn and
+ * the diagonal is set to make the matrix diagonally dominant.
+ */
+static csc* random_csc(c_int m, c_int n, c_float prob, c_int triu, MbRng *r) {
+  c_int    i, j, nnz, pass, rows;
+  MbRng    r0 = *r;
+  csc     *M  = OSQP_NULL;
+  c_float *rowsum, x;
+
+  // Count the elements in the first pass and store them in the second one
+  for (pass = 0; pass < 2; pass++) {
+    *r  = r0;
+    nnz = 0;
+    for (j = 0; j < n; j++) {
+      if (M) M->p[j] = nnz;
+      rows = triu ? j : m;
+      for (i = rng_skip(r, prob) - 1; i < rows; i += rng_skip(r, prob)) {
+        x = 2. * rng_uniform(r) - 1.; // Drawn in both passes
+        if (M) {
+          M->i[nnz] = i;
+          M->x[nnz] = x;
+        }
+        nnz++;
+      }
+      if (triu) {
+        if (M) M->i[nnz] = j;
+        nnz++;
+      }
+    }
+    if (M) {
+      M->p[n] = nnz;
+      break;
+    }
+    M = csc_spalloc(m, n, nnz ? nnz : 1, 1, 0);
+    if (!M) return OSQP_NULL;
+  }
+
+  if (triu) {
+    rowsum = (c_float *)c_calloc(n ? n : 1, sizeof(c_float));
+    if (!rowsum) {
+      csc_spfree(M);
+      return OSQP_NULL;
+    }
+    for (j = 0; j < n; j++) {
+      for (i = M->p[j]; i < M->p[j + 1] - 1; i++) {
+        rowsum[M->i[i]] += c_absval(M->x[i]);
+        rowsum[j]       += c_absval(M->x[i]);
+      }
+    }
+    for (j = 0; j < n; j++) M->x[M->p[j + 1] - 1] = 1. + rowsum[j];
+    c_free(rowsum);
+  }
+
+  return M;
+}
+
+/// Dense matrix stored in csc form (only the upper triangular part with triu)
+static csc* dense_csc(c_int m, c_int n, c_int triu, MbRng *r) {
+  c_int i, j, nnz = 0;
+  csc  *M = csc_spalloc(m, n, triu ? n * (n + 1) / 2 : m * n, 1, 0);
+
+  if (!M) return OSQP_NULL;
+  for (j = 0; j < n; j++) {
+    M->p[j] = nnz;
+    for (i = 0; i < (triu ? j + 1 : m); i++) {
+      M->i[nnz]   = i;
+      M->x[nnz++] = 2. * rng_uniform(r) - 1.;
+    }
+  }
+  M->p[n] = nnz;
+
+  return M;
+}
+
+/// Random matrix of dense bs x bs blocks with density nonzeros per column
+static bsr* random_bsr(c_int m, c_int n, c_int bs, c_float density, MbRng *r) {
+  c_int I, J, i, j, k, nnz = 0;
+  c_int mb = (m + bs - 1) / bs, nb = (n + bs - 1) / bs;
+  csc  *pat, *M;
+  bsr  *B;
+
+  pat = random_csc(mb, nb, density / (bs * c_max(mb, 1)), 0, r);
+  if (!pat) return OSQP_NULL;
+
+  M = csc_spalloc(m, n, c_max(pat->p[nb] * bs * bs, 1), 1, 0);
+  if (!M) {
+    csc_spfree(pat);
+    return OSQP_NULL;
+  }
+  for (j = 0; j < n; j++) {
+    J       = j / bs;
+    M->p[j] = nnz;
+    for (k = pat->p[J]; k < pat->p[J + 1]; k++) {
+      I = pat->i[k];
+      for (i = I * bs; i < c_min((I + 1) * bs, m); i++) {
+        M->i[nnz]   = i;
+        M->x[nnz++] = 2. * rng_uniform(r) - 1.;
+      }
+    }
+  }
+  M->p[n] = nnz;
+
+  B = csc_to_bsr(M, bs);
+  csc_spfree(pat);
+  csc_spfree(M);
+
+  return B;
+}
+
+
+/*********************************
+*  Kernels                      *
+*********************************/
+
+static void free_data(MbData *d) {
+  if (d->P) csc_spfree(d->P);
+  if (d->A) csc_spfree(d->A);
+  if (d->Pd) csc_spfree(d->Pd);
+  if (d->Ad) csc_spfree(d->Ad);
+  if (d->Ab) bsr_spfree(d->Ab);
+  if (d->KKT) csc_spfree(d->KKT);
+  if (d->s) d->s->free(d->s);
+  c_free(d->PtoKKT);
+  c_free(d->AtoKKT);
+  c_free(d->rhotoKKT);
+  c_free(d->Pdiag_idx);
+  c_free(d->a);
+  c_free(d->b);
+  c_free(d->c);
+  c_free(d->ones);
+  c_free(d->rhs);
+  c_free(d->sol);
+  c_free(d->ia);
+  c_free(d->ib);
+  c_free(d->rho_vec);
+  c_free(d->rho_inv_vec);
+  c_free(d->pdata.l);
+  c_free(d->pdata.u);
+}
+
+/**
+ * Generate the data of the kernels
+ * @return Exitflag (nonzero if an allocation failed)
+ */
+static c_int init_data(MbData *d, c_int n, c_int m, c_float density, c_int bs,
+                       enum ordering_type ordering, unsigned long seed) {
+  c_int i, len = c_max(n, m);
+  MbRng r;
+
+  memset(d, 0, sizeof(MbData));
+  d->n       = n;
+  d->m       = m;
+  d->density = density;
+  rng_seed(&r, seed);
+
+  d->P  = random_csc(n, n, c_min(density / (2. * c_max(n, 1)), 1.), 1, &r);
+  d->A  = random_csc(m, n, c_min(density / c_max(m, 1), 1.), 0, &r);
+  d->Ab = random_bsr(m, n, bs, density, &r);
+  if ((c_float)m * n <= MB_DENSE_MAX) {
+    d->Pd = dense_csc(n, n, 1, &r);
+    d->Ad = dense_csc(m, n, 0, &r);
+    if (!d->Pd || !d->Ad) return 1;
+  }
+
+  d->a           = (c_float *)c_malloc(len * sizeof(c_float));
+  d->b           = (c_float *)c_malloc(len * sizeof(c_float));
+  d->c           = (c_float *)c_malloc(len * sizeof(c_float));
+  d->ones        = (c_float *)c_malloc(len * sizeof(c_float));
+  d->rhs         = (c_float *)c_malloc((n + m) * sizeof(c_float));
+  d->sol         = (c_float *)c_malloc((n + m) * sizeof(c_float));
+  d->ia          = (c_int *)c_malloc(n * sizeof(c_int));
+  d->ib          = (c_int *)c_malloc(n * sizeof(c_int));
+  d->rho_vec     = (c_float *)c_malloc(m * sizeof(c_float));
+  d->rho_inv_vec = (c_float *)c_malloc(m * sizeof(c_float));
+  d->pdata.l     = (c_float *)c_malloc(m * sizeof(c_float));
+  d->pdata.u     = (c_float *)c_malloc(m * sizeof(c_float));
+  d->PtoKKT      = (c_int *)c_malloc(c_max(d->P ? d->P->p[n] : 0, 1) * sizeof(c_int));
+  d->AtoKKT      = (c_int *)c_malloc(c_max(d->A ? d->A->p[n] : 0, 1) * sizeof(c_int));
+  d->rhotoKKT    = (c_int *)c_malloc(c_max(m, 1) * sizeof(c_int));
+  if (!d->P || !d->A || !d->Ab || !d->a || !d->b || !d->c || !d->ones ||
+      !d->rhs || !d->sol || !d->ia || !d->ib || !d->rho_vec ||
+      !d->rho_inv_vec || !d->pdata.l || !d->pdata.u || !d->PtoKKT ||
+      !d->AtoKKT || !d->rhotoKKT) return 1;
+
+  // Positive vectors keep the reciprocal and the square root finite
+  for (i = 0; i < len; i++) {
+    d->a[i]    = 0.5 + rng_uniform(&r);
+    d->b[i]    = 0.5 + rng_uniform(&r);
+    d->c[i]    = 0.5 + rng_uniform(&r);
+    d->ones[i] = 1.;
+  }
+  for (i = 0; i < n + m; i++) d->rhs[i] = 2. * rng_uniform(&r) - 1.;
+  for (i = 0; i < n; i++) d->ia[i] = i;
+  for (i = 0; i < m; i++) {
+    d->rho_vec[i]     = MB_RHO;
+    d->rho_inv_vec[i] = 1. / MB_RHO;
+    d->pdata.l[i]     = -rng_uniform(&r);
+    d->pdata.u[i]     = rng_uniform(&r);
+  }
+
+  // KKT matrix with the maps used by the updates
+  d->KKT = form_KKT(d->P, d->A, 0, MB_SIGMA, d->rho_inv_vec, d->PtoKKT,
+                    d->AtoKKT, &d->Pdiag_idx, &d->Pdiag_n, d->rhotoKKT);
+  if (!d->KKT) return 1;
+
+  // The QDLDL kernels are skipped if the factor is too large
+  if (kkt_fill(d->P, d->A, OSQP_NULL, ordering) <= MB_FACTOR_MAX) {
+    if (init_linsys_solver(&d->s, d->P, d->A, MB_SIGMA, d->rho_vec,
+                           QDLDL_SOLVER, 0, OSQP_NULL, ordering, OSQP_NULL)) {
+      d->s = OSQP_NULL;
+      return 1;
+    }
+    linsys_factor_stats(d->s, &d->stats);
+  }
+
+  // The projection only reads the bounds of the workspace data
+  d->pdata.n    = n;
+  d->pdata.m    = m;
+  d->pwork.data = &d->pdata;
+
+  return 0;
+}
+
+/// Check if the data of a kernel are available
+static c_int kernel_available(const MbData *d, enum mb_kernel k) {
+  switch (k) {
+  case MB_MAT_VEC_DENSE:
+  case MB_MAT_TPOSE_VEC_DENSE:
+  case MB_MAT_VEC_DENSE_SYM_TRIU:
+    return d->Ad != OSQP_NULL;
+
+  case MB_QDLDL_SETUP:
+  case MB_QDLDL_REFACTOR:
+  case MB_QDLDL_SOLVE:
+    return d->s != OSQP_NULL;
+
+  default:
+    return 1;
+  }
+}
+
+/// Run a kernel once
+static void run_kernel(MbData *d, enum mb_kernel k, enum ordering_type ordering) {
+  c_int n = d->n, m = d->m;
+  csc  *KKT;
+  c_int *Pdiag_idx, Pdiag_n;
+  LinSysSolver *s;
+
+  switch (k) {
+  case MB_PREA_VEC_COPY:       prea_vec_copy(d->a, d->b, n); break;
+  case MB_PREA_INT_VEC_COPY:   prea_int_vec_copy(d->ia, d->ib, n); break;
+  case MB_VEC_SET_SCALAR:      vec_set_scalar(d->c, 1., n); break;
+  case MB_INT_VEC_SET_SCALAR:  int_vec_set_scalar(d->ib, 1, n); break;
+  case MB_VEC_ADD_SCALAR:      vec_add_scalar(d->c, 0., n); break;
+  case MB_VEC_MULT_SCALAR:     vec_mult_scalar(d->c, 1., n); break;
+  case MB_VEC_ADD_SCALED:      vec_add_scaled(d->c, d->a, d->b, n, 0.5); break;
+  case MB_VEC_NORM_INF:        d->sink += vec_norm_inf(d->a, n); break;
+  case MB_VEC_SCALED_NORM_INF: d->sink += vec_scaled_norm_inf(d->a, d->b, n); break;
+  case MB_VEC_NORM_INF_DIFF:   d->sink += vec_norm_inf_diff(d->a, d->b, n); break;
+  case MB_VEC_MEAN:            d->sink += vec_mean(d->a, n); break;
+  case MB_VEC_EW_RECIPR:       vec_ew_recipr(d->a, d->c, n); break;
+  case MB_VEC_PROD:            d->sink += vec_prod(d->a, d->b, n); break;
+  case MB_VEC_EW_PROD:         vec_ew_prod(d->a, d->b, d->c, n); break;
+  case MB_VEC_EW_SQRT:         vec_ew_sqrt(d->c, n); break;
+  case MB_VEC_EW_MAX:          vec_ew_max(d->c, n, 0.); break;
+  case MB_VEC_EW_MIN:          vec_ew_min(d->c, n, 2.); break;
+  case MB_VEC_EW_MAX_VEC:      vec_ew_max_vec(d->a, d->b, d->c, n); break;
+  case MB_VEC_EW_MIN_VEC:      vec_ew_min_vec(d->a, d->b, d->c, n); break;
+
+  case MB_MAT_MULT_SCALAR:     mat_mult_scalar(d->A, 1.); break;
+  case MB_MAT_PREMULT_DIAG:    mat_premult_diag(d->A, d->ones); break;
+  case MB_MAT_POSTMULT_DIAG:   mat_postmult_diag(d->A, d->ones); break;
+  case MB_MAT_VEC:             mat_vec(d->A, d->a, d->c, 0); break;
+  case MB_MAT_TPOSE_VEC:       mat_tpose_vec(d->A, d->a, d->c, 0, 0); break;
+  case MB_MAT_INF_NORM_COLS:   mat_inf_norm_cols(d->A, d->c); break;
+  case MB_MAT_INF_NORM_ROWS:   mat_inf_norm_rows(d->A, d->c); break;
+  case MB_MAT_INF_NORM_COLS_SYM_TRIU: mat_inf_norm_cols_sym_triu(d->P, d->c); break;
+  case MB_QUAD_FORM:           d->sink += quad_form(d->P, d->a); break;
+
+  case MB_MAT_VEC_DENSE:          mat_vec_dense(d->Ad, d->a, d->c, 0); break;
+  case MB_MAT_TPOSE_VEC_DENSE:    mat_tpose_vec_dense(d->Ad, d->a, d->c, 0); break;
+  case MB_MAT_VEC_DENSE_SYM_TRIU: mat_vec_dense_sym_triu(d->Pd, d->a, d->c); break;
+  case MB_BSR_MAT_VEC:            bsr_mat_vec(d->Ab, d->a, d->c, 0); break;
+  case MB_BSR_MAT_TPOSE_VEC:      bsr_mat_tpose_vec(d->Ab, d->a, d->c, 0); break;
+
+  case MB_FORM_KKT:
+    Pdiag_idx = OSQP_NULL;
+    KKT = form_KKT(d->P, d->A, 0, MB_SIGMA, d->rho_inv_vec, OSQP_NULL,
+                   OSQP_NULL, &Pdiag_idx, &Pdiag_n, OSQP_NULL);
+    if (KKT) csc_spfree(KKT);
+    c_free(Pdiag_idx);
+    break;
+
+  case MB_UPDATE_KKT_P:
+    update_KKT_P(d->KKT, d->P, d->PtoKKT, MB_SIGMA, d->Pdiag_idx, d->Pdiag_n);
+    break;
+
+  case MB_UPDATE_KKT_A:
+    update_KKT_A(d->KKT, d->A, d->AtoKKT);
+    break;
+
+  case MB_UPDATE_KKT_PARAM2:
+    update_KKT_param2(d->KKT, d->rho_inv_vec, d->rhotoKKT, m);
+    break;
+
+  case MB_QDLDL_SETUP:
+    if (!init_linsys_solver(&s, d->P, d->A, MB_SIGMA, d->rho_vec, QDLDL_SOLVER,
+                            0, OSQP_NULL, ordering, OSQP_NULL)) s->free(s);
+    break;
+
+  case MB_QDLDL_REFACTOR:
+    d->s->update_matrices(d->s, d->P, d->A);
+    break;
+
+  case MB_QDLDL_SOLVE:
+    // The right-hand side is overwritten with the solution
+    prea_vec_copy(d->rhs, d->sol, n + m);
+    d->s->solve(d->s, d->sol);
+    break;
+
+  case MB_PROJECT:
+    project(&d->pwork, d->c);
+    break;
+
+  default:
+    break;
+  }
+}
+
+/// Compulsory traffic in bytes and floating point operations of a kernel
+static void kernel_cost(const MbData *d, enum mb_kernel k,
+                        double *bytes, double *flops) {
+  double F = sizeof(c_float), I = sizeof(c_int);
+  double n = d->n, m = d->m;
+  double nzA = d->A->p[d->A->n], nzP = d->P->p[d->P->n];
+  double nzK = d->KKT->p[d->KKT->n];
+  double nzL = d->stats.nnz_L, nzB = 0., bs2;
+
+  *bytes = 0.;
+  *flops = 0.;
+
+  switch (k) {
+  case MB_PREA_VEC_COPY:       *bytes = 2 * n * F; break;
+  case MB_PREA_INT_VEC_COPY:   *bytes = 2 * n * I; break;
+  case MB_VEC_SET_SCALAR:      *bytes = n * F; break;
+  case MB_INT_VEC_SET_SCALAR:  *bytes = n * I; break;
+  case MB_VEC_ADD_SCALAR:
+  case MB_VEC_MULT_SCALAR:
+  case MB_VEC_EW_RECIPR:
+  case MB_VEC_EW_SQRT:
+  case MB_VEC_EW_MAX:
+  case MB_VEC_EW_MIN:          *bytes = 2 * n * F; *flops = n; break;
+  case MB_VEC_ADD_SCALED:      *bytes = 3 * n * F; *flops = 2 * n; break;
+  case MB_VEC_NORM_INF:
+  case MB_VEC_MEAN:            *bytes = n * F; *flops = n; break;
+  case MB_VEC_SCALED_NORM_INF:
+  case MB_VEC_NORM_INF_DIFF:
+  case MB_VEC_PROD:            *bytes = 2 * n * F; *flops = 2 * n; break;
+  case MB_VEC_EW_PROD:
+  case MB_VEC_EW_MAX_VEC:
+  case MB_VEC_EW_MIN_VEC:      *bytes = 3 * n * F; *flops = n; break;
+
+  case MB_MAT_MULT_SCALAR:     *bytes = 2 * nzA * F; *flops = nzA; break;
+  case MB_MAT_PREMULT_DIAG:    *bytes = nzA * (2 * F + I) + m * F; *flops = nzA; break;
+  case MB_MAT_POSTMULT_DIAG:   *bytes = 2 * nzA * F + (n + 1) * I + n * F; *flops = nzA; break;
+  case MB_MAT_VEC:
+  case MB_MAT_TPOSE_VEC:       *bytes = nzA * (F + I) + (n + 1) * I + (n + m) * F;
+                               *flops = 2 * nzA; break;
+  case MB_MAT_INF_NORM_COLS:   *bytes = nzA * F + (n + 1) * I + n * F; *flops = nzA; break;
+  case MB_MAT_INF_NORM_ROWS:   *bytes = nzA * (F + I) + (n + 1) * I + m * F; *flops = nzA; break;
+  case MB_MAT_INF_NORM_COLS_SYM_TRIU:
+                               *bytes = nzP * (F + I) + (n + 1) * I + n * F;
+                               *flops = 2 * nzP; break;
+  case MB_QUAD_FORM:           *bytes = nzP * (F + I) + (n + 1) * I + n * F;
+                               *flops = 3 * nzP; break;
+
+  case MB_MAT_VEC_DENSE:
+  case MB_MAT_TPOSE_VEC_DENSE: *bytes = (m * n + n + m) * F; *flops = 2 * m * n; break;
+  case MB_MAT_VEC_DENSE_SYM_TRIU:
+                               *bytes = (n * (n + 1) / 2 + 2 * n) * F; *flops = 2 * n * n; break;
+  case MB_BSR_MAT_VEC:
+  case MB_BSR_MAT_TPOSE_VEC:
+    nzB    = d->Ab->p[d->Ab->mb];
+    bs2    = (double)d->Ab->bs * d->Ab->bs;
+    *bytes = nzB * (bs2 * F + I) + (d->Ab->mb + 1) * I + (n + m) * F;
+    *flops = 2 * nzB * bs2;
+    break;
+
+  case MB_FORM_KKT:            *bytes = (nzP + nzA + nzK) * (F + I) + (2 * n + m + 1) * I; break;
+  case MB_UPDATE_KKT_P:        *bytes = nzP * (2 * F + I); *flops = d->Pdiag_n; break;
+  case MB_UPDATE_KKT_A:        *bytes = nzA * (2 * F + I); break;
+  case MB_UPDATE_KKT_PARAM2:   *bytes = m * (2 * F + I); *flops = m; break;
+
+  case MB_QDLDL_SETUP:
+  case MB_QDLDL_REFACTOR:      *bytes = (nzK + nzL) * (F + I) + (n + m) * F;
+                               *flops = d->stats.flops; break;
+  case MB_QDLDL_SOLVE:         *bytes = 2 * nzL * (F + I) + 5 * (n + m) * F + (n + m) * I;
+                               *flops = 4 * nzL + (n + m); break;
+
+  case MB_PROJECT:             *bytes = 4 * m * F; *flops = 2 * m; break;
+
+  default:
+    break;
+  }
+}
+
+/**
+ * Time a kernel: the calls are grouped in batches of at least min_time
+ * seconds and the time per call is the minimum over the batches
+ */
+static double time_kernel(MbData *d, enum mb_kernel k, enum ordering_type ordering,
+                          c_int reps, double min_time) {
+  c_int     rep, i, calls = 1;
+  double    t, best = -1.;
+  OSQPTimer timer;
+
+  // Warm up and find the number of calls of a batch
+  for (;;) {
+    osqp_tic(&timer);
+    for (i = 0; i < calls; i++) run_kernel(d, k, ordering);
+    t = osqp_toc(&timer);
+    if ((t >= min_time) || (calls >= (1 << 30))) break;
+    calls = (t > 0.) ? (c_int)c_min(2. * calls * min_time / t + 1., 1 << 30)
+                     : 2 * calls;
+  }
+
+  for (rep = 0; rep < reps; rep++) {
+    osqp_tic(&timer);
+    for (i = 0; i < calls; i++) run_kernel(d, k, ordering);
+    t = osqp_toc(&timer) / calls;
+    if ((best < 0.) || (t < best)) best = t;
+  }
+
+  return best;
+}
+
+
+static void print_usage(void) {
+  printf("Usage: osqp_microbench [options]\n"
+         "  -k <name>       run the kernels whose name contains name (default: all)\n"
+         "  -n <n1,n2,...>  numbers of variables (default: 1000,10000,100000)\n"
+         "  -a <ratio>      ratio of constraints to variables (default: 2)\n"
+         "  -d <d1,d2,...>  nonzeros per column of A (default: 4,16)\n"
+         "  -B <bs>         block size of the block sparse kernels (default: 4)\n"
+         "  -r <reps>       batches, the minimum time is reported (default: 5)\n"
+         "  -t <seconds>    minimum time of a batch (default: 0.01)\n"
+         "  -O <ordering>   KKT ordering: amd, rcm or nd (default: amd)\n"
+         "  -S <seed>       seed of the data generator (default: 1)\n"
+         "  -o <file>       write the results to file (default: stdout)\n");
+}
+
+static c_int parse_list(char *arg, double *list) {
+  c_int k = 0;
+  char *tok;
+
+  for (tok = strtok(arg, ","); tok && (k < MB_MAX_LIST); tok = strtok(OSQP_NULL, ",")) {
+    list[k++] = atof(tok);
+  }
+
+  return k;
+}
+
+
+int main(int argc, char **argv) {
+  c_int         a, s, q, k, nsizes = 3, ndens = 2, bs = 4, reps = 5;
+  double        sizes[MB_MAX_LIST] = { 1000, 10000, 100000 };
+  double        dens[MB_MAX_LIST]  = { 4, 16 };
+  double        ratio = 2., min_time = 1e-02, t, bytes, flops;
+  unsigned long seed        = 1;
+  const char   *kernel_name = OSQP_NULL, *out_file = OSQP_NULL;
+  enum ordering_type ordering = AMD_ORDERING;
+  FILE         *out = stdout;
+  MbData        d;
+
+  memset(&d, 0, sizeof(MbData));
+
+  // Parse the options
+  for (a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-h")) {
+      print_usage();
+      return 0;
+    }
+    if ((argv[a][0] != '-') || (a + 1 >= argc)) {
+      print_usage();
+      return 2;
+    }
+    switch (argv[a][1]) {
+    case 'k': kernel_name = argv[++a]; break;
+    case 'n': nsizes = parse_list(argv[++a], sizes); break;
+    case 'd': ndens = parse_list(argv[++a], dens); break;
+    case 'a': ratio = atof(argv[++a]); break;
+    case 'B': bs = atoi(argv[++a]); bs = c_max(bs, 1); break;
+    case 'r': reps = atoi(argv[++a]); reps = c_max(reps, 1); break;
+    case 't': min_time = atof(argv[++a]); break;
+    case 'S': seed = strtoul(argv[++a], OSQP_NULL, 10); break;
+    case 'o': out_file = argv[++a]; break;
+    case 'O':
+      a++;
+      if (!strcmp(argv[a], "amd")) ordering = AMD_ORDERING;
+      else if (!strcmp(argv[a], "rcm")) ordering = RCM_ORDERING;
+      else if (!strcmp(argv[a], "nd")) ordering = ND_ORDERING;
+      else {
+        print_usage();
+        return 2;
+      }
+      break;
+    default:
+      print_usage();
+      return 2;
+    }
+  }
+
+  if (out_file) {
+    out = fopen(out_file, "w");
+    if (!out) {
+      fprintf(stderr, "Cannot open %s\n", out_file);
+      return 2;
+    }
+  }
+
+  fputs("kernel,n,m,density,time,bytes,flops,gb_s,gflop_s\n", out);
+  for (s = 0; s < nsizes; s++) {
+    c_int n = (c_int)sizes[s], m = (c_int)(ratio * sizes[s]);
+
+    for (q = 0; q < ndens; q++) {
+      if ((n < 1) || (m < 1) || init_data(&d, n, m, dens[q], bs, ordering, seed)) {
+        fprintf(stderr, "n %i m %i density %g: cannot generate the data\n",
+                (int)n, (int)m, dens[q]);
+        free_data(&d);
+        continue;
+      }
+      fprintf(stderr, "n %i  m %i  nnz(P) %i  nnz(A) %i  nnz(L) %i\n",
+              (int)n, (int)m, (int)d.P->p[n], (int)d.A->p[n], (int)d.stats.nnz_L);
+      if (!d.s) {
+        fprintf(stderr, "  the factor has more than %i nonzeros, skipping the QDLDL kernels\n",
+                (int)MB_FACTOR_MAX);
+      }
+
+      for (k = 0; k < MB_NKERNELS; k++) {
+        if (kernel_name && !strstr(mb_kernel_name[k], kernel_name)) continue;
+        if (!kernel_available(&d, (enum mb_kernel)k)) continue;
+
+        t = time_kernel(&d, (enum mb_kernel)k, ordering, reps, min_time);
+        kernel_cost(&d, (enum mb_kernel)k, &bytes, &flops);
+        fprintf(out, "%s,%i,%i,%g,%.6e,%.6e,%.6e,%.4f,%.4f\n",
+                mb_kernel_name[k], (int)n, (int)m, dens[q], t, bytes, flops,
+                1e-09 * bytes / t, 1e-09 * flops / t);
+        fprintf(stderr, "  %-28s %.3e s  %8.3f GB/s  %8.3f GFLOP/s\n",
+                mb_kernel_name[k], t, 1e-09 * bytes / t, 1e-09 * flops / t);
+        fflush(out);
+      }
+      free_data(&d);
+    }
+  }
+
+  if (out_file) fclose(out);
+
+  return 0;
+}
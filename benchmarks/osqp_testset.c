@@ -0,0 +1,608 @@
+/*
+ * OSQP test set runner
+ *
+ * Solves every QPS problem of a directory, e.g., the Maros-Meszaros test set,
+ * with the given settings and writes the status, iterations, objective,
+ * residuals and times of each problem as CSV. The objective of the file, with
+ * its constant and sense, is compared with the reference objectives if given. The times are the minimum over the
+ * repetitions, each of them a setup and a solve.
+ *
+ * With a baseline CSV from a previous run, the shifted geometric means of the
+ * run times of both runs are compared, the problems that are not solved
+ * counting with a fixed failure time. The program returns 1 if the run is
+ * slower than the tolerance or a problem solved in the baseline fails.
+ */
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef IS_WINDOWS
+# include <windows.h>
+#else  /* ifdef IS_WINDOWS */
+# include <dirent.h>
+#endif /* ifdef IS_WINDOWS */
+
+#include "osqp.h"
+
+#ifndef PROFILING
+# error "osqp_testset requires OSQP to be compiled with PROFILING"
+#endif /* ifndef PROFILING */
+
+#define TS_NAME_LEN  (64)
+#define TS_PATH_LEN  (1024)
+#define TS_LINE_LEN  (512)
+#define TS_MIN_TIME  (1e-04) ///< timing differences below this are noise
+
+
+/// Results of a problem
+typedef struct {
+  char   name[TS_NAME_LEN];
+  long   n, m, nnz_P, nnz_A, status, status_polish, iter;
+  double obj_val, obj_ref, obj_err, pri_res, dua_res;
+  double setup_time, solve_time, run_time;
+} TsResult;
+
+/// Reference objective of a problem
+typedef struct {
+  char   name[TS_NAME_LEN];
+  double obj;
+} TsReference;
+
+/// Growing array
+typedef struct {
+  void *v;
+  c_int len, size;
+} TsArray;
+
+static const char *ts_header =
+  "problem,n,m,nnz_P,nnz_A,status,status_polish,iter,obj_val,obj_ref,obj_err,"
+  "pri_res,dua_res,setup_time,solve_time,run_time\n";
+
+/// Settings given in a settings file or with -s
+typedef struct {
+  const char *name;
+  c_int       is_float;
+  size_t      offset; ///< offset of the field in OSQPSettings
+} TsSetting;
+
+static const TsSetting ts_settings[] = {
+  { "rho",                    1, offsetof(OSQPSettings, rho) },
+  { "sigma",                  1, offsetof(OSQPSettings, sigma) },
+  { "scaling",                0, offsetof(OSQPSettings, scaling) },
+  { "adaptive_rho",           0, offsetof(OSQPSettings, adaptive_rho) },
+  { "adaptive_rho_interval",  0, offsetof(OSQPSettings, adaptive_rho_interval) },
+  { "adaptive_rho_tolerance", 1, offsetof(OSQPSettings, adaptive_rho_tolerance) },
+  { "adaptive_rho_fraction",  1, offsetof(OSQPSettings, adaptive_rho_fraction) },
+  { "max_iter",               0, offsetof(OSQPSettings, max_iter) },
+  { "eps_abs",                1, offsetof(OSQPSettings, eps_abs) },
+  { "eps_rel",                1, offsetof(OSQPSettings, eps_rel) },
+  { "eps_prim_inf",           1, offsetof(OSQPSettings, eps_prim_inf) },
+  { "eps_dual_inf",           1, offsetof(OSQPSettings, eps_dual_inf) },
+  { "alpha",                  1, offsetof(OSQPSettings, alpha) },
+  { "delta",                  1, offsetof(OSQPSettings, delta) },
+  { "polish",                 0, offsetof(OSQPSettings, polish) },
+  { "polish_refine_iter",     0, offsetof(OSQPSettings, polish_refine_iter) },
+  { "presolve",               0, offsetof(OSQPSettings, presolve) },
+  { "var_bounds",             0, offsetof(OSQPSettings, var_bounds) },
+  { "verbose",                0, offsetof(OSQPSettings, verbose) },
+  { "scaled_termination",     0, offsetof(OSQPSettings, scaled_termination) },
+  { "check_termination",      0, offsetof(OSQPSettings, check_termination) },
+  { "warm_start",             0, offsetof(OSQPSettings, warm_start) },
+  { "time_limit",             1, offsetof(OSQPSettings, time_limit) }
+};
+
+#define TS_NSETTINGS ((c_int)(sizeof(ts_settings) / sizeof(ts_settings[0])))
+
+
+static void print_usage(void) {
+  printf("Usage: osqp_testset [options] <directory>\n"
+         "Solves the .qps, .mps and .sif files in QPS format of the directory.\n"
+         "  -f <pattern>     run only the problems whose name contains pattern\n"
+         "  -r <reps>        repetitions, the minimum time is reported (default: 1)\n"
+         "  -p <file>        settings file with a setting name and value per line\n"
+         "  -s <name=value>  setting, e.g., -s eps_abs=1e-5 (can be repeated)\n"
+         "  -O <ordering>    KKT ordering: amd, rcm or nd (default: amd)\n"
+         "  -R <file>        reference objectives, a problem name and objective per line\n"
+         "  -A <tol>         relative objective error of an accurate solution (default: 1e-3)\n"
+         "  -o <file>        write the results to file (default: stdout)\n"
+         "  -b <file>        compare with the results of a previous run\n"
+         "  -g <shift>       shift of the geometric means in seconds (default: 1e-2)\n"
+         "  -F <time>        time of the failed problems in the means (default: the\n"
+         "                   time limit, or 10 seconds without a time limit)\n"
+         "  -t <tol>         slowdown ratio reported as a regression (default: 1.2)\n");
+}
+
+// Grow the array to hold one more element of size bytes
+static void* array_push(TsArray *a, size_t size) {
+  void *v;
+
+  if (a->len == a->size) {
+    a->size = c_max(2 * a->size, 16);
+    v       = c_realloc(a->v, a->size * size);
+    if (!v) return OSQP_NULL;
+    a->v = v;
+  }
+  return (char *)a->v + size * a->len++;
+}
+
+static c_int name_equal(const char *a, const char *b) {
+  for (; *a && *b; a++, b++) {
+    if (toupper((unsigned char)*a) != toupper((unsigned char)*b)) return 0;
+  }
+  return *a == *b;
+}
+
+static c_int setting_index(const char *name) {
+  c_int k;
+
+  for (k = 0; k < TS_NSETTINGS; k++) {
+    if (!strcmp(ts_settings[k].name, name)) return k;
+  }
+  return -1;
+}
+
+/**
+ * Set the setting k from its value
+ * @return Exitflag (nonzero if the value is not valid)
+ */
+static c_int set_setting(OSQPSettings *settings, c_int k, const char *value) {
+  char  *end;
+  double v;
+
+  v = strtod(value, &end);
+  if ((end == value) || (*end && !isspace((unsigned char)*end))) return 1;
+  if (ts_settings[k].is_float) *(c_float *)((char *)settings + ts_settings[k].offset) = (c_float)v;
+  else *(c_int *)((char *)settings + ts_settings[k].offset) = (c_int)v;
+
+  return 0;
+}
+
+/**
+ * Read a settings file in the format of the CUTEst OSQP.SPC files: a setting
+ * name starting in the first column followed by its value. Other lines and
+ * unknown settings are ignored.
+ * @return Exitflag (nonzero if the file could not be read or has an invalid value)
+ */
+static c_int read_settings(const char *file, OSQPSettings *settings) {
+  char  line[TS_LINE_LEN], name[TS_NAME_LEN], value[TS_NAME_LEN];
+  c_int k;
+  FILE *f = fopen(file, "r");
+
+  if (!f) return 1;
+
+  while (fgets(line, TS_LINE_LEN, f)) {
+    if (!isalpha((unsigned char)line[0])) continue;
+    if (sscanf(line, "%63s %63s", name, value) != 2) value[0] = '\0';
+    if ((k = setting_index(name)) < 0) {
+      fprintf(stderr, "Ignoring the setting %s of %s\n", name, file);
+      continue;
+    }
+    if (set_setting(settings, k, value)) {
+      fprintf(stderr, "Invalid setting in %s: %s", file, line);
+      fclose(f);
+      return 1;
+    }
+  }
+  fclose(f);
+
+  return 0;
+}
+
+/**
+ * Read the reference objectives, a problem name and its objective per line.
+ * Lines starting with # are ignored.
+ * @return Exitflag (nonzero if the file could not be read)
+ */
+static c_int read_references(const char *file, TsArray *refs) {
+  char         line[TS_LINE_LEN];
+  TsReference  r, *p;
+  FILE        *f = fopen(file, "r");
+
+  if (!f) return 1;
+
+  while (fgets(line, TS_LINE_LEN, f)) {
+    if ((line[0] == '#') || (sscanf(line, "%63s %lf", r.name, &r.obj) != 2)) continue;
+    p = (TsReference *)array_push(refs, sizeof(TsReference));
+    if (!p) {
+      fclose(f);
+      return 1;
+    }
+    *p = r;
+  }
+  fclose(f);
+
+  return 0;
+}
+
+static c_int read_results(const char *file, TsArray *res) {
+  char      line[TS_LINE_LEN];
+  TsResult  r, *p;
+  FILE     *f = fopen(file, "r");
+
+  if (!f) return 1;
+
+  while (fgets(line, TS_LINE_LEN, f)) {
+    if (sscanf(line, "%63[^,],%ld,%ld,%ld,%ld,%ld,%ld,%ld,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf",
+               r.name, &r.n, &r.m, &r.nnz_P, &r.nnz_A, &r.status,
+               &r.status_polish, &r.iter, &r.obj_val, &r.obj_ref, &r.obj_err,
+               &r.pri_res, &r.dua_res, &r.setup_time, &r.solve_time,
+               &r.run_time) != 16) continue;
+    p = (TsResult *)array_push(res, sizeof(TsResult));
+    if (!p) {
+      fclose(f);
+      return 1;
+    }
+    *p = r;
+  }
+  fclose(f);
+
+  return 0;
+}
+
+static void write_result(FILE *f, const TsResult *r) {
+  fprintf(f, "%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%.17g,%.17g,%.6e,%.6e,%.6e,%.6e,%.6e,%.6e\n",
+          r->name, r->n, r->m, r->nnz_P, r->nnz_A, r->status, r->status_polish,
+          r->iter, r->obj_val, r->obj_ref, r->obj_err, r->pri_res, r->dua_res,
+          r->setup_time, r->solve_time, r->run_time);
+}
+
+
+/*********************************
+*  Problem files                *
+*********************************/
+
+// Check if the file has the extension of a QPS file
+static c_int is_qps_file(const char *file) {
+  const char *ext = strrchr(file, '.');
+
+  return ext && (name_equal(ext, ".qps") || name_equal(ext, ".mps") ||
+                 name_equal(ext, ".sif"));
+}
+
+static int compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Add a copy of a file name to the list
+static c_int push_file(TsArray *files, const char *name) {
+  char **p;
+  char  *s;
+
+  if (!is_qps_file(name)) return 0;
+  s = (char *)c_malloc(strlen(name) + 1);
+  p = (char **)array_push(files, sizeof(char *));
+  if (!s || !p) {
+    if (s) c_free(s);
+    return 1;
+  }
+  strcpy(s, name);
+  *p = s;
+
+  return 0;
+}
+
+/**
+ * List the QPS files of a directory in alphabetical order
+ * @return Exitflag (nonzero if the directory could not be read)
+ */
+static c_int list_files(const char *dir, TsArray *files) {
+  c_int exitflag = 0;
+#ifdef IS_WINDOWS
+  char             pattern[TS_PATH_LEN];
+  WIN32_FIND_DATAA fd;
+  HANDLE           h;
+
+  snprintf(pattern, TS_PATH_LEN, "%s\\*", dir);
+  h = FindFirstFileA(pattern, &fd);
+  if (h == INVALID_HANDLE_VALUE) return 1;
+  do {
+    exitflag = push_file(files, fd.cFileName);
+  } while (!exitflag && FindNextFileA(h, &fd));
+  FindClose(h);
+#else  /* ifdef IS_WINDOWS */
+  struct dirent *e;
+  DIR           *d = opendir(dir);
+
+  if (!d) return 1;
+  while (!exitflag && (e = readdir(d))) {
+    exitflag = push_file(files, e->d_name);
+  }
+  closedir(d);
+#endif /* ifdef IS_WINDOWS */
+
+  if (files->len) qsort(files->v, (size_t)files->len, sizeof(char *), compare_names);
+
+  return exitflag;
+}
+
+
+/*********************************
+*  Runs                         *
+*********************************/
+
+/**
+ * Solve a problem reps times
+ * @return Exitflag (nonzero if the problem could not be read)
+ */
+static c_int run_problem(const char         *path,
+                         c_int               reps,
+                         const OSQPSettings *settings,
+                         TsResult           *res) {
+  c_int          rep, exitflag;
+  OSQPData      *data;
+  OSQPObjective  objective;
+  OSQPWorkspace *work;
+
+  res->n = res->m = res->nnz_P = res->nnz_A = 0;
+  res->status        = OSQP_UNSOLVED;
+  res->status_polish = 0;
+  res->iter          = 0;
+  res->obj_val       = res->obj_err = res->pri_res = res->dua_res = NAN;
+  res->setup_time    = res->solve_time = res->run_time = 0.;
+
+  if (osqp_read_qps(path, &data, &objective)) return 1;
+  res->n     = (long)data->n;
+  res->m     = (long)data->m;
+  res->nnz_P = (long)data->P->p[data->n];
+  res->nnz_A = (long)data->A->p[data->n];
+
+  for (rep = 0; rep < reps; rep++) {
+    exitflag = osqp_setup(&work, data, settings);
+    if (exitflag) {
+      if (exitflag == OSQP_NONCVX_ERROR) res->status = OSQP_NON_CVX;
+      break;
+    }
+    osqp_solve(work);
+
+    if (rep == 0) {
+      res->status        = (long)work->info->status_val;
+      res->status_polish = (long)work->info->status_polish;
+      res->iter          = (long)work->info->iter;
+      res->pri_res       = work->info->pri_res;
+      res->dua_res       = work->info->dua_res;
+
+      // Objective of the file, with its constant and sense
+      res->obj_val = objective.maximize ? -work->info->obj_val : work->info->obj_val;
+      res->obj_val += objective.constant;
+    }
+    if ((rep == 0) || (work->info->setup_time < res->setup_time))
+      res->setup_time = work->info->setup_time;
+    if ((rep == 0) || (work->info->solve_time < res->solve_time))
+      res->solve_time = work->info->solve_time;
+    if ((rep == 0) || (work->info->run_time < res->run_time))
+      res->run_time = work->info->run_time;
+
+    osqp_cleanup(work);
+  }
+  osqp_free_problem(data, OSQP_NULL);
+
+  return 0;
+}
+
+// Check if the problem is solved, accurately if its reference objective is known
+static c_int is_solved(const TsResult *r, double acc_tol) {
+  if (r->status != OSQP_SOLVED) return 0;
+  return (r->obj_ref != r->obj_ref) || (r->obj_err <= acc_tol);
+}
+
+/**
+ * Compare the run with the baseline: shifted geometric means of the run
+ * times, exp(mean(log(t + shift))) - shift, over the problems of both runs,
+ * with the time of the unsolved problems set to fail_time.
+ * @return Number of regressions
+ */
+static c_int compare_results(const TsArray *res,
+                             const TsArray *base,
+                             double         shift,
+                             double         fail_time,
+                             double         acc_tol,
+                             double         tol) {
+  c_int           k, j, nboth = 0, nreg = 0, nfixed = 0;
+  double          log_new = 0., log_old = 0., t_new, t_old, sgm_new, sgm_old;
+  const TsResult *r, *b = OSQP_NULL;
+
+  for (k = 0; k < res->len; k++) {
+    r = (const TsResult *)res->v + k;
+    for (j = 0; j < base->len; j++) {
+      b = (const TsResult *)base->v + j;
+      if (!strcmp(b->name, r->name)) break;
+    }
+    if (j == base->len) continue;
+
+    t_new = is_solved(r, acc_tol) ? r->run_time : fail_time;
+    t_old = is_solved(b, acc_tol) ? b->run_time : fail_time;
+    log_new += log(t_new + shift);
+    log_old += log(t_old + shift);
+    nboth++;
+
+    if (is_solved(b, acc_tol) && !is_solved(r, acc_tol)) {
+      fprintf(stderr, "regression: %s status %ld -> %ld\n", r->name, b->status, r->status);
+      nreg++;
+    } else if (!is_solved(b, acc_tol) && is_solved(r, acc_tol)) {
+      nfixed++;
+    } else if ((t_new > tol * t_old) && (t_new - t_old > TS_MIN_TIME)) {
+      // Slower problems are listed, the mean decides the regression
+      fprintf(stderr, "slower: %s run_time %.3e -> %.3e (x%.2f)\n",
+              r->name, t_old, t_new, t_new / t_old);
+    }
+  }
+  if (!nboth) {
+    fprintf(stderr, "No problem in common with the baseline\n");
+    return 0;
+  }
+
+  sgm_new = exp(log_new / nboth) - shift;
+  sgm_old = exp(log_old / nboth) - shift;
+  fprintf(stderr, "%i problems in common with the baseline, %i newly solved\n",
+          (int)nboth, (int)nfixed);
+  fprintf(stderr, "shifted geometric mean of the run time (shift %g s): "
+          "baseline %.4e s, run %.4e s, speedup %.3f\n",
+          shift, sgm_old, sgm_new, sgm_old / sgm_new);
+  if (sgm_new > tol * sgm_old) {
+    fprintf(stderr, "regression: shifted geometric mean slower than x%.2f\n", tol);
+    nreg++;
+  }
+
+  return nreg;
+}
+
+
+int main(int argc, char **argv) {
+  c_int         a, k, j, reps = 1, nsolved = 0, nacc = 0, nref = 0, nreg = 0, failed = 0;
+  double        shift = 1e-02, fail_time = -1., acc_tol = 1e-03, tol = 1.2;
+  const char   *dir = OSQP_NULL, *pattern = OSQP_NULL, *out_file = OSQP_NULL;
+  const char   *base_file = OSQP_NULL, *ref_file = OSQP_NULL;
+  char          path[TS_PATH_LEN], *eq, *name;
+  FILE         *out = stdout;
+  OSQPSettings  settings;
+  TsArray       files = { OSQP_NULL, 0, 0 }, refs = { OSQP_NULL, 0, 0 };
+  TsArray       res = { OSQP_NULL, 0, 0 }, base = { OSQP_NULL, 0, 0 };
+  TsResult     *r;
+
+  osqp_set_default_settings(&settings);
+  settings.verbose    = 0;
+  settings.var_bounds = 1; // QPS files give the bounds of the variables
+
+  // Parse the options
+  for (a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-h")) {
+      print_usage();
+      return 0;
+    }
+    if (argv[a][0] != '-') {
+      dir = argv[a];
+      continue;
+    }
+    if (a + 1 >= argc) {
+      print_usage();
+      return 2;
+    }
+    switch (argv[a][1]) {
+    case 'f': pattern = argv[++a]; break;
+    case 'r': reps = atoi(argv[++a]); reps = c_max(reps, 1); break;
+    case 'R': ref_file = argv[++a]; break;
+    case 'A': acc_tol = atof(argv[++a]); break;
+    case 'o': out_file = argv[++a]; break;
+    case 'b': base_file = argv[++a]; break;
+    case 'g': shift = atof(argv[++a]); break;
+    case 'F': fail_time = atof(argv[++a]); break;
+    case 't': tol = atof(argv[++a]); break;
+    case 'p':
+      if (read_settings(argv[++a], &settings)) {
+        fprintf(stderr, "Cannot read the settings %s\n", argv[a]);
+        return 2;
+      }
+      break;
+    case 's':
+      eq = strchr(argv[++a], '=');
+      if (eq) *eq = '\0';
+      if (!eq || ((k = setting_index(argv[a])) < 0) ||
+          set_setting(&settings, k, eq + 1)) {
+        fprintf(stderr, "Invalid setting %s\n", argv[a]);
+        return 2;
+      }
+      break;
+    case 'O':
+      a++;
+      if (!strcmp(argv[a], "amd")) settings.ordering = AMD_ORDERING;
+      else if (!strcmp(argv[a], "rcm")) settings.ordering = RCM_ORDERING;
+      else if (!strcmp(argv[a], "nd")) settings.ordering = ND_ORDERING;
+      else {
+        print_usage();
+        return 2;
+      }
+      break;
+    default:
+      print_usage();
+      return 2;
+    }
+  }
+  if (!dir) {
+    print_usage();
+    return 2;
+  }
+  if (fail_time < 0.) fail_time = (settings.time_limit > 0.) ? settings.time_limit : 10.;
+
+  if (list_files(dir, &files)) {
+    fprintf(stderr, "Cannot read the directory %s\n", dir);
+    failed = 1;
+    goto cleanup;
+  }
+  if (ref_file && read_references(ref_file, &refs)) {
+    fprintf(stderr, "Cannot read the reference objectives %s\n", ref_file);
+    failed = 1;
+    goto cleanup;
+  }
+  if (base_file && read_results(base_file, &base)) {
+    fprintf(stderr, "Cannot read the baseline %s\n", base_file);
+    failed = 1;
+    goto cleanup;
+  }
+  if (out_file) {
+    out = fopen(out_file, "w");
+    if (!out) {
+      fprintf(stderr, "Cannot open %s\n", out_file);
+      failed = 1;
+      goto cleanup;
+    }
+  }
+
+  fputs(ts_header, out);
+  for (k = 0; k < files.len; k++) {
+    name = ((char **)files.v)[k];
+    if (pattern && !strstr(name, pattern)) continue;
+
+    r = (TsResult *)array_push(&res, sizeof(TsResult));
+    if (!r) {
+      failed = 1;
+      break;
+    }
+    memset(r, 0, sizeof(TsResult));
+    strncpy(r->name, name, TS_NAME_LEN - 1);
+    if ((eq = strrchr(r->name, '.'))) *eq = '\0';
+    snprintf(path, TS_PATH_LEN, "%s/%s", dir, name);
+
+    // A problem that cannot be read is written as unsolved
+    if (run_problem(path, reps, &settings, r)) {
+      fprintf(stderr, "%s: cannot read the problem\n", name);
+    }
+
+    // Relative error of the objective
+    r->obj_ref = NAN;
+    for (j = 0; j < refs.len; j++) {
+      if (name_equal(((TsReference *)refs.v)[j].name, r->name)) {
+        r->obj_ref = ((TsReference *)refs.v)[j].obj;
+        r->obj_err = fabs(r->obj_val - r->obj_ref) / c_max(fabs(r->obj_ref), 1.);
+        nref++;
+        break;
+      }
+    }
+    if (r->status == OSQP_SOLVED) nsolved++;
+    if (is_solved(r, acc_tol) && (r->obj_ref == r->obj_ref)) nacc++;
+
+    fprintf(stderr, "%-12s n %7ld  m %7ld  status %3ld  iter %6ld  obj_err %.1e  run %.3e s\n",
+            r->name, r->n, r->m, r->status, r->iter, r->obj_err, r->run_time);
+    write_result(out, r);
+    fflush(out);
+  }
+
+  fprintf(stderr, "%i problems, %i solved, %i of %i with a reference objective accurate to %g\n",
+          (int)res.len, (int)nsolved, (int)nacc, (int)nref, acc_tol);
+  if (base_file) {
+    nreg = compare_results(&res, &base, shift, fail_time, acc_tol, tol);
+    fprintf(stderr, "%i regressions with respect to %s\n", (int)nreg, base_file);
+  }
+  if (out_file) fclose(out);
+
+cleanup:
+  for (k = 0; k < files.len; k++) c_free(((char **)files.v)[k]);
+  if (files.v) c_free(files.v);
+  if (refs.v) c_free(refs.v);
+  if (res.v) c_free(res.v);
+  if (base.v) c_free(base.v);
+
+  return (failed || nreg) ? 1 : 0;
+}
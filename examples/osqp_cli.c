@@ -0,0 +1,702 @@
+/*
+ * OSQP command-line solver
+ *
+ * Reads a problem from a QPS file or a binary problem file written by
+ * osqp_write_problem, sets it up with the settings given as options and
+ * solves it a number of times, optionally perturbing the linear cost and the
+ * bounds between the solves. The problem, the settings, the setup and every
+ * solve are written as JSON, with the time and calls of the solver phases if
+ * OSQP is compiled with PROFILING.
+ *
+ * The settings stored in a binary problem file are the starting point and
+ * the options override them. The solver output is off unless verbose is set,
+ * in which case the JSON should be written to a file with --output.
+ */
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "osqp.h"
+
+
+/// Types of the settings given as options
+typedef enum {
+  CLI_INT, CLI_FLOAT, CLI_SOLVER, CLI_ORDERING, CLI_STRING, CLI_ARRAY
+} CliType;
+
+/// Setting given as an option --<name> <value>
+typedef struct {
+  const char *name;
+  CliType     type;
+  size_t      offset; ///< offset of the field in OSQPSettings
+  const char *help;
+} CliSetting;
+
+static const CliSetting cli_settings[] = {
+  { "rho",                    CLI_FLOAT,    offsetof(OSQPSettings, rho),                    "ADMM step rho" },
+  { "sigma",                  CLI_FLOAT,    offsetof(OSQPSettings, sigma),                  "ADMM step sigma" },
+  { "scaling",                CLI_INT,      offsetof(OSQPSettings, scaling),                "scaling iterations, 0 to disable" },
+  { "adaptive_rho",           CLI_INT,      offsetof(OSQPSettings, adaptive_rho),           "adapt rho (0 or 1)" },
+  { "adaptive_rho_interval",  CLI_INT,      offsetof(OSQPSettings, adaptive_rho_interval),  "iterations between rho adaptations, 0 for automatic" },
+  { "adaptive_rho_tolerance", CLI_FLOAT,    offsetof(OSQPSettings, adaptive_rho_tolerance), "ratio of rho changes triggering a factorization" },
+#ifdef PROFILING
+  { "adaptive_rho_fraction",  CLI_FLOAT,    offsetof(OSQPSettings, adaptive_rho_fraction),  "automatic rho interval as a fraction of the setup time" },
+#endif /* ifdef PROFILING */
+  { "max_iter",               CLI_INT,      offsetof(OSQPSettings, max_iter),               "maximum number of iterations" },
+  { "eps_abs",                CLI_FLOAT,    offsetof(OSQPSettings, eps_abs),                "absolute tolerance" },
+  { "eps_rel",                CLI_FLOAT,    offsetof(OSQPSettings, eps_rel),                "relative tolerance" },
+  { "eps_prim_inf",           CLI_FLOAT,    offsetof(OSQPSettings, eps_prim_inf),           "primal infeasibility tolerance" },
+  { "eps_dual_inf",           CLI_FLOAT,    offsetof(OSQPSettings, eps_dual_inf),           "dual infeasibility tolerance" },
+  { "alpha",                  CLI_FLOAT,    offsetof(OSQPSettings, alpha),                  "relaxation parameter" },
+  { "linsys_solver",          CLI_SOLVER,   offsetof(OSQPSettings, linsys_solver),          "qdldl, mkl_pardiso, plugin or normal" },
+  { "linsys_solver_lib",      CLI_STRING,   offsetof(OSQPSettings, linsys_solver_lib),      "shared library of the linear system solver" },
+  { "stages",                 CLI_ARRAY,    offsetof(OSQPSettings, stages),                 "file with the n + m stages of a multi-stage problem" },
+  { "ordering",               CLI_ORDERING, offsetof(OSQPSettings, ordering),               "amd, rcm, nd or user" },
+  { "perm",                   CLI_ARRAY,    offsetof(OSQPSettings, perm),                   "file with the n + m indices of the user ordering" },
+  { "delta",                  CLI_FLOAT,    offsetof(OSQPSettings, delta),                  "regularization of polishing" },
+  { "polish",                 CLI_INT,      offsetof(OSQPSettings, polish),                 "polish the solution (0 or 1)" },
+  { "polish_refine_iter",     CLI_INT,      offsetof(OSQPSettings, polish_refine_iter),     "iterative refinement steps of polishing" },
+  { "warm_start_cache",       CLI_INT,      offsetof(OSQPSettings, warm_start_cache),       "number of cached solutions, 0 to disable" },
+  { "presolve",               CLI_INT,      offsetof(OSQPSettings, presolve),               "presolve the problem (0 or 1)" },
+  { "var_bounds",             CLI_INT,      offsetof(OSQPSettings, var_bounds),             "use the variable bounds of the problem (0 or 1)" },
+  { "trace_interval",         CLI_INT,      offsetof(OSQPSettings, trace_interval),         "iterations between trace records, 0 to disable" },
+  { "trace_buffer",           CLI_INT,      offsetof(OSQPSettings, trace_buffer),           "trace records kept for --trace_dump" },
+  { "verbose",                CLI_INT,      offsetof(OSQPSettings, verbose),                "print the solver output (0 or 1)" },
+  { "scaled_termination",     CLI_INT,      offsetof(OSQPSettings, scaled_termination),     "scaled termination criteria (0 or 1)" },
+  { "check_termination",      CLI_INT,      offsetof(OSQPSettings, check_termination),      "iterations between termination checks" },
+  { "warm_start",             CLI_INT,      offsetof(OSQPSettings, warm_start),             "warm start from the previous solution (0 or 1)" },
+#ifdef PROFILING
+  { "time_limit",             CLI_FLOAT,    offsetof(OSQPSettings, time_limit),             "time limit in seconds, 0 to disable" },
+#endif /* ifdef PROFILING */
+};
+
+#define CLI_NSETTINGS ((c_int)(sizeof(cli_settings) / sizeof(cli_settings[0])))
+
+/// Names of the linear system solvers, indexed by enum linsys_solver_type
+static const char *cli_solver_name[] = {
+  "qdldl", "mkl_pardiso", "plugin", "normal"
+};
+
+/// Names of the orderings, indexed by enum ordering_type
+static const char *cli_ordering_name[] = {
+  "amd", "rcm", "nd", "user"
+};
+
+/// Result of a solve
+typedef struct {
+  c_int   iter, status_val, status_polish, rho_updates;
+  char    status[32];
+  c_float obj_val, pri_res, dua_res, rho_estimate;
+#ifdef PROFILING
+  c_float solve_time, polish_time, update_time, run_time;
+  OSQPProfile profile;
+#endif /* ifdef PROFILING */
+} CliSolve;
+
+
+static void print_usage(void) {
+  c_int k;
+
+  printf("Usage: osqp_cli [options] <problem file>\n"
+         "The problem file is a QPS file or a binary problem file.\n"
+         "  --repeat <n>            number of solves (default: 1)\n"
+         "  --perturb_q <eps>       relative perturbation of q between the solves\n"
+         "  --perturb_bounds <eps>  relative shift of the bounds between the solves\n"
+         "  --seed <seed>           seed of the perturbations (default: 1)\n"
+         "  --output <file>         write the JSON to file (default: stdout)\n"
+         "  --save <file>           write the problem and settings to a binary problem file\n"
+         "  --trace_dump <file>     write the trace records to file after the solves\n"
+         "Settings:\n");
+  for (k = 0; k < CLI_NSETTINGS; k++) {
+    printf("  --%-24s %s\n", cli_settings[k].name, cli_settings[k].help);
+  }
+}
+
+static c_int cli_setting_index(const char *name) {
+  c_int k;
+
+  for (k = 0; k < CLI_NSETTINGS; k++) {
+    if (!strcmp(cli_settings[k].name, name)) return k;
+  }
+  return -1;
+}
+
+static c_int cli_name_index(const char *value, const char **names, c_int len) {
+  c_int k;
+
+  for (k = 0; k < len; k++) {
+    if (!strcmp(names[k], value)) return k;
+  }
+  return -1;
+}
+
+/**
+ * Read a list of len integers from a file
+ * @return List allocated with c_malloc, OSQP_NULL if the file could not be read
+ */
+static c_int* read_list(const char *file, c_int len) {
+  c_int  k;
+  long   v;
+  c_int *list;
+  FILE  *f;
+
+  f = fopen(file, "r");
+  if (!f) return OSQP_NULL;
+
+  list = (c_int *)c_malloc(len * sizeof(c_int));
+  for (k = 0; list && (k < len); k++) {
+    if (fscanf(f, "%ld", &v) != 1) break;
+    list[k] = (c_int)v;
+  }
+  fclose(f);
+
+  if (list && (k < len)) {
+    c_free(list);
+    return OSQP_NULL;
+  }
+  return list;
+}
+
+/**
+ * Set a setting from the value of its option
+ * @return Exitflag (nonzero if the value is not valid)
+ */
+static c_int apply_setting(OSQPSettings     *settings,
+                           const CliSetting *s,
+                           const char       *value,
+                           c_int             len,
+                           c_int           **list) {
+  char  *field = (char *)settings + s->offset;
+  char  *end;
+  long   ival;
+  double fval;
+  c_int  k;
+
+  switch (s->type) {
+  case CLI_INT:
+    ival = strtol(value, &end, 10);
+    if ((end == value) || *end) return 1;
+    *(c_int *)field = (c_int)ival;
+    break;
+
+  case CLI_FLOAT:
+    fval = strtod(value, &end);
+    if ((end == value) || *end) return 1;
+    *(c_float *)field = (c_float)fval;
+    break;
+
+  case CLI_SOLVER:
+    k = cli_name_index(value, cli_solver_name, 4);
+    if (k < 0) return 1;
+    *(enum linsys_solver_type *)field = (enum linsys_solver_type)k;
+    break;
+
+  case CLI_ORDERING:
+    k = cli_name_index(value, cli_ordering_name, 4);
+    if (k < 0) return 1;
+    *(enum ordering_type *)field = (enum ordering_type)k;
+    break;
+
+  case CLI_STRING:
+    *(const char **)field = value;
+    break;
+
+  case CLI_ARRAY:
+    if (*list) c_free(*list);
+    *list = read_list(value, len);
+    if (!*list) return 1;
+    *(const c_int **)field = *list;
+    break;
+  }
+
+  return 0;
+}
+
+/// Check if a file starts with the magic of the binary problem files
+static c_int is_problem_file(const char *file) {
+  char  magic[8];
+  FILE *f = fopen(file, "rb");
+  c_int ok;
+
+  if (!f) return 0;
+  ok = (fread(magic, 1, 8, f) == 8) && !memcmp(magic, "OSQPPRB1", 8);
+  fclose(f);
+
+  return ok;
+}
+
+
+/*********************************
+*  Perturbations                *
+*********************************/
+
+/// xorshift64* generator
+typedef struct {
+  unsigned long long s;
+} CliRng;
+
+static void rng_seed(CliRng *r, unsigned long seed) {
+  r->s = 0x9E3779B97F4A7C15ULL ^ ((unsigned long long)seed * 2654435761ULL);
+  if (!r->s) r->s = 1;
+}
+
+// Uniform in (-1, 1)
+static c_float rng_symmetric(CliRng *r) {
+  r->s ^= r->s >> 12;
+  r->s ^= r->s << 25;
+  r->s ^= r->s >> 27;
+  return (c_float)(2. * ((((r->s * 2685821657736338717ULL) >> 11) + 0.5) /
+                         9007199254740992.0) - 1.);
+}
+
+// Perturb each element of v by eps max(|v_i|, 1) relative to v0
+static void perturb_vector(c_float *v, const c_float *v0, c_int len,
+                           c_float eps, CliRng *r) {
+  c_int i;
+
+  for (i = 0; i < len; i++) {
+    v[i] = v0[i] + eps * c_max(c_absval(v0[i]), 1.) * rng_symmetric(r);
+  }
+}
+
+// Shift both bounds of each constraint by the same amount, so that l <= u and
+// the equality constraints are kept
+static void perturb_bounds(c_float *l, c_float *u, const c_float *l0,
+                           const c_float *u0, c_int len, c_float eps,
+                           CliRng *r) {
+  c_int   i;
+  c_float scale, shift;
+
+  for (i = 0; i < len; i++) {
+    l[i] = l0[i];
+    u[i] = u0[i];
+    if ((l0[i] <= -OSQP_INFTY) && (u0[i] >= OSQP_INFTY)) continue;
+    if (l0[i] <= -OSQP_INFTY) scale = c_absval(u0[i]);
+    else if (u0[i] >= OSQP_INFTY) scale = c_absval(l0[i]);
+    else scale = c_max(c_absval(l0[i]), c_absval(u0[i]));
+    shift = eps * c_max(scale, 1.) * rng_symmetric(r);
+    if (l0[i] > -OSQP_INFTY) l[i] += shift;
+    if (u0[i] < OSQP_INFTY) u[i] += shift;
+  }
+}
+
+
+/*********************************
+*  JSON                         *
+*********************************/
+
+static void json_string(FILE *f, const char *s) {
+  if (!s) {
+    fputs("null", f);
+    return;
+  }
+  fputc('"', f);
+  for (; *s; s++) {
+    if ((*s == '"') || (*s == '\\')) fprintf(f, "\\%c", *s);
+    else if ((unsigned char)*s < 0x20) fprintf(f, "\\u%04x", (unsigned char)*s);
+    else fputc(*s, f);
+  }
+  fputc('"', f);
+}
+
+// Infinite and NaN values are written as null
+static void json_float(FILE *f, c_float x) {
+  if (x - x == 0) fprintf(f, "%.17g", (double)x);
+  else fputs("null", f);
+}
+
+// Key with the spaces of the name replaced by underscores
+static void json_key(FILE *f, const char *name) {
+  fputc('"', f);
+  for (; *name; name++) fputc((*name == ' ') ? '_' : *name, f);
+  fputs("\": ", f);
+}
+
+static void json_factor_stats(FILE *f, const OSQPFactorStats *s) {
+  fprintf(f, "{\"dim\": %ld, \"nnz_KKT\": %ld, \"nnz_L\": %ld, \"fill\": ",
+          (long)s->dim, (long)s->nnz_KKT, (long)s->nnz_L);
+  json_float(f, s->fill);
+  fputs(", \"flops\": ", f);
+  json_float(f, s->flops);
+  fprintf(f, ", \"etree_height\": %ld}", (long)s->etree_height);
+}
+
+#ifdef PROFILING
+static void json_profile(FILE *f, const OSQPProfile *profile) {
+  c_int k;
+
+  fputc('{', f);
+  for (k = 0; k < PROFILE_NPHASES; k++) {
+    if (k) fputs(", ", f);
+    json_key(f, PROFILE_PHASE_NAME[k]);
+    fputs("{\"time\": ", f);
+    json_float(f, profile->time[k]);
+    fprintf(f, ", \"calls\": %ld}", (long)profile->calls[k]);
+  }
+  fputc('}', f);
+}
+
+static int compare_float(const void *a, const void *b) {
+  c_float x = *(const c_float *)a, y = *(const c_float *)b;
+
+  return (x > y) - (x < y);
+}
+
+// Minimum, median, mean and maximum of the times, sorted in place
+static void json_time_stats(FILE *f, c_float *t, c_int len) {
+  c_int   k;
+  c_float sum = 0.;
+
+  qsort(t, (size_t)len, sizeof(c_float), compare_float);
+  for (k = 0; k < len; k++) sum += t[k];
+  fputs("{\"min\": ", f);
+  json_float(f, t[0]);
+  fputs(", \"median\": ", f);
+  json_float(f, (len % 2) ? t[len / 2] : 0.5 * (t[len / 2 - 1] + t[len / 2]));
+  fputs(", \"mean\": ", f);
+  json_float(f, sum / len);
+  fputs(", \"max\": ", f);
+  json_float(f, t[len - 1]);
+  fputc('}', f);
+}
+#endif /* ifdef PROFILING */
+
+static void json_settings(FILE *f, const OSQPSettings *settings) {
+  c_int       k;
+  const char *field;
+
+  fputc('{', f);
+  for (k = 0; k < CLI_NSETTINGS; k++) {
+    field = (const char *)settings + cli_settings[k].offset;
+    fprintf(f, "%s\"%s\": ", k ? ", " : "", cli_settings[k].name);
+    switch (cli_settings[k].type) {
+    case CLI_INT:
+      fprintf(f, "%ld", (long)*(const c_int *)field);
+      break;
+
+    case CLI_FLOAT:
+      json_float(f, *(const c_float *)field);
+      break;
+
+    case CLI_SOLVER:
+      json_string(f, cli_solver_name[*(const enum linsys_solver_type *)field]);
+      break;
+
+    case CLI_ORDERING:
+      json_string(f, cli_ordering_name[*(const enum ordering_type *)field]);
+      break;
+
+    case CLI_STRING:
+      json_string(f, *(const char *const *)field);
+      break;
+
+    case CLI_ARRAY:
+      fputs(*(const c_int *const *)field ? "true" : "false", f);
+      break;
+    }
+  }
+  fputc('}', f);
+}
+
+static void json_solve(FILE *f, const CliSolve *s) {
+  fprintf(f, "{\"status\": ");
+  json_string(f, s->status);
+  fprintf(f, ", \"status_val\": %ld, \"status_polish\": %ld, \"iter\": %ld, "
+          "\"rho_updates\": %ld, \"obj_val\": ",
+          (long)s->status_val, (long)s->status_polish, (long)s->iter,
+          (long)s->rho_updates);
+  json_float(f, s->obj_val);
+  fputs(", \"pri_res\": ", f);
+  json_float(f, s->pri_res);
+  fputs(", \"dua_res\": ", f);
+  json_float(f, s->dua_res);
+  fputs(", \"rho_estimate\": ", f);
+  json_float(f, s->rho_estimate);
+#ifdef PROFILING
+  fputs(", \"update_time\": ", f);
+  json_float(f, s->update_time);
+  fputs(", \"solve_time\": ", f);
+  json_float(f, s->solve_time);
+  fputs(", \"polish_time\": ", f);
+  json_float(f, s->polish_time);
+  fputs(", \"run_time\": ", f);
+  json_float(f, s->run_time);
+  fputs(", \"phases\": ", f);
+  json_profile(f, &s->profile);
+#endif /* ifdef PROFILING */
+  fputc('}', f);
+}
+
+
+int main(int argc, char **argv) {
+  c_int a, k, r, reps = 1, nsolved = 0, iter_min = 0, iter_max = 0, exitflag = 0;
+  c_float         perturb_q = 0., perturb_b = 0., iter_sum = 0.;
+  unsigned long   seed = 1;
+  const char     *file = OSQP_NULL, *out_file = OSQP_NULL, *save_file = OSQP_NULL;
+  const char     *trace_file = OSQP_NULL;
+  const char     *values[sizeof(cli_settings) / sizeof(cli_settings[0])];
+  c_int          *lists[2] = { OSQP_NULL, OSQP_NULL };
+  c_int           binary, bounded;
+  OSQPData       *data;
+  OSQPSettings   *file_settings = OSQP_NULL;
+  OSQPObjective   objective;
+  OSQPSettings    settings;
+  OSQPWorkspace  *work;
+  OSQPFactorStats kkt_stats, polish_stats, unused;
+  CliSolve       *solves;
+  CliRng          rng;
+  c_float        *q = OSQP_NULL, *l = OSQP_NULL, *u = OSQP_NULL;
+  c_float        *lb = OSQP_NULL, *ub = OSQP_NULL, *lb0 = OSQP_NULL, *ub0 = OSQP_NULL;
+  FILE           *out = stdout;
+#ifdef PROFILING
+  c_float         setup_time;
+  c_float        *times;
+  OSQPProfile     setup_profile;
+#endif /* ifdef PROFILING */
+
+  for (k = 0; k < CLI_NSETTINGS; k++) values[k] = OSQP_NULL;
+
+  // Parse the options
+  for (a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-h") || !strcmp(argv[a], "--help")) {
+      print_usage();
+      return 0;
+    }
+    if (strncmp(argv[a], "--", 2)) {
+      if (file) {
+        print_usage();
+        return 2;
+      }
+      file = argv[a];
+      continue;
+    }
+    if (a + 1 >= argc) {
+      print_usage();
+      return 2;
+    }
+    if (!strcmp(argv[a], "--repeat")) {
+      reps = atoi(argv[++a]);
+      reps = c_max(reps, 1);
+    }
+    else if (!strcmp(argv[a], "--perturb_q")) perturb_q = atof(argv[++a]);
+    else if (!strcmp(argv[a], "--perturb_bounds")) perturb_b = atof(argv[++a]);
+    else if (!strcmp(argv[a], "--seed")) seed = strtoul(argv[++a], OSQP_NULL, 10);
+    else if (!strcmp(argv[a], "--output")) out_file = argv[++a];
+    else if (!strcmp(argv[a], "--save")) save_file = argv[++a];
+    else if (!strcmp(argv[a], "--trace_dump")) trace_file = argv[++a];
+    else if ((k = cli_setting_index(argv[a] + 2)) >= 0) values[k] = argv[++a];
+    else {
+      fprintf(stderr, "Unknown option %s\n", argv[a]);
+      return 2;
+    }
+  }
+  if (!file) {
+    print_usage();
+    return 2;
+  }
+
+  // Read the problem and its settings
+  binary = is_problem_file(file);
+  if (binary) exitflag = osqp_read_problem(file, &data, &file_settings, &objective);
+  else exitflag = osqp_read_qps(file, &data, &objective);
+  if (exitflag) {
+    fprintf(stderr, "Cannot read the problem file %s\n", file);
+    return 1;
+  }
+
+  // The variable bounds read from the problem file are used by default
+  if (file_settings) settings = *file_settings;
+  else {
+    osqp_set_default_settings(&settings);
+    settings.var_bounds = 1;
+  }
+  settings.verbose = 0;
+
+  for (k = 0; k < CLI_NSETTINGS; k++) {
+    if (!values[k]) continue;
+    if (apply_setting(&settings, &cli_settings[k], values[k], data->n + data->m,
+                      &lists[(cli_settings[k].offset == offsetof(OSQPSettings, perm))])) {
+      fprintf(stderr, "Invalid value %s of --%s\n", values[k], cli_settings[k].name);
+      exitflag = 1;
+      goto cleanup_data;
+    }
+  }
+
+  if (save_file && osqp_write_problem(save_file, data, &settings, &objective)) {
+    fprintf(stderr, "Cannot write the problem file %s\n", save_file);
+    exitflag = 1;
+    goto cleanup_data;
+  }
+
+  if (out_file) {
+    out = fopen(out_file, "w");
+    if (!out) {
+      fprintf(stderr, "Cannot open %s\n", out_file);
+      exitflag = 1;
+      goto cleanup_data;
+    }
+  }
+
+  solves = (CliSolve *)c_calloc(reps, sizeof(CliSolve));
+  q      = (c_float *)c_malloc(data->n * sizeof(c_float));
+  l      = (c_float *)c_malloc(c_max(data->m, 1) * sizeof(c_float));
+  u      = (c_float *)c_malloc(c_max(data->m, 1) * sizeof(c_float));
+  bounded = settings.var_bounds && (data->lb || data->ub);
+  if (bounded) {
+    lb  = (c_float *)c_malloc(data->n * sizeof(c_float));
+    ub  = (c_float *)c_malloc(data->n * sizeof(c_float));
+    lb0 = (c_float *)c_malloc(data->n * sizeof(c_float));
+    ub0 = (c_float *)c_malloc(data->n * sizeof(c_float));
+  }
+  if (!solves || !q || !l || !u ||
+      (bounded && (!lb || !ub || !lb0 || !ub0))) {
+    fprintf(stderr, "Out of memory\n");
+    exitflag = 1;
+    goto cleanup_vectors;
+  }
+
+  // Both bounds of the variables are updated together
+  for (k = 0; lb0 && (k < data->n); k++) {
+    lb0[k] = data->lb ? data->lb[k] : -OSQP_INFTY;
+    ub0[k] = data->ub ? data->ub[k] : OSQP_INFTY;
+  }
+
+  // Setup
+  if (osqp_setup(&work, data, &settings)) {
+    fprintf(stderr, "Setup of %s failed\n", file);
+    exitflag = 1;
+    goto cleanup_vectors;
+  }
+  osqp_get_factor_stats(work, &kkt_stats, &unused);
+#ifdef PROFILING
+  setup_time = work->info->setup_time;
+  osqp_get_profile(work, &setup_profile);
+#endif /* ifdef PROFILING */
+
+  // Solves
+  rng_seed(&rng, seed);
+  for (r = 0; r < reps; r++) {
+    CliSolve *s = &solves[r];
+
+    if (r && (perturb_q > 0.)) {
+      perturb_vector(q, data->q, data->n, perturb_q, &rng);
+      exitflag = osqp_update_lin_cost(work, q);
+    }
+    if (!exitflag && r && (perturb_b > 0.)) {
+      perturb_bounds(l, u, data->l, data->u, data->m, perturb_b, &rng);
+      exitflag = osqp_update_bounds(work, l, u);
+      if (!exitflag && lb0) {
+        perturb_bounds(lb, ub, lb0, ub0, data->n, perturb_b, &rng);
+        exitflag = osqp_update_var_bounds(work, lb, ub);
+      }
+    }
+    if (exitflag) {
+      fprintf(stderr, "Update of solve %i failed\n", (int)r);
+      break;
+    }
+
+#ifdef PROFILING
+    osqp_reset_profile(work);
+#endif /* ifdef PROFILING */
+    osqp_solve(work);
+
+    s->iter          = work->info->iter;
+    s->status_val    = work->info->status_val;
+    s->status_polish = work->info->status_polish;
+    s->rho_updates   = work->info->rho_updates;
+    s->obj_val       = (objective.maximize ? -work->info->obj_val :
+                        work->info->obj_val) + objective.constant; // objective of the file
+    s->pri_res       = work->info->pri_res;
+    s->dua_res       = work->info->dua_res;
+    s->rho_estimate  = work->info->rho_estimate;
+    snprintf(s->status, sizeof(s->status), "%s", work->info->status);
+#ifdef PROFILING
+    s->update_time = work->info->update_time;
+    s->solve_time  = work->info->solve_time;
+    s->polish_time = work->info->polish_time;
+    s->run_time    = work->info->run_time;
+    osqp_get_profile(work, &s->profile);
+#endif /* ifdef PROFILING */
+
+    if (s->status_val == OSQP_SOLVED) nsolved++;
+    iter_min  = r ? c_min(iter_min, s->iter) : s->iter;
+    iter_max  = r ? c_max(iter_max, s->iter) : s->iter;
+    iter_sum += s->iter;
+  }
+  reps = r;
+  osqp_get_factor_stats(work, &unused, &polish_stats);
+
+  if (trace_file && osqp_dump_trace(work, trace_file)) {
+    fprintf(stderr, "Cannot write the trace to %s\n", trace_file);
+    exitflag = 1;
+  }
+
+  // Write the results
+  fputs("{\n  \"problem\": {\"file\": ", out);
+  json_string(out, file);
+  fprintf(out, ", \"format\": \"%s\", \"n\": %ld, \"m\": %ld, \"nnz_P\": %ld, "
+          "\"nnz_A\": %ld, \"var_bounds\": %s},\n",
+          binary ? "binary" : "qps", (long)data->n, (long)data->m,
+          (long)data->P->p[data->n], (long)data->A->p[data->n],
+          (data->lb || data->ub) ? "true" : "false");
+  fputs("  \"settings\": ", out);
+  json_settings(out, &settings);
+  fputs(",\n  \"setup\": {", out);
+#ifdef PROFILING
+  fputs("\"setup_time\": ", out);
+  json_float(out, setup_time);
+  fputs(", \"phases\": ", out);
+  json_profile(out, &setup_profile);
+  fputs(", ", out);
+#endif /* ifdef PROFILING */
+  fputs("\"factor\": ", out);
+  json_factor_stats(out, &kkt_stats);
+  fputs("},\n  \"solves\": [", out);
+  for (r = 0; r < reps; r++) {
+    fputs(r ? ",\n    " : "\n    ", out);
+    json_solve(out, &solves[r]);
+  }
+  fprintf(out, "%s],\n  \"summary\": {\"solves\": %ld, \"solved\": %ld",
+          reps ? "\n  " : "", (long)reps, (long)nsolved);
+  if (reps) {
+    fprintf(out, ", \"iter\": {\"min\": %ld, \"mean\": ", (long)iter_min);
+    json_float(out, iter_sum / reps);
+    fprintf(out, ", \"max\": %ld}", (long)iter_max);
+#ifdef PROFILING
+    times = (c_float *)c_malloc(reps * sizeof(c_float));
+    if (times) {
+      for (r = 0; r < reps; r++) times[r] = solves[r].solve_time;
+      fputs(", \"solve_time\": ", out);
+      json_time_stats(out, times, reps);
+      for (r = 0; r < reps; r++) times[r] = solves[r].run_time;
+      fputs(", \"run_time\": ", out);
+      json_time_stats(out, times, reps);
+      c_free(times);
+    }
+#endif /* ifdef PROFILING */
+  }
+  fputs(", \"polish_factor\": ", out);
+  json_factor_stats(out, &polish_stats);
+  fputs("}\n}\n", out);
+
+  osqp_cleanup(work);
+
+cleanup_vectors:
+  if (out_file && out) fclose(out);
+  if (solves) c_free(solves);
+  if (q) c_free(q);
+  if (l) c_free(l);
+  if (u) c_free(u);
+  if (lb) c_free(lb);
+  if (ub) c_free(ub);
+  if (lb0) c_free(lb0);
+  if (ub0) c_free(ub0);
+
+cleanup_data:
+  if (lists[0]) c_free(lists[0]);
+  if (lists[1]) c_free(lists[1]);
+  osqp_free_problem(data, file_settings);
+
+  return (int)exitflag;
+}
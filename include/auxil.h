@@ -164,6 +164,16 @@ c_int check_termination(OSQPWorkspace *work,
 c_int validate_data(const OSQPData *data);
 
 
+/**
+ * Shallow copy of the problem data without the variable bounds, which are
+ * only read with the var_bounds setting
+ * @param  data    Problem data
+ * @param  data_nb Copy of data with lb and ub set to OSQP_NULL
+ */
+void copy_data_without_var_bounds(const OSQPData *data,
+                                  OSQPData       *data_nb);
+
+
 /**
  * Validate problem settings
  * @param  settings OSQPSettings to be validated
@@ -172,6 +182,26 @@ c_int validate_data(const OSQPData *data);
 c_int validate_settings(const OSQPSettings *settings);
 
 
+/**
+ * Validate the stages of the variables and constraints
+ * @param  data   OSQPData of the problem
+ * @param  stages Stage of each variable and constraint (size n + m)
+ * @return        Exitflag to check
+ */
+c_int validate_stages(const OSQPData *data,
+                      const c_int    *stages);
+
+
+/**
+ * Validate the user ordering of the variables and constraints
+ * @param  data   OSQPData of the problem
+ * @param  perm   Permutation of the variables and constraints (size n + m)
+ * @return        Exitflag to check
+ */
+c_int validate_perm(const OSQPData *data,
+                    const c_int    *perm);
+
+
 # endif // #ifndef EMBEDDED
 
 # ifdef __cplusplus
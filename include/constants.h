@@ -33,10 +33,37 @@ extern "C" {
 /*************************
 * Linear System Solvers *
 *************************/
-enum linsys_solver_type { QDLDL_SOLVER, MKL_PARDISO_SOLVER };
+enum linsys_solver_type { QDLDL_SOLVER, MKL_PARDISO_SOLVER, PLUGIN_SOLVER, NORMAL_SOLVER };
 extern const char * LINSYS_SOLVER_NAME[];
 
 
+/******************
+* KKT orderings  *
+******************/
+enum ordering_type { AMD_ORDERING, RCM_ORDERING, ND_ORDERING, USER_ORDERING };
+extern const char * ORDERING_NAME[];
+
+
+/******************
+* Profile phases *
+******************/
+enum profile_phase {
+  PROFILE_SCALING,        ///< data scaling
+  PROFILE_KKT_FORM,       ///< KKT matrix assembly in the linear system solver
+  PROFILE_ORDERING,       ///< ordering and permutation of the KKT matrix
+  PROFILE_FACTOR,         ///< numeric factorization at setup and matrix updates
+  PROFILE_LINSYS_SOLVE,   ///< linear system solve (triangular solves), timed only with PROFILE_ITERATIONS
+  PROFILE_PROJECTION,     ///< projection onto the constraints, timed only with PROFILE_ITERATIONS
+  PROFILE_RESIDUALS,      ///< residuals and objective for the termination check
+  PROFILE_INFEASIBILITY,  ///< primal and dual infeasibility checks
+  PROFILE_RHO_UPDATE,     ///< rho estimate and refactorization
+  PROFILE_POLISH_FACTOR,  ///< factorization of the reduced KKT matrix in polish
+  PROFILE_POLISH_REFINE,  ///< iterative refinement in polish
+  PROFILE_NPHASES
+};
+extern const char * PROFILE_PHASE_NAME[];
+
+
 /******************
 * Solver Errors  *
 ******************/
@@ -76,7 +103,18 @@ extern const char * OSQP_ERROR_MESSAGE[];
 #  define DELTA (1E-6)
 #  define POLISH (0)
 #  define POLISH_REFINE_ITER (3)
+#  define POLISH_MAX_UPDATE_RANK (16) ///< maximum number of active set changes applied to the cached polish factorization
 #  define VERBOSE (1)
+#  define WARM_START_CACHE (0)
+#  define WARM_START_CACHE_DIM (16)        ///< dimension of the fingerprint of (q, l, u) in the warm start cache (at most 32)
+#  define PRESOLVE (0)
+#  define VAR_BOUNDS (0)
+#  define TRACE_INTERVAL (0)
+#  define TRACE_BUFFER (0)
+#  define BSR_MAX_BLOCK_SIZE (8) ///< maximum block size of the block compressed-row copy of A
+#  define BSR_MAX_FILL (1.5)     ///< maximum ratio between the stored block elements and the nonzero elements of A
+#  define ORDERING (AMD_ORDERING)
+#  define ND_LEAF_SIZE (64)      ///< parts of the nested dissection ordering with at most this number of rows are ordered with AMD
 # endif // ifndef EMBEDDED
 
 # define SCALED_TERMINATION (0)
@@ -112,6 +150,8 @@ extern const char * OSQP_ERROR_MESSAGE[];
 
 # ifdef PROFILING
 #  define TIME_LIMIT (0)                        ///< Disable time limit as default
+#  define TIME_LIMIT_CHECK_MAX (64)             ///< maximum number of iterations between two checks of the time limit
+#  define TSC_CALIBRATION_TIME (1e-3)           ///< time over which the time stamp counter is calibrated (seconds)
 # endif // ifdef PROFILING
 
 /* Printing */
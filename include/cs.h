@@ -69,6 +69,48 @@ csc* csc_done(csc  *C,
               void *x,
               c_int ok);
 
+/*****************************************************************************
+* Block Compressed-Row Matrices                                             *
+*****************************************************************************/
+
+/**
+ * Block size for which the block compressed-row form of A pays off in the
+ * matrix-vector products. The blocks are aligned to multiples of the block
+ * size. A block size is used if the stored block elements are at most
+ * BSR_MAX_FILL times the nonzero elements of A and it stores fewer values and
+ * indices than the csc form.
+ * @param  A Matrix in CSC format
+ * @return   Block size, or 1 if no block size pays off
+ */
+c_int csc_block_size(const csc *A);
+
+/**
+ * Build the block compressed-row form of A with blocks of size bs
+ * (uses MALLOC)
+ * @param  A  Matrix in CSC format
+ * @param  bs Block size
+ * @return    Matrix in block compressed-row form, OSQP_NULL if memory
+ *            allocation failed
+ */
+bsr* csc_to_bsr(const csc *A,
+                c_int      bs);
+
+/**
+ * Copy the values of A to the block compressed-row matrix B built from A
+ * with csc_to_bsr. The sparsity pattern of A must not have changed.
+ * @param B Matrix in block compressed-row form
+ * @param A Matrix in CSC format
+ */
+void bsr_update_values(bsr       *B,
+                       const csc *A);
+
+/**
+ * Free block compressed-row matrix
+ * @param B Matrix in block compressed-row form
+ */
+void bsr_spfree(bsr *B);
+
+
 /*****************************************************************************
 * Copy Matrices                                                             *
 *****************************************************************************/
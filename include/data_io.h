@@ -0,0 +1,125 @@
+/* Problem files: QPS/MPS text files and binary dumps of the data and settings */
+#ifndef DATA_IO_H
+# define DATA_IO_H
+
+# ifdef __cplusplus
+extern "C" {
+# endif // ifdef __cplusplus
+
+
+# include "types.h"
+
+
+/**
+ * Objective of a problem file that is not held by OSQPData. The objective of
+ * the file at the solution is
+ * (maximize ? -info->obj_val : info->obj_val) + constant.
+ */
+typedef struct {
+  c_float constant; ///< constant term of the objective
+  c_int   maximize; ///< the objective is maximized: P and q of the data are negated
+} OSQPObjective;
+
+/**
+ * Read a quadratic program from a QPS file (free MPS format with a QUADOBJ,
+ * QMATRIX or QSECTION section for the quadratic cost).
+ *
+ * The constraint rows become the rows of A with their bounds l and u, the
+ * ranges included. Free rows other than the objective are kept as
+ * constraints with infinite bounds. The bounds of the variables are stored
+ * in lb and ub, which are OSQP_NULL if no variable is bounded. Values larger
+ * than OSQP_INFTY in magnitude are infinite. Integer markers are ignored.
+ * A maximization (OBJSENSE MAX) is changed into a minimization. The
+ * objective constant is minus the right-hand side of the objective row.
+ * Names cannot contain spaces.
+ *
+ * The data are freed with osqp_free_problem.
+ * @param  filename  Name of the file
+ * @param  data      Problem data (output)
+ * @param  objective Constant and sense of the objective (output, can be
+ *                   OSQP_NULL)
+ * @return           Exitflag (nonzero if the file could not be read)
+ */
+c_int osqp_read_qps(const char    *filename,
+                    OSQPData     **data,
+                    OSQPObjective *objective);
+
+/**
+ * Write a quadratic program to a QPS file in free MPS format.
+ *
+ * The variables are named C1, C2, ... and the constraints R1, R2, ... .
+ * Constraints with both bounds finite and different are written as ranges,
+ * chosen so that both bounds are read back exactly when a range close to
+ * u - l allows it; the others can differ in the last bit. Use
+ * osqp_write_problem for bit-identical copies. A maximized objective is
+ * written with OBJSENSE MAX and the signs of P and q of the file.
+ * @param  filename  Name of the file
+ * @param  data      Problem data
+ * @param  objective Constant and sense of the objective (can be OSQP_NULL)
+ * @return           Exitflag (nonzero if the file could not be written)
+ */
+c_int osqp_write_qps(const char          *filename,
+                     const OSQPData      *data,
+                     const OSQPObjective *objective);
+
+/**
+ * Write the problem data and settings to a binary file.
+ *
+ * The file starts with the 8 characters "OSQPPRB1", one byte with the size
+ * of c_int, one byte with the size of c_float, one byte with the byte order
+ * (1 if little endian) and one byte of flags (1: lb, 2: ub, 4: settings,
+ * 8: objective). Follow n, m and the number of nonzeros of P and A (c_int),
+ * the arrays p, i and x of P and A, q, l, u, lb and ub, and the constant
+ * (c_float) and sense (c_int) of the objective. The settings are written as
+ * their number (c_int) and, for each setting, its identifier and type
+ * (c_int) and its value (c_int or c_float), then the lengths and values of
+ * the stages, the user permutation and the name of the linear system solver
+ * library. The trace callback and its data are not written.
+ * @param  filename  Name of the file
+ * @param  data      Problem data
+ * @param  settings  Solver settings (can be OSQP_NULL)
+ * @param  objective Constant and sense of the objective (can be OSQP_NULL)
+ * @return           Exitflag (nonzero if the file could not be written)
+ */
+c_int osqp_write_problem(const char          *filename,
+                         const OSQPData      *data,
+                         const OSQPSettings  *settings,
+                         const OSQPObjective *objective);
+
+/**
+ * Read the problem data and settings written by osqp_write_problem.
+ *
+ * The file is mapped into memory where possible. Files written with other
+ * sizes of c_int and c_float are converted, otherwise the data are
+ * bit-identical to the ones written. Settings unknown to this version are
+ * skipped and the missing ones take their default value.
+ *
+ * The data and settings are freed with osqp_free_problem.
+ * @param  filename  Name of the file
+ * @param  data      Problem data (output)
+ * @param  settings  Solver settings (output, can be OSQP_NULL). OSQP_NULL if
+ *                   the file has no settings
+ * @param  objective Constant and sense of the objective (output, can be
+ *                   OSQP_NULL). Zero if the file has no objective
+ * @return           Exitflag (nonzero if the file could not be read)
+ */
+c_int osqp_read_problem(const char    *filename,
+                        OSQPData     **data,
+                        OSQPSettings **settings,
+                        OSQPObjective *objective);
+
+/**
+ * Free the problem data and settings read by osqp_read_qps or
+ * osqp_read_problem
+ * @param data     Problem data (can be OSQP_NULL)
+ * @param settings Solver settings (can be OSQP_NULL)
+ */
+void osqp_free_problem(OSQPData     *data,
+                       OSQPSettings *settings);
+
+
+# ifdef __cplusplus
+}
+# endif // ifdef __cplusplus
+
+#endif // ifndef DATA_IO_H
@@ -0,0 +1,45 @@
+/* Derivatives of the solution with respect to the problem data */
+#ifndef DERIVATIVE_H
+# define DERIVATIVE_H
+
+# ifdef __cplusplus
+extern "C" {
+# endif // ifdef __cplusplus
+
+
+# include "types.h"
+
+/**
+ * Compute vector-Jacobian products of the solution with respect to q, l and u
+ * by solving the adjoint of the KKT system of the active constraints.
+ * All the vectors are stored column-wise with nrhs columns.
+ * @param  work Workspace
+ * @param  nrhs Number of gradient vectors
+ * @param  dx   Gradients with respect to x (size n x nrhs)
+ * @param  dy   Gradients with respect to y (size m x nrhs, OSQP_NULL if zero)
+ * @param  dq   Output gradients with respect to q (size n x nrhs)
+ * @param  dl   Output gradients with respect to l (size m x nrhs, optional)
+ * @param  du   Output gradients with respect to u (size m x nrhs, optional)
+ * @return      Exitflag
+ */
+c_int adjoint_derivative(OSQPWorkspace *work,
+                         c_int          nrhs,
+                         const c_float *dx,
+                         const c_float *dy,
+                         c_float       *dq,
+                         c_float       *dl,
+                         c_float       *du);
+
+/**
+ * Free the factorization of the active constraints KKT matrix.
+ * It must be called whenever P, A or delta change.
+ * @param work Workspace
+ */
+void derivative_free_factorization(OSQPWorkspace *work);
+
+
+# ifdef __cplusplus
+}
+# endif // ifdef __cplusplus
+
+#endif // ifndef DERIVATIVE_H
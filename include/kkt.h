@@ -99,6 +99,25 @@ void update_KKT_param2(csc           *KKT,
                        const c_int   *param2toKKT,
                        const c_int    m);
 
+#  ifndef EMBEDDED
+
+/**
+ * Add a shift to the diagonal of the upper left block P + param1 I of the KKT
+ * matrix. The diagonal elements are always stored, also where P has none.
+ *
+ * @param KKT    KKT matrix in CSC or CSR form (upper-triangular)
+ * @param perm   Permutation of the KKT matrix: row k is row perm[k] of the
+ *               unpermuted matrix (OSQP_NULL if not permuted)
+ * @param n      Size of the upper left block
+ * @param shift  Value added to the diagonal elements of the block
+ */
+void update_KKT_param1(csc         *KKT,
+                       const c_int *perm,
+                       const c_int  n,
+                       c_float      shift);
+
+#  endif // ifndef EMBEDDED
+
 # endif // EMBEDDED != 1
 
 
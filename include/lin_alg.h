@@ -199,6 +199,74 @@ void mat_inf_norm_cols_sym_triu(const csc *M,
 
 # endif // EMBEDDED != 1
 
+# ifndef EMBEDDED
+
+/**
+ * Check if all elements of matrix A are stored in column-major order, i.e.
+ * A->x is the dense column-major matrix
+ * @param  A Input matrix
+ * @return   1 if A is stored densely, 0 otherwise
+ */
+c_int mat_is_dense(const csc *A);
+
+/**
+ * Check if all elements of the upper triangular part of the square matrix P
+ * are stored in column-major order
+ * @param  P Input matrix (upper triangular)
+ * @return   1 if P is stored densely, 0 otherwise
+ */
+c_int mat_is_dense_triu(const csc *P);
+
+/* Matrix-vector multiplication with a densely stored matrix (see mat_is_dense)
+ *    y  =  A*x  (if plus_eq == 0)
+ *    y +=  A*x  (if plus_eq == 1)
+ *    y -=  A*x  (if plus_eq == -1)
+ */
+void mat_vec_dense(const csc     *A,
+                   const c_float *x,
+                   c_float       *y,
+                   c_int          plus_eq);
+
+/* Matrix-transpose-vector multiplication with a densely stored matrix
+ *    y  =  A'*x  (if plus_eq == 0)
+ *    y +=  A'*x  (if plus_eq == 1)
+ *    y -=  A'*x  (if plus_eq == -1)
+ */
+void mat_tpose_vec_dense(const csc     *A,
+                         const c_float *x,
+                         c_float       *y,
+                         c_int          plus_eq);
+
+/* Symmetric matrix-vector multiplication y = P*x with the upper triangular
+ * part of P stored densely (see mat_is_dense_triu)
+ */
+void mat_vec_dense_sym_triu(const csc     *P,
+                            const c_float *x,
+                            c_float       *y);
+
+/* Matrix-vector multiplication with a matrix in block compressed-row form
+ *    y  =  A*x  (if plus_eq == 0)
+ *    y +=  A*x  (if plus_eq == 1)
+ *    y -=  A*x  (if plus_eq == -1)
+ */
+void bsr_mat_vec(const bsr     *A,
+                 const c_float *x,
+                 c_float       *y,
+                 c_int          plus_eq);
+
+/* Matrix-transpose-vector multiplication with a matrix in block
+ * compressed-row form
+ *    y  =  A'*x  (if plus_eq == 0)
+ *    y +=  A'*x  (if plus_eq == 1)
+ *    y -=  A'*x  (if plus_eq == -1)
+ */
+void bsr_mat_tpose_vec(const bsr     *A,
+                       const c_float *x,
+                       c_float       *y,
+                       c_int          plus_eq);
+
+# endif // ifndef EMBEDDED
+
 /**
  * Compute quadratic form f(x) = 1/2 x' P x
  * @param  P quadratic matrix in CSC form (only upper triangular)
@@ -12,9 +12,12 @@ extern "C" {
 /**
  * Load linear system solver shared library
  * @param	linsys_solver  Linear system solver
+ * @param	libname        Name of the shared library (required for the plugin
+ *                       solver, OSQP_NULL for the default MKL Pardiso library)
  * @return Zero on success, nonzero on failure.
  */
-c_int load_linsys_solver(enum linsys_solver_type linsys_solver);
+c_int load_linsys_solver(enum linsys_solver_type linsys_solver,
+                         const char             *libname);
 
 
 /**
@@ -37,6 +40,10 @@ c_int unload_linsys_solver(enum linsys_solver_type linsys_solver);
  * @param	linsys_solver Linear system solver
  * @param	polish        0/1 depending whether we are allocating for
  *polishing or not
+ * @param	stages        Stage of each variable and constraint (size n + m)
+ *used to order the KKT matrix of multi-stage problems, or OSQP_NULL
+ * @param	ordering      Ordering of the KKT matrix (QDLDL only)
+ * @param	profile       Profile of the solver phases, or OSQP_NULL
  * @return                Exitflag for error (0 if no errors)
  */
 c_int init_linsys_solver(LinSysSolver          **s,
@@ -45,7 +52,33 @@ c_int init_linsys_solver(LinSysSolver          **s,
                          c_float                 sigma,
                          const c_float          *rho_vec,
                          enum linsys_solver_type linsys_solver,
-                         c_int                   polish);
+                         c_int                   polish,
+                         const c_int            *stages,
+                         enum ordering_type      ordering,
+                         OSQPProfile            *profile);
+
+/**
+ * Compute the number of nonzeros of the factor L of the KKT matrix for a
+ * given ordering without factoring it
+ * @param   P             Cost function matrix
+ * @param	A             Constraint matrix
+ * @param	stages        Stage of each variable and constraint, or OSQP_NULL
+ * @param	ordering      Ordering of the KKT matrix
+ * @return                Number of nonzeros in L (negative if failed)
+ */
+c_int kkt_fill(const csc         *P,
+               const csc         *A,
+               const c_int       *stages,
+               enum ordering_type ordering);
+
+/**
+ * Compute the statistics of the factorization held by a linear system solver
+ * @param   s             Linear system solver structure
+ * @param	stats         Statistics of the factorization (output)
+ * @return                Exitflag (nonzero if the solver does not expose its factorization)
+ */
+c_int linsys_factor_stats(LinSysSolver    *s,
+                          OSQPFactorStats *stats);
 
 # ifdef __cplusplus
 }
@@ -0,0 +1,56 @@
+/* Interface of the linear system solvers loaded at runtime */
+#ifndef LINSYS_PLUGIN_H
+# define LINSYS_PLUGIN_H
+
+# ifdef __cplusplus
+extern "C" {
+# endif // ifdef __cplusplus
+
+# include "types.h"
+
+/**
+ * A linear system solver plugin is a shared library that exports the two
+ * functions
+ *
+ *    c_int osqp_linsys_plugin_abi(void);
+ *    c_int osqp_linsys_plugin_init(LinSysSolver **s, const csc *P,
+ *                                  const csc *A, c_float sigma,
+ *                                  const c_float *rho_vec, c_int polish);
+ *
+ * osqp_linsys_plugin_abi must return OSQP_LINSYS_PLUGIN_ABI as defined when
+ * the plugin is compiled. osqp_linsys_plugin_init has the same semantics as
+ * init_linsys_solver: it allocates the solver structure, which starts with
+ * the fields of LinSysSolver, links all its functions and factorizes the KKT
+ * matrix. On failure it sets *s to OSQP_NULL and returns an exitflag.
+ * update_sigma may be left OSQP_NULL, in which case the solver is set up again
+ * when the ADMM step of the variable bounds changes.
+ *
+ * The plugin is selected with settings->linsys_solver = PLUGIN_SOLVER and
+ * settings->linsys_solver_lib set to the name of the shared library.
+ */
+
+/// Version of the plugin interface. Increase it whenever LinSysSolver or the
+/// semantics of its functions change.
+# define OSQP_LINSYS_PLUGIN_ABI_VERSION (2)
+
+/// ABI identifier that also encodes the size of c_int and c_float
+# define OSQP_LINSYS_PLUGIN_ABI ((c_int)(OSQP_LINSYS_PLUGIN_ABI_VERSION * 10000 + \
+                                         sizeof(c_int) * 100 + sizeof(c_float)))
+
+/// Names of the symbols exported by the plugin
+# define OSQP_LINSYS_PLUGIN_ABI_SYMBOL ("osqp_linsys_plugin_abi")
+# define OSQP_LINSYS_PLUGIN_INIT_SYMBOL ("osqp_linsys_plugin_init")
+
+typedef c_int (*osqp_linsys_plugin_abi_t)(void);
+typedef c_int (*osqp_linsys_plugin_init_t)(LinSysSolver  **s,
+                                           const csc      *P,
+                                           const csc      *A,
+                                           c_float         sigma,
+                                           const c_float  *rho_vec,
+                                           c_int           polish);
+
+# ifdef __cplusplus
+}
+# endif // ifdef __cplusplus
+
+#endif // ifndef LINSYS_PLUGIN_H
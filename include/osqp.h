@@ -10,9 +10,11 @@ extern "C" {
 # include "util.h" // Needed for osqp_set_default_settings functions
 
 
-// Library to deal with sparse matrices enabled only if embedded not defined
+// Library to deal with sparse matrices and problem files enabled only if
+// embedded not defined
 # ifndef EMBEDDED
 #  include "cs.h"
+#  include "data_io.h"
 # endif // ifndef EMBEDDED
 
 /********************
@@ -57,6 +59,24 @@ void osqp_set_default_settings(OSQPSettings *settings);
  */
 c_int osqp_setup(OSQPWorkspace** workp, const OSQPData* data, const OSQPSettings* settings);
 
+/**
+ * Initialize OSQP solver with dense problem data.
+ *
+ * P and A are given as dense column-major arrays. All their elements are
+ * stored so that the residuals are computed with dense matrix-vector products.
+ * The linear system solver is the one of the settings; the dense normal
+ * equations solver is selected with NORMAL_SOLVER. The indices of the elements
+ * in osqp_update_P and
+ * osqp_update_A are the column-major positions in the upper triangular part
+ * of P and in A.
+ *
+ * @param  workp        Solver workspace pointer
+ * @param  data         Dense problem data
+ * @param  settings     Solver settings
+ * @return              Exitflag for errors (0 if no errors)
+ */
+c_int osqp_setup_dense(OSQPWorkspace** workp, const OSQPDenseData* data, const OSQPSettings* settings);
+
 # endif // #ifndef EMBEDDED
 
 /**
@@ -89,6 +109,123 @@ c_int osqp_solve(OSQPWorkspace *work);
  */
 c_int osqp_cleanup(OSQPWorkspace *work);
 
+
+/**
+ * Number of nonzeros of the factor L of the KKT matrix with the given
+ * ordering, computed from the elimination tree without factoring the matrix.
+ *
+ * It can be used after osqp_setup to compare the fill of the orderings and
+ * choose the one with the fewest nonzeros. The KKT matrix is the one QDLDL
+ * factors for the problem after presolve, ordered within the stages if these
+ * are given. USER_ORDERING is only available if the workspace was set up
+ * with a user ordering.
+ *
+ * @param  work     Workspace
+ * @param  ordering Ordering of the KKT matrix
+ * @return          Number of nonzeros in L (negative if failed)
+ */
+c_int osqp_kkt_fill(const OSQPWorkspace *work,
+                    enum ordering_type   ordering);
+
+
+/**
+ * Statistics of the factorizations of the KKT matrix of the ADMM iterations
+ * and of the reduced KKT matrix of the polishing step.
+ *
+ * The statistics are computed from the column counts of L and the
+ * elimination tree kept by QDLDL, without factoring again. The polish
+ * statistics are those of the cached factorization of the last polishing
+ * step before any low-rank update, and have dimension 0 if no factorization
+ * is cached. Linear system solvers other than QDLDL do not expose their
+ * factors and give zero statistics.
+ *
+ * @param  work          Workspace
+ * @param  kkt_stats     Statistics of the ADMM KKT factorization (output)
+ * @param  polish_stats  Statistics of the polish KKT factorization (output,
+ *                       can be OSQP_NULL)
+ * @return               Exitflag for errors (nonzero if the linear system
+ *                       solver does not expose its factorization)
+ */
+c_int osqp_get_factor_stats(const OSQPWorkspace *work,
+                            OSQPFactorStats     *kkt_stats,
+                            OSQPFactorStats     *polish_stats);
+
+
+/**
+ * Compute vector-Jacobian products of the solution with respect to the
+ * problem vectors q, l and u (backward pass)
+ *
+ * Given the gradients dx and dy of a scalar loss with respect to the solution
+ * x and y, it computes the gradients of the loss with respect to q, l and u.
+ * The KKT matrix of the constraints active at the solution is factorized
+ * through the linear system solver and reused in the following calls as long
+ * as the active set and the matrices do not change.
+ *
+ * All the vectors are stored column-wise with nrhs columns, so that several
+ * gradients can be processed with the same factorization.
+ *
+ * The function must be called after osqp_solve returned a solution.
+ *
+ * @param  work Workspace
+ * @param  nrhs Number of gradient vectors
+ * @param  dx   Gradients of the loss with respect to x (size n x nrhs)
+ * @param  dy   Gradients of the loss with respect to y (size m x nrhs). OSQP_NULL if zero
+ * @param  dq   Gradients of the loss with respect to q (size n x nrhs)
+ * @param  dl   Gradients of the loss with respect to l (size m x nrhs). OSQP_NULL if not needed
+ * @param  du   Gradients of the loss with respect to u (size m x nrhs). OSQP_NULL if not needed
+ * @return      Exitflag for errors
+ */
+c_int osqp_adjoint_derivative(OSQPWorkspace *work,
+                              c_int          nrhs,
+                              const c_float *dx,
+                              const c_float *dy,
+                              c_float       *dq,
+                              c_float       *dl,
+                              c_float       *du);
+
+
+/**
+ * Split the problem into independent subproblems and set up one solver
+ * workspace for each of them.
+ *
+ * The subproblems are the connected components of the graph whose nodes are
+ * the variables and whose edges are the off-diagonal elements of P and the
+ * pairs of variables appearing in the same row of A. Each subproblem has its
+ * own rho adaptation and termination criteria. Constraints without nonzero
+ * elements are assigned to the first subproblem.
+ *
+ * If OSQP is compiled with OpenMP, the subproblems are set up (with the QDLDL
+ * and normal equations solvers) and solved in parallel.
+ *
+ * @param  decompp      Decomposition pointer
+ * @param  data         Problem data
+ * @param  settings     Solver settings, used for all the subproblems
+ * @return              Exitflag for errors (0 if no errors)
+ */
+c_int osqp_setup_decomposed(OSQPDecomposition  **decompp,
+                            const OSQPData      *data,
+                            const OSQPSettings  *settings);
+
+/**
+ * Solve all the subproblems of a decomposed problem.
+ *
+ * The solutions are stitched together in \a decomp->solution. The
+ * information in \a decomp->info combines the ones of the subproblems: the
+ * status is the worst one, the iterations and residuals are the largest ones
+ * and the objective value is the sum of the objective values.
+ *
+ * @param  decomp Decomposition
+ * @return        Exitflag for errors
+ */
+c_int osqp_solve_decomposed(OSQPDecomposition *decomp);
+
+/**
+ * Cleanup a decomposed problem and the workspaces of its subproblems
+ * @param  decomp Decomposition
+ * @return        Exitflag for errors
+ */
+c_int osqp_cleanup_decomposed(OSQPDecomposition *decomp);
+
 # endif // ifndef EMBEDDED
 
 /** @} */
@@ -147,11 +284,31 @@ c_int osqp_update_upper_bound(OSQPWorkspace *work,
                               const c_float *u_new);
 
 
+# ifndef EMBEDDED
+
+/**
+ * Update lower and upper bounds of the variables. The variable bounds must
+ * have been given at setup; use -OSQP_INFTY and OSQP_INFTY for unbounded
+ * variables.
+ * @param  work   Workspace
+ * @param  lb_new New lower bound of the variables
+ * @param  ub_new New upper bound of the variables
+ * @return        Exitflag: 1 if the problem has no variable bounds or if new
+ *                lower bound is not <= than new upper bound
+ */
+c_int osqp_update_var_bounds(OSQPWorkspace *work,
+                             const c_float *lb_new,
+                             const c_float *ub_new);
+
+# endif // ifndef EMBEDDED
+
+
 /**
  * Warm start primal and dual variables
  * @param  work Workspace structure
  * @param  x    Primal variable
- * @param  y    Dual variable
+ * @param  y    Dual variable, followed by the multipliers of the variable
+ *              bounds if the problem has them
  * @return      Exitflag
  */
 c_int osqp_warm_start(OSQPWorkspace *work,
@@ -172,7 +329,8 @@ c_int osqp_warm_start_x(OSQPWorkspace *work,
 /**
  * Warm start dual variable
  * @param  work Workspace structure
- * @param  y    Dual variable
+ * @param  y    Dual variable, followed by the multipliers of the variable
+ *              bounds if the problem has them
  * @return      Exitflag
  */
 c_int osqp_warm_start_y(OSQPWorkspace *work,
@@ -406,6 +564,36 @@ c_int osqp_update_verbose(OSQPWorkspace *work,
                           c_int          verbose_new);
 
 
+/**
+ * Update the trace settings. The trace recorder keeps the number of records
+ * set in osqp_setup with trace_buffer.
+ * @param  work                Workspace
+ * @param  trace_interval_new  New number of iterations between two trace records (0 disables tracing)
+ * @param  trace_callback_new  New function called with each trace record (OSQP_NULL if none)
+ * @param  trace_data_new      New user data passed to the callback
+ * @return                     Exitflag
+ */
+c_int osqp_update_trace(OSQPWorkspace      *work,
+                        c_int               trace_interval_new,
+                        osqp_trace_callback trace_callback_new,
+                        void               *trace_data_new);
+
+
+/**
+ * Write the records of the trace recorder to a binary file, oldest first.
+ *
+ * The file starts with the 8 characters "OSQPTRC1", one byte with the size of
+ * c_int, one byte with the size of c_float and the number of records (c_int).
+ * Each record follows as iter (c_int) and obj_val, pri_res, dua_res, rho and
+ * time (c_float), in native byte order.
+ * @param  work      Workspace
+ * @param  filename  Name of the file
+ * @return           Exitflag (nonzero if the recorder is disabled or the file could not be written)
+ */
+c_int osqp_dump_trace(const OSQPWorkspace *work,
+                      const char          *filename);
+
+
 # endif // #ifndef EMBEDDED
 
 # ifdef PROFILING
@@ -418,6 +606,30 @@ c_int osqp_update_verbose(OSQPWorkspace *work,
  */
 c_int osqp_update_time_limit(OSQPWorkspace *work,
                              c_float        time_limit_new);
+
+
+/**
+ * Get the profile of the solver phases
+ *
+ * The profile contains the cumulative time and number of calls of each phase
+ * (scaling, forming, ordering and factoring the KKT matrix, linear system
+ * solves, projections, residuals, infeasibility checks, rho updates and
+ * polishing) since the setup or the last call to osqp_reset_profile.
+ * The phases are indexed by enum profile_phase.
+ * @param  work     Workspace
+ * @param  profile  Profile (output)
+ * @return          Exitflag
+ */
+c_int osqp_get_profile(const OSQPWorkspace *work,
+                       OSQPProfile         *profile);
+
+
+/**
+ * Reset the profile of the solver phases
+ * @param  work  Workspace
+ * @return       Exitflag
+ */
+c_int osqp_reset_profile(OSQPWorkspace *work);
 # endif // ifdef PROFILING
 
 /** @} */
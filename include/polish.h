@@ -17,6 +17,13 @@ extern "C" {
  */
 c_int polish(OSQPWorkspace *work);
 
+/**
+ * Free the cached factorization of the reduced KKT matrix.
+ * It must be called whenever P, A or delta change.
+ * @param work Workspace
+ */
+void polish_free_factorization(OSQPWorkspace *work);
+
 
 # ifdef __cplusplus
 }
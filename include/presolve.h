@@ -0,0 +1,107 @@
+/* Presolve and postsolve of the problem data */
+#ifndef PRESOLVE_H
+# define PRESOLVE_H
+
+# ifdef __cplusplus
+extern "C" {
+# endif // ifdef __cplusplus
+
+
+# include "types.h"
+
+/**
+ * Build the presolved problem and store the maps to the original one in
+ * work->presolve.
+ *
+ * Constraints with infinite lower and upper bounds are removed. Constraints
+ * with a single nonzero element are merged into the variable bounds of the
+ * presolved problem, and variables whose bounds are equal are fixed and
+ * removed from the problem.
+ * Constraints whose nonzero elements are all in fixed variables are removed if
+ * they are satisfied.
+ * Duplicate and parallel constraints, i.e., rows of A equal up to a scaling,
+ * are found by hashing the rows normalized by their first element and merged
+ * into the first one of their group, whose bounds are intersected with the
+ * scaled bounds of the others. Groups whose merged bounds are inconsistent
+ * are kept so that infeasibility is detected by the solver.
+ *
+ * @param  work     Workspace
+ * @param  data     Problem data
+ * @param  stages   Stages of the variables and constraints (OSQP_NULL if not given)
+ * @param  data_red Presolved problem data. It must be freed with presolve_free_data
+ * @return          Exitflag: 1 if memory allocation failed
+ */
+c_int presolve_init(OSQPWorkspace   *work,
+                    const OSQPData  *data,
+                    const c_int     *stages,
+                    OSQPData       **data_red);
+
+/**
+ * Free the presolved problem data returned by presolve_init
+ * @param data_red Presolved problem data
+ */
+void presolve_free_data(OSQPData *data_red);
+
+/**
+ * Replace the linear cost and compute the one of the presolved problem in
+ * presolve->q_red
+ * @param presolve Presolve structure
+ * @param q_new    New linear cost
+ */
+void presolve_update_lin_cost(OSQPPresolve  *presolve,
+                              const c_float *q_new);
+
+/**
+ * Replace the bounds and the variable bounds and compute the ones of the
+ * presolved problem in presolve->l_red, presolve->u_red, presolve->lb_red and
+ * presolve->ub_red. The bounds are not replaced if they change the presolved
+ * problem, i.e., the removed constraints or the values of the fixed variables.
+ * @param  presolve Presolve structure
+ * @param  l_new    New lower bound
+ * @param  u_new    New upper bound
+ * @param  lb_new   New lower bound of the variables
+ * @param  ub_new   New upper bound of the variables
+ * @return          Exitflag: 1 if the presolved problem changes
+ */
+c_int presolve_update_bounds(OSQPPresolve  *presolve,
+                             const c_float *l_new,
+                             const c_float *u_new,
+                             const c_float *lb_new,
+                             const c_float *ub_new);
+
+/**
+ * Map a primal vector of the original problem to presolve->x_red
+ * @param presolve Presolve structure
+ * @param x        Primal vector
+ */
+void presolve_x(OSQPPresolve  *presolve,
+                const c_float *x);
+
+/**
+ * Map a dual vector of the original problem to presolve->y_red
+ * @param presolve Presolve structure
+ * @param y        Dual vector, followed by the multipliers of the variable
+ *                 bounds if the original problem has them
+ */
+void presolve_y(OSQPPresolve  *presolve,
+                const c_float *y);
+
+/**
+ * Recover the solution of the original problem from the solution of the
+ * presolved problem, stored at the beginning of work->solution
+ * @param work Workspace
+ */
+void postsolve_solution(OSQPWorkspace *work);
+
+/**
+ * Free the presolve structure
+ * @param presolve Presolve structure
+ */
+void presolve_free(OSQPPresolve *presolve);
+
+
+# ifdef __cplusplus
+}
+# endif // ifdef __cplusplus
+
+#endif // ifndef PRESOLVE_H
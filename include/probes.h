@@ -0,0 +1,35 @@
+/* Static tracepoints (USDT) at the phase boundaries of the solver */
+#ifndef PROBES_H
+# define PROBES_H
+
+# include "glob_opts.h"
+
+/**
+ * OSQP_PROBEn(name, ...) places the static tracepoint osqp:name with n integer
+ * arguments.
+ *
+ * With the cmake option USDT, the tracepoints are the USDT probes of
+ * <sys/sdt.h>: a nop in the code and a note in the .note.stapsdt section of
+ * the library, which perf (perf buildid-cache --add, then perf record -e
+ * sdt_osqp:name) and bpftrace (usdt:libosqp.so:osqp:name) enable at runtime
+ * without rebuilding. Without USDT they compile to nothing and their arguments
+ * are not evaluated.
+ *
+ * Tracepoints and arguments:
+ *   setup_begin(n, m)               setup_end(n, m)
+ *   solve_begin(n, m)               solve_end(iter, status_val)
+ *   factor_begin(dim, nnz_L)        factor_end(dim, status)
+ *   rho_update_begin(iter, updates) rho_update_end(iter, updates)
+ *   termination_check(iter, exitflag)
+ *   polish_begin(n, m)              polish_end(status_polish)
+ */
+# ifdef USDT
+#  include <sys/sdt.h>
+#  define OSQP_PROBE1(name, a1)     DTRACE_PROBE1(osqp, name, (long)(a1))
+#  define OSQP_PROBE2(name, a1, a2) DTRACE_PROBE2(osqp, name, (long)(a1), (long)(a2))
+# else /* ifdef USDT */
+#  define OSQP_PROBE1(name, a1)
+#  define OSQP_PROBE2(name, a1, a2)
+# endif /* ifdef USDT */
+
+#endif // ifndef PROBES_H
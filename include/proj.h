@@ -20,7 +20,8 @@ void project(OSQPWorkspace *work,
 
 
 /**
- * Ensure z satisfies box constraints and y is is normal cone of z
+ * Ensure z satisfies box constraints and y is is normal cone of z. The
+ * variable bounds follow the constraints in z and y.
  * @param work Workspace
  * @param z    Primal variable z
  * @param y    Dual variable y
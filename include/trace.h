@@ -0,0 +1,55 @@
+/* Per-iteration trace of the solver: user callback and ring buffer recorder */
+#ifndef TRACE_H
+# define TRACE_H
+
+# ifdef __cplusplus
+extern "C" {
+# endif // ifdef __cplusplus
+
+
+# include "types.h"
+
+/**
+ * Allocate the trace recorder with settings->trace_buffer records.
+ * The recorder is not allocated if the setting is zero.
+ * @param  work Workspace
+ * @return      Exitflag
+ */
+c_int trace_init(OSQPWorkspace *work);
+
+/**
+ * Form the trace record of the current iteration from the solver information,
+ * store it in the recorder and pass it to the trace callback. The oldest
+ * record is replaced when the recorder is full.
+ * @param work Workspace
+ * @param iter Iteration number
+ */
+void trace_iteration(OSQPWorkspace *work,
+                     c_int          iter);
+
+/**
+ * Write the stored records to a binary file, oldest first.
+ *
+ * The file starts with the 8 characters "OSQPTRC1", one byte with the size of
+ * c_int, one byte with the size of c_float and the number of records
+ * (c_int). Each record is then written as iter (c_int) followed by obj_val,
+ * pri_res, dua_res, rho and time (c_float), in native byte order.
+ * @param  trace    Trace recorder
+ * @param  filename Name of the file
+ * @return          Exitflag (nonzero if the file could not be written)
+ */
+c_int trace_dump(const OSQPTrace *trace,
+                 const char      *filename);
+
+/**
+ * Free the trace recorder
+ * @param work Workspace
+ */
+void trace_free(OSQPWorkspace *work);
+
+
+# ifdef __cplusplus
+}
+# endif // ifdef __cplusplus
+
+#endif // ifndef TRACE_H
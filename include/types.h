@@ -28,6 +28,25 @@ typedef struct {
   c_int    nz;    ///< number of entries in triplet matrix, -1 for csc
 } csc;
 
+/**
+ *  Matrix in block compressed-row form with dense square blocks of size bs.
+ *  The last block row and block column are padded with zeros if the
+ *  dimensions are not multiples of bs.
+ */
+typedef struct {
+  c_int    m;    ///< number of rows
+  c_int    n;    ///< number of columns
+  c_int    bs;   ///< block size
+  c_int    mb;   ///< number of block rows
+  c_int    nb;   ///< number of block columns
+  c_int   *p;    ///< block row pointers (size mb+1)
+  c_int   *j;    ///< block column indices, sorted in each block row (size p[mb])
+  c_float *x;    ///< values of the blocks, row-major in each block (size p[mb]*bs*bs)
+  c_int   *map;  ///< position in x of each element of the csc matrix it is built from
+  c_float *xp;   ///< padded input vector of the products (size bs*max(mb,nb))
+  c_float *yp;   ///< padded output vector of the products (size bs*max(mb,nb))
+} bsr;
+
 /**
  * Linear system solver structure (sublevel objects initialize it differently)
  */
@@ -57,9 +76,21 @@ typedef struct {
 typedef struct {
   c_float *x; ///< primal solution
   c_float *y; ///< Lagrange multiplier associated to \f$l <= Ax <= u\f$
+# ifndef EMBEDDED
+  c_float *y_bnd; ///< Lagrange multiplier associated to \f$lb <= x <= ub\f$ (OSQP_NULL without variable bounds)
+# endif // ifndef EMBEDDED
 } OSQPSolution;
 
 
+/**
+ * Profile of the solver phases
+ */
+typedef struct {
+  c_float time[PROFILE_NPHASES];  ///< cumulative time of each phase (seconds), indexed by enum profile_phase
+  c_int   calls[PROFILE_NPHASES]; ///< number of times each phase was run
+} OSQPProfile;
+
+
 /**
  * Solver return information
  */
@@ -82,6 +113,8 @@ typedef struct {
   c_float update_time; ///< time taken for update phase (seconds)
   c_float polish_time; ///< time taken for polish phase (seconds)
   c_float run_time;    ///< total time  (seconds)
+
+  OSQPProfile profile; ///< time and calls of the solver phases since the setup or osqp_reset_profile
 # endif // ifdef PROFILING
 
 # if EMBEDDED != 1
@@ -97,21 +130,138 @@ typedef struct {
  * Polish structure
  */
 typedef struct {
-  csc *Ared;          ///< active rows of A
+  csc *Ared;          ///< active rows of A and of the variable bounds (identity rows)
   ///<    Ared = vstack[Alow, Aupp]
   c_int    n_low;     ///< number of lower-active rows
   c_int    n_upp;     ///< number of upper-active rows
-  c_int   *A_to_Alow; ///< Maps indices in A to indices in Alow
+  c_int   *A_to_Alow; ///< Maps indices in A to indices in Alow. Index m + j is the bound of variable j
   c_int   *A_to_Aupp; ///< Maps indices in A to indices in Aupp
   c_int   *Alow_to_A; ///< Maps indices in Alow to indices in A
   c_int   *Aupp_to_A; ///< Maps indices in Aupp to indices in A
+  LinSysSolver *linsys_solver; ///< cached factorization of the reduced KKT matrix
+  c_int    m_fac;     ///< number of rows of A in the cached factorization
+  c_int   *A_to_Afac; ///< Maps indices in A to rows of the cached factorization (-1 if not included)
+  c_int   *Afac_to_A; ///< Maps rows of the cached factorization to indices in A
+  c_int    update_rank; ///< rows added and dropped by the low-rank update of the last polish (0 if none)
   c_float *x;         ///< optimal x-solution obtained by polish
-  c_float *z;         ///< optimal z-solution obtained by polish
-  c_float *y;         ///< optimal y-solution obtained by polish
+  c_float *z;         ///< optimal z-solution obtained by polish (size m + n_bnd)
+  c_float *y;         ///< optimal y-solution obtained by polish (size m + n_bnd)
   c_float  obj_val;   ///< objective value at polished solution
   c_float  pri_res;   ///< primal residual at polished solution
   c_float  dua_res;   ///< dual residual at polished solution
 } OSQPPolish;
+
+/**
+ * Derivative structure
+ */
+typedef struct {
+  csc          *Ared;          ///< rows of A active at the solution
+  c_int         mred;          ///< number of active rows
+  c_int        *A_to_Ared;     ///< Maps indices in A to indices in Ared (-1 if inactive)
+  c_int        *Ared_to_A;     ///< Maps indices in Ared to indices in A
+  LinSysSolver *linsys_solver; ///< factorization of the KKT matrix of the active constraints
+} OSQPDerivative;
+
+/**
+ * Warm start cache structure
+ */
+typedef struct {
+  c_int    size;        ///< maximum number of stored solutions
+  c_int    count;       ///< number of stored solutions
+  c_int    next;        ///< position of the next stored solution (ring buffer)
+  c_int    skip_lookup; ///< boolean, the iterates have been set by the user
+  c_float *key;         ///< fingerprint of the current vectors q, l, u, lb and ub
+  c_float *keys;        ///< fingerprints of the stored solutions (size x WARM_START_CACHE_DIM)
+  c_float *x;           ///< stored scaled primal solutions (size x n)
+  c_float *y;           ///< stored scaled dual solutions (size x (m + n_bnd))
+  c_float *rho;         ///< rho values at the stored solutions
+} OSQPWarmStartCache;
+
+/**
+ * Statistics of the factorization of a KKT matrix
+ */
+typedef struct {
+  c_int   dim;          ///< dimension of the KKT matrix (0 if not factored)
+  c_int   nnz_KKT;      ///< number of nonzeros in the upper triangular part of the permuted KKT matrix
+  c_int   nnz_L;        ///< number of nonzeros below the diagonal of the factor L
+  c_float fill;         ///< fill ratio (nnz_L + dim) / nnz_KKT
+  c_float flops;        ///< floating point operations of the numeric factorization
+  c_int   etree_height; ///< height of the elimination tree (length of its longest path)
+} OSQPFactorStats;
+
+/**
+ * Trace record of an ADMM iteration
+ */
+typedef struct {
+  c_int   iter;    ///< iteration number
+  c_float obj_val; ///< primal objective
+  c_float pri_res; ///< norm of primal residual
+  c_float dua_res; ///< norm of dual residual
+  c_float rho;     ///< ADMM step rho
+  c_float time;    ///< time since the start of the solve (seconds); 0 without PROFILING
+} OSQPTraceRecord;
+
+/**
+ * Function called with each trace record
+ * @param record Trace record of the current iteration
+ * @param data   User data given in the settings
+ */
+typedef void (*osqp_trace_callback)(const OSQPTraceRecord *record, void *data);
+
+/**
+ * Trace recorder structure
+ */
+typedef struct {
+  c_int            size;    ///< maximum number of stored records
+  c_int            count;   ///< number of stored records
+  c_int            next;    ///< position of the next stored record (ring buffer)
+  OSQPTraceRecord *records; ///< stored records
+} OSQPTrace;
+
+/**
+ * Presolve structure
+ */
+typedef struct {
+  c_int    n;          ///< number of variables of the original problem
+  c_int    m;          ///< number of constraints of the original problem
+  c_int    n_red;      ///< number of variables of the presolved problem
+  c_int    m_red;      ///< number of constraints of the presolved problem
+  csc     *P;          ///< quadratic cost matrix of the original problem
+  csc     *A;          ///< constraint matrix of the original problem
+  c_float *q;          ///< linear cost of the original problem
+  c_float *l;          ///< lower bound of the original problem
+  c_float *u;          ///< upper bound of the original problem
+  c_float *lb;         ///< lower bound of the variables of the original problem
+  c_float *ub;         ///< upper bound of the variables of the original problem
+  c_float *q_red;      ///< linear cost of the presolved problem
+  c_float *l_red;      ///< lower bound of the presolved problem
+  c_float *u_red;      ///< upper bound of the presolved problem
+  c_float *lb_red;     ///< lower bound of the variables of the presolved problem
+  c_float *ub_red;     ///< upper bound of the variables of the presolved problem
+  c_float *x_red;      ///< primal vector of the presolved problem
+  c_float *y_red;      ///< dual vector of the presolved problem followed by the multipliers of its variable bounds
+  c_int   *var_map;    ///< index of each variable in the presolved problem (-1 if fixed)
+  c_int   *con_map;    ///< index of each constraint in the presolved problem (-1 if removed)
+  c_int    bnd;        ///< boolean, the original problem has variable bounds
+  c_int    bnd_red;    ///< boolean, the presolved problem has variable bounds
+  c_int   *row_type;   ///< reduction applied to each constraint
+  c_int   *row_nnz;    ///< number of nonzero elements of each row of A
+  c_int   *row_var;    ///< variable of each singleton constraint
+  c_float *row_coef;   ///< coefficient of each singleton constraint
+  c_int   *par_rep;    ///< first row of the group of parallel rows of each row (-1 if not parallel to another row)
+  c_float *par_scale;  ///< ratio between each row and the first row of its group of parallel rows
+  c_float *row_l;      ///< lower bound of each constraint merged with the ones of its parallel rows
+  c_float *row_u;      ///< upper bound of each constraint merged with the ones of its parallel rows
+  c_int   *lo_row;     ///< singleton constraint giving the lower bound of each variable (-1 if given by lb)
+  c_int   *hi_row;     ///< singleton constraint giving the upper bound of each variable (-1 if given by ub)
+  c_float *lo;         ///< lower bound of each variable from lb and its singleton constraints
+  c_float *hi;         ///< upper bound of each variable from ub and its singleton constraints
+  c_float *x_fix;      ///< values of the fixed variables (0 for the other ones)
+  c_float *vec_n;      ///< temporary vector of size n
+  c_float *vec_m;      ///< temporary vector of size m
+  c_int   *stages;     ///< stages of the presolved problem (OSQP_NULL if not given)
+  c_float  obj_offset; ///< objective value of the fixed variables
+} OSQPPresolve;
 # endif // ifndef EMBEDDED
 
 
@@ -130,9 +280,32 @@ typedef struct {
   c_float *q; ///< dense array for linear part of cost function (size n)
   c_float *l; ///< dense array for lower bound (size m)
   c_float *u; ///< dense array for upper bound (size m)
+# ifndef EMBEDDED
+  c_float *lb; ///< dense array for lower bound of the variables (size n, OSQP_NULL if not bounded below), read only with the var_bounds setting
+  c_float *ub; ///< dense array for upper bound of the variables (size n, OSQP_NULL if not bounded above), read only with the var_bounds setting
+# endif // ifndef EMBEDDED
 } OSQPData;
 
 
+# ifndef EMBEDDED
+
+/**
+ * Dense data structure
+ */
+typedef struct {
+  c_int    n; ///< number of variables n
+  c_int    m; ///< number of constraints m
+  c_float *P; ///< quadratic cost matrix P in column-major order (size n x n). Only the upper triangular part is used.
+  c_float *A; ///< linear constraints matrix A in column-major order (size m x n)
+  c_float *q; ///< dense array for linear part of cost function (size n)
+  c_float *l; ///< dense array for lower bound (size m)
+  c_float *u; ///< dense array for upper bound (size m)
+  c_float *lb; ///< dense array for lower bound of the variables (size n, OSQP_NULL if not bounded below), read only with the var_bounds setting
+  c_float *ub; ///< dense array for upper bound of the variables (size n, OSQP_NULL if not bounded above), read only with the var_bounds setting
+} OSQPDenseData;
+# endif // ifndef EMBEDDED
+
+
 /**
  * Settings struct
  */
@@ -159,9 +332,20 @@ typedef struct {
   enum linsys_solver_type linsys_solver; ///< linear system solver to use
 
 # ifndef EMBEDDED
+  const char *linsys_solver_lib;         ///< shared library of the linear system solver, read only in osqp_setup. Required for the plugin solver; OSQP_NULL for the default MKL Pardiso library
+  const c_int *stages;                   ///< stage of each variable and constraint (size n + m) of a multi-stage problem, read only in osqp_setup. QDLDL orders the KKT matrix stage by stage; OSQP_NULL if not given
+  enum ordering_type ordering;           ///< ordering of the KKT matrix for QDLDL (AMD, reverse Cuthill-McKee, nested dissection or user), applied within each stage if stages are given
+  const c_int *perm;                     ///< permutation of the variables and constraints (size n + m) for the user ordering, read only in osqp_setup. perm[k] is the variable (k < n) or constraint (n + k) factored in position k
   c_float delta;                         ///< regularization parameter for polishing
   c_int   polish;                        ///< boolean, polish ADMM solution
   c_int   polish_refine_iter;            ///< number of iterative refinement steps in polishing
+  c_int   warm_start_cache;              ///< number of previous solutions stored to warm start the following solves; if 0, then disabled
+  c_int   presolve;                      ///< boolean, remove fixed variables and free or empty constraints and merge singleton constraints into the variable bounds before the setup
+  c_int   var_bounds;                    ///< boolean, read the variable bounds lb and ub of the data in the setup; if 0, then they are ignored
+  c_int   trace_interval;                ///< number of iterations between two trace records; if 0, then tracing is disabled
+  c_int   trace_buffer;                  ///< number of trace records kept by the recorder, read only in osqp_setup; if 0, then the recorder is disabled
+  osqp_trace_callback trace_callback;    ///< function called with each trace record; OSQP_NULL if not given
+  void   *trace_data;                    ///< user data passed to trace_callback
 
   c_int verbose;                         ///< boolean, write out progress
 # endif // ifndef EMBEDDED
@@ -189,6 +373,35 @@ typedef struct {
 # ifndef EMBEDDED
   /// Polish structure
   OSQPPolish *pol;
+
+  /// Derivative structure (allocated at the first derivative computation)
+  OSQPDerivative *deriv;
+
+  /// Warm start cache (OSQP_NULL if disabled)
+  OSQPWarmStartCache *ws_cache;
+
+  /// Trace recorder (OSQP_NULL if disabled)
+  OSQPTrace *trace;
+
+  /// Flag whether all elements of P (upper triangular part) and A are stored (dense matrix-vector products)
+  c_int dense_data;
+
+  /// A in block compressed-row form for the matrix-vector products (OSQP_NULL if its elements are not grouped in small dense blocks)
+  bsr *A_bsr;
+
+  /// Stage of each variable and constraint (OSQP_NULL if not given)
+  c_int *stages;
+
+  /// Presolve structure (OSQP_NULL if disabled)
+  OSQPPresolve *presolve;
+
+  /// Number of variable bounds: n with variable bounds, 0 otherwise. The
+  /// splitting variables and the multipliers of the bounds follow the ones of
+  /// the constraints in z and y
+  c_int n_bnd;
+
+  /// ADMM step of the variable bounds, added to sigma in the KKT matrix
+  c_float rho_bnd;
 # endif // ifndef EMBEDDED
 
   /**
@@ -286,9 +499,39 @@ typedef struct {
   c_int summary_printed; ///< Has last summary been printed? (true/false)
 # endif // ifdef PRINTING
 
+# ifdef CTRLC
+  /// flag indicating that the caller installs the Ctrl-C listener around osqp_solve
+  c_int shared_interrupt_listener;
+# endif // ifdef CTRLC
+
 } OSQPWorkspace;
 
 
+# ifndef EMBEDDED
+
+/**
+ * Decomposition of a problem into independent subproblems
+ */
+typedef struct {
+  c_int           n;        ///< number of variables of the whole problem
+  c_int           m;        ///< number of constraints of the whole problem
+  c_int           ncomp;    ///< number of subproblems
+  c_int          *var_ptr;  ///< start of the variables of each subproblem in var_idx (size ncomp+1)
+  c_int          *var_idx;  ///< variables sorted by subproblem (size n)
+  c_int          *con_ptr;  ///< start of the constraints of each subproblem in con_idx (size ncomp+1)
+  c_int          *con_idx;  ///< constraints sorted by subproblem (size m)
+  OSQPWorkspace **work;     ///< workspaces of the subproblems (size ncomp)
+  OSQPSolution   *solution; ///< solution of the whole problem
+  OSQPInfo       *info;     ///< solver information of the whole problem
+
+#  ifdef PROFILING
+  OSQPTimer *timer;         ///< timer object
+  c_int      first_run;     ///< flag indicating whether the solve function has been run before
+#  endif // ifdef PROFILING
+} OSQPDecomposition;
+# endif // ifndef EMBEDDED
+
+
 /**
  * Define linsys_solver prototype structure
  *
@@ -301,6 +544,10 @@ struct linsys_solver {
                  c_float      *b);              ///< solve linear system
 
 # ifndef EMBEDDED
+  c_int (*solve_multi)(LinSysSolver *self,
+                       c_float      *B,         ///< solve linear system with nrhs right-hand
+                       c_int         nrhs);     //   sides stored column-wise in B
+
   void (*free)(LinSysSolver *self);             ///< free linear system solver (only in desktop version)
 # endif // ifndef EMBEDDED
 
@@ -314,6 +561,10 @@ struct linsys_solver {
 # endif // if EMBEDDED != 1
 
 # ifndef EMBEDDED
+  c_int (*update_sigma)(LinSysSolver  *s,
+                        c_float        sigma,      ///< update sigma and rho_vec with a numeric
+                        const c_float *rho_vec);   //   refactorization (OSQP_NULL if not supported)
+
   c_int nthreads; ///< number of threads active
 # endif // ifndef EMBEDDED
 };
@@ -125,10 +125,23 @@ struct OSQP_TIMER {
 #   include <time.h>
 #   include <sys/time.h>
 
+/* Use the invariant time stamp counter on x86 if enabled. It is calibrated
+   against clock_gettime() once, at the first use in any thread, and
+   clock_gettime() is used if the processor has no invariant time stamp
+   counter. */
+#   if defined(TSC_TIMER) && defined(__GNUC__) && \
+  (defined(__x86_64__) || defined(__i386__))
+#    define OSQP_TSC
+#    include <stdint.h>
+#   endif /* if defined(TSC_TIMER) && defined(__GNUC__) && ... */
+
 
 struct OSQP_TIMER {
   struct timespec tic;
   struct timespec toc;
+#   ifdef OSQP_TSC
+  uint64_t tsc_tic; ///< time stamp counter at tic
+#   endif /* ifdef OSQP_TSC */
 };
 
 #  endif // ifdef IS_WINDOWS
@@ -152,8 +165,44 @@ void    osqp_tic(OSQPTimer *t);
  */
 c_float osqp_toc(OSQPTimer *t);
 
+/**
+ * Add the time of a run of a phase to the profile
+ * @param profile Profile (nothing is done if OSQP_NULL)
+ * @param phase   Phase
+ * @param time    Time of the run (seconds)
+ */
+void osqp_profile_add(OSQPProfile       *profile,
+                      enum profile_phase phase,
+                      c_float            time);
+
 # endif /* END #ifdef PROFILING */
 
+/**
+ * Timing of the phases of the profile. PROFILE_TIC starts the timer t and
+ * PROFILE_TOC adds the time since then to a phase of the profile. Without
+ * PROFILING they do nothing.
+ */
+# ifdef PROFILING
+#  define PROFILE_TIC(t)                 osqp_tic(t)
+#  define PROFILE_TOC(profile, phase, t) osqp_profile_add((profile), (phase), osqp_toc(t))
+# else /* ifdef PROFILING */
+#  define PROFILE_TIC(t)
+#  define PROFILE_TOC(profile, phase, t)
+# endif /* ifdef PROFILING */
+
+/**
+ * Timing of the phases run at every ADMM iteration. Reading the clock twice
+ * per iteration is not negligible on small problems, so they are only timed
+ * with PROFILE_ITERATIONS.
+ */
+# ifdef PROFILE_ITERATIONS
+#  define PROFILE_ITER_TIC(t)                 PROFILE_TIC(t)
+#  define PROFILE_ITER_TOC(profile, phase, t) PROFILE_TOC(profile, phase, t)
+# else /* ifdef PROFILE_ITERATIONS */
+#  define PROFILE_ITER_TIC(t)
+#  define PROFILE_ITER_TOC(profile, phase, t)
+# endif /* ifdef PROFILE_ITERATIONS */
+
 
 /* ================================= DEBUG FUNCTIONS ======================= */
 
@@ -0,0 +1,54 @@
+/* Cache of previous solutions used to warm start parametric solves */
+#ifndef WARM_CACHE_H
+# define WARM_CACHE_H
+
+# ifdef __cplusplus
+extern "C" {
+# endif // ifdef __cplusplus
+
+
+# include "types.h"
+
+/**
+ * Allocate the warm start cache with settings->warm_start_cache entries.
+ * The cache is not allocated if the setting is zero.
+ * @param  work Workspace
+ * @return      Exitflag
+ */
+c_int warm_cache_init(OSQPWorkspace *work);
+
+/**
+ * Compute the fingerprint of the current vectors q, l, u, lb and ub and, if
+ * warm starting is enabled and the iterates have not been set by the user,
+ * warm start x, z, y and rho from the stored solution with the nearest
+ * fingerprint.
+ * @param  work Workspace
+ * @return      Exitflag
+ */
+c_int warm_cache_lookup(OSQPWorkspace *work);
+
+/**
+ * Store the current solution together with the fingerprint computed in
+ * warm_cache_lookup. The oldest entry is replaced when the cache is full.
+ * @param work Workspace
+ */
+void warm_cache_insert(OSQPWorkspace *work);
+
+/**
+ * Remove all the stored solutions. It must be called whenever P or A change.
+ * @param work Workspace
+ */
+void warm_cache_clear(OSQPWorkspace *work);
+
+/**
+ * Free the warm start cache
+ * @param work Workspace
+ */
+void warm_cache_free(OSQPWorkspace *work);
+
+
+# ifdef __cplusplus
+}
+# endif // ifdef __cplusplus
+
+#endif // ifndef WARM_CACHE_H
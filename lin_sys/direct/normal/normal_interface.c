@@ -0,0 +1,407 @@
+#include "glob_opts.h"
+
+#include "normal_interface.h"
+#include "lin_alg.h"
+#include "cs.h"
+
+
+// Free normal equations structure
+void free_linsys_solver_normal(normal_solver *s) {
+    if (s) {
+        if (s->A)         csc_spfree(s->A);
+        if (s->At)        csc_spfree(s->At);
+        if (s->AtoAt)     c_free(s->AtoAt);
+        if (s->M0)        c_free(s->M0);
+        if (s->G)         c_free(s->G);
+        if (s->L)         c_free(s->L);
+        if (s->rho_vec)   c_free(s->rho_vec);
+        if (s->rho_class) c_free(s->rho_class);
+        if (s->sol)       c_free(s->sol);
+        if (s->bz)        c_free(s->bz);
+        c_free(s);
+    }
+}
+
+
+/**
+ * Form the transpose of A and the map from the elements of A to At
+ * @param  s    Linear system solver structure
+ * @return      Exitflag
+ */
+static c_int form_At(normal_solver *s) {
+    c_int j, ptr, pos;
+    c_int *count;
+    const csc *A = s->A;
+
+    s->At    = csc_spalloc(A->n, A->m, A->p[A->n], 1, 0);
+    s->AtoAt = (c_int *)c_malloc((A->p[A->n] + 1) * sizeof(c_int));
+    count    = (c_int *)c_calloc(A->m + 1, sizeof(c_int));
+    if (!(s->At) || !(s->AtoAt) || !count) {
+        if (count) c_free(count);
+        return 1;
+    }
+
+    // Count elements in each row of A
+    for (ptr = 0; ptr < A->p[A->n]; ptr++) count[A->i[ptr]]++;
+    csc_cumsum(s->At->p, count, A->m);
+
+    // Rows of A are stored in increasing column order
+    for (j = 0; j < A->n; j++) {
+        for (ptr = A->p[j]; ptr < A->p[j + 1]; ptr++) {
+            pos               = count[A->i[ptr]]++;
+            s->At->i[pos]     = j;
+            s->At->x[pos]     = A->x[ptr];
+            s->AtoAt[ptr]     = pos;
+        }
+    }
+
+    c_free(count);
+    return 0;
+}
+
+/**
+ * Store P + sigma I in dense form (lower triangle)
+ * @param  s    Linear system solver structure
+ * @param  P    Cost function matrix (upper triangular form)
+ */
+static void form_M0(normal_solver *s, const csc *P) {
+    c_int i, j, ptr, n = s->n;
+
+    vec_set_scalar(s->M0, 0., n * n);
+
+    for (j = 0; j < n; j++) {
+        for (ptr = P->p[j]; ptr < P->p[j + 1]; ptr++) {
+            i = P->i[ptr];
+
+            // Element (j, i) of the lower triangle
+            if (i <= j) s->M0[j + i * n] += P->x[ptr];
+            else        s->M0[i + j * n] += P->x[ptr];
+        }
+        s->M0[j + j * n] += s->sigma;
+    }
+}
+
+/**
+ * Group the constraints by their value of rho_vec
+ * @param  s        Linear system solver structure
+ * @param  rho_vec  Parameter vector
+ * @return          Number of classes (0 if more than NORMAL_MAX_RHO_CLASSES)
+ */
+static c_int classify_rho(normal_solver *s, const c_float *rho_vec) {
+    c_int i, c, nclass = 0;
+
+    for (i = 0; i < s->m; i++) {
+        for (c = 0; c < nclass; c++) {
+            if (rho_vec[i] == s->rho_class_val[c]) break;
+        }
+        if (c == nclass) {
+            if (nclass == NORMAL_MAX_RHO_CLASSES) return 0;
+            s->rho_class_val[nclass++] = rho_vec[i];
+        }
+        s->rho_class[i] = c;
+    }
+
+    return nclass;
+}
+
+/**
+ * Add rho * a_i a_i' to the lower triangle of the dense matrix M for row i
+ * of A.
+ */
+static void add_row_product(const normal_solver *s, c_float *M, c_int i, c_float rho) {
+    c_int p, q, j, k, n = s->n;
+    c_float rho_aj;
+
+    for (p = s->At->p[i]; p < s->At->p[i + 1]; p++) {
+        j      = s->At->i[p];
+        rho_aj = rho * s->At->x[p];
+
+        // Column indices in a row of At are increasing: k <= j
+        for (q = s->At->p[i]; q <= p; q++) {
+            k = s->At->i[q];
+            M[j + k * n] += rho_aj * s->At->x[q];
+        }
+    }
+}
+
+/**
+ * Form the products A_c' A_c of the rows of A in each rho class
+ * @param  s    Linear system solver structure
+ */
+static void form_G(normal_solver *s) {
+    c_int i, n = s->n;
+
+    if (!s->nclass) return;
+
+    vec_set_scalar(s->G, 0., s->nclass * n * n);
+    for (i = 0; i < s->m; i++) {
+        add_row_product(s, s->G + s->rho_class[i] * n * n, i, 1.);
+    }
+}
+
+/**
+ * Form M = P + sigma I + A' diag(rho) A and compute its dense Cholesky
+ * factorization M = L L' in place.
+ * @param  s    Linear system solver structure
+ * @return      Exitflag (nonzero if M is not positive definite)
+ */
+static c_int factor(normal_solver *s) {
+    c_int i, j, k, c, n = s->n;
+    c_float *L = s->L;
+    c_float *Lj, *L0, *L1, *L2, *L3;
+    c_float l0, l1, l2, l3, d;
+
+    prea_vec_copy(s->M0, L, n * n);
+    if (s->nclass) {
+        for (c = 0; c < s->nclass; c++) {
+            vec_add_scaled(L, L, s->G + c * n * n, n * n, s->rho_class_val[c]);
+        }
+    } else {
+        for (i = 0; i < s->m; i++) add_row_product(s, L, i, s->rho_vec[i]);
+    }
+
+    // Left-looking Cholesky factorization. Column j is updated with four
+    // previous columns at a time.
+    for (j = 0; j < n; j++) {
+        Lj = L + j * n;
+        for (k = 0; k + 3 < j; k += 4) {
+            L0 = L + k * n;
+            L1 = L0 + n;
+            L2 = L1 + n;
+            L3 = L2 + n;
+            l0 = L0[j];
+            l1 = L1[j];
+            l2 = L2[j];
+            l3 = L3[j];
+            for (i = j; i < n; i++) {
+                Lj[i] -= L0[i] * l0 + L1[i] * l1 + L2[i] * l2 + L3[i] * l3;
+            }
+        }
+        for (; k < j; k++) {
+            L0 = L + k * n;
+            l0 = L0[j];
+            if (l0 == 0.) continue;
+            for (i = j; i < n; i++) Lj[i] -= L0[i] * l0;
+        }
+
+        d = Lj[j];
+        if (d <= 0.) {
+#ifdef PRINTING
+            c_eprint("Error in normal equations Cholesky factorization. The problem seems to be non-convex");
+#endif
+            return 1;
+        }
+        d = c_sqrt(d);
+        Lj[j] = d;
+        for (i = j + 1; i < n; i++) Lj[i] /= d;
+    }
+
+    return 0;
+}
+
+/**
+ * Solve L L' x = b in place
+ */
+static void chol_solve(const normal_solver *s, c_float *x) {
+    c_int i, j, n = s->n;
+    const c_float *L = s->L;
+    c_float xj;
+
+    // Forward substitution L y = b
+    for (j = 0; j < n; j++) {
+        xj    = x[j] / L[j + j * n];
+        x[j]  = xj;
+        for (i = j + 1; i < n; i++) x[i] -= L[i + j * n] * xj;
+    }
+
+    // Backward substitution L' x = y
+    for (j = n - 1; j >= 0; j--) {
+        xj = x[j];
+        for (i = j + 1; i < n; i++) xj -= L[i + j * n] * x[i];
+        x[j] = xj / L[j + j * n];
+    }
+}
+
+
+// Initialize factorization structure
+c_int init_linsys_solver_normal(normal_solver ** sp, const csc * P, const csc * A, c_float sigma, const c_float * rho_vec, c_int polish){
+    c_int i;
+    c_int n, m;
+
+    // Allocate private structure to store the factorization
+    normal_solver *s;
+    s = c_calloc(1, sizeof(normal_solver));
+    *sp = s;
+    if (!s) return OSQP_LINSYS_SOLVER_INIT_ERROR;
+
+    // Size of the reduced system
+    n = s->n = P->n;
+    m = s->m = A->m;
+
+    // Sigma parameter
+    s->sigma = sigma;
+
+    // Polishing flag
+    s->polish = polish;
+
+    // Link Functions
+    s->solve = &solve_linsys_normal;
+    s->solve_multi = &solve_multi_linsys_normal;
+    s->free = &free_linsys_solver_normal;
+    s->update_matrices = &update_linsys_solver_matrices_normal;
+    s->update_rho_vec = &update_linsys_solver_rho_vec_normal;
+    s->update_sigma = &update_linsys_solver_sigma_normal;
+
+    // Assign type
+    s->type = NORMAL_SOLVER;
+
+    // Set number of threads to 1 (single threaded)
+    s->nthreads = 1;
+
+    // Dense matrices and working vectors
+    s->A         = copy_csc_mat(A);
+    s->M0        = (c_float *)c_malloc(sizeof(c_float) * n * n);
+    s->L         = (c_float *)c_malloc(sizeof(c_float) * n * n);
+    s->rho_vec   = (c_float *)c_malloc(sizeof(c_float) * (m + 1));
+    s->rho_class = (c_int *)c_malloc(sizeof(c_int) * (m + 1));
+    s->sol       = (c_float *)c_malloc(sizeof(c_float) * (n + 1));
+    s->bz        = (c_float *)c_malloc(sizeof(c_float) * (m + 1));
+
+    if (!(s->A) || !(s->M0) || !(s->L) || !(s->rho_vec) || !(s->rho_class) ||
+        !(s->sol) || !(s->bz) || form_At(s)) {
+#ifdef PRINTING
+        c_eprint("Error forming normal equations matrix");
+#endif
+        free_linsys_solver_normal(s);
+        *sp = OSQP_NULL;
+        return OSQP_LINSYS_SOLVER_INIT_ERROR;
+    }
+
+    // Use dense products if all elements of A are stored
+    s->dense_A = mat_is_dense(s->A);
+
+    // Parameter vector. In polish the (2,2) block is -delta I.
+    for (i = 0; i < m; i++) {
+        s->rho_vec[i] = polish ? 1. / sigma : rho_vec[i];
+    }
+
+    // Store the products of the rows with the same rho to update rho cheaply
+    s->nclass = classify_rho(s, s->rho_vec);
+    if (s->nclass) {
+        s->G = (c_float *)c_malloc(sizeof(c_float) * s->nclass * n * n);
+        if (!(s->G)) s->nclass = 0;
+    }
+
+    form_M0(s, P);
+    form_G(s);
+
+    // Factorize the reduced matrix
+    if (factor(s)) {
+        free_linsys_solver_normal(s);
+        *sp = OSQP_NULL;
+        return OSQP_NONCVX_ERROR;
+    }
+
+    // No error
+    return 0;
+}
+
+
+// Returns solution to the linear system  Ax = b with solution stored in b
+c_int solve_linsys_normal(normal_solver * s, c_float * b) {
+    c_int i;
+    c_float *bx = b, *bz = b + s->n;
+
+    // x = M^{-1} (b_x + A' diag(rho) b_z)
+    vec_ew_prod(s->rho_vec, bz, s->bz, s->m);
+    prea_vec_copy(bx, s->sol, s->n);
+    if (s->dense_A) mat_tpose_vec_dense(s->A, s->bz, s->sol, 1);
+    else            mat_tpose_vec(s->A, s->bz, s->sol, 1, 0);
+    chol_solve(s, s->sol);
+
+    // A x
+    if (s->dense_A) mat_vec_dense(s->A, s->sol, s->bz, 0);
+    else            mat_vec(s->A, s->sol, s->bz, 0);
+
+    if (s->polish) {
+        /* nu = diag(rho) (A x - b_z) */
+        for (i = 0; i < s->m; i++) bz[i] = s->rho_vec[i] * (s->bz[i] - bz[i]);
+    } else {
+        /* z_tilde = b_z + diag(rho)^{-1} nu = A x */
+        prea_vec_copy(s->bz, bz, s->m);
+    }
+    prea_vec_copy(s->sol, bx, s->n);
+
+    return 0;
+}
+
+
+c_int solve_multi_linsys_normal(normal_solver * s, c_float * B, c_int nrhs) {
+    c_int i;
+
+    for (i = 0; i < nrhs; i++) solve_linsys_normal(s, B + i * (s->n + s->m));
+
+    return 0;
+}
+
+
+// Update private structure with new P and A
+c_int update_linsys_solver_matrices_normal(normal_solver * s, const csc *P, const csc *A) {
+    c_int ptr;
+
+    // Update copies of A and At with the new values
+    for (ptr = 0; ptr < A->p[A->n]; ptr++) {
+        s->A->x[ptr]             = A->x[ptr];
+        s->At->x[s->AtoAt[ptr]]  = A->x[ptr];
+    }
+
+    form_M0(s, P);
+    form_G(s);
+
+    return factor(s);
+}
+
+
+c_int update_linsys_solver_rho_vec_normal(normal_solver * s, const c_float * rho_vec){
+    c_int i, c, nclass, consistent;
+    c_float rho_class_val[NORMAL_MAX_RHO_CLASSES];
+
+    // Check whether the rho classes are preserved
+    consistent = (s->nclass > 0);
+    for (c = 0; c < s->nclass; c++) rho_class_val[c] = -1.;
+    for (i = 0; consistent && i < s->m; i++) {
+        c = s->rho_class[i];
+        if (rho_class_val[c] < 0.) rho_class_val[c] = rho_vec[i];
+        else if (rho_class_val[c] != rho_vec[i]) consistent = 0;
+    }
+
+    prea_vec_copy(rho_vec, s->rho_vec, s->m);
+
+    if (consistent) {
+        // Only rescale the stored products
+        for (c = 0; c < s->nclass; c++) s->rho_class_val[c] = rho_class_val[c];
+    } else if (s->G) {
+        // Regroup the constraints and form the products again
+        nclass = classify_rho(s, s->rho_vec);
+        if (nclass > s->nclass) {
+            c_free(s->G);
+            s->G = (c_float *)c_malloc(sizeof(c_float) * nclass * s->n * s->n);
+            if (!(s->G)) nclass = 0;
+        }
+        s->nclass = nclass;
+        form_G(s);
+    }
+
+    return factor(s);
+}
+
+
+c_int update_linsys_solver_sigma_normal(normal_solver * s, c_float sigma, const c_float * rho_vec){
+    c_int j;
+
+    // Shift the diagonal of P + sigma I
+    for (j = 0; j < s->n; j++) s->M0[j + j * s->n] += sigma - s->sigma;
+    s->sigma = sigma;
+
+    return update_linsys_solver_rho_vec_normal(s, rho_vec);
+}
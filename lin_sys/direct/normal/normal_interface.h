@@ -0,0 +1,146 @@
+#ifndef NORMAL_INTERFACE_H
+#define NORMAL_INTERFACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "types.h"
+
+/**
+ * Maximum number of distinct values in rho_vec for which the products
+ * A_c' A_c of the rows with the same rho are stored. With at most this many
+ * values a change of rho only rescales and sums the stored products.
+ */
+#define NORMAL_MAX_RHO_CLASSES (3)
+
+/**
+ * Normal equations solver structure
+ *
+ * The quasi-definite KKT system
+ *
+ *     [P + sigma I         A'       ] [x ]   [b_x]
+ *     [     A       -diag(rho)^{-1} ] [nu] = [b_z]
+ *
+ * is reduced to the n x n positive definite system
+ *
+ *     (P + sigma I + A' diag(rho) A) x = b_x + A' diag(rho) b_z
+ *
+ * that is factored with a dense Cholesky factorization. This is much cheaper
+ * than the sparse LDL factorization of the full KKT matrix when n << m.
+ */
+typedef struct normal normal_solver;
+
+struct normal {
+    enum linsys_solver_type type;
+
+    /**
+     * @name Functions
+     * @{
+     */
+    c_int (*solve)(struct normal * self, c_float * b);
+
+    c_int (*solve_multi)(struct normal * self, c_float * B, c_int nrhs); ///< Solve with several right-hand sides
+
+    void (*free)(struct normal * self); ///< Free workspace
+
+    c_int (*update_matrices)(struct normal * self, const csc *P, const csc *A);  ///< Update solver matrices
+    c_int (*update_rho_vec)(struct normal * self, const c_float * rho_vec);      ///< Update rho_vec parameter
+    c_int (*update_sigma)(struct normal * self, c_float sigma, const c_float * rho_vec); ///< Update sigma and rho_vec parameters
+
+    c_int nthreads;
+    /** @} */
+
+    /**
+     * @name Attributes
+     * @{
+     */
+    csc *A;                 ///< copy of the constraint matrix
+    csc *At;                ///< transpose of A (rows of A stored column-wise)
+    c_int *AtoAt;           ///< index of elements from A to At
+    c_float *M0;            ///< P + sigma I in dense form (lower triangle, column-major)
+    c_float *G;             ///< products A_c' A_c for each rho class (lower triangle, column-major)
+    c_float *L;             ///< dense Cholesky factor (lower triangle, column-major)
+    c_float *rho_vec;       ///< parameter vector
+    c_int *rho_class;       ///< rho class of each constraint
+    c_float rho_class_val[NORMAL_MAX_RHO_CLASSES]; ///< value of rho for each class
+    c_int nclass;           ///< number of rho classes (0 if there are too many values)
+    c_int dense_A;          ///< flag whether all elements of A are stored (dense products)
+    c_float *sol;           ///< solution to the reduced system
+    c_float *bz;            ///< workspace memory of size m for solves
+    c_float sigma;          ///< scalar parameter
+    c_int polish;           ///< polishing flag
+    c_int n;                ///< number of QP variables
+    c_int m;                ///< number of QP constraints
+    /** @} */
+};
+
+
+
+/**
+ * Initialize normal equations solver
+ *
+ * @param  s         Pointer to a private structure
+ * @param  P         Cost function matrix (upper triangular form)
+ * @param  A         Constraints matrix
+ * @param  sigma     Algorithm parameter. If polish, then sigma = delta.
+ * @param  rho_vec   Algorithm parameter. If polish, then rho_vec = OSQP_NULL.
+ * @param  polish    Flag whether we are initializing for polish or not
+ * @return           Exitflag for error (0 if no errors)
+ */
+c_int init_linsys_solver_normal(normal_solver ** sp, const csc * P, const csc * A, c_float sigma, const c_float * rho_vec, c_int polish);
+
+/**
+ * Solve linear system and store result in b
+ * @param  s        Linear system solver structure
+ * @param  b        Right-hand side
+ * @return          Exitflag
+ */
+c_int solve_linsys_normal(normal_solver * s, c_float * b);
+
+/**
+ * Solve linear system with several right-hand sides and store result in B
+ * @param  s        Linear system solver structure
+ * @param  B        Right-hand sides stored column-wise (size (n + m) x nrhs)
+ * @param  nrhs     Number of right-hand sides
+ * @return          Exitflag
+ */
+c_int solve_multi_linsys_normal(normal_solver * s, c_float * B, c_int nrhs);
+
+/**
+ * Update linear system solver matrices
+ * @param  s        Linear system solver structure
+ * @param  P        Matrix P
+ * @param  A        Matrix A
+ * @return          Exitflag
+ */
+c_int update_linsys_solver_matrices_normal(normal_solver * s, const csc *P, const csc *A);
+
+/**
+ * Update rho_vec parameter in linear system solver structure
+ * @param  s        Linear system solver structure
+ * @param  rho_vec  new rho_vec value
+ * @return          exitflag
+ */
+c_int update_linsys_solver_rho_vec_normal(normal_solver * s, const c_float * rho_vec);
+
+/**
+ * Update sigma and rho_vec parameters in linear system solver structure
+ * @param  s        Linear system solver structure
+ * @param  sigma    new sigma value
+ * @param  rho_vec  new rho_vec value
+ * @return          exitflag
+ */
+c_int update_linsys_solver_sigma_normal(normal_solver * s, c_float sigma, const c_float * rho_vec);
+
+/**
+ * Free linear system solver
+ * @param s linear system solver object
+ */
+void free_linsys_solver_normal(normal_solver * s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
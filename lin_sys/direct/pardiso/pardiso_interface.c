@@ -96,9 +96,11 @@ c_int init_linsys_solver_pardiso(pardiso_solver ** sp, const csc * P, const csc
 
     // Link Functions
     s->solve = &solve_linsys_pardiso;
+    s->solve_multi = &solve_multi_linsys_pardiso;
     s->free = &free_linsys_solver_pardiso;
     s->update_matrices = &update_linsys_solver_matrices_pardiso;
     s->update_rho_vec = &update_linsys_solver_rho_vec_pardiso;
+    s->update_sigma = &update_linsys_solver_sigma_pardiso;
 
     // Assign type
     s->type = MKL_PARDISO_SOLVER;
@@ -258,6 +260,52 @@ c_int solve_linsys_pardiso(pardiso_solver * s, c_float * b) {
     return 0;
 }
 
+// Returns solution to linear system  Ax = B with nrhs right-hand sides stored in B
+c_int solve_multi_linsys_pardiso(pardiso_solver * s, c_float * B, c_int nrhs) {
+    c_int i, j;
+    c_float *X, *x, *b;
+
+    if (nrhs == 1) return solve_linsys_pardiso(s, B);
+
+    // Pardiso needs a solution (or work) array as large as B
+    X = (c_float *)c_malloc(sizeof(c_float) * s->nKKT * nrhs);
+    if (!X) return 1;
+
+    // Back substitution for all right-hand sides at once
+    s->phase = PARDISO_SOLVE;
+    pardiso (s->pt, &(s->maxfct), &(s->mnum), &(s->mtype), &(s->phase),
+             &(s->nKKT), s->KKT->x, s->KKT_p, s->KKT_i, &(s->idum), &nrhs,
+             s->iparm, &(s->msglvl), B, X, &(s->error));
+    if ( s->error != 0 ){
+#ifdef PRINTING
+        c_eprint("Error during linear system solution: %d", (int)s->error);
+#endif
+        c_free(X);
+        return 1;
+    }
+
+    if (!(s->polish)) {
+        for (i = 0; i < nrhs; i++) {
+            b = B + i * s->nKKT;
+            x = X + i * s->nKKT;
+
+            /* copy x_tilde from x */
+            for (j = 0 ; j < s->n ; j++) {
+                b[j] = x[j];
+            }
+
+            /* compute z_tilde from b and x */
+            for (j = 0 ; j < s->m ; j++) {
+                b[j + s->n] += s->rho_inv_vec[j] * x[j + s->n];
+            }
+        }
+    }
+
+    c_free(X);
+
+    return 0;
+}
+
 // Update solver structure with new P and A
 c_int update_linsys_solver_matrices_pardiso(pardiso_solver * s, const csc *P, const csc *A) {
 
@@ -298,3 +346,16 @@ c_int update_linsys_solver_rho_vec_pardiso(pardiso_solver * s, const c_float * r
     // Return exit flag
     return s->error;
 }
+
+
+c_int update_linsys_solver_sigma_pardiso(pardiso_solver * s, c_float sigma, const c_float * rho_vec) {
+
+    // The KKT matrix of the polish solver has no mappings
+    if (s->polish) return 1;
+
+    // Shift the diagonal of the P block of the KKT matrix
+    update_KKT_param1(s->KKT, OSQP_NULL, s->n, sigma - s->sigma);
+    s->sigma = sigma;
+
+    return update_linsys_solver_rho_vec_pardiso(s, rho_vec);
+}
@@ -24,10 +24,13 @@ struct pardiso {
      */
     c_int (*solve)(struct pardiso * self, c_float * b);
 
+    c_int (*solve_multi)(struct pardiso * self, c_float * B, c_int nrhs); ///< Solve with several right-hand sides
+
     void (*free)(struct pardiso * self); ///< Free workspace (only if desktop)
 
     c_int (*update_matrices)(struct pardiso * self, const csc *P, const csc *A);    ///< Update solver matrices
     c_int (*update_rho_vec)(struct pardiso * self, const c_float * rho_vec);        ///< Update rho_vec parameter
+    c_int (*update_sigma)(struct pardiso * self, c_float sigma, const c_float * rho_vec); ///< Update sigma and rho_vec parameters
 
     c_int nthreads;
     /** @} */
@@ -95,6 +98,16 @@ c_int init_linsys_solver_pardiso(pardiso_solver ** sp, const csc * P, const csc
 c_int solve_linsys_pardiso(pardiso_solver * s, c_float * b);
 
 
+/**
+ * Solve linear system with several right-hand sides and store result in B
+ * @param  s        Linear system solver structure
+ * @param  B        Right-hand sides stored column-wise (size (n + m) x nrhs)
+ * @param  nrhs     Number of right-hand sides
+ * @return          Exitflag
+ */
+c_int solve_multi_linsys_pardiso(pardiso_solver * s, c_float * B, c_int nrhs);
+
+
 /**
  * Update linear system solver matrices
  * @param  s        Linear system solver structure
@@ -114,6 +127,16 @@ c_int update_linsys_solver_matrices_pardiso(pardiso_solver * s, const csc *P, co
 c_int update_linsys_solver_rho_vec_pardiso(pardiso_solver * s, const c_float * rho_vec);
 
 
+/**
+ * Update sigma and rho_vec parameters in linear system solver structure
+ * @param  s        Linear system solver structure
+ * @param  sigma    new sigma value
+ * @param  rho_vec  new rho_vec value
+ * @return          exitflag
+ */
+c_int update_linsys_solver_sigma_pardiso(pardiso_solver * s, c_float sigma, const c_float * rho_vec);
+
+
 /**
  * Free linear system solver
  * @param s linear system solver object
@@ -2,15 +2,20 @@
 
 #include "qdldl.h"
 #include "qdldl_interface.h"
+#include "probes.h"
 
 #ifndef EMBEDDED
-#include "amd.h"
+#include "qdldl_ordering.h"
 #endif
 
 #if EMBEDDED != 1
 #include "kkt.h"
 #endif
 
+#ifndef EMBEDDED
+#include "util.h"
+#endif
+
 #ifndef EMBEDDED
 
 // Free LDL Factorization structure
@@ -71,10 +76,12 @@ static c_int LDL_factor(csc *A,  qdldl_solver * p, c_int nvar){
     p->L->x = (c_float *)c_malloc(sizeof(c_float)*sum_Lnz);
 
     // Factor matrix
+    OSQP_PROBE2(factor_begin, A->n, sum_Lnz);
     factor_status = QDLDL_factor(A->n, A->p, A->i, A->x,
                                  p->L->p, p->L->i, p->L->x,
                                  p->D, p->Dinv, p->Lnz,
                                  p->etree, p->bwork, p->iwork, p->fwork);
+    OSQP_PROBE2(factor_end, A->n, factor_status);
 
 
     if (factor_status < 0){
@@ -96,27 +103,115 @@ static c_int LDL_factor(csc *A,  qdldl_solver * p, c_int nvar){
 }
 
 
-static c_int permute_KKT(csc ** KKT, qdldl_solver * p, c_int Pnz, c_int Anz, c_int m, c_int * PtoKKT, c_int * AtoKKT, c_int * rhotoKKT){
-    c_float *info;
-    c_int amd_status;
+/**
+ * Compute a stage-wise ordering of the KKT matrix. The rows are ordered by
+ * stage and each diagonal block of a stage is ordered with the given
+ * ordering. For banded multi-stage problems the factorization then proceeds
+ * stage by stage as in a Riccati recursion and the fill stays within adjacent
+ * stages.
+ * @param  KKT      KKT matrix (upper triangular)
+ * @param  stages   Stage of each row of the KKT matrix
+ * @param  ordering Ordering of the diagonal blocks
+ * @param  perm     Permutation vector (output)
+ * @return          Exitflag (negative if the ordering failed)
+ */
+static c_int stage_order(const csc * KKT, const c_int * stages, enum ordering_type ordering, c_int * perm){
+    c_int i, j, k, ptr, s, ns, nnz, off, status = 0;
+    c_int nstages = 0, n = KKT->n;
+    c_int *count, *idx, *local, *Sp, *Si, *Sperm;
+
+    for (i = 0; i < n; i++) nstages = c_max(nstages, stages[i] + 1);
+
+    count = (c_int *)c_calloc(nstages + 1, sizeof(c_int));
+    idx   = (c_int *)c_malloc(n * sizeof(c_int));
+    local = (c_int *)c_malloc(n * sizeof(c_int));
+    // Sp holds the nstages + 1 stage pointers, then the n + 1 column pointers
+    // of a block. The stage numbers may exceed n in reduced KKT matrices
+    Sp    = (c_int *)c_malloc((c_max(n, nstages) + 1) * sizeof(c_int));
+    Si    = (c_int *)c_malloc((KKT->p[n] + 1) * sizeof(c_int));
+    Sperm = (c_int *)c_malloc(n * sizeof(c_int));
+    if (!count || !idx || !local || !Sp || !Si || !Sperm) {
+        status = -1;
+        goto cleanup;
+    }
+
+    // Sort the rows by stage keeping their order within each stage
+    for (i = 0; i < n; i++) count[stages[i]]++;
+    csc_cumsum(Sp, count, nstages);
+    for (i = 0; i < n; i++) {
+        k        = count[stages[i]]++;
+        idx[k]   = i;
+        local[i] = k - Sp[stages[i]];
+    }
+    prea_int_vec_copy(Sp, count, nstages + 1);
+
+    // Order the diagonal block of each stage
+    for (s = 0; s < nstages; s++) {
+        off = count[s];
+        ns  = count[s + 1] - off;
+        if (ns == 0) continue;
+
+        // Stages of a single row, e.g. from a user ordering
+        if (ns == 1) {
+            perm[off] = idx[off];
+            continue;
+        }
+
+        nnz = 0;
+        for (k = 0; k < ns; k++) {
+            j     = idx[off + k];
+            Sp[k] = nnz;
+            for (ptr = KKT->p[j]; ptr < KKT->p[j + 1]; ptr++) {
+                if (stages[KKT->i[ptr]] == s) Si[nnz++] = local[KKT->i[ptr]];
+            }
+        }
+        Sp[ns] = nnz;
+
+        status = qdldl_order(ns, Sp, Si, ordering, Sperm);
+        if (status < 0) goto cleanup;
+
+        for (k = 0; k < ns; k++) perm[off + k] = idx[off + Sperm[k]];
+    }
+    status = 0;
+
+cleanup:
+    if (count) c_free(count);
+    if (idx)   c_free(idx);
+    if (local) c_free(local);
+    if (Sp)    c_free(Sp);
+    if (Si)    c_free(Si);
+    if (Sperm) c_free(Sperm);
+    return status;
+}
+
+/**
+ * Compute the fill-reducing permutation of the KKT matrix
+ * @param  KKT      KKT matrix (upper triangular)
+ * @param  stages   Stage of each row of the KKT matrix (OSQP_NULL if not given)
+ * @param  ordering Ordering of the whole matrix or of the diagonal blocks of
+ *                  the stages
+ * @param  perm     Permutation vector (output)
+ * @return          Exitflag (negative if the ordering failed)
+ */
+static c_int order_KKT(const csc * KKT, const c_int * stages, enum ordering_type ordering, c_int * perm){
+    if (stages) {
+        // Compute stage-wise permutation for multi-stage problems
+        return stage_order(KKT, stages, ordering, perm);
+    }
+    return qdldl_order(KKT->n, KKT->p, KKT->i, ordering, perm);
+}
+
+
+static c_int permute_KKT(csc ** KKT, qdldl_solver * p, c_int Pnz, c_int Anz, c_int m, c_int * PtoKKT, c_int * AtoKKT, c_int * rhotoKKT, const c_int * stages, enum ordering_type ordering){
+    c_int order_status;
     c_int * Pinv;
     csc *KKT_temp;
     c_int * KtoPKPt;
     c_int i; // Indexing
 
-    info = (c_float *)c_malloc(AMD_INFO * sizeof(c_float));
-
-    // Compute permutation matrix P using AMD
-#ifdef DLONG
-    amd_status = amd_l_order((*KKT)->n, (*KKT)->p, (*KKT)->i, p->P, (c_float *)OSQP_NULL, info);
-#else
-    amd_status = amd_order((*KKT)->n, (*KKT)->p, (*KKT)->i, p->P, (c_float *)OSQP_NULL, info);
-#endif
-    if (amd_status < 0) {
-        // Free Amd info and return an error
-        c_free(info);
-        return amd_status;
-    }
+    // Compute permutation matrix P
+    order_status = order_KKT(*KKT, stages, ordering, p->P);
+    if (order_status < 0) return order_status;
 
 
     // Inverse of the permutation vector
@@ -159,20 +254,84 @@ static c_int permute_KKT(csc ** KKT, qdldl_solver * p, c_int Pnz, c_int Anz, c_i
     (*KKT) = KKT_temp;
     // Free Pinv
     c_free(Pinv);
-    // Free Amd info
-    c_free(info);
 
     return 0;
 }
 
 
+c_int factor_stats_qdldl(qdldl_solver * s, OSQPFactorStats * stats){
+    c_int j, dim = s->n + s->m;
+    QDLDL_int *depth = s->iwork; // Free between the factorizations
+    c_float c;
+
+    stats->dim          = dim;
+    stats->nnz_KKT      = s->nnz_KKT;
+    stats->nnz_L        = s->L->p[dim];
+    stats->fill         = (c_float)(stats->nnz_L + dim) / (c_float)s->nnz_KKT;
+    stats->flops        = 0.0;
+    stats->etree_height = 0;
+
+    for (j = 0; j < dim; j++) {
+        // A column with c nonzeros below the diagonal takes c divisions and
+        // c (c + 1) / 2 multiply-adds
+        c = (c_float)s->Lnz[j];
+        stats->flops += c * (c + 2.);
+    }
+
+    // The parent of a node comes after it in the elimination tree (roots are -1)
+    for (j = dim - 1; j >= 0; j--) {
+        depth[j] = (s->etree[j] == -1) ? 1 : depth[s->etree[j]] + 1;
+        stats->etree_height = c_max(stats->etree_height, depth[j]);
+    }
+
+    return 0;
+}
+
+
+c_int kkt_fill_qdldl(const csc * P, const csc * A, const c_int * stages, enum ordering_type ordering){
+    c_int i, n = P->n + A->m, Lnnz = -1;
+    c_int *perm = OSQP_NULL, *Pinv = OSQP_NULL, *work = OSQP_NULL;
+    c_float *param2;
+    csc *KKT, *PKPt = OSQP_NULL;
+
+    // Only the sparsity pattern is used
+    param2 = (c_float *)c_malloc((A->m ? A->m : 1) * sizeof(c_float));
+    if (!param2) return -1;
+    for (i = 0; i < A->m; i++) param2[i] = 1.;
+    KKT = form_KKT(P, A, 0, 1., param2, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL);
+    c_free(param2);
+    if (!KKT) return -1;
+
+    perm = (c_int *)c_malloc(n * sizeof(c_int));
+    work = (c_int *)c_malloc(3 * n * sizeof(c_int));
+    if (perm && work && (order_KKT(KKT, stages, ordering, perm) >= 0)) {
+        Pinv = csc_pinv(perm, n);
+        if (Pinv) PKPt = csc_symperm(KKT, Pinv, OSQP_NULL, 0);
+        if (PKPt) Lnnz = QDLDL_etree(n, PKPt->p, PKPt->i, work, work + n, work + 2 * n);
+    }
+
+    csc_spfree(KKT);
+    csc_spfree(PKPt);
+    if (perm) c_free(perm);
+    if (Pinv) c_free(Pinv);
+    if (work) c_free(work);
+
+    return (Lnnz < 0) ? -1 : Lnnz;
+}
+
+
 // Initialize LDL Factorization structure
-c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A, c_float sigma, const c_float * rho_vec, c_int polish){
+c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A, c_float sigma, const c_float * rho_vec, c_int polish, const c_int * stages, enum ordering_type ordering, OSQPProfile * profile){
 
     // Define Variables
     csc * KKT_temp;     // Temporary KKT pointer
     c_int i;            // Loop counter
     c_int n_plus_m;     // Define n_plus_m dimension
+    c_int flag;         // Exitflag of the factorization
+
+#ifdef PROFILING
+    OSQPTimer timer;
+#endif
 
     // Allocate private structure to store KKT factorization
     qdldl_solver *s;
@@ -194,7 +353,9 @@ c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A,
     s->solve = &solve_linsys_qdldl;
 
 #ifndef EMBEDDED
+    s->solve_multi = &solve_multi_linsys_qdldl;
     s->free = &free_linsys_solver_qdldl;
+    s->update_sigma = &update_linsys_solver_sigma_qdldl;
 #endif
 
 #if EMBEDDED != 1
@@ -257,11 +418,17 @@ c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A,
             s->rho_inv_vec[i] = sigma;
         }
 
+        PROFILE_TIC(&timer);
         KKT_temp = form_KKT(P, A, 0, sigma, s->rho_inv_vec, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL);
+        PROFILE_TOC(profile, PROFILE_KKT_FORM, &timer);
 
         // Permute matrix
-        if (KKT_temp)
-            permute_KKT(&KKT_temp, s, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL);
+        PROFILE_TIC(&timer);
+        if (KKT_temp && (permute_KKT(&KKT_temp, s, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, OSQP_NULL, stages, ordering) < 0)) {
+            csc_spfree(KKT_temp);
+            KKT_temp = OSQP_NULL;
+        }
+        PROFILE_TOC(profile, PROFILE_ORDERING, &timer);
     }
     else { // Called from ADMM algorithm
 
@@ -275,13 +442,19 @@ c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A,
             s->rho_inv_vec[i] = 1. / rho_vec[i];
         }
 
+        PROFILE_TIC(&timer);
         KKT_temp = form_KKT(P, A, 0, sigma, s->rho_inv_vec,
                             s->PtoKKT, s->AtoKKT,
                             &(s->Pdiag_idx), &(s->Pdiag_n), s->rhotoKKT);
+        PROFILE_TOC(profile, PROFILE_KKT_FORM, &timer);
 
         // Permute matrix
-        if (KKT_temp)
-            permute_KKT(&KKT_temp, s, P->p[P->n], A->p[A->n], A->m, s->PtoKKT, s->AtoKKT, s->rhotoKKT);
+        PROFILE_TIC(&timer);
+        if (KKT_temp && (permute_KKT(&KKT_temp, s, P->p[P->n], A->p[A->n], A->m, s->PtoKKT, s->AtoKKT, s->rhotoKKT, stages, ordering) < 0)) {
+            csc_spfree(KKT_temp);
+            KKT_temp = OSQP_NULL;
+        }
+        PROFILE_TOC(profile, PROFILE_ORDERING, &timer);
     }
 
     // Check if matrix has been created
@@ -294,8 +467,14 @@ c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A,
         return OSQP_LINSYS_SOLVER_INIT_ERROR;
     }
 
+    // Number of nonzeros of the KKT matrix for the factorization statistics
+    s->nnz_KKT = KKT_temp->p[KKT_temp->n];
+
     // Factorize the KKT matrix
-    if (LDL_factor(KKT_temp, s, P->n) < 0) {
+    PROFILE_TIC(&timer);
+    flag = LDL_factor(KKT_temp, s, P->n);
+    PROFILE_TOC(profile, PROFILE_FACTOR, &timer);
+    if (flag < 0) {
         csc_spfree(KKT_temp);
         free_linsys_solver_qdldl(s);
         *sp = OSQP_NULL;
@@ -369,7 +548,107 @@ c_int solve_linsys_qdldl(qdldl_solver * s, c_float * b) {
 }
 
 
+#ifndef EMBEDDED
+
+// Number of right-hand sides processed together in solve_multi
+#define SOLVE_MULTI_BLOCK (8)
+
+static void LDLSolve_multi(c_float *W, c_int nb, const csc *L, const c_float *Dinv) {
+    /* solves LDL' X = W for nb right-hand sides stored row-wise in W */
+    c_int i, j, k, c;
+    c_float l, d;
+    c_float *wi, *wj;
+
+    // Solve L Y = W
+    for (j = 0; j < L->n; j++) {
+        wj = W + j * nb;
+        for (k = L->p[j]; k < L->p[j + 1]; k++) {
+            wi = W + L->i[k] * nb;
+            l  = L->x[k];
+            for (c = 0; c < nb; c++) wi[c] -= l * wj[c];
+        }
+    }
+
+    // Solve D Z = Y
+    for (i = 0; i < L->n; i++) {
+        wi = W + i * nb;
+        d  = Dinv[i];
+        for (c = 0; c < nb; c++) wi[c] *= d;
+    }
+
+    // Solve L' X = Z
+    for (j = L->n - 1; j >= 0; j--) {
+        wj = W + j * nb;
+        for (k = L->p[j]; k < L->p[j + 1]; k++) {
+            wi = W + L->i[k] * nb;
+            l  = L->x[k];
+            for (c = 0; c < nb; c++) wj[c] -= l * wi[c];
+        }
+    }
+}
+
+
+c_int solve_multi_linsys_qdldl(qdldl_solver * s, c_float * B, c_int nrhs) {
+    c_int i, j, c, nb, col;
+    c_int n_plus_m = s->n + s->m;
+    c_float *W, *b;
+
+    if (nrhs == 1) return solve_linsys_qdldl(s, B);
+
+    // Row-wise workspace for a block of right-hand sides so that each
+    // column of L is loaded once per block
+    nb = c_min(nrhs, SOLVE_MULTI_BLOCK);
+    W  = (c_float *)c_malloc(sizeof(c_float) * n_plus_m * nb);
+    if (!W) return 1;
+
+    for (col = 0; col < nrhs; col += nb) {
+        nb = c_min(nrhs - col, SOLVE_MULTI_BLOCK);
+
+        // Permute right-hand sides
+        for (c = 0; c < nb; c++) {
+            b = B + (col + c) * n_plus_m;
+            for (i = 0; i < n_plus_m; i++) W[i * nb + c] = b[s->P[i]];
+        }
+
+        LDLSolve_multi(W, nb, s->L, s->Dinv);
+
+        // Permute back and store solution
+        for (c = 0; c < nb; c++) {
+            b = B + (col + c) * n_plus_m;
+            if (s->polish) {
+                for (i = 0; i < n_plus_m; i++) b[s->P[i]] = W[i * nb + c];
+            } else {
+                /* store x_tilde and compute z_tilde from b and the solution */
+                for (i = 0; i < n_plus_m; i++) {
+                    j = s->P[i];
+                    if (j < s->n) b[j] = W[i * nb + c];
+                    else b[j] += s->rho_inv_vec[j - s->n] * W[i * nb + c];
+                }
+            }
+        }
+    }
+
+    c_free(W);
+
+    return 0;
+}
+
+#endif
+
 #if EMBEDDED != 1
+// Numeric factorization of the updated KKT matrix with the symbolic one of the setup
+static c_int refactor_KKT(qdldl_solver * s){
+    c_int factor_status;
+
+    OSQP_PROBE2(factor_begin, s->KKT->n, s->L->p[s->KKT->n]);
+    factor_status = QDLDL_factor(s->KKT->n, s->KKT->p, s->KKT->i, s->KKT->x,
+        s->L->p, s->L->i, s->L->x, s->D, s->Dinv, s->Lnz,
+        s->etree, s->bwork, s->iwork, s->fwork);
+    OSQP_PROBE2(factor_end, s->KKT->n, factor_status);
+
+    return factor_status;
+}
+
 // Update private structure with new P and A
 c_int update_linsys_solver_matrices_qdldl(qdldl_solver * s, const csc *P, const csc *A) {
 
@@ -379,9 +658,7 @@ c_int update_linsys_solver_matrices_qdldl(qdldl_solver * s, const csc *P, const
     // Update KKT matrix with new A
     update_KKT_A(s->KKT, A, s->AtoKKT);
 
-    return (QDLDL_factor(s->KKT->n, s->KKT->p, s->KKT->i, s->KKT->x,
-        s->L->p, s->L->i, s->L->x, s->D, s->Dinv, s->Lnz,
-        s->etree, s->bwork, s->iwork, s->fwork) < 0);
+    return (refactor_KKT(s) < 0);
 
 }
 
@@ -397,10 +674,29 @@ c_int update_linsys_solver_rho_vec_qdldl(qdldl_solver * s, const c_float * rho_v
     // Update KKT matrix with new rho_vec
     update_KKT_param2(s->KKT, s->rho_inv_vec, s->rhotoKKT, s->m);
 
-    return (QDLDL_factor(s->KKT->n, s->KKT->p, s->KKT->i, s->KKT->x,
-        s->L->p, s->L->i, s->L->x, s->D, s->Dinv, s->Lnz,
-        s->etree, s->bwork, s->iwork, s->fwork) < 0);
+    return (refactor_KKT(s) < 0);
+}
+
+#ifndef EMBEDDED
+c_int update_linsys_solver_sigma_qdldl(qdldl_solver * s, c_float sigma, const c_float * rho_vec){
+    c_int i;
+
+    // The KKT matrix is only kept by the solver of the ADMM iterations
+    if (!s->KKT || s->polish) return 1;
+
+    // Shift the diagonal of the P block of the permuted KKT matrix
+    update_KKT_param1(s->KKT, s->P, s->n, sigma - s->sigma);
+    s->sigma = sigma;
+
+    // Update internal rho_inv_vec
+    for (i = 0; i < s->m; i++){
+        s->rho_inv_vec[i] = 1. / rho_vec[i];
+    }
+    update_KKT_param2(s->KKT, s->rho_inv_vec, s->rhotoKKT, s->m);
+
+    return (refactor_KKT(s) < 0);
 }
+#endif
 
 
 #endif
@@ -23,6 +23,8 @@ struct qdldl {
     c_int (*solve)(struct qdldl * self, c_float * b);
 
 #ifndef EMBEDDED
+    c_int (*solve_multi)(struct qdldl * self, c_float * B, c_int nrhs); ///< Solve with several right-hand sides (only if desktop)
+
     void (*free)(struct qdldl * self); ///< Free workspace (only if desktop)
 #endif
 
@@ -33,6 +35,8 @@ struct qdldl {
 #endif
 
 #ifndef EMBEDDED
+    c_int (*update_sigma)(struct qdldl * self, c_float sigma, const c_float * rho_vec); ///< Update sigma and rho_vec parameters
+
     c_int nthreads;
 #endif
     /** @} */
@@ -50,6 +54,7 @@ struct qdldl {
     c_float sigma;          ///< scalar parameter
 #ifndef EMBEDDED
     c_int polish;           ///< polishing flag
+    c_int nnz_KKT;          ///< number of nonzeros of the permuted KKT matrix (upper triangular part)
 #endif
     c_int n;                ///< number of QP variables
     c_int m;                ///< number of QP constraints
@@ -84,9 +89,15 @@ struct qdldl {
  * @param  sigma     Algorithm parameter. If polish, then sigma = delta.
  * @param  rho_vec   Algorithm parameter. If polish, then rho_vec = OSQP_NULL.
  * @param  polish    Flag whether we are initializing for polish or not
+ * @param  stages    Stage of each variable and constraint for a stage-wise
+ *                   ordering of the KKT matrix (OSQP_NULL if not given)
+ * @param  ordering  Ordering of the KKT matrix, or of the diagonal blocks of
+ *                   the stages if given
+ * @param  profile   Profile of the forming, ordering and factorization of the
+ *                   KKT matrix (OSQP_NULL if not recorded)
  * @return           Exitflag for error (0 if no errors)
  */
-c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A, c_float sigma, const c_float * rho_vec, c_int polish);
+c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A, c_float sigma, const c_float * rho_vec, c_int polish, const c_int * stages, enum ordering_type ordering, OSQPProfile * profile);
 
 /**
  * Solve linear system and store result in b
@@ -97,6 +108,38 @@ c_int init_linsys_solver_qdldl(qdldl_solver ** sp, const csc * P, const csc * A,
 c_int solve_linsys_qdldl(qdldl_solver * s, c_float * b);
 
 
+#ifndef EMBEDDED
+/**
+ * Compute the number of nonzeros of the factor L of the KKT matrix for a
+ * given ordering without factoring it
+ * @param  P        Cost function matrix (upper triangular form)
+ * @param  A        Constraints matrix
+ * @param  stages   Stage of each variable and constraint (OSQP_NULL if not given)
+ * @param  ordering Ordering of the KKT matrix
+ * @return          Number of nonzeros in L (negative if failed)
+ */
+c_int kkt_fill_qdldl(const csc * P, const csc * A, const c_int * stages, enum ordering_type ordering);
+
+/**
+ * Compute the statistics of the factorization from the column counts of L and
+ * the elimination tree
+ * @param  s        Linear system solver structure
+ * @param  stats    Statistics of the factorization (output)
+ * @return          Exitflag
+ */
+c_int factor_stats_qdldl(qdldl_solver * s, OSQPFactorStats * stats);
+
+/**
+ * Solve linear system with several right-hand sides and store result in B
+ * @param  s        Linear system solver structure
+ * @param  B        Right-hand sides stored column-wise (size (n + m) x nrhs)
+ * @param  nrhs     Number of right-hand sides
+ * @return          Exitflag
+ */
+c_int solve_multi_linsys_qdldl(qdldl_solver * s, c_float * B, c_int nrhs);
+#endif
+
+
 #if EMBEDDED != 1
 /**
  * Update linear system solver matrices
@@ -120,6 +163,18 @@ c_int update_linsys_solver_rho_vec_qdldl(qdldl_solver * s, const c_float * rho_v
 
 #endif
 
+#ifndef EMBEDDED
+/**
+ * Update sigma and rho_vec parameters in linear system solver structure. The
+ * ordering and the symbolic factorization are kept.
+ * @param  s        Linear system solver structure
+ * @param  sigma    new sigma value
+ * @param  rho_vec  new rho_vec value
+ * @return          exitflag
+ */
+c_int update_linsys_solver_sigma_qdldl(qdldl_solver * s, c_float sigma, const c_float * rho_vec);
+#endif
+
 #ifndef EMBEDDED
 /**
  * Free linear system solver
@@ -0,0 +1,424 @@
+#include "glob_opts.h"
+#include "qdldl_ordering.h"
+#include "amd.h"
+
+
+/**
+ * Adjacency graph of a symmetric matrix without the diagonal, with
+ * workspaces for the breadth-first searches
+ */
+typedef struct {
+  c_int  n;       ///< number of nodes
+  c_int *p;       ///< start of the neighbors of each node in i (size n+1)
+  c_int *i;       ///< neighbors (size p[n])
+  c_int *label;   ///< part of each node, searches only visit nodes of one part
+  c_int *mark;    ///< visited flags of the searches, equal to stamp if visited
+  c_int  stamp;   ///< current search
+  c_int *level;   ///< level of each visited node
+  c_int *order;   ///< nodes in the order of the search
+  c_int *lev_ptr; ///< start of each level in order (size n+1)
+  c_int  nlev;    ///< number of levels of the last search
+} OrderGraph;
+
+
+/**
+ * Build the adjacency graph from the upper triangular part of the matrix.
+ * The arrays of g are allocated here.
+ */
+static c_int graph_init(OrderGraph *g, c_int n, const c_int *Ap, const c_int *Ai) {
+  c_int i, j, ptr, nnz = 0;
+
+  g->n     = n;
+  g->stamp = 0;
+  g->nlev  = 0;
+
+  for (j = 0; j < n; j++) {
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      if (Ai[ptr] != j) nnz += 2;
+    }
+  }
+
+  g->p       = c_calloc(n + 1, sizeof(c_int));
+  g->i       = c_malloc((nnz ? nnz : 1) * sizeof(c_int));
+  g->label   = c_calloc(n ? n : 1, sizeof(c_int));
+  g->mark    = c_malloc((n ? n : 1) * sizeof(c_int));
+  g->level   = c_malloc((n ? n : 1) * sizeof(c_int));
+  g->order   = c_malloc((n ? n : 1) * sizeof(c_int));
+  g->lev_ptr = c_malloc((n + 1) * sizeof(c_int));
+  if (!(g->p) || !(g->i) || !(g->label) || !(g->mark) || !(g->level) ||
+      !(g->order) || !(g->lev_ptr)) return -1;
+
+  // Count the neighbors of each node, then fill them using p as the next
+  // position of each node
+  for (j = 0; j < n; j++) {
+    g->mark[j] = -1;
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      i = Ai[ptr];
+      if (i != j) {
+        g->p[i + 1]++;
+        g->p[j + 1]++;
+      }
+    }
+  }
+  for (j = 0; j < n; j++) g->p[j + 1] += g->p[j];
+  for (j = 0; j < n; j++) {
+    for (ptr = Ap[j]; ptr < Ap[j + 1]; ptr++) {
+      i = Ai[ptr];
+      if (i != j) {
+        g->i[g->p[i]++] = j;
+        g->i[g->p[j]++] = i;
+      }
+    }
+  }
+  for (j = n; j > 0; j--) g->p[j] = g->p[j - 1];
+  g->p[0] = 0;
+
+  return 0;
+}
+
+static void graph_free(OrderGraph *g) {
+  c_free(g->p);
+  c_free(g->i);
+  c_free(g->label);
+  c_free(g->mark);
+  c_free(g->level);
+  c_free(g->order);
+  c_free(g->lev_ptr);
+}
+
+#define DEGREE(g, v) ((g)->p[(v) + 1] - (g)->p[(v)])
+
+/**
+ * Breadth-first search from root over the nodes with the label of root.
+ * The level structure is stored in g->order, g->lev_ptr, g->level and
+ * g->nlev.
+ * @return Number of visited nodes
+ */
+static c_int graph_bfs(OrderGraph *g, c_int root) {
+  c_int head, tail, v, w, ptr, lab = g->label[root];
+
+  g->stamp++;
+  g->mark[root]  = g->stamp;
+  g->level[root] = 0;
+  g->order[0]    = root;
+
+  for (head = 0, tail = 1; head < tail; head++) {
+    v = g->order[head];
+    for (ptr = g->p[v]; ptr < g->p[v + 1]; ptr++) {
+      w = g->i[ptr];
+      if ((g->label[w] == lab) && (g->mark[w] != g->stamp)) {
+        g->mark[w]       = g->stamp;
+        g->level[w]      = g->level[v] + 1;
+        g->order[tail++] = w;
+      }
+    }
+  }
+
+  // The levels are nondecreasing in the order of the search
+  g->nlev = 0;
+  for (head = 0; head < tail; head++) {
+    if ((head == 0) ||
+        (g->level[g->order[head]] != g->level[g->order[head - 1]])) {
+      g->lev_ptr[g->nlev++] = head;
+    }
+  }
+  g->lev_ptr[g->nlev] = tail;
+
+  return tail;
+}
+
+/**
+ * Find a pseudo-peripheral node of the component of root (George-Liu) and
+ * leave the level structure from it in g
+ * @return Number of nodes of the component
+ */
+static c_int graph_peripheral(OrderGraph *g, c_int root) {
+  c_int k, v, x, nlev, cnt;
+
+  cnt  = graph_bfs(g, root);
+  nlev = g->nlev;
+
+  for (;;) {
+    // Node of minimum degree in the last level
+    x = g->order[g->lev_ptr[nlev - 1]];
+    for (k = g->lev_ptr[nlev - 1]; k < g->lev_ptr[nlev]; k++) {
+      v = g->order[k];
+      if (DEGREE(g, v) < DEGREE(g, x)) x = v;
+    }
+    if (x == root) break;
+
+    graph_bfs(g, x);
+    if (g->nlev <= nlev) {
+      graph_bfs(g, root);
+      break;
+    }
+    root = x;
+    nlev = g->nlev;
+  }
+
+  return cnt;
+}
+
+/**
+ * Sort nodes by increasing degree (Shell sort)
+ */
+static void sort_by_degree(const OrderGraph *g, c_int *v, c_int len) {
+  c_int gap, k, j, t;
+
+  for (gap = len / 2; gap > 0; gap /= 2) {
+    for (k = gap; k < len; k++) {
+      t = v[k];
+      for (j = k; (j >= gap) && (DEGREE(g, v[j - gap]) > DEGREE(g, t)); j -= gap) {
+        v[j] = v[j - gap];
+      }
+      v[j] = t;
+    }
+  }
+}
+
+/**
+ * Reverse Cuthill-McKee ordering. Each component is searched from a
+ * pseudo-peripheral node, visiting the neighbors of each node by increasing
+ * degree.
+ */
+static void rcm_order(OrderGraph *g, c_int *perm) {
+  c_int start, root, head, tail, v, w, ptr, first, k, t;
+
+  tail = 0;
+  for (start = 0; start < g->n; start++) {
+    if (g->label[start] < 0) continue;
+
+    graph_peripheral(g, start);
+    root = g->order[0];
+
+    // Cuthill-McKee search of the component. Visited nodes get label -1.
+    g->label[root] = -1;
+    perm[tail++]   = root;
+    for (head = tail - 1; head < tail; head++) {
+      v     = perm[head];
+      first = tail;
+      for (ptr = g->p[v]; ptr < g->p[v + 1]; ptr++) {
+        w = g->i[ptr];
+        if (g->label[w] >= 0) {
+          g->label[w]  = -1;
+          perm[tail++] = w;
+        }
+      }
+      sort_by_degree(g, perm + first, tail - first);
+    }
+  }
+
+  // Reverse the order
+  for (k = 0; k < g->n / 2; k++) {
+    t                  = perm[k];
+    perm[k]            = perm[g->n - 1 - k];
+    perm[g->n - 1 - k] = t;
+  }
+}
+
+/**
+ * Order the part perm[s..s+len) of the graph, whose nodes have label lab,
+ * with AMD. loc, Sp, Si and Sperm are workspaces.
+ */
+static c_int amd_part(OrderGraph *g, c_int *perm, c_int s, c_int len, c_int lab,
+                      c_int *loc, c_int *Sp, c_int *Si, c_int *Sperm) {
+  c_int k, v, w, ptr, nnz = 0, status;
+
+  for (k = 0; k < len; k++) loc[perm[s + k]] = k;
+
+  for (k = 0; k < len; k++) {
+    v     = perm[s + k];
+    Sp[k] = nnz;
+    for (ptr = g->p[v]; ptr < g->p[v + 1]; ptr++) {
+      w = g->i[ptr];
+      if (g->label[w] == lab) Si[nnz++] = loc[w];
+    }
+  }
+  Sp[len] = nnz;
+
+#ifdef DLONG
+  status = amd_l_order(len, Sp, Si, Sperm, (c_float *)OSQP_NULL, (c_float *)OSQP_NULL);
+#else
+  status = amd_order(len, Sp, Si, Sperm, (c_float *)OSQP_NULL, (c_float *)OSQP_NULL);
+#endif
+  if (status < 0) return status;
+
+  // loc holds the nodes in their new order
+  for (k = 0; k < len; k++) loc[k] = perm[s + Sperm[k]];
+  for (k = 0; k < len; k++) perm[s + k] = loc[k];
+
+  return 0;
+}
+
+/**
+ * Nested dissection ordering. Each part is split by the smallest level of the
+ * level structure from a pseudo-peripheral node that leaves at least a
+ * quarter of the nodes on each side. The separator nodes with no neighbor in
+ * the next level are moved to the first side. The two sides are ordered
+ * before the separator.
+ */
+static c_int nd_order(OrderGraph *g, c_int *perm) {
+  c_int k, v, w, ptr, s, len, lab, cnt, sep, na, nb, ns, nlab, top, status = 0;
+  c_int *stack, *tmp, *Sp, *Si, *Sperm;
+
+  stack = c_malloc((3 * g->n + 3) * sizeof(c_int));
+  tmp   = c_malloc((g->n ? g->n : 1) * sizeof(c_int));
+  Sp    = c_malloc((g->n + 1) * sizeof(c_int));
+  Si    = c_malloc((g->p[g->n] ? g->p[g->n] : 1) * sizeof(c_int));
+  Sperm = c_malloc((g->n ? g->n : 1) * sizeof(c_int));
+  if (!stack || !tmp || !Sp || !Si || !Sperm) {
+    status = -1;
+    goto cleanup;
+  }
+
+  for (k = 0; k < g->n; k++) perm[k] = k;
+
+  // Stack of parts (start in perm, length, label)
+  top      = 0;
+  nlab     = 1;
+  stack[0] = 0;
+  stack[1] = g->n;
+  stack[2] = 0;
+  if (g->n) top = 1;
+
+  while (top > 0) {
+    top--;
+    s   = stack[3 * top];
+    len = stack[3 * top + 1];
+    lab = stack[3 * top + 2];
+
+    if (len <= ND_LEAF_SIZE) {
+      status = amd_part(g, perm, s, len, lab, tmp, Sp, Si, Sperm);
+      if (status < 0) goto cleanup;
+      continue;
+    }
+
+    cnt = graph_peripheral(g, perm[s]);
+
+    if (cnt < len) {
+      // Disconnected part: split off the component of perm[s]
+      na = 0;
+      nb = cnt;
+      for (k = 0; k < len; k++) {
+        v = perm[s + k];
+        if (g->mark[v] == g->stamp) {
+          tmp[na++]   = v;
+          g->label[v] = nlab;
+        } else {
+          tmp[nb++]   = v;
+          g->label[v] = nlab + 1;
+        }
+      }
+      for (k = 0; k < len; k++) perm[s + k] = tmp[k];
+      stack[3 * top]     = s;
+      stack[3 * top + 1] = cnt;
+      stack[3 * top + 2] = nlab;
+      top++;
+      stack[3 * top]     = s + cnt;
+      stack[3 * top + 1] = len - cnt;
+      stack[3 * top + 2] = nlab + 1;
+      top++;
+      nlab += 2;
+      continue;
+    }
+
+    // Smallest level with at least a quarter of the nodes on each side
+    sep = -1;
+    for (k = 1; k < g->nlev - 1; k++) {
+      if ((4 * g->lev_ptr[k] >= len) && (4 * (len - g->lev_ptr[k + 1]) >= len) &&
+          ((sep < 0) ||
+           (g->lev_ptr[k + 1] - g->lev_ptr[k] < g->lev_ptr[sep + 1] - g->lev_ptr[sep]))) {
+        sep = k;
+      }
+    }
+    if (sep < 0) {
+      // No balanced separator, e.g. for a dense part
+      status = amd_part(g, perm, s, len, lab, tmp, Sp, Si, Sperm);
+      if (status < 0) goto cleanup;
+      continue;
+    }
+
+    // First side, second side and separator
+    na = nb = ns = 0;
+    for (k = 0; k < len; k++) {
+      v = g->order[k];
+      if (g->level[v] < sep) {
+        tmp[na++] = v;
+      } else if (g->level[v] > sep) {
+        perm[s + nb++] = v;
+      }
+    }
+    for (k = g->lev_ptr[sep]; k < g->lev_ptr[sep + 1]; k++) {
+      v = g->order[k];
+      for (ptr = g->p[v]; ptr < g->p[v + 1]; ptr++) {
+        w = g->i[ptr];
+        if ((g->label[w] == lab) && (g->mark[w] == g->stamp) &&
+            (g->level[w] == sep + 1)) break;
+      }
+      if (ptr == g->p[v + 1]) tmp[na++] = v;
+      else Sperm[ns++] = v;
+    }
+
+    // Write the part as [first side, second side, separator]
+    for (k = nb - 1; k >= 0; k--) perm[s + na + k] = perm[s + k];
+    for (k = 0; k < na; k++) {
+      perm[s + k]      = tmp[k];
+      g->label[tmp[k]] = nlab;
+    }
+    for (k = 0; k < nb; k++) g->label[perm[s + na + k]] = nlab + 1;
+    for (k = 0; k < ns; k++) {
+      perm[s + na + nb + k] = Sperm[k];
+      g->label[Sperm[k]]    = -1;
+    }
+
+    if (na) {
+      stack[3 * top]     = s;
+      stack[3 * top + 1] = na;
+      stack[3 * top + 2] = nlab;
+      top++;
+    }
+    if (nb) {
+      stack[3 * top]     = s + na;
+      stack[3 * top + 1] = nb;
+      stack[3 * top + 2] = nlab + 1;
+      top++;
+    }
+    nlab += 2;
+  }
+
+cleanup:
+  c_free(stack);
+  c_free(tmp);
+  c_free(Sp);
+  c_free(Si);
+  c_free(Sperm);
+
+  return status;
+}
+
+
+c_int qdldl_order(c_int n, const c_int *Ap, const c_int *Ai,
+                  enum ordering_type ordering, c_int *perm) {
+  c_int status = 0;
+  OrderGraph g;
+
+  if ((ordering != RCM_ORDERING) && (ordering != ND_ORDERING)) {
+#ifdef DLONG
+    status = amd_l_order(n, Ap, Ai, perm, (c_float *)OSQP_NULL, (c_float *)OSQP_NULL);
+#else
+    status = amd_order(n, Ap, Ai, perm, (c_float *)OSQP_NULL, (c_float *)OSQP_NULL);
+#endif
+    return (status < 0) ? status : 0;
+  }
+
+  if (graph_init(&g, n, Ap, Ai)) {
+    status = -1;
+  } else if (ordering == RCM_ORDERING) {
+    rcm_order(&g, perm);
+  } else {
+    status = nd_order(&g, perm);
+  }
+  graph_free(&g);
+
+  return status;
+}
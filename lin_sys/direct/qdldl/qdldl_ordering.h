@@ -0,0 +1,37 @@
+#ifndef QDLDL_ORDERING_H
+#define QDLDL_ORDERING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "types.h"
+
+/**
+ * Compute a fill-reducing ordering of a symmetric matrix.
+ *
+ * AMD_ORDERING uses the bundled AMD. RCM_ORDERING uses reverse Cuthill-McKee
+ * started from pseudo-peripheral nodes, which reduces the profile of the
+ * matrix. ND_ORDERING uses nested dissection: the graph is split recursively
+ * by separators taken from the level structure of a breadth-first search and
+ * the parts are ordered before their separator. Parts with at most
+ * ND_LEAF_SIZE nodes are ordered with AMD.
+ *
+ * @param  n        Dimension of the matrix
+ * @param  Ap       Column pointers of the upper triangular part (size n+1)
+ * @param  Ai       Row indices of the upper triangular part
+ * @param  ordering Ordering type (USER_ORDERING is not computed here)
+ * @param  perm     Permutation vector (output): perm[k] is the row in position k
+ * @return          Exitflag (negative if the ordering failed)
+ */
+c_int qdldl_order(c_int              n,
+                  const c_int       *Ap,
+                  const c_int       *Ai,
+                  enum ordering_type ordering,
+                  c_int             *perm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ifndef QDLDL_ORDERING_H
@@ -0,0 +1,121 @@
+#include "lib_handler.h"
+#include "plugin_loader.h"
+#include "linsys_plugin.h"
+
+#include "glob_opts.h"
+#include "constants.h"
+
+typedef void (*voidfun)(void);
+
+voidfun lh_load_sym (soHandle_t h, const char *symName);
+
+
+// Handlers are static variables. A single plugin can be loaded at a time
+// and it is shared among workspaces.
+static soHandle_t Plugin_handle = OSQP_NULL;
+static c_int Plugin_refs = 0;
+static osqp_linsys_plugin_init_t func_plugin_init = OSQP_NULL;
+
+
+c_int lh_load_plugin(const char* libname) {
+    soHandle_t h;
+    osqp_linsys_plugin_abi_t func_abi;
+    c_int abi;
+
+    h = lh_load_lib(libname);
+    if (!h) return 1;
+
+    // Same plugin already loaded by another workspace
+    if (Plugin_handle) {
+        if (h != Plugin_handle) {
+#ifdef PRINTING
+            c_eprint("A different linear system solver plugin is already loaded");
+#endif
+            lh_unload_lib(h);
+            return 1;
+        }
+        Plugin_refs++;
+        return 0;
+    }
+
+    // Check that the plugin has been built for this version of the interface
+    func_abi = (osqp_linsys_plugin_abi_t)lh_load_sym(h, OSQP_LINSYS_PLUGIN_ABI_SYMBOL);
+    if (!func_abi) {
+        lh_unload_lib(h);
+        return 1;
+    }
+    abi = func_abi();
+    if (abi != OSQP_LINSYS_PLUGIN_ABI) {
+#ifdef PRINTING
+        c_eprint("Plugin %s built for ABI %i, expected %i", libname,
+                 (int)abi, (int)OSQP_LINSYS_PLUGIN_ABI);
+#endif
+        lh_unload_lib(h);
+        return 1;
+    }
+
+    func_plugin_init = (osqp_linsys_plugin_init_t)lh_load_sym(h, OSQP_LINSYS_PLUGIN_INIT_SYMBOL);
+    if (!func_plugin_init) {
+        lh_unload_lib(h);
+        return 1;
+    }
+
+    Plugin_handle = h;
+    Plugin_refs   = 1;
+
+    return 0;
+}
+
+c_int lh_unload_plugin() {
+    c_int rc;
+
+    if (Plugin_handle == OSQP_NULL) return 0;
+
+    rc = lh_unload_lib(Plugin_handle);
+
+    // Forget the handlers only when no workspace uses the plugin
+    if (--Plugin_refs == 0) {
+        Plugin_handle    = OSQP_NULL;
+        func_plugin_init = OSQP_NULL;
+    }
+
+    return rc;
+}
+
+c_int init_linsys_solver_plugin(LinSysSolver  **s,
+                                const csc      *P,
+                                const csc      *A,
+                                c_float         sigma,
+                                const c_float  *rho_vec,
+                                c_int           polish) {
+    c_int exitflag;
+
+    if (!func_plugin_init) {
+#ifdef PRINTING
+        c_eprint("Linear system solver plugin not loaded");
+#endif
+        *s = OSQP_NULL;
+        return OSQP_LINSYS_SOLVER_INIT_ERROR;
+    }
+
+    exitflag = func_plugin_init(s, P, A, sigma, rho_vec, polish);
+    if (exitflag) {
+        *s = OSQP_NULL;
+        return exitflag;
+    }
+
+    // All the functions are required
+    if (!(*s) || !(*s)->solve || !(*s)->solve_multi || !(*s)->free ||
+        !(*s)->update_matrices || !(*s)->update_rho_vec) {
+#ifdef PRINTING
+        c_eprint("Linear system solver plugin does not define all the functions");
+#endif
+        if (*s && (*s)->free) (*s)->free(*s);
+        *s = OSQP_NULL;
+        return OSQP_LINSYS_SOLVER_INIT_ERROR;
+    }
+
+    (*s)->type = PLUGIN_SOLVER;
+
+    return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef PLUGINLOADER_H
+#define PLUGINLOADER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "types.h"
+
+
+/**
+ * Tries to load a linear system solver plugin.
+ * Return a failure if the library cannot be loaded, it does not export the
+ * plugin symbols, it was built for a different plugin ABI or a different
+ * plugin is already loaded.
+ * @param libname The name under which the plugin can be found.
+ * @return Zero on success, nonzero on failure.
+ */
+c_int lh_load_plugin(const char* libname);
+
+/**
+ * Unloads the loaded plugin. The library is closed when it is no longer used
+ * by any workspace.
+ * @return Zero on success, nonzero on failure.
+ */
+c_int lh_unload_plugin();
+
+/**
+ * Initialize the linear system solver of the loaded plugin and check that
+ * all its functions are linked.
+ * Arguments are the same as in init_linsys_solver.
+ * @return Exitflag for error (0 if no errors)
+ */
+c_int init_linsys_solver_plugin(LinSysSolver  **s,
+                                const csc      *P,
+                                const csc      *A,
+                                c_float         sigma,
+                                const c_float  *rho_vec,
+                                c_int           polish);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*PLUGINLOADER_H*/
@@ -5,30 +5,45 @@
 #include "constants.h"
 #include "scaling.h"
 #include "util.h"
+#include "probes.h"
+
+#ifndef EMBEDDED
+# include "presolve.h"
+#endif /* ifndef EMBEDDED */
 
 /***********************************************************
 * Auxiliary functions needed to compute ADMM iterations * *
 ***********************************************************/
 #if EMBEDDED != 1
 c_float compute_rho_estimate(OSQPWorkspace *work) {
-  c_int   n, m;                       // Dimensions
+  c_int   n, m, m_bnd;                // Dimensions
   c_float pri_res, dua_res;           // Primal and dual residuals
   c_float pri_res_norm, dua_res_norm; // Normalization for the residuals
   c_float temp_res_norm;              // Temporary residual norm
   c_float rho_estimate;               // Rho estimate value
 
   // Get problem dimensions
-  n = work->data->n;
-  m = work->data->m;
+  n     = work->data->n;
+  m     = work->data->m;
+  m_bnd = m;
+#ifndef EMBEDDED
+  m_bnd += work->n_bnd; // z and y include the variable bounds
+#endif /* ifndef EMBEDDED */
 
   // Get primal and dual residuals
-  pri_res = vec_norm_inf(work->z_prev, m);
+  pri_res = vec_norm_inf(work->z_prev, m_bnd);
   dua_res = vec_norm_inf(work->x_prev, n);
 
   // Normalize primal residual
-  pri_res_norm  = vec_norm_inf(work->z, m);           // ||z||
+  pri_res_norm  = vec_norm_inf(work->z, m_bnd);       // ||z||
   temp_res_norm = vec_norm_inf(work->Ax, m);          // ||Ax||
   pri_res_norm  = c_max(pri_res_norm, temp_res_norm); // max (||z||,||Ax||)
+#ifndef EMBEDDED
+  if (work->n_bnd) {
+    temp_res_norm = vec_norm_inf(work->x, n);         // ||x|| (bounds rows)
+    pri_res_norm  = c_max(pri_res_norm, temp_res_norm);
+  }
+#endif /* ifndef EMBEDDED */
   pri_res      /= (pri_res_norm + 1e-10);             // Normalize primal
                                                       // residual (prevent 0
                                                       // division)
@@ -57,8 +72,13 @@ c_float compute_rho_estimate(OSQPWorkspace *work) {
 c_int adapt_rho(OSQPWorkspace *work) {
   c_int   exitflag; // Exitflag
   c_float rho_new;  // New rho value
+# ifdef PROFILING
+  OSQPTimer timer;  // Timer of the profile
+# endif /* ifdef PROFILING */
 
   exitflag = 0;     // Initialize exitflag to 0
+  PROFILE_TIC(&timer);
+  OSQP_PROBE2(rho_update_begin, work->info->iter, work->info->rho_updates);
 
   // Compute new rho
   rho_new = compute_rho_estimate(work);
@@ -73,6 +93,8 @@ c_int adapt_rho(OSQPWorkspace *work) {
     work->info->rho_updates += 1;
   }
 
+  OSQP_PROBE2(rho_update_end, work->info->iter, work->info->rho_updates);
+  PROFILE_TOC(&work->info->profile, PROFILE_RHO_UPDATE, &timer);
   return exitflag;
 }
 
@@ -98,6 +120,11 @@ void set_rho_vec(OSQPWorkspace *work) {
     }
     work->rho_inv_vec[i] = 1. / work->rho_vec[i];
   }
+
+#ifndef EMBEDDED
+  // Variable bounds
+  if (work->n_bnd) work->rho_bnd = work->settings->rho;
+#endif /* ifndef EMBEDDED */
 }
 
 c_int update_rho_vec(OSQPWorkspace *work) {
@@ -156,9 +183,15 @@ void swap_vectors(c_float **a, c_float **b) {
 }
 
 void cold_start(OSQPWorkspace *work) {
+  c_int m_bnd = work->data->m;
+
+#ifndef EMBEDDED
+  m_bnd += work->n_bnd;
+#endif /* ifndef EMBEDDED */
+
   vec_set_scalar(work->x, 0., work->data->n);
-  vec_set_scalar(work->z, 0., work->data->m);
-  vec_set_scalar(work->y, 0., work->data->m);
+  vec_set_scalar(work->z, 0., m_bnd);
+  vec_set_scalar(work->y, 0., m_bnd);
 }
 
 static void compute_rhs(OSQPWorkspace *work) {
@@ -170,6 +203,15 @@ static void compute_rhs(OSQPWorkspace *work) {
                         work->data->q[i];
   }
 
+#ifndef EMBEDDED
+  // Variable bounds are the constraint rows I x, whose rho_bnd * I term is in
+  // the KKT matrix
+  for (i = 0; i < work->n_bnd; i++) {
+    work->xz_tilde[i] += work->rho_bnd * work->z_prev[work->data->m + i] -
+                         work->y[work->data->m + i];
+  }
+#endif /* ifndef EMBEDDED */
+
   for (i = 0; i < work->data->m; i++) {
     // Cycle over dual variable in the first step (nu)
     work->xz_tilde[i + work->data->n] = work->z_prev[i] - work->rho_inv_vec[i] *
@@ -178,11 +220,17 @@ static void compute_rhs(OSQPWorkspace *work) {
 }
 
 void update_xz_tilde(OSQPWorkspace *work) {
+#ifdef PROFILE_ITERATIONS
+  OSQPTimer timer;
+#endif /* ifdef PROFILE_ITERATIONS */
+
   // Compute right-hand side
   compute_rhs(work);
 
   // Solve linear system
+  PROFILE_ITER_TIC(&timer);
   work->linsys_solver->solve(work->linsys_solver, work->xz_tilde);
+  PROFILE_ITER_TOC(&work->info->profile, PROFILE_LINSYS_SOLVE, &timer);
 }
 
 void update_x(OSQPWorkspace *work) {
@@ -202,6 +250,12 @@ void update_x(OSQPWorkspace *work) {
 
 void update_z(OSQPWorkspace *work) {
   c_int i;
+#ifndef EMBEDDED
+  c_int j;
+#endif /* ifndef EMBEDDED */
+#ifdef PROFILE_ITERATIONS
+  OSQPTimer timer;
+#endif /* ifdef PROFILE_ITERATIONS */
 
   // update z
   for (i = 0; i < work->data->m; i++) {
@@ -211,11 +265,29 @@ void update_z(OSQPWorkspace *work) {
   }
 
   // project z
+  PROFILE_ITER_TIC(&timer);
   project(work, work->z);
+
+#ifndef EMBEDDED
+  // update and project the splitting variables of the variable bounds. Their
+  // x tilde is the one of the variables.
+  for (i = 0; i < work->n_bnd; i++) {
+    j          = work->data->m + i;
+    work->z[j] = c_min(c_max(work->settings->alpha * work->xz_tilde[i] +
+                             ((c_float)1.0 - work->settings->alpha) * work->z_prev[j] +
+                             work->y[j] / work->rho_bnd,
+                             work->data->lb[i]),
+                       work->data->ub[i]);
+  }
+#endif /* ifndef EMBEDDED */
+  PROFILE_ITER_TOC(&work->info->profile, PROFILE_PROJECTION, &timer);
 }
 
 void update_y(OSQPWorkspace *work) {
   c_int i; // Index
+#ifndef EMBEDDED
+  c_int j;
+#endif /* ifndef EMBEDDED */
 
   for (i = 0; i < work->data->m; i++) {
     work->delta_y[i] = work->rho_vec[i] *
@@ -225,6 +297,18 @@ void update_y(OSQPWorkspace *work) {
                         work->z[i]);
     work->y[i] += work->delta_y[i];
   }
+
+#ifndef EMBEDDED
+  // Multipliers of the variable bounds
+  for (i = 0; i < work->n_bnd; i++) {
+    j                = work->data->m + i;
+    work->delta_y[j] = work->rho_bnd *
+                       (work->settings->alpha * work->xz_tilde[i] +
+                        ((c_float)1.0 - work->settings->alpha) * work->z_prev[j] -
+                        work->z[j]);
+    work->y[j] += work->delta_y[j];
+  }
+#endif /* ifndef EMBEDDED */
 }
 
 c_float compute_obj_val(OSQPWorkspace *work, c_float *x) {
@@ -237,23 +321,97 @@ c_float compute_obj_val(OSQPWorkspace *work, c_float *x) {
     obj_val *= work->scaling->cinv;
   }
 
+#ifndef EMBEDDED
+  // Objective value of the variables fixed by presolve
+  if (work->presolve) obj_val += work->presolve->obj_offset;
+#endif /* ifndef EMBEDDED */
+
   return obj_val;
 }
 
+/**
+ * Matrix-vector products with the problem data. Densely stored matrices use
+ * the dense kernels without index indirection and A uses the block kernels
+ * if it has a block compressed-row copy.
+ */
+static void data_A_vec(OSQPWorkspace *work, const c_float *x, c_float *y) {
+#ifndef EMBEDDED
+  if (work->dense_data) {
+    mat_vec_dense(work->data->A, x, y, 0);
+    return;
+  }
+  if (work->A_bsr) {
+    bsr_mat_vec(work->A_bsr, x, y, 0);
+    return;
+  }
+#endif
+  mat_vec(work->data->A, x, y, 0);
+}
+
+static void data_At_vec(OSQPWorkspace *work, const c_float *x, c_float *y) {
+#ifndef EMBEDDED
+  if (work->dense_data) {
+    mat_tpose_vec_dense(work->data->A, x, y, 0);
+    return;
+  }
+  if (work->A_bsr) {
+    bsr_mat_tpose_vec(work->A_bsr, x, y, 0);
+    return;
+  }
+#endif
+  mat_tpose_vec(work->data->A, x, y, 0, 0);
+}
+
+static void data_P_vec(OSQPWorkspace *work, const c_float *x, c_float *y) {
+#ifndef EMBEDDED
+  if (work->dense_data) {
+    mat_vec_dense_sym_triu(work->data->P, x, y);
+    return;
+  }
+#endif
+  // P * x (upper triangular part)
+  mat_vec(work->data->P, x, y, 0);
+
+  // P' * x (lower triangular part with no diagonal)
+  mat_tpose_vec(work->data->P, x, y, 1, 1);
+}
+
 c_float compute_pri_res(OSQPWorkspace *work, c_float *x, c_float *z) {
   // NB: Use z_prev as working vector
   // pr = Ax - z
+  c_float pri_res;
+
+#ifndef EMBEDDED
+  c_int m = work->data->m;
+#endif /* ifndef EMBEDDED */
 
-  mat_vec(work->data->A, x, work->Ax, 0); // Ax
+  data_A_vec(work, x, work->Ax); // Ax
   vec_add_scaled(work->z_prev, work->Ax, z, work->data->m, -1);
 
   // If scaling active -> rescale residual
   if (work->settings->scaling && !work->settings->scaled_termination) {
-    return vec_scaled_norm_inf(work->scaling->Einv, work->z_prev, work->data->m);
+    pri_res = vec_scaled_norm_inf(work->scaling->Einv, work->z_prev, work->data->m);
+  } else {
+    pri_res = vec_norm_inf(work->z_prev, work->data->m);
   }
 
+#ifndef EMBEDDED
+  // pr = x - z for the variable bounds. Their rows are scaled by Dinv.
+  if (work->n_bnd) {
+    vec_add_scaled(work->z_prev + m, x, z + m, work->n_bnd, -1);
+
+    if (work->settings->scaling && !work->settings->scaled_termination) {
+      pri_res = c_max(pri_res, vec_scaled_norm_inf(work->scaling->D,
+                                                   work->z_prev + m,
+                                                   work->n_bnd));
+    } else {
+      pri_res = c_max(pri_res, vec_norm_inf(work->z_prev + m, work->n_bnd));
+    }
+  }
+#endif /* ifndef EMBEDDED */
+
   // Return norm of the residual
-  return vec_norm_inf(work->z_prev, work->data->m);
+  return pri_res;
 }
 
 c_float compute_pri_tol(OSQPWorkspace *work, c_float eps_abs, c_float eps_rel) {
@@ -272,6 +430,18 @@ c_float compute_pri_tol(OSQPWorkspace *work, c_float eps_abs, c_float eps_rel) {
 
     // Choose maximum
     max_rel_eps = c_max(max_rel_eps, temp_rel_eps);
+
+#ifndef EMBEDDED
+    // ||D * z_bnd|| and ||D * x|| for the variable bounds
+    if (work->n_bnd) {
+      temp_rel_eps = vec_scaled_norm_inf(work->scaling->D,
+                                         work->z + work->data->m,
+                                         work->n_bnd);
+      max_rel_eps  = c_max(max_rel_eps, temp_rel_eps);
+      temp_rel_eps = vec_scaled_norm_inf(work->scaling->D, work->x, work->n_bnd);
+      max_rel_eps  = c_max(max_rel_eps, temp_rel_eps);
+    }
+#endif /* ifndef EMBEDDED */
   } else { // No unscaling required
     // ||z||
     max_rel_eps = vec_norm_inf(work->z, work->data->m);
@@ -281,6 +451,16 @@ c_float compute_pri_tol(OSQPWorkspace *work, c_float eps_abs, c_float eps_rel) {
 
     // Choose maximum
     max_rel_eps = c_max(max_rel_eps, temp_rel_eps);
+
+#ifndef EMBEDDED
+    // ||z_bnd|| and ||x|| for the variable bounds
+    if (work->n_bnd) {
+      temp_rel_eps = vec_norm_inf(work->z + work->data->m, work->n_bnd);
+      max_rel_eps  = c_max(max_rel_eps, temp_rel_eps);
+      temp_rel_eps = vec_norm_inf(work->x, work->n_bnd);
+      max_rel_eps  = c_max(max_rel_eps, temp_rel_eps);
+    }
+#endif /* ifndef EMBEDDED */
   }
 
   // eps_prim
@@ -295,21 +475,31 @@ c_float compute_dua_res(OSQPWorkspace *work, c_float *x, c_float *y) {
   // dr = q
   prea_vec_copy(work->data->q, work->x_prev, work->data->n);
 
-  // P * x (upper triangular part)
-  mat_vec(work->data->P, x, work->Px, 0);
-
-  // P' * x (lower triangular part with no diagonal)
-  mat_tpose_vec(work->data->P, x, work->Px, 1, 1);
+  // P * x (full P matrix)
+  data_P_vec(work, x, work->Px);
 
-  // dr += P * x (full P matrix)
+  // dr += P * x
   vec_add_scaled(work->x_prev, work->x_prev, work->Px, work->data->n, 1);
 
   // dr += A' * y
   if (work->data->m > 0) {
-    mat_tpose_vec(work->data->A, y, work->Aty, 0, 0);
+    data_At_vec(work, y, work->Aty);
     vec_add_scaled(work->x_prev, work->x_prev, work->Aty, work->data->n, 1);
   }
 
+#ifndef EMBEDDED
+  // dr += y_bnd. Aty includes the multipliers of the variable bounds for the
+  // dual tolerance and the rho estimate.
+  if (work->n_bnd) {
+    if (work->data->m > 0) {
+      vec_add_scaled(work->Aty, work->Aty, y + work->data->m, work->n_bnd, 1);
+    } else {
+      prea_vec_copy(y, work->Aty, work->n_bnd);
+    }
+    vec_add_scaled(work->x_prev, work->x_prev, y + work->data->m, work->n_bnd, 1);
+  }
+#endif /* ifndef EMBEDDED */
+
   // If scaling active -> rescale residual
   if (work->settings->scaling && !work->settings->scaled_termination) {
     return work->scaling->cinv * vec_scaled_norm_inf(work->scaling->Dinv,
@@ -373,6 +563,11 @@ c_int is_primal_infeasible(OSQPWorkspace *work, c_float eps_prim_inf) {
   c_float norm_delta_y;
   c_float ineq_lhs = 0.0;
 
+#ifndef EMBEDDED
+  c_int    m      = work->data->m;
+  c_float *dy_bnd = work->delta_y + m; // delta_y of the variable bounds
+#endif /* ifndef EMBEDDED */
+
   // Project delta_y onto the polar of the recession cone of [l,u]
   for (i = 0; i < work->data->m; i++) {
     if (work->data->u[i] > OSQP_INFTY * MIN_SCALING) {          // Infinite upper bound
@@ -389,13 +584,38 @@ c_int is_primal_infeasible(OSQPWorkspace *work, c_float eps_prim_inf) {
     }
   }
 
+#ifndef EMBEDDED
+  // Same projection for the variable bounds [lb,ub]
+  for (i = 0; i < work->n_bnd; i++) {
+    if (work->data->ub[i] > OSQP_INFTY * MIN_SCALING) {
+      dy_bnd[i] = (work->data->lb[i] < -OSQP_INFTY * MIN_SCALING) ? 0.0 :
+                  c_min(dy_bnd[i], 0.0);
+    } else if (work->data->lb[i] < -OSQP_INFTY * MIN_SCALING) {
+      dy_bnd[i] = c_max(dy_bnd[i], 0.0);
+    }
+  }
+#endif /* ifndef EMBEDDED */
+
   // Compute infinity norm of delta_y (unscale if necessary)
   if (work->settings->scaling && !work->settings->scaled_termination) {
     // Use work->Adelta_x as temporary vector
     vec_ew_prod(work->scaling->E, work->delta_y, work->Adelta_x, work->data->m);
     norm_delta_y = vec_norm_inf(work->Adelta_x, work->data->m);
+#ifndef EMBEDDED
+    // The rows of the variable bounds are scaled by Dinv
+    if (work->n_bnd) {
+      norm_delta_y = c_max(norm_delta_y,
+                           vec_scaled_norm_inf(work->scaling->Dinv, dy_bnd,
+                                               work->n_bnd));
+    }
+#endif /* ifndef EMBEDDED */
   } else {
     norm_delta_y = vec_norm_inf(work->delta_y, work->data->m);
+#ifndef EMBEDDED
+    if (work->n_bnd) {
+      norm_delta_y = c_max(norm_delta_y, vec_norm_inf(dy_bnd, work->n_bnd));
+    }
+#endif /* ifndef EMBEDDED */
   }
 
   if (norm_delta_y > eps_prim_inf) { // ||delta_y|| > 0
@@ -405,10 +625,24 @@ c_int is_primal_infeasible(OSQPWorkspace *work, c_float eps_prim_inf) {
                   work->data->l[i] * c_min(work->delta_y[i], 0);
     }
 
+#ifndef EMBEDDED
+    for (i = 0; i < work->n_bnd; i++) {
+      ineq_lhs += work->data->ub[i] * c_max(dy_bnd[i], 0) +
+                  work->data->lb[i] * c_min(dy_bnd[i], 0);
+    }
+#endif /* ifndef EMBEDDED */
+
     // Check if the condition is satisfied: ineq_lhs < -eps
     if (ineq_lhs < -eps_prim_inf * norm_delta_y) {
       // Compute and return ||A'delta_y|| < eps_prim_inf
-      mat_tpose_vec(work->data->A, work->delta_y, work->Atdelta_y, 0, 0);
+      data_At_vec(work, work->delta_y, work->Atdelta_y);
+
+#ifndef EMBEDDED
+      // += delta_y of the variable bounds
+      if (work->n_bnd) {
+        vec_add_scaled(work->Atdelta_y, work->Atdelta_y, dy_bnd, work->n_bnd, 1);
+      }
+#endif /* ifndef EMBEDDED */
 
       // Unscale if necessary
       if (work->settings->scaling && !work->settings->scaled_termination) {
@@ -442,6 +676,9 @@ c_int is_dual_infeasible(OSQPWorkspace *work, c_float eps_dual_inf) {
   c_int   i; // Index for loops
   c_float norm_delta_x;
   c_float cost_scaling;
+#ifndef EMBEDDED
+  c_float dx;
+#endif /* ifndef EMBEDDED */
 
   // Compute norm of delta_x
   if (work->settings->scaling && !work->settings->scaled_termination) { // Unscale
@@ -466,8 +703,7 @@ c_int is_dual_infeasible(OSQPWorkspace *work, c_float eps_dual_inf) {
     if (vec_prod(work->data->q, work->delta_x, work->data->n) <
         -cost_scaling * eps_dual_inf * norm_delta_x) {
       // Compute product P * delta_x (NB: P is store in upper triangular form)
-      mat_vec(work->data->P, work->delta_x, work->Pdelta_x, 0);
-      mat_tpose_vec(work->data->P, work->delta_x, work->Pdelta_x, 1, 1);
+      data_P_vec(work, work->delta_x, work->Pdelta_x);
 
       // Scale if necessary
       if (work->settings->scaling && !work->settings->scaled_termination) {
@@ -481,7 +717,7 @@ c_int is_dual_infeasible(OSQPWorkspace *work, c_float eps_dual_inf) {
       if (vec_norm_inf(work->Pdelta_x, work->data->n) <
           cost_scaling * eps_dual_inf * norm_delta_x) {
         // Compute A * delta_x
-        mat_vec(work->data->A, work->delta_x, work->Adelta_x, 0);
+        data_A_vec(work, work->delta_x, work->Adelta_x);
 
         // Scale if necessary
         if (work->settings->scaling && !work->settings->scaled_termination) {
@@ -504,6 +740,22 @@ c_int is_dual_infeasible(OSQPWorkspace *work, c_float eps_dual_inf) {
           }
         }
 
+#ifndef EMBEDDED
+        // Same conditions for the variable bounds with delta_x (unscaled by D)
+        for (i = 0; i < work->n_bnd; i++) {
+          dx = work->delta_x[i];
+          if (work->settings->scaling && !work->settings->scaled_termination) {
+            dx *= work->scaling->D[i];
+          }
+          if (((work->data->ub[i] < OSQP_INFTY * MIN_SCALING) &&
+               (dx >  eps_dual_inf * norm_delta_x)) ||
+              ((work->data->lb[i] > -OSQP_INFTY * MIN_SCALING) &&
+               (dx < -eps_dual_inf * norm_delta_x))) {
+            return 0;
+          }
+        }
+#endif /* ifndef EMBEDDED */
+
         // All conditions passed -> dual infeasible
         return 1;
       }
@@ -527,28 +779,46 @@ c_int has_solution(OSQPInfo * info){
 void store_solution(OSQPWorkspace *work) {
 #ifndef EMBEDDED
   c_float norm_vec;
+  c_int   m_bnd = work->data->m + work->n_bnd;
 #endif /* ifndef EMBEDDED */
 
   if (has_solution(work->info)) {
     prea_vec_copy(work->x, work->solution->x, work->data->n); // primal
+#ifndef EMBEDDED
+    prea_vec_copy(work->y, work->solution->y, m_bnd);         // dual
+#else /* ifndef EMBEDDED */
     prea_vec_copy(work->y, work->solution->y, work->data->m); // dual
+#endif /* ifndef EMBEDDED */
 
     // Unscale solution if scaling has been performed
     if (work->settings->scaling)
       unscale_solution(work);
+
+#ifndef EMBEDDED
+    // Recover the solution of the original problem
+    if (work->presolve) postsolve_solution(work);
+#endif /* ifndef EMBEDDED */
   } else {
     // No solution present. Solution is NaN
     vec_set_scalar(work->solution->x, OSQP_NAN, work->data->n);
     vec_set_scalar(work->solution->y, OSQP_NAN, work->data->m);
 
 #ifndef EMBEDDED
+    if (work->presolve) {
+      vec_set_scalar(work->solution->x, OSQP_NAN, work->presolve->n);
+      vec_set_scalar(work->solution->y, OSQP_NAN, work->presolve->m);
+    }
+    if (work->solution->y_bnd) {
+      vec_set_scalar(work->solution->y_bnd, OSQP_NAN,
+                     work->presolve ? work->presolve->n : work->data->n);
+    }
 
     // Normalize infeasibility certificates if embedded is off
     // NB: It requires a division
     if ((work->info->status_val == OSQP_PRIMAL_INFEASIBLE) ||
         ((work->info->status_val == OSQP_PRIMAL_INFEASIBLE_INACCURATE))) {
-      norm_vec = vec_norm_inf(work->delta_y, work->data->m);
-      vec_mult_scalar(work->delta_y, 1. / norm_vec, work->data->m);
+      norm_vec = vec_norm_inf(work->delta_y, m_bnd);
+      vec_mult_scalar(work->delta_y, 1. / norm_vec, m_bnd);
     }
 
     if ((work->info->status_val == OSQP_DUAL_INFEASIBLE) ||
@@ -573,6 +843,7 @@ void update_info(OSQPWorkspace *work,
 
 #ifdef PROFILING
   c_float *run_time;                    // Execution time
+  OSQPTimer timer;                      // Timer of the profile
 #endif /* ifdef PROFILING */
 
 #ifndef EMBEDDED
@@ -606,12 +877,17 @@ void update_info(OSQPWorkspace *work,
 
 
   // Compute the objective if needed
+  PROFILE_TIC(&timer);
   if (compute_objective) {
     *obj_val = compute_obj_val(work, x);
   }
 
   // Compute primal residual
+#ifndef EMBEDDED
+  if (work->data->m + work->n_bnd == 0) {
+#else /* ifndef EMBEDDED */
   if (work->data->m == 0) {
+#endif /* ifndef EMBEDDED */
     // No constraints -> Always primal feasible
     *pri_res = 0.;
   } else {
@@ -620,6 +896,7 @@ void update_info(OSQPWorkspace *work,
 
   // Compute dual residual
   *dua_res = compute_dua_res(work, x, y);
+  PROFILE_TOC(&work->info->profile, PROFILE_RESIDUALS, &timer);
 
   // Update timing
 #ifdef PROFILING
@@ -686,6 +963,9 @@ c_int check_termination(OSQPWorkspace *work, c_int approximate) {
   c_int   exitflag;
   c_int   prim_res_check, dual_res_check, prim_inf_check, dual_inf_check;
   c_float eps_abs, eps_rel;
+#ifdef PROFILING
+  OSQPTimer timer;
+#endif /* ifdef PROFILING */
 
   // Initialize variables to 0
   exitflag       = 0;
@@ -717,7 +997,11 @@ c_int check_termination(OSQPWorkspace *work, c_int approximate) {
   }
 
   // Check residuals
+#ifndef EMBEDDED
+  if (work->data->m + work->n_bnd == 0) {
+#else /* ifndef EMBEDDED */
   if (work->data->m == 0) {
+#endif /* ifndef EMBEDDED */
     prim_res_check = 1; // No constraints -> Primal feasibility always satisfied
   }
   else {
@@ -729,7 +1013,9 @@ c_int check_termination(OSQPWorkspace *work, c_int approximate) {
       prim_res_check = 1;
     } else {
       // Primal infeasibility check
+      PROFILE_TIC(&timer);
       prim_inf_check = is_primal_infeasible(work, eps_prim_inf);
+      PROFILE_TOC(&work->info->profile, PROFILE_INFEASIBILITY, &timer);
     }
   } // End check if m == 0
 
@@ -741,7 +1027,9 @@ c_int check_termination(OSQPWorkspace *work, c_int approximate) {
     dual_res_check = 1;
   } else {
     // Check dual infeasibility
+    PROFILE_TIC(&timer);
     dual_inf_check = is_dual_infeasible(work, eps_dual_inf);
+    PROFILE_TOC(&work->info->profile, PROFILE_INFEASIBILITY, &timer);
   }
 
   // Compare checks to determine solver status
@@ -765,6 +1053,10 @@ c_int check_termination(OSQPWorkspace *work, c_int approximate) {
     if (work->settings->scaling && !work->settings->scaled_termination) {
       // Update infeasibility certificate
       vec_ew_prod(work->scaling->E, work->delta_y, work->delta_y, work->data->m);
+#ifndef EMBEDDED
+      vec_ew_prod(work->scaling->Dinv, work->delta_y + work->data->m,
+                  work->delta_y + work->data->m, work->n_bnd);
+#endif /* ifndef EMBEDDED */
     }
     work->info->obj_val = OSQP_INFTY;
     exitflag            = 1;
@@ -785,6 +1077,8 @@ c_int check_termination(OSQPWorkspace *work, c_int approximate) {
     exitflag            = 1;
   }
 
+  OSQP_PROBE2(termination_check, work->info->iter, exitflag);
+
   return exitflag;
 }
 
@@ -869,14 +1163,68 @@ c_int validate_data(const OSQPData *data) {
     }
   }
 
+  // Bounds of the variables
+  if (data->lb && data->ub) {
+    for (j = 0; j < data->n; j++) {
+      if (data->lb[j] > data->ub[j]) {
+# ifdef PRINTING
+        c_eprint("Lower bound of variable %d is greater than its upper bound: %.4e > %.4e",
+                 (int)j, data->lb[j], data->ub[j]);
+# endif /* ifdef PRINTING */
+        return 1;
+      }
+    }
+  }
+
   // TODO: Complete with other checks
 
   return 0;
 }
 
+c_int validate_stages(const OSQPData *data, const c_int *stages) {
+  c_int j;
+
+  for (j = 0; j < data->n + data->m; j++) {
+    if ((stages[j] < 0) || (stages[j] >= data->n + data->m)) {
+# ifdef PRINTING
+      c_eprint("stages[%i] = %i must be between 0 and n + m - 1",
+               (int)j, (int)stages[j]);
+# endif /* ifdef PRINTING */
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+c_int validate_perm(const OSQPData *data, const c_int *perm) {
+  c_int j, nm = data->n + data->m, exitflag = 0;
+  c_int *mark;
+
+  mark = (c_int *)c_calloc(nm ? nm : 1, sizeof(c_int));
+  if (!mark) return 1;
+
+  for (j = 0; j < nm; j++) {
+    if ((perm[j] < 0) || (perm[j] >= nm) || mark[perm[j]]) {
+# ifdef PRINTING
+      c_eprint("perm must be a permutation of 0, ..., n + m - 1 (perm[%i] = %i)",
+               (int)j, (int)perm[j]);
+# endif /* ifdef PRINTING */
+      exitflag = 1;
+      break;
+    }
+    mark[perm[j]] = 1;
+  }
+
+  c_free(mark);
+  return exitflag;
+}
+
 c_int validate_linsys_solver(c_int linsys_solver) {
   if ((linsys_solver != QDLDL_SOLVER) &&
-      (linsys_solver != MKL_PARDISO_SOLVER)) {
+      (linsys_solver != MKL_PARDISO_SOLVER) &&
+      (linsys_solver != PLUGIN_SOLVER) &&
+      (linsys_solver != NORMAL_SOLVER)) {
     return 1;
   }
 
@@ -886,6 +1234,19 @@ c_int validate_linsys_solver(c_int linsys_solver) {
   return 0;
 }
 
+void copy_data_without_var_bounds(const OSQPData *data,
+                                  OSQPData       *data_nb) {
+  data_nb->n  = data->n;
+  data_nb->m  = data->m;
+  data_nb->P  = data->P;
+  data_nb->A  = data->A;
+  data_nb->q  = data->q;
+  data_nb->l  = data->l;
+  data_nb->u  = data->u;
+  data_nb->lb = OSQP_NULL;
+  data_nb->ub = OSQP_NULL;
+}
+
 c_int validate_settings(const OSQPSettings *settings) {
   if (!settings) {
 # ifdef PRINTING
@@ -938,6 +1299,41 @@ c_int validate_settings(const OSQPSettings *settings) {
     return 1;
   }
 
+  if (settings->warm_start_cache < 0) {
+# ifdef PRINTING
+    c_eprint("warm_start_cache must be nonnegative");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if ((settings->presolve != 0) && (settings->presolve != 1)) {
+# ifdef PRINTING
+    c_eprint("presolve must be either 0 or 1");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if ((settings->var_bounds != 0) && (settings->var_bounds != 1)) {
+# ifdef PRINTING
+    c_eprint("var_bounds must be either 0 or 1");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if (settings->trace_interval < 0) {
+# ifdef PRINTING
+    c_eprint("trace_interval must be nonnegative");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if (settings->trace_buffer < 0) {
+# ifdef PRINTING
+    c_eprint("trace_buffer must be nonnegative");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
   if (settings->rho <= 0.0) {
 # ifdef PRINTING
     c_eprint("rho must be positive");
@@ -1017,6 +1413,32 @@ c_int validate_settings(const OSQPSettings *settings) {
     return 1;
   }
 
+  if ((settings->linsys_solver == PLUGIN_SOLVER) &&
+      !settings->linsys_solver_lib) {
+# ifdef PRINTING
+    c_eprint("linsys_solver_lib must be given for the plugin linear system solver");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if ((settings->ordering != AMD_ORDERING) &&
+      (settings->ordering != RCM_ORDERING) &&
+      (settings->ordering != ND_ORDERING) &&
+      (settings->ordering != USER_ORDERING)) {
+# ifdef PRINTING
+    c_eprint("ordering not recognized");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if ((settings->ordering == USER_ORDERING) &&
+      (!settings->perm || settings->stages)) {
+# ifdef PRINTING
+    c_eprint("user ordering requires perm and no stages");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
   if ((settings->verbose != 0) &&
       (settings->verbose != 1)) {
 # ifdef PRINTING
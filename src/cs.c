@@ -316,3 +316,159 @@ csc* csc_to_triu(csc *M) {
   // Return matrix in triplet form
   return M_triu;
 }
+
+/**
+ * Number of blocks of size bs with nonzero elements of A. mark is a
+ * workspace of size ceil(m/bs).
+ */
+static c_int csc_count_blocks(const csc *A, c_int bs, c_int *mark) {
+  c_int I, J, j, ptr, nb = 0;
+  c_int mb = (A->m + bs - 1) / bs;
+
+  for (I = 0; I < mb; I++) mark[I] = -1;
+
+  for (j = 0; j < A->n; j++) {
+    J = j / bs;
+    for (ptr = A->p[j]; ptr < A->p[j + 1]; ptr++) {
+      I = A->i[ptr] / bs;
+      if (mark[I] != J) {
+        mark[I] = J;
+        nb++;
+      }
+    }
+  }
+  return nb;
+}
+
+c_int csc_block_size(const csc *A) {
+  c_int bs, nb, best = 1;
+  c_int nnz = A->p[A->n];
+  c_int *mark;
+  c_float cost, best_cost;
+
+  if ((nnz == 0) || (A->m < 2) || (A->n < 2)) return 1;
+
+  mark = c_malloc(A->m * sizeof(c_int));
+  if (!mark) return 1;
+
+  // One value and one index per element in csc form, bs*bs values and one
+  // index per block in block form
+  best_cost = 2.0 * nnz;
+  for (bs = 2; bs <= BSR_MAX_BLOCK_SIZE; bs++) {
+    if ((bs > A->m) || (bs > A->n)) break;
+
+    nb = csc_count_blocks(A, bs, mark);
+    if ((c_float)nb * bs * bs > BSR_MAX_FILL * nnz) continue;
+
+    cost = (c_float)nb * (bs * bs + 1);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best      = bs;
+    }
+  }
+  c_free(mark);
+
+  return best;
+}
+
+bsr* csc_to_bsr(const csc *A, c_int bs) {
+  c_int I, J, i, j, ptr, nb, len;
+  c_int *mark, *next;
+  bsr   *B;
+
+  B = c_calloc(1, sizeof(bsr));
+  if (!B) return OSQP_NULL;
+
+  B->m  = A->m;
+  B->n  = A->n;
+  B->bs = bs;
+  B->mb = (A->m + bs - 1) / bs;
+  B->nb = (A->n + bs - 1) / bs;
+  len   = bs * c_max(B->mb, B->nb);
+
+  mark   = c_malloc((B->mb ? B->mb : 1) * sizeof(c_int));
+  next   = c_malloc((B->mb ? B->mb : 1) * sizeof(c_int));
+  B->p   = c_malloc((B->mb + 1) * sizeof(c_int));
+  B->map = c_malloc((A->p[A->n] ? A->p[A->n] : 1) * sizeof(c_int));
+  B->xp  = c_calloc(len ? len : 1, sizeof(c_float));
+  B->yp  = c_calloc(len ? len : 1, sizeof(c_float));
+  if (!mark || !next || !(B->p) || !(B->map) || !(B->xp) || !(B->yp)) {
+    c_free(mark);
+    c_free(next);
+    bsr_spfree(B);
+    return OSQP_NULL;
+  }
+
+  // Number of blocks in each block row
+  for (I = 0; I < B->mb; I++) {
+    mark[I] = -1;
+    next[I] = 0;
+  }
+  for (j = 0; j < A->n; j++) {
+    J = j / bs;
+    for (ptr = A->p[j]; ptr < A->p[j + 1]; ptr++) {
+      I = A->i[ptr] / bs;
+      if (mark[I] != J) {
+        mark[I] = J;
+        next[I]++;
+      }
+    }
+  }
+  B->p[0] = 0;
+  for (I = 0; I < B->mb; I++) {
+    B->p[I + 1] = B->p[I] + next[I];
+    next[I]     = B->p[I];
+    mark[I]     = -1;
+  }
+  nb = B->p[B->mb];
+
+  B->j = c_malloc((nb ? nb : 1) * sizeof(c_int));
+  B->x = c_calloc(nb ? nb * bs * bs : 1, sizeof(c_float));
+  if (!(B->j) || !(B->x)) {
+    c_free(mark);
+    c_free(next);
+    bsr_spfree(B);
+    return OSQP_NULL;
+  }
+
+  // Block columns are visited in increasing order, hence they are sorted in
+  // each block row. mark holds the last block of each block row.
+  for (j = 0; j < A->n; j++) {
+    J = j / bs;
+    for (ptr = A->p[j]; ptr < A->p[j + 1]; ptr++) {
+      i = A->i[ptr];
+      I = i / bs;
+      if ((mark[I] < 0) || (B->j[mark[I]] != J)) {
+        mark[I]       = next[I]++;
+        B->j[mark[I]] = J;
+      }
+      B->map[ptr] = mark[I] * bs * bs + (i - I * bs) * bs + (j - J * bs);
+    }
+  }
+  c_free(mark);
+  c_free(next);
+
+  bsr_update_values(B, A);
+
+  return B;
+}
+
+void bsr_update_values(bsr *B, const csc *A) {
+  c_int ptr;
+
+  for (ptr = 0; ptr < A->p[A->n]; ptr++) {
+    B->x[B->map[ptr]] = A->x[ptr];
+  }
+}
+
+void bsr_spfree(bsr *B) {
+  if (B) {
+    if (B->p)   c_free(B->p);
+    if (B->j)   c_free(B->j);
+    if (B->x)   c_free(B->x);
+    if (B->map) c_free(B->map);
+    if (B->xp)  c_free(B->xp);
+    if (B->yp)  c_free(B->yp);
+    c_free(B);
+  }
+}
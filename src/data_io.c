@@ -0,0 +1,1320 @@
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "data_io.h"
+#include "osqp.h"
+#include "constants.h"
+
+#if defined(IS_LINUX) || defined(IS_MAC)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# define DATA_IO_MMAP
+#endif /* if defined(IS_LINUX) || defined(IS_MAC) */
+
+#ifdef DFLOAT
+# define IO_FLOAT_FMT "%.9g"
+# define IO_NEXTAFTER nextafterf
+#else  /* ifdef DFLOAT */
+# define IO_FLOAT_FMT "%.17g"
+# define IO_NEXTAFTER nextafter
+#endif /* ifdef DFLOAT */
+
+#define IO_MAX_TOKENS  (7)
+#define IO_MAX_NAME    (255)
+#define IO_RANGE_STEPS (4) ///< neighbours of u - l tried for an exact range
+
+
+/*********************************
+*  Files mapped into memory     *
+*********************************/
+
+/// Contents of a file
+typedef struct {
+  const char *buf;    ///< contents of the file
+  size_t      len;    ///< length of the file
+  void       *addr;   ///< mapping or buffer to release
+  c_int       mapped; ///< the file is mapped into memory
+} IOFile;
+
+// Map the file into memory or read it into a buffer
+static c_int io_open(IOFile *f, const char *filename) {
+  FILE  *fp;
+  size_t len;
+
+  f->buf    = "";
+  f->len    = 0;
+  f->addr   = OSQP_NULL;
+  f->mapped = 0;
+
+#ifdef DATA_IO_MMAP
+  {
+    struct stat st;
+    int         fd = open(filename, O_RDONLY);
+
+    if (fd < 0) return 1;
+    if (fstat(fd, &st)) {
+      close(fd);
+      return 1;
+    }
+    if (st.st_size > 0) {
+      f->addr = mmap(OSQP_NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (f->addr != MAP_FAILED) {
+        f->buf    = (const char *)f->addr;
+        f->len    = (size_t)st.st_size;
+        f->mapped = 1;
+        close(fd);
+        return 0;
+      }
+      f->addr = OSQP_NULL;
+    }
+    close(fd);
+    if (st.st_size == 0) return 0;
+  }
+#endif /* ifdef DATA_IO_MMAP */
+
+  // Read the whole file
+  fp = fopen(filename, "rb");
+  if (!fp) return 1;
+  if (fseek(fp, 0, SEEK_END) || ((len = (size_t)ftell(fp)) == (size_t)-1) ||
+      fseek(fp, 0, SEEK_SET)) {
+    fclose(fp);
+    return 1;
+  }
+  if (len > 0) {
+    f->addr = c_malloc(len);
+    if (!f->addr || (fread(f->addr, 1, len, fp) != len)) {
+      if (f->addr) c_free(f->addr);
+      f->addr = OSQP_NULL;
+      fclose(fp);
+      return 1;
+    }
+    f->buf = (const char *)f->addr;
+    f->len = len;
+  }
+  fclose(fp);
+
+  return 0;
+}
+
+static void io_close(IOFile *f) {
+  if (!f->addr) return;
+#ifdef DATA_IO_MMAP
+  if (f->mapped) {
+    munmap(f->addr, f->len);
+    f->addr = OSQP_NULL;
+    return;
+  }
+#endif /* ifdef DATA_IO_MMAP */
+  c_free(f->addr);
+  f->addr = OSQP_NULL;
+}
+
+
+/*********************************
+*  Problem data                 *
+*********************************/
+
+void osqp_free_problem(OSQPData *data, OSQPSettings *settings) {
+  if (data) {
+    if (data->P) csc_spfree(data->P);
+    if (data->A) csc_spfree(data->A);
+    if (data->q) c_free(data->q);
+    if (data->l) c_free(data->l);
+    if (data->u) c_free(data->u);
+    if (data->lb) c_free(data->lb);
+    if (data->ub) c_free(data->ub);
+    c_free(data);
+  }
+  if (settings) {
+    if (settings->stages) c_free((c_int *)settings->stages);
+    if (settings->perm) c_free((c_int *)settings->perm);
+    if (settings->linsys_solver_lib) c_free((char *)settings->linsys_solver_lib);
+    c_free(settings);
+  }
+}
+
+// Allocate the data with vectors of sizes n and m and the bounds if requested
+static OSQPData* alloc_data(c_int n, c_int m, c_int has_lb, c_int has_ub) {
+  OSQPData *data = (OSQPData *)c_calloc(1, sizeof(OSQPData));
+
+  if (!data) return OSQP_NULL;
+  data->n = n;
+  data->m = m;
+  data->q = (c_float *)c_malloc(c_max(n, 1) * sizeof(c_float));
+  data->l = (c_float *)c_malloc(c_max(m, 1) * sizeof(c_float));
+  data->u = (c_float *)c_malloc(c_max(m, 1) * sizeof(c_float));
+  if (has_lb) data->lb = (c_float *)c_malloc(c_max(n, 1) * sizeof(c_float));
+  if (has_ub) data->ub = (c_float *)c_malloc(c_max(n, 1) * sizeof(c_float));
+  if (!data->q || !data->l || !data->u || (has_lb && !data->lb) ||
+      (has_ub && !data->ub)) {
+    osqp_free_problem(data, OSQP_NULL);
+    return OSQP_NULL;
+  }
+
+  return data;
+}
+
+
+/*********************************
+*  Binary problem files         *
+*********************************/
+
+#define IO_MAGIC      "OSQPPRB1"
+#define IO_HAS_LB     (1)
+#define IO_HAS_UB     (2)
+#define IO_HAS_SET    (4)
+#define IO_HAS_OBJ    (8)
+
+/// Types of the settings
+enum io_type { IO_INT, IO_FLOAT, IO_LINSYS, IO_ORDERING };
+
+/// Setting written to the binary files. The identifiers must not change.
+typedef struct {
+  c_int        id;
+  enum io_type type;
+  size_t       offset;
+} IOSetting;
+
+static const IOSetting io_settings[] = {
+  { 1,  IO_FLOAT,    offsetof(OSQPSettings, rho) },
+  { 2,  IO_FLOAT,    offsetof(OSQPSettings, sigma) },
+  { 3,  IO_INT,      offsetof(OSQPSettings, scaling) },
+  { 4,  IO_INT,      offsetof(OSQPSettings, adaptive_rho) },
+  { 5,  IO_INT,      offsetof(OSQPSettings, adaptive_rho_interval) },
+  { 6,  IO_FLOAT,    offsetof(OSQPSettings, adaptive_rho_tolerance) },
+#ifdef PROFILING
+  { 7,  IO_FLOAT,    offsetof(OSQPSettings, adaptive_rho_fraction) },
+#endif /* ifdef PROFILING */
+  { 8,  IO_INT,      offsetof(OSQPSettings, max_iter) },
+  { 9,  IO_FLOAT,    offsetof(OSQPSettings, eps_abs) },
+  { 10, IO_FLOAT,    offsetof(OSQPSettings, eps_rel) },
+  { 11, IO_FLOAT,    offsetof(OSQPSettings, eps_prim_inf) },
+  { 12, IO_FLOAT,    offsetof(OSQPSettings, eps_dual_inf) },
+  { 13, IO_FLOAT,    offsetof(OSQPSettings, alpha) },
+  { 14, IO_LINSYS,   offsetof(OSQPSettings, linsys_solver) },
+  { 15, IO_ORDERING, offsetof(OSQPSettings, ordering) },
+  { 16, IO_FLOAT,    offsetof(OSQPSettings, delta) },
+  { 17, IO_INT,      offsetof(OSQPSettings, polish) },
+  { 18, IO_INT,      offsetof(OSQPSettings, polish_refine_iter) },
+  { 19, IO_INT,      offsetof(OSQPSettings, warm_start_cache) },
+  { 20, IO_INT,      offsetof(OSQPSettings, presolve) },
+  { 21, IO_INT,      offsetof(OSQPSettings, trace_interval) },
+  { 22, IO_INT,      offsetof(OSQPSettings, trace_buffer) },
+  { 23, IO_INT,      offsetof(OSQPSettings, verbose) },
+  { 24, IO_INT,      offsetof(OSQPSettings, scaled_termination) },
+  { 25, IO_INT,      offsetof(OSQPSettings, check_termination) },
+  { 26, IO_INT,      offsetof(OSQPSettings, warm_start) },
+#ifdef PROFILING
+  { 27, IO_FLOAT,    offsetof(OSQPSettings, time_limit) },
+#endif /* ifdef PROFILING */
+  { 28, IO_INT,      offsetof(OSQPSettings, var_bounds) },
+};
+
+#define IO_NSETTINGS ((c_int)(sizeof(io_settings) / sizeof(io_settings[0])))
+
+// Byte order of the machine: 1 if little endian
+static unsigned char io_little_endian(void) {
+  unsigned int one = 1;
+
+  return *(unsigned char *)&one;
+}
+
+static c_int write_ints(FILE *f, const c_int *v, c_int len) {
+  return (len <= 0) || (fwrite(v, sizeof(c_int), (size_t)len, f) == (size_t)len);
+}
+
+static c_int write_floats(FILE *f, const c_float *v, c_int len) {
+  return (len <= 0) || (fwrite(v, sizeof(c_float), (size_t)len, f) == (size_t)len);
+}
+
+static c_int write_csc(FILE *f, const csc *M) {
+  return write_ints(f, M->p, M->n + 1) && write_ints(f, M->i, M->p[M->n]) &&
+         write_floats(f, M->x, M->p[M->n]);
+}
+
+// Write the settings with their identifiers
+static c_int write_settings(FILE *f, const OSQPSettings *settings,
+                            c_int len) {
+  c_int k, ok, id, type, ival, nset = IO_NSETTINGS, slen;
+  c_float fval;
+  const char *field;
+
+  ok = write_ints(f, &nset, 1);
+  for (k = 0; ok && k < nset; k++) {
+    field = (const char *)settings + io_settings[k].offset;
+    id    = io_settings[k].id;
+    type  = (c_int)io_settings[k].type;
+    ok    = write_ints(f, &id, 1) && write_ints(f, &type, 1);
+    switch (io_settings[k].type) {
+    case IO_FLOAT:
+      memcpy(&fval, field, sizeof(c_float));
+      ok = ok && write_floats(f, &fval, 1);
+      break;
+
+    case IO_LINSYS:
+      ival = (c_int)(*(const enum linsys_solver_type *)field);
+      ok   = ok && write_ints(f, &ival, 1);
+      break;
+
+    case IO_ORDERING:
+      ival = (c_int)(*(const enum ordering_type *)field);
+      ok   = ok && write_ints(f, &ival, 1);
+      break;
+
+    default:
+      memcpy(&ival, field, sizeof(c_int));
+      ok = ok && write_ints(f, &ival, 1);
+      break;
+    }
+  }
+
+  // Arrays of the settings and name of the solver library
+  slen = settings->stages ? len : 0;
+  ok   = ok && write_ints(f, &slen, 1) && write_ints(f, settings->stages, slen);
+  slen = settings->perm ? len : 0;
+  ok   = ok && write_ints(f, &slen, 1) && write_ints(f, settings->perm, slen);
+  slen = settings->linsys_solver_lib ? (c_int)strlen(settings->linsys_solver_lib) : 0;
+  ok   = ok && write_ints(f, &slen, 1) &&
+         ((slen == 0) ||
+          (fwrite(settings->linsys_solver_lib, 1, (size_t)slen, f) == (size_t)slen));
+
+  return ok;
+}
+
+c_int osqp_write_problem(const char          *filename,
+                         const OSQPData      *data,
+                         const OSQPSettings  *settings,
+                         const OSQPObjective *objective) {
+  c_int ok, dims[4];
+  unsigned char head[4];
+  FILE *f;
+
+  if (!data || !data->P || !data->A) return 1;
+
+  f = fopen(filename, "wb");
+  if (!f) {
+#ifdef PRINTING
+    c_eprint("could not open %s", filename);
+#endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  head[0] = (unsigned char)sizeof(c_int);
+  head[1] = (unsigned char)sizeof(c_float);
+  head[2] = io_little_endian();
+  head[3] = (unsigned char)((data->lb ? IO_HAS_LB : 0) |
+                            (data->ub ? IO_HAS_UB : 0) |
+                            (settings ? IO_HAS_SET : 0) |
+                            (objective ? IO_HAS_OBJ : 0));
+  dims[0] = data->n;
+  dims[1] = data->m;
+  dims[2] = data->P->p[data->n];
+  dims[3] = data->A->p[data->n];
+
+  ok = (fwrite(IO_MAGIC, 1, 8, f) == 8) && (fwrite(head, 1, 4, f) == 4) &&
+       write_ints(f, dims, 4) && write_csc(f, data->P) &&
+       write_csc(f, data->A) && write_floats(f, data->q, data->n) &&
+       write_floats(f, data->l, data->m) && write_floats(f, data->u, data->m);
+  if (ok && data->lb) ok = write_floats(f, data->lb, data->n);
+  if (ok && data->ub) ok = write_floats(f, data->ub, data->n);
+  if (ok && objective) {
+    ok = write_floats(f, &objective->constant, 1) &&
+         write_ints(f, &objective->maximize, 1);
+  }
+  if (ok && settings) ok = write_settings(f, settings, data->n + data->m);
+
+  if (fclose(f)) ok = 0;
+
+#ifdef PRINTING
+  if (!ok) {
+    c_eprint("could not write %s", filename);
+  }
+#endif /* ifdef PRINTING */
+
+  return !ok;
+}
+
+/// Reader of a binary file with the sizes of c_int and c_float of the writer
+typedef struct {
+  const unsigned char *p, *end;
+  size_t isz, fsz;
+} IOCursor;
+
+// Check if count elements of width bytes are left to read
+static c_int io_has(const IOCursor *c, c_int count, size_t width) {
+  return (count >= 0) && ((size_t)(c->end - c->p) / width >= (size_t)count);
+}
+
+static c_int read_ints(IOCursor *c, c_int *v, c_int len) {
+  c_int k;
+  int   i4;
+  long long i8;
+
+  if (!io_has(c, len, c->isz)) return 0;
+
+  if (c->isz == sizeof(c_int)) {
+    if (len > 0) memcpy(v, c->p, (size_t)len * sizeof(c_int));
+  } else {
+    for (k = 0; k < len; k++) {
+      if (c->isz == sizeof(int)) {
+        memcpy(&i4, c->p + k * c->isz, sizeof(int));
+        v[k] = (c_int)i4;
+      } else {
+        memcpy(&i8, c->p + k * c->isz, sizeof(long long));
+        v[k] = (c_int)i8;
+      }
+    }
+  }
+  c->p += (size_t)len * c->isz;
+
+  return 1;
+}
+
+static c_int read_floats(IOCursor *c, c_float *v, c_int len) {
+  c_int  k;
+  float  f4;
+  double f8;
+
+  if (!io_has(c, len, c->fsz)) return 0;
+
+  if (c->fsz == sizeof(c_float)) {
+    if (len > 0) memcpy(v, c->p, (size_t)len * sizeof(c_float));
+  } else {
+    for (k = 0; k < len; k++) {
+      if (c->fsz == sizeof(float)) {
+        memcpy(&f4, c->p + k * c->fsz, sizeof(float));
+        v[k] = (c_float)f4;
+      } else {
+        memcpy(&f8, c->p + k * c->fsz, sizeof(double));
+        v[k] = (c_float)f8;
+      }
+    }
+  }
+  c->p += (size_t)len * c->fsz;
+
+  return 1;
+}
+
+// Read a csc matrix of size m x n with nnz elements and check its structure
+static csc* read_csc(IOCursor *c, c_int m, c_int n, c_int nnz) {
+  c_int j, k = 0;
+  csc  *M;
+
+  // The file must hold the arrays before they are allocated
+  if (!io_has(c, n, c->isz) || !io_has(c, nnz, c->isz + c->fsz)) return OSQP_NULL;
+
+  M = csc_spalloc(m, n, c_max(nnz, 1), 1, 0);
+  if (!M) return OSQP_NULL;
+  if (!read_ints(c, M->p, n + 1) || !read_ints(c, M->i, nnz) ||
+      !read_floats(c, M->x, nnz) || (M->p[0] != 0) || (M->p[n] != nnz)) {
+    csc_spfree(M);
+    return OSQP_NULL;
+  }
+
+  // Column pointers nondecreasing and at most nnz
+  for (j = 0; j < n; j++) {
+    if ((M->p[j + 1] < M->p[j]) || (M->p[j + 1] > nnz)) break;
+  }
+  if (j == n) {
+    for (k = 0; k < nnz; k++) {
+      if ((M->i[k] < 0) || (M->i[k] >= m)) break;
+    }
+  }
+  if ((j < n) || (k < nnz)) {
+    csc_spfree(M);
+    return OSQP_NULL;
+  }
+
+  return M;
+}
+
+// Read an optional array of the settings of length len
+static c_int read_setting_array(IOCursor *c, c_int len, const c_int **v) {
+  c_int  slen;
+  c_int *a;
+
+  if (!read_ints(c, &slen, 1) || ((slen != 0) && (slen != len))) return 0;
+  if (slen == 0) return 1;
+
+  a = (c_int *)c_malloc(slen * sizeof(c_int));
+  if (!a) return 0;
+  *v = a;
+
+  return read_ints(c, a, slen);
+}
+
+// Read the settings, skipping the unknown ones
+static c_int read_settings(IOCursor *c, OSQPSettings *settings, c_int len) {
+  c_int k, j, nset, id, type, ival = 0, slen;
+  c_float fval;
+  char *field, *lib;
+
+  if (!read_ints(c, &nset, 1) || (nset < 0)) return 0;
+
+  for (k = 0; k < nset; k++) {
+    if (!read_ints(c, &id, 1) || !read_ints(c, &type, 1)) return 0;
+    if (type == IO_FLOAT) {
+      if (!read_floats(c, &fval, 1)) return 0;
+    } else if (!read_ints(c, &ival, 1)) return 0;
+
+    for (j = 0; j < IO_NSETTINGS; j++) {
+      if (io_settings[j].id == id) break;
+    }
+    if ((j == IO_NSETTINGS) || ((c_int)io_settings[j].type != type)) continue;
+
+    field = (char *)settings + io_settings[j].offset;
+    switch (io_settings[j].type) {
+    case IO_FLOAT:    memcpy(field, &fval, sizeof(c_float)); break;
+    case IO_LINSYS:   *(enum linsys_solver_type *)field = (enum linsys_solver_type)ival; break;
+    case IO_ORDERING: *(enum ordering_type *)field = (enum ordering_type)ival; break;
+    default:          memcpy(field, &ival, sizeof(c_int)); break;
+    }
+  }
+
+  if (!read_setting_array(c, len, &settings->stages) ||
+      !read_setting_array(c, len, &settings->perm) ||
+      !read_ints(c, &slen, 1) || (slen < 0) ||
+      ((size_t)(c->end - c->p) < (size_t)slen)) return 0;
+
+  if (slen > 0) {
+    lib = (char *)c_malloc(slen + 1);
+    if (!lib) return 0;
+    memcpy(lib, c->p, (size_t)slen);
+    lib[slen] = '\0';
+    c->p     += slen;
+    settings->linsys_solver_lib = lib;
+  }
+
+  return 1;
+}
+
+c_int osqp_read_problem(const char    *filename,
+                        OSQPData     **data,
+                        OSQPSettings **settings,
+                        OSQPObjective *objective) {
+  c_int ok = 0, dims[4], flags;
+  OSQPData     *d = OSQP_NULL;
+  OSQPSettings *s = OSQP_NULL;
+  OSQPObjective obj;
+  IOFile   f;
+  IOCursor c;
+
+  *data = OSQP_NULL;
+  if (settings) *settings = OSQP_NULL;
+  obj.constant = 0.;
+  obj.maximize = 0;
+
+  if (io_open(&f, filename)) {
+#ifdef PRINTING
+    c_eprint("could not open %s", filename);
+#endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  c.p   = (const unsigned char *)f.buf;
+  c.end = c.p + f.len;
+  if ((f.len < 12) || memcmp(c.p, IO_MAGIC, 8)) goto exit;
+  c.isz = c.p[8];
+  c.fsz = c.p[9];
+  flags = c.p[11];
+  if (((c.isz != sizeof(int)) && (c.isz != sizeof(long long))) ||
+      ((c.fsz != sizeof(float)) && (c.fsz != sizeof(double))) ||
+      (c.p[10] != io_little_endian())) goto exit;
+  c.p += 12;
+
+  // The vectors q, l and u must fit in the file before they are allocated
+  if (!read_ints(&c, dims, 4) || !io_has(&c, dims[0], c.fsz) ||
+      !io_has(&c, dims[1], 2 * c.fsz) || (dims[2] < 0) || (dims[3] < 0)) goto exit;
+
+  d = alloc_data(dims[0], dims[1], flags & IO_HAS_LB, flags & IO_HAS_UB);
+  if (!d) goto exit;
+  d->P = read_csc(&c, d->n, d->n, dims[2]);
+  if (!d->P) goto exit;
+  d->A = read_csc(&c, d->m, d->n, dims[3]);
+  if (!d->A || !read_floats(&c, d->q, d->n) || !read_floats(&c, d->l, d->m) ||
+      !read_floats(&c, d->u, d->m)) goto exit;
+  if (d->lb && !read_floats(&c, d->lb, d->n)) goto exit;
+  if (d->ub && !read_floats(&c, d->ub, d->n)) goto exit;
+  if ((flags & IO_HAS_OBJ) &&
+      (!read_floats(&c, &obj.constant, 1) || !read_ints(&c, &obj.maximize, 1))) goto exit;
+
+  if ((flags & IO_HAS_SET) && settings) {
+    s = (OSQPSettings *)c_calloc(1, sizeof(OSQPSettings));
+    if (!s) goto exit;
+    osqp_set_default_settings(s);
+    if (!read_settings(&c, s, d->n + d->m)) goto exit;
+  }
+  ok = 1;
+
+exit:
+  io_close(&f);
+  if (!ok) {
+#ifdef PRINTING
+    c_eprint("%s is not a valid problem file", filename);
+#endif /* ifdef PRINTING */
+    osqp_free_problem(d, s);
+    return 1;
+  }
+  *data = d;
+  if (settings) *settings = s;
+  if (objective) *objective = obj;
+
+  return 0;
+}
+
+
+/*********************************
+*  QPS files                    *
+*********************************/
+
+/// Growable array of triplets
+typedef struct {
+  c_int    nnz, nzmax;
+  c_int   *i, *j;
+  c_float *x;
+} IOTriplets;
+
+static c_int trip_add(IOTriplets *T, c_int i, c_int j, c_float x) {
+  c_int    nzmax;
+  c_int   *ti, *tj;
+  c_float *tx;
+
+  if (T->nnz == T->nzmax) {
+    nzmax = c_max(2 * T->nzmax, 64);
+    ti = (c_int *)c_realloc(T->i, nzmax * sizeof(c_int));
+    if (ti) T->i = ti;
+    tj = (c_int *)c_realloc(T->j, nzmax * sizeof(c_int));
+    if (tj) T->j = tj;
+    tx = (c_float *)c_realloc(T->x, nzmax * sizeof(c_float));
+    if (tx) T->x = tx;
+    if (!ti || !tj || !tx) return 1;
+    T->nzmax = nzmax;
+  }
+  T->i[T->nnz] = i;
+  T->j[T->nnz] = j;
+  T->x[T->nnz] = x;
+  T->nnz++;
+
+  return 0;
+}
+
+static void trip_free(IOTriplets *T) {
+  if (T->i) c_free(T->i);
+  if (T->j) c_free(T->j);
+  if (T->x) c_free(T->x);
+}
+
+/**
+ * Compressed column form of the triplets with the rows sorted in each column
+ * and the duplicate elements summed
+ */
+static csc* trip_to_csc(const IOTriplets *T, c_int m, c_int n) {
+  c_int  k, j, p, q, last, *cnt, *order, *tmp;
+  csc   *M;
+
+  M     = csc_spalloc(m, n, c_max(T->nnz, 1), 1, 0);
+  cnt   = (c_int *)c_calloc(c_max(m, n) + 1, sizeof(c_int));
+  order = (c_int *)c_malloc(c_max(T->nnz, 1) * sizeof(c_int));
+  tmp   = (c_int *)c_malloc(c_max(T->nnz, 1) * sizeof(c_int));
+  if (!M || !cnt || !order || !tmp) {
+    if (M) csc_spfree(M);
+    c_free(cnt);
+    c_free(order);
+    c_free(tmp);
+    return OSQP_NULL;
+  }
+
+  // Counting sort by row, then stable counting sort by column
+  for (k = 0; k < T->nnz; k++) cnt[T->i[k] + 1]++;
+  for (k = 0; k < m; k++) cnt[k + 1] += cnt[k];
+  for (k = 0; k < T->nnz; k++) tmp[cnt[T->i[k]]++] = k;
+
+  for (k = 0; k <= n; k++) cnt[k] = 0;
+  for (k = 0; k < T->nnz; k++) cnt[T->j[k] + 1]++;
+  for (k = 0; k < n; k++) cnt[k + 1] += cnt[k];
+  for (k = 0; k < T->nnz; k++) order[cnt[T->j[tmp[k]]]++] = tmp[k];
+
+  // Sum the duplicates
+  p = 0;
+  q = 0;
+  for (j = 0; j < n; j++) {
+    M->p[j] = p;
+    last    = -1;
+    for (; q < cnt[j]; q++) {
+      k = order[q];
+      if (T->i[k] == last) {
+        M->x[p - 1] += T->x[k];
+      } else {
+        M->i[p]   = T->i[k];
+        M->x[p++] = T->x[k];
+        last      = T->i[k];
+      }
+    }
+  }
+  M->p[n] = p;
+
+  c_free(cnt);
+  c_free(order);
+  c_free(tmp);
+
+  return M;
+}
+
+/// Hash table of the names of the rows or columns
+typedef struct {
+  char  **names; ///< names in order of insertion
+  c_int   count, size;
+  c_int  *table; ///< index of the name in each slot (-1 if empty)
+  c_int   tsize;
+} IONames;
+
+static unsigned long name_hash(const char *s) {
+  unsigned long h = 5381;
+
+  while (*s) h = h * 33 + (unsigned char)*s++;
+
+  return h;
+}
+
+// Index of a name, -1 if not found
+static c_int names_find(const IONames *N, const char *s) {
+  unsigned long h;
+  c_int k;
+
+  if (!N->tsize) return -1;
+  for (h = name_hash(s) % N->tsize; N->table[h] >= 0; h = (h + 1) % N->tsize) {
+    k = N->table[h];
+    if (!strcmp(N->names[k], s)) return k;
+  }
+
+  return -1;
+}
+
+// Add a new name and return its index, -1 if the allocation failed
+static c_int names_add(IONames *N, const char *s) {
+  c_int    k, tsize, *table;
+  char   **names;
+  size_t   len = strlen(s);
+  unsigned long h;
+
+  if (N->count == N->size) {
+    N->size = c_max(2 * N->size, 64);
+    names   = (char **)c_realloc(N->names, N->size * sizeof(char *));
+    if (!names) return -1;
+    N->names = names;
+  }
+
+  // Rehash at half occupancy
+  if (2 * (N->count + 1) > N->tsize) {
+    tsize = c_max(2 * N->tsize, 128);
+    table = (c_int *)c_malloc(tsize * sizeof(c_int));
+    if (!table) return -1;
+    for (k = 0; k < tsize; k++) table[k] = -1;
+    for (k = 0; k < N->count; k++) {
+      for (h = name_hash(N->names[k]) % tsize; table[h] >= 0; h = (h + 1) % tsize) ;
+      table[h] = k;
+    }
+    if (N->table) c_free(N->table);
+    N->table = table;
+    N->tsize = tsize;
+  }
+
+  N->names[N->count] = (char *)c_malloc(len + 1);
+  if (!N->names[N->count]) return -1;
+  memcpy(N->names[N->count], s, len + 1);
+  for (h = name_hash(s) % N->tsize; N->table[h] >= 0; h = (h + 1) % N->tsize) ;
+  N->table[h] = N->count;
+
+  return N->count++;
+}
+
+static void names_free(IONames *N) {
+  c_int k;
+
+  for (k = 0; k < N->count; k++) c_free(N->names[k]);
+  if (N->names) c_free(N->names);
+  if (N->table) c_free(N->table);
+}
+
+/// Sections of a QPS file
+enum qps_section {
+  QPS_NONE, QPS_NAME, QPS_OBJSENSE, QPS_ROWS, QPS_COLUMNS, QPS_RHS,
+  QPS_RANGES, QPS_BOUNDS, QPS_QUADOBJ, QPS_QMATRIX, QPS_ENDATA, QPS_UNKNOWN
+};
+
+/// Contents of a QPS file being read
+typedef struct {
+  IONames    rows, cols;
+  char      *row_type;            ///< N, E, L or G
+  c_float   *rhs, *range;         ///< right-hand side and range of the rows
+  c_int     *has_range;
+  c_float   *q, *lb, *ub;         ///< cost and bounds of the columns
+  c_int     *lb_set;              ///< the lower bound is given
+  c_int      rows_size, cols_size;
+  c_int      obj;                 ///< index of the objective row
+  c_int      maximize;
+  c_float    obj_rhs;             ///< right-hand side of the objective row
+  IOTriplets A, P;
+} QPSReader;
+
+static void qps_free(QPSReader *r) {
+  names_free(&r->rows);
+  names_free(&r->cols);
+  c_free(r->row_type);
+  c_free(r->rhs);
+  c_free(r->range);
+  c_free(r->has_range);
+  c_free(r->q);
+  c_free(r->lb);
+  c_free(r->ub);
+  c_free(r->lb_set);
+  trip_free(&r->A);
+  trip_free(&r->P);
+}
+
+// Grow the arrays of the rows or columns to hold index k
+static c_int qps_grow(void **a, c_int size, c_int new_size, size_t elem) {
+  void *b = c_realloc(*a, new_size * elem);
+
+  if (!b) return 1;
+  memset((char *)b + size * elem, 0, (new_size - size) * elem);
+  *a = b;
+
+  return 0;
+}
+
+static c_int qps_add_row(QPSReader *r, const char *name, char type) {
+  c_int k, size;
+
+  if (names_find(&r->rows, name) >= 0) return -1;
+  k = names_add(&r->rows, name);
+  if (k < 0) return -1;
+  if (k == r->rows_size) {
+    size = c_max(2 * r->rows_size, 64);
+    if (qps_grow((void **)&r->row_type, r->rows_size, size, sizeof(char)) ||
+        qps_grow((void **)&r->rhs, r->rows_size, size, sizeof(c_float)) ||
+        qps_grow((void **)&r->range, r->rows_size, size, sizeof(c_float)) ||
+        qps_grow((void **)&r->has_range, r->rows_size, size, sizeof(c_int))) return -1;
+    r->rows_size = size;
+  }
+  r->row_type[k] = type;
+
+  return k;
+}
+
+// Index of a column, added with the default bounds if new
+static c_int qps_col(QPSReader *r, const char *name) {
+  c_int k = names_find(&r->cols, name), size;
+
+  if (k >= 0) return k;
+  k = names_add(&r->cols, name);
+  if (k < 0) return -1;
+  if (k == r->cols_size) {
+    size = c_max(2 * r->cols_size, 64);
+    if (qps_grow((void **)&r->q, r->cols_size, size, sizeof(c_float)) ||
+        qps_grow((void **)&r->lb, r->cols_size, size, sizeof(c_float)) ||
+        qps_grow((void **)&r->ub, r->cols_size, size, sizeof(c_float)) ||
+        qps_grow((void **)&r->lb_set, r->cols_size, size, sizeof(c_int))) return -1;
+    r->cols_size = size;
+  }
+  r->lb[k] = 0.;
+  r->ub[k] = OSQP_INFTY;
+
+  return k;
+}
+
+// Value clipped to [-OSQP_INFTY, OSQP_INFTY]
+static c_float qps_value(const char *s, c_int *ok) {
+  char  *end;
+  double v = strtod(s, &end);
+
+  if ((end == s) || *end) *ok = 0;
+
+  return (c_float)c_min(c_max(v, -OSQP_INFTY), OSQP_INFTY);
+}
+
+static enum qps_section qps_section_of(const char *s) {
+  if (!strcmp(s, "NAME")) return QPS_NAME;
+  if (!strcmp(s, "OBJSENSE") || !strcmp(s, "OBJSENS")) return QPS_OBJSENSE;
+  if (!strcmp(s, "ROWS")) return QPS_ROWS;
+  if (!strcmp(s, "COLUMNS")) return QPS_COLUMNS;
+  if (!strcmp(s, "RHS")) return QPS_RHS;
+  if (!strcmp(s, "RANGES")) return QPS_RANGES;
+  if (!strcmp(s, "BOUNDS")) return QPS_BOUNDS;
+  if (!strcmp(s, "QUADOBJ")) return QPS_QUADOBJ;
+  if (!strcmp(s, "QMATRIX") || !strcmp(s, "QSECTION")) return QPS_QMATRIX;
+  if (!strcmp(s, "ENDATA")) return QPS_ENDATA;
+
+  return QPS_UNKNOWN;
+}
+
+// Read the pairs of rows and values of a COLUMNS, RHS or RANGES line
+static c_int qps_row_values(QPSReader *r, char **tok, c_int ntok,
+                            enum qps_section sec, c_int col) {
+  c_int k, i, ok = 1;
+  c_float v;
+
+  for (k = (ntok % 2) ? 1 : 0; k + 1 < ntok; k += 2) {
+    v = qps_value(tok[k + 1], &ok);
+    if (!ok) return 1;
+    if ((i = names_find(&r->rows, tok[k])) < 0) return 1;
+
+    if (sec == QPS_COLUMNS) {
+      if (i == r->obj) r->q[col] += v;
+      else if (trip_add(&r->A, i, col, v)) return 1;
+    } else if (sec == QPS_RHS) {
+      // The right-hand side of the objective is minus its constant
+      if (i == r->obj) r->obj_rhs = v;
+      else r->rhs[i] = v;
+    } else if (i != r->obj) {
+      r->range[i]     = v;
+      r->has_range[i] = 1;
+    }
+  }
+
+  return 0;
+}
+
+static c_int qps_bound(QPSReader *r, char **tok, c_int ntok) {
+  c_int   j, ok = 1, has_value;
+  c_float v = 0.;
+  const char *type = tok[0];
+
+  has_value = strcmp(type, "FR") && strcmp(type, "MI") &&
+              strcmp(type, "PL") && strcmp(type, "BV");
+
+  // The name of the bound set is optional
+  if (ntok < 2 + has_value) return 1;
+  j = qps_col(r, tok[ntok - 1 - has_value]);
+  if (j < 0) return 1;
+  if (has_value) v = qps_value(tok[ntok - 1], &ok);
+  if (!ok) return 1;
+
+  if (!strcmp(type, "UP") || !strcmp(type, "UI")) {
+    r->ub[j] = v;
+    if ((v < 0.) && !r->lb_set[j]) r->lb[j] = -OSQP_INFTY;
+  } else if (!strcmp(type, "LO") || !strcmp(type, "LI")) {
+    r->lb[j]     = v;
+    r->lb_set[j] = 1;
+  } else if (!strcmp(type, "FX")) {
+    r->lb[j]     = v;
+    r->ub[j]     = v;
+    r->lb_set[j] = 1;
+  } else if (!strcmp(type, "FR")) {
+    r->lb[j]     = -OSQP_INFTY;
+    r->ub[j]     = OSQP_INFTY;
+    r->lb_set[j] = 1;
+  } else if (!strcmp(type, "MI")) {
+    r->lb[j]     = -OSQP_INFTY;
+    r->lb_set[j] = 1;
+  } else if (!strcmp(type, "PL")) {
+    r->ub[j] = OSQP_INFTY;
+  } else if (!strcmp(type, "BV")) {
+    r->lb[j]     = 0.;
+    r->ub[j]     = 1.;
+    r->lb_set[j] = 1;
+  } else if (!strcmp(type, "SC")) {
+    r->ub[j] = v;
+  } else {
+    return 1;
+  }
+
+  return 0;
+}
+
+// Form the problem data from the contents of the file
+static OSQPData* qps_data(QPSReader *r) {
+  c_int     i, j, k, m = 0, n = r->cols.count, has_lb = 0, has_ub = 0;
+  c_int    *row_map;
+  c_float   rhs, range;
+  OSQPData *data;
+
+  // Constraint rows: all rows except the objective
+  row_map = (c_int *)c_malloc(c_max(r->rows.count, 1) * sizeof(c_int));
+  if (!row_map) return OSQP_NULL;
+  for (i = 0; i < r->rows.count; i++) row_map[i] = (i == r->obj) ? -1 : m++;
+
+  for (j = 0; j < n; j++) {
+    if (r->lb[j] > -OSQP_INFTY) has_lb = 1;
+    if (r->ub[j] < OSQP_INFTY) has_ub = 1;
+  }
+
+  data = alloc_data(n, m, has_lb, has_ub);
+  if (!data) {
+    c_free(row_map);
+    return OSQP_NULL;
+  }
+
+  for (i = 0; i < r->rows.count; i++) {
+    if ((k = row_map[i]) < 0) continue;
+    rhs   = r->rhs[i];
+    range = r->has_range[i] ? r->range[i] : 0.;
+    switch (r->row_type[i]) {
+    case 'E':
+      data->l[k] = rhs;
+      data->u[k] = rhs;
+      if (range > 0.) data->u[k] = rhs + range;
+      if (range < 0.) data->l[k] = rhs + range;
+      break;
+
+    case 'L':
+      data->l[k] = r->has_range[i] ? rhs - c_absval(range) : -OSQP_INFTY;
+      data->u[k] = rhs;
+      break;
+
+    case 'G':
+      data->l[k] = rhs;
+      data->u[k] = r->has_range[i] ? rhs + c_absval(range) : OSQP_INFTY;
+      break;
+
+    default: // Free row
+      data->l[k] = -OSQP_INFTY;
+      data->u[k] = OSQP_INFTY;
+      break;
+    }
+  }
+
+  for (j = 0; j < n; j++) {
+    data->q[j] = r->maximize ? -r->q[j] : r->q[j];
+    if (has_lb) data->lb[j] = r->lb[j];
+    if (has_ub) data->ub[j] = r->ub[j];
+  }
+
+  // Renumber the rows of A and form the upper triangular part of P
+  for (k = 0; k < r->A.nnz; k++) r->A.i[k] = row_map[r->A.i[k]];
+  if (r->maximize) {
+    for (k = 0; k < r->P.nnz; k++) r->P.x[k] = -r->P.x[k];
+  }
+  c_free(row_map);
+
+  data->A = trip_to_csc(&r->A, m, n);
+  data->P = trip_to_csc(&r->P, n, n);
+  if (!data->A || !data->P) {
+    osqp_free_problem(data, OSQP_NULL);
+    return OSQP_NULL;
+  }
+
+  return data;
+}
+
+c_int osqp_read_qps(const char    *filename,
+                    OSQPData     **data,
+                    OSQPObjective *objective) {
+  c_int  ntok, line = 0, i, j, k, err = 0, ok, header;
+  size_t len;
+  char   buf[IO_MAX_TOKENS * (IO_MAX_NAME + 1)];
+  char  *tok[IO_MAX_TOKENS];
+  const char *s, *end, *eol;
+  enum qps_section sec = QPS_NONE;
+  c_float   v;
+  QPSReader r;
+  IOFile    f;
+
+  *data = OSQP_NULL;
+  if (io_open(&f, filename)) {
+#ifdef PRINTING
+    c_eprint("could not open %s", filename);
+#endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  memset(&r, 0, sizeof(QPSReader));
+  r.obj = -1;
+
+  s   = f.buf;
+  end = f.buf + f.len;
+  while (!err && (s < end) && (sec != QPS_ENDATA)) {
+    eol = (const char *)memchr(s, '\n', (size_t)(end - s));
+    if (!eol) eol = end;
+    line++;
+
+    // Section headers start in the first column, data lines do not
+    header = (*s != ' ') && (*s != '\t');
+
+    // Split the line into tokens, skipping the comments
+    ntok = 0;
+    for (k = 0; s < eol; k += IO_MAX_NAME + 1) {
+      while ((s < eol) && ((*s == ' ') || (*s == '\t') || (*s == '\r'))) s++;
+      if ((s == eol) || ((ntok == 0) && (*s == '*'))) break;
+      if (ntok == IO_MAX_TOKENS) {
+        err = 1;
+        break;
+      }
+      tok[ntok++] = buf + k;
+      for (len = 0; (s < eol) && (*s != ' ') && (*s != '\t') && (*s != '\r'); s++) {
+        if (len < IO_MAX_NAME) buf[k + len++] = *s;
+      }
+      buf[k + len] = '\0';
+    }
+    s = (eol < end) ? eol + 1 : end;
+    if (err || (ntok == 0)) continue;
+
+    if (header && (qps_section_of(tok[0]) != QPS_UNKNOWN)) {
+      sec = qps_section_of(tok[0]);
+      if ((sec == QPS_OBJSENSE) && (ntok > 1)) {
+        r.maximize = !strcmp(tok[1], "MAX") || !strcmp(tok[1], "MAXIMIZE");
+      }
+
+      // QSECTION of a row other than the objective: quadratic constraints
+      if ((sec == QPS_QMATRIX) && (ntok > 1) &&
+          ((r.obj < 0) || strcmp(tok[1], r.rows.names[r.obj]))) err = 1;
+      continue;
+    }
+
+    switch (sec) {
+    case QPS_OBJSENSE:
+      r.maximize = !strcmp(tok[0], "MAX") || !strcmp(tok[0], "MAXIMIZE");
+      break;
+
+    case QPS_ROWS:
+      if ((ntok < 2) || (strlen(tok[0]) != 1) || !strchr("NELG", tok[0][0])) {
+        err = 1;
+        break;
+      }
+      if ((tok[0][0] == 'N') && (r.obj < 0)) {
+        r.obj = qps_add_row(&r, tok[1], 'N');
+        err   = r.obj < 0;
+      } else {
+        err = qps_add_row(&r, tok[1], tok[0][0]) < 0;
+      }
+      break;
+
+    case QPS_COLUMNS:
+      if ((ntok >= 3) && !strcmp(tok[1], "'MARKER'")) break;
+      if ((ntok != 3) && (ntok != 5)) {
+        err = 1;
+        break;
+      }
+      j   = qps_col(&r, tok[0]);
+      err = (j < 0) || qps_row_values(&r, tok + 1, ntok - 1, sec, j);
+      break;
+
+    case QPS_RHS:
+    case QPS_RANGES:
+      err = qps_row_values(&r, tok, ntok, sec, 0);
+      break;
+
+    case QPS_BOUNDS:
+      err = qps_bound(&r, tok, ntok);
+      break;
+
+    case QPS_QUADOBJ:
+    case QPS_QMATRIX:
+      ok = 1;
+      if (ntok != 3) {
+        err = 1;
+        break;
+      }
+      i = qps_col(&r, tok[0]);
+      j = qps_col(&r, tok[1]);
+      v = qps_value(tok[2], &ok);
+      if ((i < 0) || (j < 0) || !ok) {
+        err = 1;
+        break;
+      }
+
+      // QMATRIX lists both triangles, QUADOBJ only one of them
+      if ((sec == QPS_QMATRIX) && (i > j)) break;
+      err = trip_add(&r.P, c_min(i, j), c_max(i, j), v);
+      break;
+
+    case QPS_NAME:
+      break;
+
+    default:
+      err = 1;
+      break;
+    }
+  }
+  io_close(&f);
+
+  if (!err && (sec != QPS_ENDATA)) err = 1;
+  if (!err) {
+    *data = qps_data(&r);
+    if (!*data) err = 1;
+    line = 0;
+  }
+  if (!err && objective) {
+    objective->constant = -r.obj_rhs;
+    objective->maximize = r.maximize;
+  }
+  qps_free(&r);
+
+  if (err) {
+#ifdef PRINTING
+    if (line > 0) {
+      c_eprint("error in %s at line %i", filename, (int)line);
+    } else {
+      c_eprint("could not read %s", filename);
+    }
+#endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+ * Type, right-hand side and range of a constraint with both bounds finite and
+ * different. The range is searched among the neighbours of u - l so that the
+ * bound computed from it by the reader, rhs + range for a G row or
+ * rhs - range for an L row, is exact whenever possible.
+ */
+static char range_row(c_float l, c_float u, c_float *rhs, c_float *range) {
+  c_int   k;
+  c_float r_up = u - l, r_dn = u - l;
+
+  for (k = 0; k <= IO_RANGE_STEPS; k++) {
+    if (l + r_up == u) {
+      *rhs   = l;
+      *range = r_up;
+      return 'G';
+    }
+    if (u - r_up == l) {
+      *rhs   = u;
+      *range = r_up;
+      return 'L';
+    }
+    if (l + r_dn == u) {
+      *rhs   = l;
+      *range = r_dn;
+      return 'G';
+    }
+    if (u - r_dn == l) {
+      *rhs   = u;
+      *range = r_dn;
+      return 'L';
+    }
+    r_up = IO_NEXTAFTER(r_up, OSQP_INFTY);
+    r_dn = IO_NEXTAFTER(r_dn, 0.);
+  }
+  *rhs   = l;
+  *range = u - l;
+
+  return 'G';
+}
+
+// Type of a constraint row
+static char row_type(c_float l, c_float u) {
+  c_float rhs, range;
+
+  if ((l <= -OSQP_INFTY) && (u >= OSQP_INFTY)) return 'N';
+  if (l == u) return 'E';
+  if (l <= -OSQP_INFTY) return 'L';
+  if (u >= OSQP_INFTY) return 'G';
+
+  return range_row(l, u, &rhs, &range);
+}
+
+// Bound of a variable, infinite if the bound is not given
+static c_float var_bound(const c_float *b, c_int j, c_float inf) {
+  return b ? b[j] : inf;
+}
+
+c_int osqp_write_qps(const char          *filename,
+                     const OSQPData      *data,
+                     const OSQPObjective *objective) {
+  c_int   i, j, k, ok, maximize = objective && objective->maximize;
+  c_float l, u, rhs, range;
+  FILE   *f;
+
+  if (!data || !data->P || !data->A) return 1;
+
+  f = fopen(filename, "w");
+  if (!f) {
+#ifdef PRINTING
+    c_eprint("could not open %s", filename);
+#endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  fprintf(f, "NAME          OSQP\n");
+  if (maximize) fprintf(f, "OBJSENSE\n    MAX\n");
+  fprintf(f, "ROWS\n N  OBJ\n");
+  for (i = 0; i < data->m; i++) {
+    fprintf(f, " %c  R%i\n", row_type(data->l[i], data->u[i]), (int)i + 1);
+  }
+
+  fprintf(f, "COLUMNS\n");
+  for (j = 0; j < data->n; j++) {
+    if (data->q[j] != 0.) {
+      fprintf(f, "    C%i  OBJ  " IO_FLOAT_FMT "\n", (int)j + 1,
+              maximize ? -data->q[j] : data->q[j]);
+    }
+    for (k = data->A->p[j]; k < data->A->p[j + 1]; k++) {
+      fprintf(f, "    C%i  R%i  " IO_FLOAT_FMT "\n", (int)j + 1,
+              (int)data->A->i[k] + 1, data->A->x[k]);
+    }
+  }
+
+  fprintf(f, "RHS\n");
+  if (objective && (objective->constant != 0.)) {
+    fprintf(f, "    RHS  OBJ  " IO_FLOAT_FMT "\n", -objective->constant);
+  }
+  for (i = 0; i < data->m; i++) {
+    l = data->l[i];
+    u = data->u[i];
+    switch (row_type(l, u)) {
+    case 'N': continue;
+    case 'L': rhs = u; break;
+    default:  rhs = l; break;
+    }
+    if ((l > -OSQP_INFTY) && (u < OSQP_INFTY) && (l != u)) range_row(l, u, &rhs, &range);
+    fprintf(f, "    RHS  R%i  " IO_FLOAT_FMT "\n", (int)i + 1, rhs);
+  }
+
+  fprintf(f, "RANGES\n");
+  for (i = 0; i < data->m; i++) {
+    l = data->l[i];
+    u = data->u[i];
+    if ((l > -OSQP_INFTY) && (u < OSQP_INFTY) && (l != u)) {
+      range_row(l, u, &rhs, &range);
+      fprintf(f, "    RNG  R%i  " IO_FLOAT_FMT "\n", (int)i + 1, range);
+    }
+  }
+
+  // The default bounds of a variable are 0 and infinity
+  fprintf(f, "BOUNDS\n");
+  for (j = 0; j < data->n; j++) {
+    l = var_bound(data->lb, j, -OSQP_INFTY);
+    u = var_bound(data->ub, j, OSQP_INFTY);
+    if ((l <= -OSQP_INFTY) && (u >= OSQP_INFTY)) {
+      fprintf(f, " FR BND  C%i\n", (int)j + 1);
+    } else if (l == u) {
+      fprintf(f, " FX BND  C%i  " IO_FLOAT_FMT "\n", (int)j + 1, l);
+    } else {
+      if (l <= -OSQP_INFTY) fprintf(f, " MI BND  C%i\n", (int)j + 1);
+      else if ((l != 0.) || (u < 0.)) {
+        fprintf(f, " LO BND  C%i  " IO_FLOAT_FMT "\n", (int)j + 1, l);
+      }
+      if (u < OSQP_INFTY) fprintf(f, " UP BND  C%i  " IO_FLOAT_FMT "\n", (int)j + 1, u);
+    }
+  }
+
+  if (data->P->p[data->n] > 0) {
+    fprintf(f, "QUADOBJ\n");
+    for (j = 0; j < data->n; j++) {
+      for (k = data->P->p[j]; k < data->P->p[j + 1]; k++) {
+        fprintf(f, "    C%i  C%i  " IO_FLOAT_FMT "\n", (int)data->P->i[k] + 1,
+                (int)j + 1, maximize ? -data->P->x[k] : data->P->x[k]);
+      }
+    }
+  }
+  fprintf(f, "ENDATA\n");
+
+  ok = !ferror(f);
+  if (fclose(f)) ok = 0;
+
+#ifdef PRINTING
+  if (!ok) {
+    c_eprint("could not write %s", filename);
+  }
+#endif /* ifdef PRINTING */
+
+  return !ok;
+}
@@ -0,0 +1,582 @@
+#include "osqp.h"
+#include "auxil.h"
+#include "lin_alg.h"
+#include "error.h"
+
+#ifdef CTRLC
+# include "ctrlc.h"
+#endif /* ifdef CTRLC */
+
+
+/**
+ * Root of the tree of variable i in the disjoint-set forest
+ */
+static c_int find_root(c_int *parent, c_int i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]]; // Path halving
+    i         = parent[i];
+  }
+  return i;
+}
+
+/**
+ * Merge the trees of variables i and j. The smallest index becomes the root.
+ */
+static void join(c_int *parent, c_int i, c_int j) {
+  i = find_root(parent, i);
+  j = find_root(parent, j);
+
+  if (i < j) parent[j] = i;
+  else if (j < i) parent[i] = j;
+}
+
+/**
+ * Find the connected components of the problem and store the variables and
+ * constraints of each of them in decomp.
+ * @param  decomp Decomposition
+ * @param  data   Problem data
+ * @return        Exitflag: 1 if memory allocation failed
+ */
+static c_int find_components(OSQPDecomposition *decomp, const OSQPData *data) {
+  c_int i, j, k, ptr, exitflag = 0;
+  c_int n = data->n;
+  c_int m = data->m;
+  c_int *parent, *row_var, *comp, *count;
+
+  parent  = c_malloc(n * sizeof(c_int));
+  comp    = c_malloc(n * sizeof(c_int));
+  row_var = c_malloc(m * sizeof(c_int));
+  count   = c_calloc(n + 1, sizeof(c_int));
+  if (!parent || !comp || !count || (m && !row_var)) {
+    exitflag = 1;
+    goto exit;
+  }
+
+  for (i = 0; i < n; i++) parent[i] = i;
+  for (i = 0; i < m; i++) row_var[i] = -1;
+
+  // Off-diagonal elements of P couple their row and column variables
+  for (j = 0; j < n; j++) {
+    for (ptr = data->P->p[j]; ptr < data->P->p[j + 1]; ptr++) {
+      if (data->P->i[ptr] != j) join(parent, data->P->i[ptr], j);
+    }
+  }
+
+  // All the variables of a row of A are coupled with the first one
+  for (j = 0; j < n; j++) {
+    for (ptr = data->A->p[j]; ptr < data->A->p[j + 1]; ptr++) {
+      i = data->A->i[ptr];
+      if (row_var[i] < 0) row_var[i] = j;
+      else join(parent, row_var[i], j);
+    }
+  }
+
+  // Number the components in the order of their first variable
+  decomp->ncomp = 0;
+  for (i = 0; i < n; i++) {
+    k = find_root(parent, i);
+    comp[i] = (k == i) ? decomp->ncomp++ : comp[k];
+  }
+
+  decomp->var_ptr = c_malloc((decomp->ncomp + 1) * sizeof(c_int));
+  decomp->con_ptr = c_malloc((decomp->ncomp + 1) * sizeof(c_int));
+  decomp->var_idx = c_malloc(n * sizeof(c_int));
+  decomp->con_idx = c_malloc(m * sizeof(c_int));
+  if (!(decomp->var_ptr) || !(decomp->con_ptr) || !(decomp->var_idx) ||
+      (m && !(decomp->con_idx))) {
+    exitflag = 1;
+    goto exit;
+  }
+
+  // Variables sorted by component
+  for (i = 0; i < n; i++) count[comp[i]]++;
+  csc_cumsum(decomp->var_ptr, count, decomp->ncomp);
+  for (i = 0; i < n; i++) decomp->var_idx[count[comp[i]]++] = i;
+
+  // Constraints sorted by component. Empty rows go to the first one.
+  for (k = 0; k < decomp->ncomp; k++) count[k] = 0;
+  for (i = 0; i < m; i++) {
+    row_var[i] = (row_var[i] < 0) ? 0 : comp[row_var[i]];
+    count[row_var[i]]++;
+  }
+  csc_cumsum(decomp->con_ptr, count, decomp->ncomp);
+  for (i = 0; i < m; i++) decomp->con_idx[count[row_var[i]]++] = i;
+
+exit:
+  c_free(parent);
+  c_free(comp);
+  c_free(row_var);
+  c_free(count);
+
+  return exitflag;
+}
+
+/**
+ * Free the data of a subproblem
+ */
+static void free_sub_data(OSQPData *data) {
+  if (data) {
+    if (data->P) csc_spfree(data->P);
+    if (data->A) csc_spfree(data->A);
+    c_free(data->q);
+    c_free(data->l);
+    c_free(data->u);
+    c_free(data->lb);
+    c_free(data->ub);
+    c_free(data);
+  }
+}
+
+/**
+ * Extract the columns of M of the variables of component k. The rows are
+ * renumbered with row_loc.
+ */
+static csc* extract_columns(const csc               *M,
+                            c_int                    nrows,
+                            const OSQPDecomposition *decomp,
+                            c_int                    k,
+                            const c_int             *row_loc) {
+  c_int j, ptr, nz = 0;
+  c_int start = decomp->var_ptr[k];
+  c_int ncols = decomp->var_ptr[k + 1] - start;
+  csc  *S;
+
+  for (j = 0; j < ncols; j++) {
+    nz += M->p[decomp->var_idx[start + j] + 1] - M->p[decomp->var_idx[start + j]];
+  }
+
+  S = csc_spalloc(nrows, ncols, nz, 1, 0);
+  if (!S) return OSQP_NULL;
+
+  // Rows of the same component keep their order, hence they stay sorted
+  nz = 0;
+  for (j = 0; j < ncols; j++) {
+    S->p[j] = nz;
+    for (ptr = M->p[decomp->var_idx[start + j]];
+         ptr < M->p[decomp->var_idx[start + j] + 1]; ptr++) {
+      S->i[nz] = row_loc[M->i[ptr]];
+      S->x[nz] = M->x[ptr];
+      nz++;
+    }
+  }
+  S->p[ncols] = nz;
+
+  return S;
+}
+
+/**
+ * Form the data of component k
+ * @param  decomp  Decomposition
+ * @param  data    Problem data
+ * @param  k       Component
+ * @param  var_loc Index of each variable within its component
+ * @param  con_loc Index of each constraint within its component
+ * @return         Data of the subproblem. OSQP_NULL if allocation failed
+ */
+static OSQPData* form_sub_data(const OSQPDecomposition *decomp,
+                               const OSQPData          *data,
+                               c_int                    k,
+                               const c_int             *var_loc,
+                               const c_int             *con_loc) {
+  c_int i, j;
+  OSQPData *sub = c_calloc(1, sizeof(OSQPData));
+
+  if (!sub) return OSQP_NULL;
+
+  sub->n = decomp->var_ptr[k + 1] - decomp->var_ptr[k];
+  sub->m = decomp->con_ptr[k + 1] - decomp->con_ptr[k];
+  sub->P = extract_columns(data->P, sub->n, decomp, k, var_loc);
+  sub->A = extract_columns(data->A, sub->m, decomp, k, con_loc);
+  sub->q = c_malloc(sub->n * sizeof(c_float));
+  sub->l = c_malloc(sub->m * sizeof(c_float));
+  sub->u = c_malloc(sub->m * sizeof(c_float));
+  if (!(sub->P) || !(sub->A) || !(sub->q) ||
+      (sub->m && (!(sub->l) || !(sub->u)))) {
+    free_sub_data(sub);
+    return OSQP_NULL;
+  }
+
+  for (i = 0; i < sub->n; i++) {
+    sub->q[i] = data->q[decomp->var_idx[decomp->var_ptr[k] + i]];
+  }
+  for (i = 0; i < sub->m; i++) {
+    sub->l[i] = data->l[decomp->con_idx[decomp->con_ptr[k] + i]];
+    sub->u[i] = data->u[decomp->con_idx[decomp->con_ptr[k] + i]];
+  }
+
+  // Variable bounds
+  if (data->lb) sub->lb = c_malloc(sub->n * sizeof(c_float));
+  if (data->ub) sub->ub = c_malloc(sub->n * sizeof(c_float));
+  if ((data->lb && !(sub->lb)) || (data->ub && !(sub->ub))) {
+    free_sub_data(sub);
+    return OSQP_NULL;
+  }
+  for (i = 0; i < sub->n; i++) {
+    j = decomp->var_idx[decomp->var_ptr[k] + i];
+    if (data->lb) sub->lb[i] = data->lb[j];
+    if (data->ub) sub->ub[i] = data->ub[j];
+  }
+
+  return sub;
+}
+
+/**
+ * Set up the workspace of component k
+ * @return Exitflag of osqp_setup
+ */
+static c_int setup_component(OSQPDecomposition  *decomp,
+                             const OSQPData     *data,
+                             const OSQPSettings *settings,
+                             c_int               k,
+                             const c_int        *var_loc,
+                             const c_int        *con_loc,
+                             const c_int        *sub_perm) {
+  c_int i, exitflag;
+  c_int *stages = OSQP_NULL;
+  OSQPSettings sub_settings = *settings;
+  OSQPData    *sub          = form_sub_data(decomp, data, k, var_loc, con_loc);
+
+  if (!sub) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  // The subproblems do not print their own output
+  sub_settings.verbose = 0;
+
+  // Stages of the variables and constraints of the component
+  if (settings->stages) {
+    stages = c_malloc((sub->n + sub->m) * sizeof(c_int));
+    if (!stages) {
+      free_sub_data(sub);
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    }
+    for (i = 0; i < sub->n; i++) {
+      stages[i] = settings->stages[decomp->var_idx[decomp->var_ptr[k] + i]];
+    }
+    for (i = 0; i < sub->m; i++) {
+      stages[sub->n + i] =
+        settings->stages[data->n + decomp->con_idx[decomp->con_ptr[k] + i]];
+    }
+    sub_settings.stages = stages;
+  }
+
+  // User ordering of the component
+  if (sub_perm) {
+    sub_settings.perm = sub_perm + decomp->var_ptr[k] + decomp->con_ptr[k];
+  }
+
+  exitflag = osqp_setup(&(decomp->work[k]), sub, &sub_settings);
+
+#ifdef CTRLC
+  // The listener is installed once by osqp_solve_decomposed
+  if (decomp->work[k]) decomp->work[k]->shared_interrupt_listener = 1;
+#endif /* ifdef CTRLC */
+
+  free_sub_data(sub);
+  c_free(stages);
+
+  return exitflag;
+}
+
+/**
+ * Order of the status values from the best to the worst one. The status of
+ * the whole problem is the worst status of the subproblems.
+ */
+static c_int status_rank(c_int status_val) {
+  switch (status_val) {
+  case OSQP_SOLVED:                       return 0;
+  case OSQP_SOLVED_INACCURATE:            return 1;
+  case OSQP_MAX_ITER_REACHED:             return 2;
+#ifdef PROFILING
+  case OSQP_TIME_LIMIT_REACHED:           return 3;
+#endif /* ifdef PROFILING */
+  case OSQP_SIGINT:                       return 4;
+  case OSQP_DUAL_INFEASIBLE_INACCURATE:   return 5;
+  case OSQP_PRIMAL_INFEASIBLE_INACCURATE: return 6;
+  case OSQP_DUAL_INFEASIBLE:              return 7;
+  case OSQP_PRIMAL_INFEASIBLE:            return 8;
+  case OSQP_NON_CVX:                      return 9;
+  default:                                return 10;
+  }
+}
+
+
+c_int osqp_setup_decomposed(OSQPDecomposition  **decompp,
+                            const OSQPData      *data,
+                            const OSQPSettings  *settings) {
+  c_int k, i, j, m_sol, exitflag = 0, parallel_setup;
+  c_int *var_loc, *con_loc, *sub_perm = OSQP_NULL;
+  OSQPDecomposition *decomp;
+  OSQPData           data_nb; // Data without the variable bounds
+
+  // The variable bounds are only read with the var_bounds setting
+  if (data && settings && !settings->var_bounds) {
+    copy_data_without_var_bounds(data, &data_nb);
+    data = &data_nb;
+  }
+
+  // Validate data. The settings are validated by the setup of the subproblems.
+  if (validate_data(data)) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  if (validate_settings(settings)) return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  if (settings->stages && validate_stages(data, settings->stages))
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  if ((settings->ordering == USER_ORDERING) && validate_perm(data, settings->perm))
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+
+  decomp = c_calloc(1, sizeof(OSQPDecomposition));
+  if (!decomp) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  *decompp = decomp;
+
+# ifdef PROFILING
+  decomp->timer = c_malloc(sizeof(OSQPTimer));
+  if (!(decomp->timer)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  // Tic before the parallel setup so that the clock is calibrated once
+  osqp_tic(decomp->timer);
+# endif /* ifdef PROFILING */
+
+  decomp->n = data->n;
+  decomp->m = data->m;
+
+  // Independent subproblems
+  if (find_components(decomp, data)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  // Index of each variable and constraint within its subproblem
+  var_loc = c_malloc(data->n * sizeof(c_int));
+  con_loc = c_malloc(data->m * sizeof(c_int));
+  decomp->work = c_calloc(decomp->ncomp, sizeof(OSQPWorkspace *));
+  if (!var_loc || (data->m && !con_loc) || !(decomp->work)) {
+    c_free(var_loc);
+    c_free(con_loc);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+  for (k = 0; k < decomp->ncomp; k++) {
+    for (i = decomp->var_ptr[k]; i < decomp->var_ptr[k + 1]; i++)
+      var_loc[decomp->var_idx[i]] = i - decomp->var_ptr[k];
+    for (i = decomp->con_ptr[k]; i < decomp->con_ptr[k + 1]; i++)
+      con_loc[decomp->con_idx[i]] = i - decomp->con_ptr[k];
+  }
+
+  // Restrict the user ordering to each subproblem keeping the relative order.
+  // The permutation of component k starts at var_ptr[k] + con_ptr[k].
+  if (settings->ordering == USER_ORDERING) {
+    c_int *comp, *pos;
+
+    sub_perm = c_malloc((data->n + data->m) * sizeof(c_int));
+    comp     = c_malloc((data->n + data->m) * sizeof(c_int));
+    pos      = c_malloc(decomp->ncomp * sizeof(c_int));
+    if (!sub_perm || !comp || !pos) {
+      c_free(var_loc);
+      c_free(con_loc);
+      c_free(sub_perm);
+      c_free(comp);
+      c_free(pos);
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    }
+    for (k = 0; k < decomp->ncomp; k++) {
+      pos[k] = decomp->var_ptr[k] + decomp->con_ptr[k];
+      for (i = decomp->var_ptr[k]; i < decomp->var_ptr[k + 1]; i++)
+        comp[decomp->var_idx[i]] = k;
+      for (i = decomp->con_ptr[k]; i < decomp->con_ptr[k + 1]; i++)
+        comp[data->n + decomp->con_idx[i]] = k;
+    }
+    for (i = 0; i < data->n + data->m; i++) {
+      j = settings->perm[i];
+      k = comp[j];
+      sub_perm[pos[k]++] = (j < data->n) ? var_loc[j] :
+                           decomp->var_ptr[k + 1] - decomp->var_ptr[k] +
+                           con_loc[j - data->n];
+    }
+    c_free(comp);
+    c_free(pos);
+  }
+
+  // Loading the MKL Pardiso and plugin libraries is not thread safe
+  parallel_setup = (settings->linsys_solver == QDLDL_SOLVER) ||
+                   (settings->linsys_solver == NORMAL_SOLVER);
+  (void)parallel_setup;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic) if (parallel_setup)
+#endif /* ifdef _OPENMP */
+  for (k = 0; k < decomp->ncomp; k++) {
+    c_int flag = setup_component(decomp, data, settings, k, var_loc, con_loc,
+                                 sub_perm);
+
+    if (flag) {
+#ifdef _OPENMP
+      #pragma omp critical
+#endif /* ifdef _OPENMP */
+      if (!exitflag) exitflag = flag;
+    }
+  }
+
+  c_free(var_loc);
+  c_free(con_loc);
+  c_free(sub_perm);
+
+  if (exitflag) return exitflag;
+
+  // Solution and information of the whole problem
+  decomp->solution    = c_calloc(1, sizeof(OSQPSolution));
+  decomp->info        = c_calloc(1, sizeof(OSQPInfo));
+  if (!(decomp->solution) || !(decomp->info))
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  m_sol               = data->m + ((data->lb || data->ub) ? data->n : 0);
+  decomp->solution->x = c_calloc(data->n, sizeof(c_float));
+  decomp->solution->y = c_calloc(m_sol, sizeof(c_float));
+  if (!(decomp->solution->x) || (m_sol && !(decomp->solution->y)))
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  // The multipliers of the variable bounds follow the ones of the constraints
+  if (data->lb || data->ub) decomp->solution->y_bnd = decomp->solution->y + data->m;
+
+  update_status(decomp->info, OSQP_UNSOLVED);
+  decomp->info->rho_estimate = settings->rho;
+
+# ifdef PRINTING
+  if (settings->verbose) {
+    c_print("OSQP decomposed the problem into %i independent subproblems\n",
+            (int)decomp->ncomp);
+  }
+# endif /* ifdef PRINTING */
+
+# ifdef PROFILING
+  decomp->info->setup_time = osqp_toc(decomp->timer);
+  decomp->first_run        = 1;
+# endif /* ifdef PROFILING */
+
+  return 0;
+}
+
+
+c_int osqp_solve_decomposed(OSQPDecomposition *decomp) {
+  c_int k, i, exitflag = 0;
+  OSQPInfo *info;
+
+  if (!decomp) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+# ifdef PROFILING
+  osqp_tic(decomp->timer);
+# endif /* ifdef PROFILING */
+
+#ifdef CTRLC
+  // Install a single Ctrl-C listener shared by all the subproblem solves
+  osqp_start_interrupt_listener();
+#endif /* ifdef CTRLC */
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif /* ifdef _OPENMP */
+  for (k = 0; k < decomp->ncomp; k++) {
+    c_int flag = osqp_solve(decomp->work[k]);
+
+    if (flag) {
+#ifdef _OPENMP
+      #pragma omp critical
+#endif /* ifdef _OPENMP */
+      if (!exitflag) exitflag = flag;
+    }
+  }
+
+#ifdef CTRLC
+  // Restore previous signal handler
+  osqp_end_interrupt_listener();
+#endif /* ifdef CTRLC */
+
+  // Stitch the solutions and the solver information together
+  info                = decomp->info;
+  info->iter          = 0;
+  info->status_polish = 1;
+  info->obj_val       = 0.0;
+  info->pri_res       = 0.0;
+  info->dua_res       = 0.0;
+  info->rho_updates   = 0;
+  update_status(info, OSQP_SOLVED);
+# ifdef PROFILING
+  info->polish_time   = 0.0;
+  for (i = 0; i < PROFILE_NPHASES; i++) {
+    info->profile.time[i]  = 0.0;
+    info->profile.calls[i] = 0;
+  }
+# endif /* ifdef PROFILING */
+
+  for (k = 0; k < decomp->ncomp; k++) {
+    OSQPWorkspace *work = decomp->work[k];
+
+    for (i = 0; i < decomp->var_ptr[k + 1] - decomp->var_ptr[k]; i++)
+      decomp->solution->x[decomp->var_idx[decomp->var_ptr[k] + i]] = work->solution->x[i];
+    for (i = 0; i < decomp->con_ptr[k + 1] - decomp->con_ptr[k]; i++)
+      decomp->solution->y[decomp->con_idx[decomp->con_ptr[k] + i]] = work->solution->y[i];
+    if (decomp->solution->y_bnd) {
+      for (i = 0; i < decomp->var_ptr[k + 1] - decomp->var_ptr[k]; i++)
+        decomp->solution->y_bnd[decomp->var_idx[decomp->var_ptr[k] + i]] =
+          work->solution->y_bnd[i];
+    }
+
+    if (status_rank(work->info->status_val) > status_rank(info->status_val))
+      update_status(info, work->info->status_val);
+
+    // The subproblem with the most iterations gives the rho estimate
+    if (work->info->iter >= info->iter) {
+      info->iter         = work->info->iter;
+      info->rho_estimate = work->info->rho_estimate;
+    }
+    info->status_polish = c_min(info->status_polish, work->info->status_polish);
+    info->obj_val      += work->info->obj_val;
+    info->pri_res       = c_max(info->pri_res, work->info->pri_res);
+    info->dua_res       = c_max(info->dua_res, work->info->dua_res);
+    info->rho_updates  += work->info->rho_updates;
+# ifdef PROFILING
+    info->polish_time = c_max(info->polish_time, work->info->polish_time);
+
+    // The phases of the subproblems are summed
+    for (i = 0; i < PROFILE_NPHASES; i++) {
+      info->profile.time[i]  += work->info->profile.time[i];
+      info->profile.calls[i] += work->info->profile.calls[i];
+    }
+# endif /* ifdef PROFILING */
+  }
+
+# ifdef PROFILING
+  info->solve_time = osqp_toc(decomp->timer) - info->polish_time;
+  info->run_time   = info->solve_time + info->polish_time;
+  if (decomp->first_run) {
+    info->run_time   += info->setup_time;
+    decomp->first_run = 0;
+  }
+# endif /* ifdef PROFILING */
+
+  return exitflag;
+}
+
+
+c_int osqp_cleanup_decomposed(OSQPDecomposition *decomp) {
+  c_int k, exitflag = 0;
+
+  if (decomp) {
+    if (decomp->work) {
+      for (k = 0; k < decomp->ncomp; k++) {
+        if (decomp->work[k] && osqp_cleanup(decomp->work[k])) exitflag = 1;
+      }
+      c_free(decomp->work);
+    }
+
+    if (decomp->solution) {
+      c_free(decomp->solution->x);
+      c_free(decomp->solution->y);
+      c_free(decomp->solution);
+    }
+    c_free(decomp->info);
+
+    c_free(decomp->var_ptr);
+    c_free(decomp->var_idx);
+    c_free(decomp->con_ptr);
+    c_free(decomp->con_idx);
+
+# ifdef PROFILING
+    c_free(decomp->timer);
+# endif /* ifdef PROFILING */
+
+    c_free(decomp);
+  }
+
+  return exitflag;
+}
@@ -0,0 +1,252 @@
+#include "derivative.h"
+#include "lin_alg.h"
+#include "lin_sys.h"
+#include "kkt.h"
+#include "util.h"
+#include "error.h"
+
+/**
+ * Guess if row j of A is lower- or upper-active at the solution from the
+ * primal and dual solution as in polish.
+ */
+static c_int is_lower_active(OSQPWorkspace *work, c_int j) {
+  return work->z[j] - work->data->l[j] < -work->y[j];
+}
+
+static c_int is_upper_active(OSQPWorkspace *work, c_int j) {
+  return work->data->u[j] - work->z[j] < work->y[j];
+}
+
+/**
+ * Allocate the derivative structure
+ * @param  work Workspace
+ * @return      Exitflag
+ */
+static c_int init_derivative(OSQPWorkspace *work) {
+  OSQPDerivative *d = c_calloc(1, sizeof(OSQPDerivative));
+
+  if (!d) return 1;
+
+  d->A_to_Ared = c_malloc(work->data->m * sizeof(c_int));
+  d->Ared_to_A = c_malloc(work->data->m * sizeof(c_int));
+  if (work->data->m && (!(d->A_to_Ared) || !(d->Ared_to_A))) {
+    if (d->A_to_Ared) c_free(d->A_to_Ared);
+    if (d->Ared_to_A) c_free(d->Ared_to_A);
+    c_free(d);
+    return 1;
+  }
+
+  work->deriv = d;
+  return 0;
+}
+
+/**
+ * Form the reduced matrix Ared that contains the rows of A active at the
+ * solution. The matrix and its KKT factorization are kept if the active set
+ * did not change.
+ * @param  work Workspace
+ * @return      Exitflag
+ */
+static c_int form_Ared(OSQPWorkspace *work) {
+  c_int j, ptr, pos, mred, Ared_nnz, changed, exitflag;
+  c_int *stages;
+  OSQPDerivative *d = work->deriv;
+
+  changed = (d->linsys_solver == OSQP_NULL);
+  mred    = 0;
+
+  for (j = 0; j < work->data->m; j++) {
+    if (is_lower_active(work, j) || is_upper_active(work, j)) {
+      d->Ared_to_A[mred] = j;
+      pos                = mred++;
+    } else {
+      pos = -1;
+    }
+
+    if (!changed && (d->A_to_Ared[j] != pos)) changed = 1;
+    d->A_to_Ared[j] = pos;
+  }
+
+  if (!changed) return 0;
+
+  // Active set changed: the factorization has to be recomputed
+  derivative_free_factorization(work);
+  if (d->Ared) csc_spfree(d->Ared);
+  d->mred = mred;
+
+  // Count number of elements in Ared
+  Ared_nnz = 0;
+  for (ptr = 0; ptr < work->data->A->p[work->data->n]; ptr++) {
+    if (d->A_to_Ared[work->data->A->i[ptr]] != -1) Ared_nnz++;
+  }
+
+  d->Ared = csc_spalloc(mred, work->data->n, Ared_nnz, 1, 0);
+  if (!(d->Ared)) return OSQP_MEM_ALLOC_ERROR;
+
+  Ared_nnz = 0;
+  for (j = 0; j < work->data->n; j++) {
+    d->Ared->p[j] = Ared_nnz;
+    for (ptr = work->data->A->p[j]; ptr < work->data->A->p[j + 1]; ptr++) {
+      pos = d->A_to_Ared[work->data->A->i[ptr]];
+      if (pos != -1) {
+        d->Ared->i[Ared_nnz]   = pos;
+        d->Ared->x[Ared_nnz++] = work->data->A->x[ptr];
+      }
+    }
+  }
+  d->Ared->p[work->data->n] = Ared_nnz;
+
+  // Stages of the variables and active rows (AMD ordering if not available)
+  stages = OSQP_NULL;
+  if (work->stages) {
+    stages = c_malloc((work->data->n + mred) * sizeof(c_int));
+    if (stages) {
+      prea_int_vec_copy(work->stages, stages, work->data->n);
+      for (j = 0; j < mred; j++) {
+        stages[work->data->n + j] = work->stages[work->data->n + d->Ared_to_A[j]];
+      }
+    }
+  }
+
+  // Form and factorize the regularized KKT matrix
+  //    [P + delta I    Ared'   ]
+  //    [Ared        -delta I   ]
+  exitflag = init_linsys_solver(&(d->linsys_solver), work->data->P, d->Ared,
+                                work->settings->delta, OSQP_NULL,
+                                work->settings->linsys_solver, 1, stages,
+                                work->settings->ordering, OSQP_NULL);
+  if (stages) c_free(stages);
+
+  return exitflag;
+}
+
+/**
+ * Compute the residuals R = G - K * X of the unregularized KKT system
+ *    K = [P     Ared']
+ *        [Ared  0    ]
+ * for nrhs columns.
+ */
+static void kkt_residual(OSQPWorkspace *work,
+                         c_int          nrhs,
+                         const c_float *G,
+                         const c_float *X,
+                         c_float       *R) {
+  c_int i, n, N;
+  const csc *Ared = work->deriv->Ared;
+
+  n = work->data->n;
+  N = n + work->deriv->mred;
+
+  for (i = 0; i < nrhs; i++) {
+    prea_vec_copy(G + i * N, R + i * N, N);
+    mat_vec(work->data->P, X + i * N, R + i * N, -1);
+    mat_tpose_vec(work->data->P, X + i * N, R + i * N, -1, 1);
+    mat_tpose_vec(Ared, X + i * N + n, R + i * N, -1, 0);
+    mat_vec(Ared, X + i * N, R + i * N + n, -1);
+  }
+}
+
+c_int adjoint_derivative(OSQPWorkspace *work,
+                         c_int          nrhs,
+                         const c_float *dx,
+                         const c_float *dy,
+                         c_float       *dq,
+                         c_float       *dl,
+                         c_float       *du) {
+  c_int i, j, k, n, m, N, exitflag;
+  c_float *G, *X, *R, *r;
+  c_float c;
+  OSQPDerivative *d;
+
+  if (!(work->deriv) && init_derivative(work))
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  d = work->deriv;
+
+  // Form the KKT matrix of the active constraints (if changed)
+  exitflag = form_Ared(work);
+  if (exitflag) {
+    // Force a new factorization at the next call
+    derivative_free_factorization(work);
+    return osqp_error(exitflag);
+  }
+
+  n = work->data->n;
+  m = work->data->m;
+  N = n + d->mred;
+  c = work->settings->scaling ? work->scaling->c : 1.;
+
+  G = (c_float *)c_malloc(N * nrhs * sizeof(c_float));
+  X = (c_float *)c_malloc(N * nrhs * sizeof(c_float));
+  R = (c_float *)c_malloc(N * nrhs * sizeof(c_float));
+  if (!G || !X || !R) {
+    if (G) c_free(G);
+    if (X) c_free(X);
+    if (R) c_free(R);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  // Scale the gradients
+  //    d/dx_scaled = D * d/dx,   d/dy_scaled = E * d/dy / c
+  for (i = 0; i < nrhs; i++) {
+    prea_vec_copy(dx + i * n, G + i * N, n);
+    for (k = 0; k < d->mred; k++) {
+      G[i * N + n + k] = dy ? dy[i * m + d->Ared_to_A[k]] : 0.;
+    }
+    if (work->settings->scaling) {
+      vec_ew_prod(work->scaling->D, G + i * N, G + i * N, n);
+      for (k = 0; k < d->mred; k++) {
+        G[i * N + n + k] *= work->scaling->E[d->Ared_to_A[k]] * work->scaling->cinv;
+      }
+    }
+  }
+
+  // Solve the adjoint system K' * X = G. K is symmetric.
+  prea_vec_copy(G, X, N * nrhs);
+  exitflag = d->linsys_solver->solve_multi(d->linsys_solver, X, nrhs);
+
+  // Iterative refinement to compensate for the regularization
+  for (k = 0; !exitflag && k < work->settings->polish_refine_iter; k++) {
+    kkt_residual(work, nrhs, G, X, R);
+    exitflag = d->linsys_solver->solve_multi(d->linsys_solver, R, nrhs);
+    for (j = 0; j < N * nrhs; j++) X[j] += R[j];
+  }
+
+  if (!exitflag) {
+    for (i = 0; i < nrhs; i++) {
+      r = X + i * N;
+
+      // dq = -c * D * x
+      for (j = 0; j < n; j++) {
+        dq[i * n + j] = work->settings->scaling ?
+                        -c * work->scaling->D[j] * r[j] : -r[j];
+      }
+
+      // dl and du = E * y on the lower and upper active constraints
+      if (dl) vec_set_scalar(dl + i * m, 0., m);
+      if (du) vec_set_scalar(du + i * m, 0., m);
+      for (k = 0; k < d->mred; k++) {
+        j = d->Ared_to_A[k];
+        if (is_lower_active(work, j)) {
+          if (dl) dl[i * m + j] = work->settings->scaling ?
+                                  work->scaling->E[j] * r[n + k] : r[n + k];
+        } else {
+          if (du) du[i * m + j] = work->settings->scaling ?
+                                  work->scaling->E[j] * r[n + k] : r[n + k];
+        }
+      }
+    }
+  }
+
+  c_free(G);
+  c_free(X);
+  c_free(R);
+
+  return exitflag;
+}
+
+void derivative_free_factorization(OSQPWorkspace *work) {
+  if (work->deriv && work->deriv->linsys_solver) {
+    work->deriv->linsys_solver->free(work->deriv->linsys_solver);
+    work->deriv->linsys_solver = OSQP_NULL;
+  }
+}
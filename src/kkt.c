@@ -221,4 +221,26 @@ void update_KKT_param2(csc *KKT, const c_float *param2,
   }
 }
 
+#ifndef EMBEDDED
+
+void update_KKT_param1(csc         *KKT,
+                       const c_int *perm,
+                       const c_int  n,
+                       c_float      shift) {
+  c_int k, ptr;
+
+  for (k = 0; k < KKT->n; k++) {
+    if ((perm ? perm[k] : k) >= n) continue;
+
+    for (ptr = KKT->p[k]; ptr < KKT->p[k + 1]; ptr++) {
+      if (KKT->i[ptr] == k) {
+        KKT->x[ptr] += shift;
+        break;
+      }
+    }
+  }
+}
+
+#endif /* ifndef EMBEDDED */
+
 #endif // EMBEDDED != 1
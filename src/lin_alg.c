@@ -383,6 +383,193 @@ void mat_inf_norm_cols_sym_triu(const csc *M, c_float *E) {
 
 #endif /* if EMBEDDED != 1 */
 
+#ifndef EMBEDDED
+
+c_int mat_is_dense(const csc *A) {
+  c_int j, ptr;
+
+  if (A->p[A->n] != A->m * A->n) return 0;
+
+  for (j = 0; j < A->n; j++) {
+    for (ptr = A->p[j]; ptr < A->p[j + 1]; ptr++) {
+      if (A->i[ptr] != ptr - j * A->m) return 0;
+    }
+  }
+  return 1;
+}
+
+c_int mat_is_dense_triu(const csc *P) {
+  c_int j, ptr;
+
+  if (P->m != P->n) return 0;
+
+  for (j = 0; j < P->n; j++) {
+    if (P->p[j] != j * (j + 1) / 2) return 0;
+    for (ptr = P->p[j]; ptr < P->p[j + 1]; ptr++) {
+      if (P->i[ptr] != ptr - P->p[j]) return 0;
+    }
+  }
+  return P->p[P->n] == P->n * (P->n + 1) / 2;
+}
+
+void mat_vec_dense(const csc *A, const c_float *x, c_float *y, c_int plus_eq) {
+  c_int i, j, m = A->m;
+  const c_float *a0, *a1, *a2, *a3;
+  c_float x0, x1, x2, x3, sc;
+
+  if (!plus_eq) vec_set_scalar(y, 0., m);
+  sc = (plus_eq == -1) ? -1. : 1.;
+
+  // Update y with four columns at a time
+  for (j = 0; j + 3 < A->n; j += 4) {
+    a0 = A->x + j * m;
+    a1 = a0 + m;
+    a2 = a1 + m;
+    a3 = a2 + m;
+    x0 = sc * x[j];
+    x1 = sc * x[j + 1];
+    x2 = sc * x[j + 2];
+    x3 = sc * x[j + 3];
+    for (i = 0; i < m; i++) {
+      y[i] += a0[i] * x0 + a1[i] * x1 + a2[i] * x2 + a3[i] * x3;
+    }
+  }
+  for (; j < A->n; j++) {
+    a0 = A->x + j * m;
+    x0 = sc * x[j];
+    for (i = 0; i < m; i++) y[i] += a0[i] * x0;
+  }
+}
+
+void mat_tpose_vec_dense(const csc *A, const c_float *x, c_float *y, c_int plus_eq) {
+  c_int j, m = A->m;
+  c_float yj;
+
+  for (j = 0; j < A->n; j++) {
+    yj = vec_prod(A->x + j * m, x, m);
+    if (plus_eq == 0)       y[j]  = yj;
+    else if (plus_eq == -1) y[j] -= yj;
+    else                    y[j] += yj;
+  }
+}
+
+void mat_vec_dense_sym_triu(const csc *P, const c_float *x, c_float *y) {
+  c_int i, j;
+  const c_float *p;
+  c_float xj, yj;
+
+  vec_set_scalar(y, 0., P->n);
+
+  // Column j holds the elements (0..j, j) of the upper triangle
+  for (j = 0; j < P->n; j++) {
+    p  = P->x + P->p[j];
+    xj = x[j];
+    yj = 0.;
+    for (i = 0; i < j; i++) {
+      y[i] += p[i] * xj;
+      yj   += p[i] * x[i];
+    }
+    y[j] += yj + p[j] * xj;
+  }
+}
+
+/**
+ * Product of the block row I of A with A->xp, stored in the block row I of
+ * A->yp. The common block sizes are passed as constants so that the loops
+ * over a block are unrolled.
+ */
+static void bsr_row_vec(const bsr *A, c_int I, c_int bs) {
+  c_int k, r, c;
+  const c_float *a, *xb;
+  c_float *yb = A->yp + I * bs;
+  c_float  yr;
+
+  for (r = 0; r < bs; r++) yb[r] = 0.;
+
+  for (k = A->p[I]; k < A->p[I + 1]; k++) {
+    a  = A->x + k * bs * bs;
+    xb = A->xp + A->j[k] * bs;
+    for (r = 0; r < bs; r++) {
+      yr = 0.;
+      for (c = 0; c < bs; c++) yr += a[r * bs + c] * xb[c];
+      yb[r] += yr;
+    }
+  }
+}
+
+/**
+ * Add the product of the transpose of the block row I of A with the block
+ * row I of A->xp to A->yp
+ */
+static void bsr_row_tpose_vec(const bsr *A, c_int I, c_int bs) {
+  c_int k, r, c;
+  const c_float *a;
+  const c_float *xb = A->xp + I * bs;
+  c_float *yb;
+  c_float  yc;
+
+  for (k = A->p[I]; k < A->p[I + 1]; k++) {
+    a  = A->x + k * bs * bs;
+    yb = A->yp + A->j[k] * bs;
+    for (c = 0; c < bs; c++) {
+      yc = 0.;
+      for (r = 0; r < bs; r++) yc += a[r * bs + c] * xb[r];
+      yb[c] += yc;
+    }
+  }
+}
+
+void bsr_mat_vec(const bsr *A, const c_float *x, c_float *y, c_int plus_eq) {
+  c_int I, i;
+
+  // Padded copy of x
+  prea_vec_copy(x, A->xp, A->n);
+  vec_set_scalar(A->xp + A->n, 0., A->nb * A->bs - A->n);
+
+  for (I = 0; I < A->mb; I++) {
+    switch (A->bs) {
+    case 2:  bsr_row_vec(A, I, 2); break;
+    case 3:  bsr_row_vec(A, I, 3); break;
+    case 4:  bsr_row_vec(A, I, 4); break;
+    case 6:  bsr_row_vec(A, I, 6); break;
+    default: bsr_row_vec(A, I, A->bs);
+    }
+  }
+
+  for (i = 0; i < A->m; i++) {
+    if (plus_eq == 0)       y[i]  = A->yp[i];
+    else if (plus_eq == -1) y[i] -= A->yp[i];
+    else                    y[i] += A->yp[i];
+  }
+}
+
+void bsr_mat_tpose_vec(const bsr *A, const c_float *x, c_float *y, c_int plus_eq) {
+  c_int I, j;
+
+  // Padded copy of x
+  prea_vec_copy(x, A->xp, A->m);
+  vec_set_scalar(A->xp + A->m, 0., A->mb * A->bs - A->m);
+  vec_set_scalar(A->yp, 0., A->nb * A->bs);
+
+  for (I = 0; I < A->mb; I++) {
+    switch (A->bs) {
+    case 2:  bsr_row_tpose_vec(A, I, 2); break;
+    case 3:  bsr_row_tpose_vec(A, I, 3); break;
+    case 4:  bsr_row_tpose_vec(A, I, 4); break;
+    case 6:  bsr_row_tpose_vec(A, I, 6); break;
+    default: bsr_row_tpose_vec(A, I, A->bs);
+    }
+  }
+
+  for (j = 0; j < A->n; j++) {
+    if (plus_eq == 0)       y[j]  = A->yp[j];
+    else if (plus_eq == -1) y[j] -= A->yp[j];
+    else                    y[j] += A->yp[j];
+  }
+}
+
+#endif /* ifndef EMBEDDED */
+
 
 c_float quad_form(const csc *P, const c_float *x) {
   c_float quad_form = 0.;
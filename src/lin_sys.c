@@ -1,18 +1,27 @@
 #include "lin_sys.h"
+#include "util.h"
 
 #include "qdldl_interface.h" // Include only this solver in the same directory
 
 const char *LINSYS_SOLVER_NAME[] = {
-  "qdldl", "mkl pardiso"
+  "qdldl", "mkl pardiso", "plugin", "normal equations"
 };
 
+const char *ORDERING_NAME[] = {
+  "amd", "rcm", "nested dissection", "user"
+};
+
+#include "plugin_loader.h"
+#include "normal_interface.h"
+
 #ifdef ENABLE_MKL_PARDISO
 # include "pardiso_interface.h"
 # include "pardiso_loader.h"
 #endif /* ifdef ENABLE_MKL_PARDISO */
 
 // Load linear system solver shared library
-c_int load_linsys_solver(enum linsys_solver_type linsys_solver) {
+c_int load_linsys_solver(enum linsys_solver_type linsys_solver,
+                         const char             *libname) {
   switch (linsys_solver) {
   case QDLDL_SOLVER:
 
@@ -23,9 +32,19 @@ c_int load_linsys_solver(enum linsys_solver_type linsys_solver) {
   case MKL_PARDISO_SOLVER:
 
     // Load Pardiso library
-    return lh_load_pardiso(OSQP_NULL);
+    return lh_load_pardiso(libname);
 
 # endif /* ifdef ENABLE_MKL_PARDISO */
+  case PLUGIN_SOLVER:
+
+    // Load plugin library
+    return lh_load_plugin(libname);
+
+  case NORMAL_SOLVER:
+
+    // We do not load the normal equations solver. We have the source.
+    return 0;
+
   default: // QDLDL
     return 0;
   }
@@ -46,6 +65,16 @@ c_int unload_linsys_solver(enum linsys_solver_type linsys_solver) {
     return lh_unload_pardiso();
 
 # endif /* ifdef ENABLE_MKL_PARDISO */
+  case PLUGIN_SOLVER:
+
+    // Unload plugin library
+    return lh_unload_plugin();
+
+  case NORMAL_SOLVER:
+
+    // We do not load the normal equations solver. We have the source.
+    return 0;
+
   default: //  QDLDL
     return 0;
   }
@@ -59,17 +88,63 @@ c_int init_linsys_solver(LinSysSolver          **s,
                          c_float                 sigma,
                          const c_float          *rho_vec,
                          enum linsys_solver_type linsys_solver,
-                         c_int                   polish) {
+                         c_int                   polish,
+                         const c_int            *stages,
+                         enum ordering_type      ordering,
+                         OSQPProfile            *profile) {
+  c_int exitflag;
+
+#ifdef PROFILING
+  OSQPTimer timer;
+#endif /* ifdef PROFILING */
+
+  // The other solvers do not report their phases and the whole
+  // initialization is profiled as the factorization
+  PROFILE_TIC(&timer);
+
   switch (linsys_solver) {
   case QDLDL_SOLVER:
-    return init_linsys_solver_qdldl((qdldl_solver **)s, P, A, sigma, rho_vec, polish);
+    return init_linsys_solver_qdldl((qdldl_solver **)s, P, A, sigma, rho_vec, polish, stages, ordering, profile);
 
 # ifdef ENABLE_MKL_PARDISO
   case MKL_PARDISO_SOLVER:
-    return init_linsys_solver_pardiso((pardiso_solver **)s, P, A, sigma, rho_vec, polish);
+    exitflag = init_linsys_solver_pardiso((pardiso_solver **)s, P, A, sigma, rho_vec, polish);
+    break;
 
 # endif /* ifdef ENABLE_MKL_PARDISO */
+  case PLUGIN_SOLVER:
+    exitflag = init_linsys_solver_plugin(s, P, A, sigma, rho_vec, polish);
+    break;
+
+  case NORMAL_SOLVER:
+    exitflag = init_linsys_solver_normal((normal_solver **)s, P, A, sigma, rho_vec, polish);
+    break;
+
   default: // QDLDL
-    return init_linsys_solver_qdldl((qdldl_solver **)s, P, A, sigma, rho_vec, polish);
+    return init_linsys_solver_qdldl((qdldl_solver **)s, P, A, sigma, rho_vec, polish, stages, ordering, profile);
+  }
+
+  PROFILE_TOC(profile, PROFILE_FACTOR, &timer);
+
+  return exitflag;
+}
+
+// Number of nonzeros of the factor of the KKT matrix for a given ordering
+c_int kkt_fill(const csc         *P,
+               const csc         *A,
+               const c_int       *stages,
+               enum ordering_type ordering) {
+  return kkt_fill_qdldl(P, A, stages, ordering);
+}
+
+// Statistics of the factorization held by a linear system solver
+c_int linsys_factor_stats(LinSysSolver    *s,
+                          OSQPFactorStats *stats) {
+  switch (s->type) {
+  case QDLDL_SOLVER:
+    return factor_stats_qdldl((qdldl_solver *)s, stats);
+
+  default: // The other solvers do not expose their factors
+    return 1;
   }
 }
@@ -4,10 +4,15 @@
 #include "scaling.h"
 #include "glob_opts.h"
 #include "error.h"
+#include "probes.h"
 
 
 #ifndef EMBEDDED
 # include "polish.h"
+# include "derivative.h"
+# include "warm_cache.h"
+# include "trace.h"
+# include "presolve.h"
 #endif /* ifndef EMBEDDED */
 
 #ifdef CTRLC
@@ -50,12 +55,31 @@ void osqp_set_default_settings(OSQPSettings *settings) {
   settings->linsys_solver = LINSYS_SOLVER;           /* relaxation parameter */
 
 #ifndef EMBEDDED
+  settings->linsys_solver_lib  = OSQP_NULL;          /* default linear system
+                                                        solver library */
+  settings->stages             = OSQP_NULL;          /* stages of a
+                                                        multi-stage problem */
+  settings->ordering           = ORDERING;           /* ordering of the KKT
+                                                        matrix */
+  settings->perm               = OSQP_NULL;          /* user ordering */
   settings->delta              = DELTA;              /* regularization parameter
                                                         for polish */
   settings->polish             = POLISH;             /* ADMM solution polish: 1
                                                       */
   settings->polish_refine_iter = POLISH_REFINE_ITER; /* iterative refinement
                                                         steps in polish */
+  settings->warm_start_cache   = WARM_START_CACHE;   /* number of cached
+                                                        solutions */
+  settings->presolve           = PRESOLVE;           /* remove fixed variables
+                                                        and constraints */
+  settings->var_bounds         = VAR_BOUNDS;         /* read the variable
+                                                        bounds of the data */
+  settings->trace_interval     = TRACE_INTERVAL;     /* iterations between
+                                                        trace records */
+  settings->trace_buffer       = TRACE_BUFFER;       /* trace records kept by
+                                                        the recorder */
+  settings->trace_callback     = OSQP_NULL;          /* trace callback */
+  settings->trace_data         = OSQP_NULL;          /* trace callback data */
   settings->verbose            = VERBOSE;            /* print output */
 #endif /* ifndef EMBEDDED */
 
@@ -74,15 +98,31 @@ void osqp_set_default_settings(OSQPSettings *settings) {
 
 
 c_int osqp_setup(OSQPWorkspace** workp, const OSQPData *data, const OSQPSettings *settings) {
-  c_int exitflag;
+  c_int exitflag, m_bnd, m_sol, bs, k;
+  const c_int *stages   = settings ? settings->stages : OSQP_NULL;
+  OSQPData    *data_red = OSQP_NULL;
+  OSQPProfile *profile  = OSQP_NULL; // Profile of the setup phases
+  OSQPData     data_nb;              // Data without the variable bounds
 
   OSQPWorkspace * work;
 
+  // The variable bounds are only read with the var_bounds setting
+  if (data && settings && !settings->var_bounds) {
+    copy_data_without_var_bounds(data, &data_nb);
+    data = &data_nb;
+  }
+
   // Validate data
   if (validate_data(data)) return osqp_error(OSQP_DATA_VALIDATION_ERROR);
 
   // Validate settings
   if (validate_settings(settings)) return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  if (settings->stages && validate_stages(data, settings->stages))
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+  if ((settings->ordering == USER_ORDERING) && validate_perm(data, settings->perm))
+    return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+
+  OSQP_PROBE2(setup_begin, data->n, data->m);
 
   // Allocate empty workspace
   work = c_calloc(1, sizeof(OSQPWorkspace));
@@ -96,8 +136,24 @@ c_int osqp_setup(OSQPWorkspace** workp, const OSQPData *data, const OSQPSettings
   osqp_tic(work->timer);
 # endif /* ifdef PROFILING */
 
+  // A user ordering is a stage-wise ordering with one row per stage
+  if (settings->ordering == USER_ORDERING) {
+    work->stages = c_malloc((data->n + data->m) * sizeof(c_int));
+    if (!(work->stages)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    for (k = 0; k < data->n + data->m; k++) work->stages[settings->perm[k]] = k;
+    stages = work->stages;
+  }
+
+  // Remove fixed variables and free, empty and singleton constraints
+  if (settings->presolve) {
+    if (presolve_init(work, data, stages, &data_red))
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    data   = data_red;
+    stages = work->presolve->stages;
+  }
+
   // Copy problem data into workspace
-  work->data = c_malloc(sizeof(OSQPData));
+  work->data = c_calloc(1, sizeof(OSQPData));
   if (!(work->data)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
   work->data->n = data->n;
   work->data->m = data->m;
@@ -115,6 +171,41 @@ c_int osqp_setup(OSQPWorkspace** workp, const OSQPData *data, const OSQPSettings
   if ( data->m && (!(work->data->l) || !(work->data->u)) )
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
+  // Variable bounds. A missing lower or upper bound is infinite.
+  if (data->lb || data->ub) {
+    work->n_bnd    = data->n;
+    work->data->lb = c_malloc(data->n * sizeof(c_float));
+    work->data->ub = c_malloc(data->n * sizeof(c_float));
+    if (!(work->data->lb) || !(work->data->ub))
+      return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    if (data->lb) prea_vec_copy(data->lb, work->data->lb, data->n);
+    else vec_set_scalar(work->data->lb, -OSQP_INFTY, data->n);
+    if (data->ub) prea_vec_copy(data->ub, work->data->ub, data->n);
+    else vec_set_scalar(work->data->ub, OSQP_INFTY, data->n);
+  }
+
+  // The splitting variables and multipliers of the variable bounds follow the
+  // ones of the constraints
+  m_bnd = data->m + work->n_bnd;
+
+  // Stages of a multi-stage problem
+  if (stages && (stages != work->stages)) {
+    if (work->stages) c_free(work->stages);
+    work->stages = c_malloc((data->n + data->m) * sizeof(c_int));
+    if (!(work->stages)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    prea_int_vec_copy(stages, work->stages, data->n + data->m);
+  }
+
+  // The presolved data has been copied
+  if (data_red) {
+    data = work->data;
+    presolve_free_data(data_red);
+  }
+
+  // Use dense matrix-vector products if all elements are stored
+  work->dense_data = mat_is_dense_triu(work->data->P) &&
+                     mat_is_dense(work->data->A);
+
   // Vectorized rho parameter
   work->rho_vec     = c_malloc(data->m * sizeof(c_float));
   work->rho_inv_vec = c_malloc(data->m * sizeof(c_float));
@@ -127,14 +218,14 @@ c_int osqp_setup(OSQPWorkspace** workp, const OSQPData *data, const OSQPSettings
 
   // Allocate internal solver variables (ADMM steps)
   work->x        = c_calloc(data->n, sizeof(c_float));
-  work->z        = c_calloc(data->m, sizeof(c_float));
+  work->z        = c_calloc(m_bnd, sizeof(c_float));
   work->xz_tilde = c_calloc(data->n + data->m, sizeof(c_float));
   work->x_prev   = c_calloc(data->n, sizeof(c_float));
-  work->z_prev   = c_calloc(data->m, sizeof(c_float));
-  work->y        = c_calloc(data->m, sizeof(c_float));
+  work->z_prev   = c_calloc(m_bnd, sizeof(c_float));
+  work->y        = c_calloc(m_bnd, sizeof(c_float));
   if (!(work->x) || !(work->xz_tilde) || !(work->x_prev))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if ( data->m && (!(work->z) || !(work->z_prev) || !(work->y)) )
+  if ( m_bnd && (!(work->z) || !(work->z_prev) || !(work->y)) )
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
   // Initialize variables x, y, z to 0
@@ -146,7 +237,7 @@ c_int osqp_setup(OSQPWorkspace** workp, const OSQPData *data, const OSQPSettings
   work->Aty = c_calloc(data->n, sizeof(c_float));
 
   // Primal infeasibility variables
-  work->delta_y   = c_calloc(data->m, sizeof(c_float));
+  work->delta_y   = c_calloc(m_bnd, sizeof(c_float));
   work->Atdelta_y = c_calloc(data->n, sizeof(c_float));
 
   // Dual infeasibility variables
@@ -157,13 +248,21 @@ c_int osqp_setup(OSQPWorkspace** workp, const OSQPData *data, const OSQPSettings
   if (!(work->Px) || !(work->Aty) || !(work->Atdelta_y) ||
       !(work->delta_x) || !(work->Pdelta_x))
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if ( data->m && (!(work->Ax) || !(work->delta_y) || !(work->Adelta_x)) )
+  if ( data->m && (!(work->Ax) || !(work->Adelta_x)) )
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  if (m_bnd && !(work->delta_y)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
   // Copy settings
   work->settings = copy_settings(settings);
   if (!(work->settings)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
+  // Allocate solution information before the setup phases are profiled
+  work->info = c_calloc(1, sizeof(OSQPInfo));
+  if (!(work->info)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+#ifdef PROFILING
+  profile = &(work->info->profile);
+#endif /* ifdef PROFILING */
+
   // Perform scaling
   if (settings->scaling) {
     // Allocate scaling structure
@@ -197,48 +296,92 @@ c_int osqp_setup(OSQPWorkspace** workp, const OSQPData *data, const OSQPSettings
     work->E_temp   = OSQP_NULL;
   }
 
+  // Block copy of the scaled A for the matrix-vector products if its elements
+  // are grouped in small dense blocks
+  if (!(work->dense_data)) {
+    bs = csc_block_size(work->data->A);
+    if (bs > 1) {
+      work->A_bsr = csc_to_bsr(work->data->A, bs);
+      if (!(work->A_bsr)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    }
+  }
+
   // Set type of constraints
   set_rho_vec(work);
 
   // Load linear system solver
-  if (load_linsys_solver(work->settings->linsys_solver)) return osqp_error(OSQP_LINSYS_SOLVER_LOAD_ERROR);
+  if (load_linsys_solver(work->settings->linsys_solver,
+                         work->settings->linsys_solver_lib))
+    return osqp_error(OSQP_LINSYS_SOLVER_LOAD_ERROR);
 
-  // Initialize linear system solver structure
+  // Initialize linear system solver structure. The ADMM step of the variable
+  // bounds is added to sigma.
   exitflag = init_linsys_solver(&(work->linsys_solver), work->data->P, work->data->A,
-                                work->settings->sigma, work->rho_vec,
-                                work->settings->linsys_solver, 0);
+                                work->settings->sigma + work->rho_bnd, work->rho_vec,
+                                work->settings->linsys_solver, 0, work->stages,
+                                work->settings->ordering, profile);
 
   if (exitflag) {
+    // The library is not unloaded in osqp_cleanup without a solver structure
+    unload_linsys_solver(work->settings->linsys_solver);
     return osqp_error(exitflag);
   }
 
   // Initialize active constraints structure
   work->pol = c_malloc(sizeof(OSQPPolish));
   if (!(work->pol)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  work->pol->Alow_to_A = c_malloc(data->m * sizeof(c_int));
-  work->pol->Aupp_to_A = c_malloc(data->m * sizeof(c_int));
-  work->pol->A_to_Alow = c_malloc(data->m * sizeof(c_int));
-  work->pol->A_to_Aupp = c_malloc(data->m * sizeof(c_int));
+  work->pol->Alow_to_A = c_malloc(m_bnd * sizeof(c_int));
+  work->pol->Aupp_to_A = c_malloc(m_bnd * sizeof(c_int));
+  work->pol->A_to_Alow = c_malloc(m_bnd * sizeof(c_int));
+  work->pol->A_to_Aupp = c_malloc(m_bnd * sizeof(c_int));
+  work->pol->A_to_Afac = c_malloc(m_bnd * sizeof(c_int));
+  work->pol->Afac_to_A = c_malloc(m_bnd * sizeof(c_int));
   work->pol->x         = c_malloc(data->n * sizeof(c_float));
-  work->pol->z         = c_malloc(data->m * sizeof(c_float));
-  work->pol->y         = c_malloc(data->m * sizeof(c_float));
+  work->pol->z         = c_malloc(m_bnd * sizeof(c_float));
+  work->pol->y         = c_malloc(m_bnd * sizeof(c_float));
   if (!(work->pol->x)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if ( data->m && (!(work->pol->Alow_to_A) || !(work->pol->Aupp_to_A) ||
+  if ( m_bnd && (!(work->pol->Alow_to_A) || !(work->pol->Aupp_to_A) ||
       !(work->pol->A_to_Alow) || !(work->pol->A_to_Aupp) ||
+      !(work->pol->A_to_Afac) || !(work->pol->Afac_to_A) ||
       !(work->pol->z) || !(work->pol->y)) )
     return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  work->pol->linsys_solver = OSQP_NULL; // Polish factorization is computed when needed
+  work->pol->m_fac         = 0;
+  work->pol->update_rank   = 0;
+
+  // Allocate warm start cache
+  if (warm_cache_init(work)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+
+  // Allocate trace recorder
+  if (trace_init(work)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
   // Allocate solution
   work->solution = c_calloc(1, sizeof(OSQPSolution));
   if (!(work->solution)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  work->solution->x = c_calloc(1, data->n * sizeof(c_float));
-  work->solution->y = c_calloc(1, data->m * sizeof(c_float));
-  if (!(work->solution->x))            return osqp_error(OSQP_MEM_ALLOC_ERROR);
-  if (data->m && !(work->solution->y)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  if (work->presolve) {
+    // Solution of the original problem. It stores the presolved solution
+    // before the postsolve.
+    m_sol = work->presolve->m + (work->presolve->bnd ? work->presolve->n : 0);
+    m_sol = c_max(m_sol, m_bnd);
+    work->solution->x = c_calloc(1, work->presolve->n * sizeof(c_float));
+    work->solution->y = c_calloc(1, m_sol * sizeof(c_float));
+    if (!(work->solution->x))          return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    if (m_sol && !(work->solution->y)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    if (work->presolve->bnd) {
+      work->solution->y_bnd = work->solution->y + work->presolve->m;
+    }
+  } else {
+    work->solution->x = c_calloc(1, data->n * sizeof(c_float));
+    work->solution->y = c_calloc(1, m_bnd * sizeof(c_float));
+    if (!(work->solution->x))          return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    if (m_bnd && !(work->solution->y)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
 
-  // Allocate and initialize information
-  work->info = c_calloc(1, sizeof(OSQPInfo));
-  if (!(work->info)) return osqp_error(OSQP_MEM_ALLOC_ERROR);
+    // The multipliers of the variable bounds are stored after the ones of
+    // the constraints
+    if (work->n_bnd) work->solution->y_bnd = work->solution->y + data->m;
+  }
+
+  // Initialize information
   work->info->status_polish = 0;              // Polishing not performed
   update_status(work->info, OSQP_UNSOLVED);
 # ifdef PROFILING
@@ -278,10 +421,71 @@ c_int osqp_setup(OSQPWorkspace** workp, const OSQPData *data, const OSQPSettings
   }
 # endif /* ifndef PROFILING */
 
+  OSQP_PROBE2(setup_end, work->data->n, work->data->m);
+
   // Return exit flag
   return 0;
 }
 
+/**
+ * Store all elements of a dense column-major matrix in csc format. If triu,
+ * only the upper triangular part is stored.
+ */
+static csc* dense_to_csc(c_int m, c_int n, const c_float *M, c_int triu) {
+  c_int i, j, nnz = 0;
+  csc  *A = csc_spalloc(m, n, triu ? n * (n + 1) / 2 : m * n, 1, 0);
+
+  if (!A) return OSQP_NULL;
+
+  for (j = 0; j < n; j++) {
+    A->p[j] = nnz;
+    for (i = 0; i < (triu ? j + 1 : m); i++) {
+      A->i[nnz]   = i;
+      A->x[nnz++] = M[j * m + i];
+    }
+  }
+  A->p[n] = nnz;
+
+  return A;
+}
+
+c_int osqp_setup_dense(OSQPWorkspace** workp, const OSQPDenseData *data, const OSQPSettings *settings) {
+  c_int exitflag;
+  OSQPData data_csc;
+
+  if (!data || !(data->P) || (data->m && !(data->A)) || (data->n <= 0)) {
+# ifdef PRINTING
+    c_eprint("Missing data");
+# endif /* ifdef PRINTING */
+    return osqp_error(OSQP_DATA_VALIDATION_ERROR);
+  }
+  if (!settings) return osqp_error(OSQP_SETTINGS_VALIDATION_ERROR);
+
+  // Store all elements of P and A so that the dense kernels are used
+  data_csc.n = data->n;
+  data_csc.m = data->m;
+  data_csc.P = dense_to_csc(data->n, data->n, data->P, 1);
+  data_csc.A = dense_to_csc(data->m, data->n, data->A, 0);
+  data_csc.q = data->q;
+  data_csc.l = data->l;
+  data_csc.u = data->u;
+  data_csc.lb = data->lb;
+  data_csc.ub = data->ub;
+
+  if (!(data_csc.P) || !(data_csc.A)) {
+    if (data_csc.P) csc_spfree(data_csc.P);
+    if (data_csc.A) csc_spfree(data_csc.A);
+    return osqp_error(OSQP_MEM_ALLOC_ERROR);
+  }
+
+  exitflag = osqp_setup(workp, &data_csc, settings);
+
+  csc_spfree(data_csc.P);
+  csc_spfree(data_csc.A);
+
+  return exitflag;
+}
+
 #endif // #ifndef EMBEDDED
 
 
@@ -291,9 +495,12 @@ c_int osqp_solve(OSQPWorkspace *work) {
   c_int iter;
   c_int compute_cost_function; // Boolean: compute the cost function in the loop or not
   c_int can_check_termination; // Boolean: check termination or not
+  c_int can_trace;             // Boolean: record a trace of the iteration or not
 
 #ifdef PROFILING
   c_float temp_run_time;       // Temporary variable to store current run time
+  c_float solve_time;          // Time since the start of the solve
+  c_int   time_check_iter;     // Next iteration at which the time limit is checked
 #endif /* ifdef PROFILING */
 
 #ifdef PRINTING
@@ -303,6 +510,8 @@ c_int osqp_solve(OSQPWorkspace *work) {
   // Check if workspace has been initialized
   if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
+  OSQP_PROBE2(solve_begin, work->data->n, work->data->m);
+
 #ifdef PROFILING
   if (work->clear_update_time == 1)
     work->info->update_time = 0.0;
@@ -324,11 +533,16 @@ c_int osqp_solve(OSQPWorkspace *work) {
                                                    // iterations if no printing
                                                    // enabled
 #endif /* ifdef PRINTING */
+#ifndef EMBEDDED
+  // The trace records contain the objective value
+  if (work->settings->trace_interval) compute_cost_function = 1;
+#endif /* ifndef EMBEDDED */
 
 
 
 #ifdef PROFILING
   osqp_tic(work->timer); // Start timer
+  time_check_iter = 1;
 #endif /* ifdef PROFILING */
 
 
@@ -343,9 +557,20 @@ c_int osqp_solve(OSQPWorkspace *work) {
 #ifdef CTRLC
 
   // initialize Ctrl-C support
-  osqp_start_interrupt_listener();
+  if (!work->shared_interrupt_listener) osqp_start_interrupt_listener();
 #endif /* ifdef CTRLC */
 
+#ifndef EMBEDDED
+  // Warm start from the cached solution with the nearest problem vectors
+  if (work->ws_cache && warm_cache_lookup(work)) {
+# ifdef PRINTING
+    c_eprint("Failed rho update");
+# endif // PRINTING
+    exitflag = 1;
+    goto exit;
+  }
+#endif /* ifndef EMBEDDED */
+
   // Initialize variables (cold start or warm start depending on settings)
   if (!work->settings->warm_start) cold_start(work);  // If not warm start ->
                                                       // set x, z, y to zero
@@ -387,22 +612,34 @@ c_int osqp_solve(OSQPWorkspace *work) {
 #ifdef PROFILING
 
     // Check if solver time_limit is enabled. In case, check if the current
-    // run time is more than the time_limit option.
-    if (work->first_run) {
-      temp_run_time = work->info->setup_time + osqp_toc(work->timer);
-    }
-    else {
-      temp_run_time = work->info->update_time + osqp_toc(work->timer);
-    }
+    // run time is more than the time_limit option. The clock is read again
+    // after half of the iterations predicted to reach the time limit at the
+    // mean iteration time, so that the limit is still detected at the first
+    // iteration exceeding it while most iterations do not read the clock.
+    if (work->settings->time_limit && (iter >= time_check_iter)) {
+      solve_time = osqp_toc(work->timer);
+      if (work->first_run) {
+        temp_run_time = work->info->setup_time + solve_time;
+      }
+      else {
+        temp_run_time = work->info->update_time + solve_time;
+      }
 
-    if (work->settings->time_limit &&
-        (temp_run_time >= work->settings->time_limit)) {
-      update_status(work->info, OSQP_TIME_LIMIT_REACHED);
+      if (temp_run_time >= work->settings->time_limit) {
+        update_status(work->info, OSQP_TIME_LIMIT_REACHED);
 # ifdef PRINTING
-      if (work->settings->verbose) c_print("run time limit reached\n");
-      can_print = 0;  // Not printing at this iteration
+        if (work->settings->verbose) c_print("run time limit reached\n");
+        can_print = 0;  // Not printing at this iteration
 # endif /* ifdef PRINTING */
-      break;
+        break;
+      }
+
+      time_check_iter = iter + 1;
+      if (solve_time > 0.) {
+        time_check_iter += (c_int)c_min(0.5 * (work->settings->time_limit -
+                                               temp_run_time) * iter / solve_time,
+                                        (c_float)(TIME_LIMIT_CHECK_MAX - 1));
+      }
     }
 #endif /* ifdef PROFILING */
 
@@ -411,14 +648,22 @@ c_int osqp_solve(OSQPWorkspace *work) {
     can_check_termination = work->settings->check_termination &&
                             (iter % work->settings->check_termination == 0);
 
+    // Do we record a trace of this iteration ?
+#ifndef EMBEDDED
+    can_trace = work->settings->trace_interval &&
+                (iter % work->settings->trace_interval == 0);
+#else /* ifndef EMBEDDED */
+    can_trace = 0;
+#endif /* ifndef EMBEDDED */
+
 #ifdef PRINTING
 
     // Can we print ?
     can_print = work->settings->verbose &&
                 ((iter % PRINT_INTERVAL == 0) || (iter == 1));
 
-    if (can_check_termination || can_print) { // Update status in either of
-                                              // these cases
+    // Update status in any of these cases
+    if (can_check_termination || can_print || can_trace) {
       // Update information
       update_info(work, iter, compute_cost_function, 0);
 
@@ -427,6 +672,13 @@ c_int osqp_solve(OSQPWorkspace *work) {
         print_summary(work);
       }
 
+# ifndef EMBEDDED
+      if (can_trace) {
+        // Record the iteration
+        trace_iteration(work, iter);
+      }
+# endif /* ifndef EMBEDDED */
+
       if (can_check_termination) {
         // Check algorithm termination
         if (check_termination(work, 0)) {
@@ -437,14 +689,23 @@ c_int osqp_solve(OSQPWorkspace *work) {
     }
 #else /* ifdef PRINTING */
 
-    if (can_check_termination) {
+    if (can_check_termination || can_trace) {
       // Update information and compute also objective value
       update_info(work, iter, compute_cost_function, 0);
 
-      // Check algorithm termination
-      if (check_termination(work, 0)) {
-        // Terminate algorithm
-        break;
+# ifndef EMBEDDED
+      if (can_trace) {
+        // Record the iteration
+        trace_iteration(work, iter);
+      }
+# endif /* ifndef EMBEDDED */
+
+      if (can_check_termination) {
+        // Check algorithm termination
+        if (check_termination(work, 0)) {
+          // Terminate algorithm
+          break;
+        }
       }
     }
 #endif /* ifdef PRINTING */
@@ -492,15 +753,16 @@ c_int osqp_solve(OSQPWorkspace *work) {
       // Update info with the residuals if it hasn't been done before
 # ifdef PRINTING
 
-      if (!can_check_termination && !can_print) {
-        // Information has not been computed neither for termination or printing
-        // reasons
+      if (!can_check_termination && !can_print && !can_trace) {
+        // Information has not been computed neither for termination, printing
+        // or trace reasons
         update_info(work, iter, compute_cost_function, 0);
       }
 # else /* ifdef PRINTING */
 
-      if (!can_check_termination) {
-        // Information has not been computed before for termination check
+      if (!can_check_termination && !can_trace) {
+        // Information has not been computed before for termination check or
+        // trace
         update_info(work, iter, compute_cost_function, 0);
       }
 # endif /* ifdef PRINTING */
@@ -513,6 +775,12 @@ c_int osqp_solve(OSQPWorkspace *work) {
         exitflag = 1;
         goto exit;
       }
+
+# ifdef PROFILING
+      // The time of a new factorization is not predicted by the mean
+      // iteration time
+      time_check_iter = iter + 1;
+# endif /* ifdef PROFILING */
     }
 #endif // EMBEDDED != 1
 
@@ -590,8 +858,11 @@ c_int osqp_solve(OSQPWorkspace *work) {
 
 #ifndef EMBEDDED
   // Polish the obtained solution
-  if (work->settings->polish && (work->info->status_val == OSQP_SOLVED))
+  if (work->settings->polish && (work->info->status_val == OSQP_SOLVED)) {
+    OSQP_PROBE2(polish_begin, work->data->n, work->data->m);
     polish(work);
+    OSQP_PROBE1(polish_end, work->info->status_polish);
+  }
 #endif /* ifndef EMBEDDED */
 
 #ifdef PROFILING
@@ -626,15 +897,25 @@ c_int osqp_solve(OSQPWorkspace *work) {
   // Store solution
   store_solution(work);
 
+#ifndef EMBEDDED
+  // Cache the solution to warm start the following solves
+  if (work->ws_cache &&
+      ((work->info->status_val == OSQP_SOLVED) ||
+       (work->info->status_val == OSQP_SOLVED_INACCURATE)))
+    warm_cache_insert(work);
+#endif /* ifndef EMBEDDED */
+
 
 // Define exit flag for quitting function
 #if defined(PROFILING) || defined(CTRLC) || EMBEDDED != 1
 exit:
 #endif /* if defined(PROFILING) || defined(CTRLC) || EMBEDDED != 1 */
 
+  OSQP_PROBE2(solve_end, work->info->iter, work->info->status_val);
+
 #ifdef CTRLC
   // Restore previous signal handler
-  osqp_end_interrupt_listener();
+  if (!work->shared_interrupt_listener) osqp_end_interrupt_listener();
 #endif /* ifdef CTRLC */
 
   return exitflag;
@@ -654,6 +935,8 @@ c_int osqp_cleanup(OSQPWorkspace *work) {
       if (work->data->q) c_free(work->data->q);
       if (work->data->l) c_free(work->data->l);
       if (work->data->u) c_free(work->data->u);
+      if (work->data->lb) c_free(work->data->lb);
+      if (work->data->ub) c_free(work->data->ub);
       c_free(work->data);
     }
 
@@ -678,8 +961,12 @@ c_int osqp_cleanup(OSQPWorkspace *work) {
       }
     }
 
+    // Free cached polish and derivative factorizations
+    polish_free_factorization(work);
+    derivative_free_factorization(work);
+
     // Unload linear system solver after free
-    if (work->settings) {
+    if (work->settings && work->linsys_solver) {
       exitflag = unload_linsys_solver(work->settings->linsys_solver);
     }
 
@@ -690,11 +977,36 @@ c_int osqp_cleanup(OSQPWorkspace *work) {
       if (work->pol->Aupp_to_A) c_free(work->pol->Aupp_to_A);
       if (work->pol->A_to_Alow) c_free(work->pol->A_to_Alow);
       if (work->pol->A_to_Aupp) c_free(work->pol->A_to_Aupp);
+      if (work->pol->A_to_Afac) c_free(work->pol->A_to_Afac);
+      if (work->pol->Afac_to_A) c_free(work->pol->Afac_to_A);
       if (work->pol->x)         c_free(work->pol->x);
       if (work->pol->z)         c_free(work->pol->z);
       if (work->pol->y)         c_free(work->pol->y);
       c_free(work->pol);
     }
+
+    // Free derivative structure
+    if (work->deriv) {
+      if (work->deriv->Ared)      csc_spfree(work->deriv->Ared);
+      if (work->deriv->A_to_Ared) c_free(work->deriv->A_to_Ared);
+      if (work->deriv->Ared_to_A) c_free(work->deriv->Ared_to_A);
+      c_free(work->deriv);
+    }
+
+    // Free warm start cache
+    warm_cache_free(work);
+
+    // Free trace recorder
+    trace_free(work);
+
+    // Free block copy of A
+    bsr_spfree(work->A_bsr);
+
+    // Free stages
+    if (work->stages) c_free(work->stages);
+
+    // Free presolve structure
+    presolve_free(work->presolve);
 #endif /* ifndef EMBEDDED */
 
     // Free other Variables
@@ -743,6 +1055,89 @@ c_int osqp_cleanup(OSQPWorkspace *work) {
   return exitflag;
 }
 
+
+c_int osqp_kkt_fill(const OSQPWorkspace *work, enum ordering_type ordering) {
+  const c_int *stages;
+
+  if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  // The stages of a user ordering only apply to the user ordering itself
+  if (work->settings->ordering == USER_ORDERING) {
+    stages = (ordering == USER_ORDERING) ? work->stages : OSQP_NULL;
+  } else {
+    if (ordering == USER_ORDERING) return -1;
+    stages = work->stages;
+  }
+
+  return kkt_fill(work->data->P, work->data->A, stages, ordering);
+}
+
+c_int osqp_get_factor_stats(const OSQPWorkspace *work,
+                            OSQPFactorStats     *kkt_stats,
+                            OSQPFactorStats     *polish_stats) {
+  c_int exitflag;
+  OSQPFactorStats none = { 0 }; // Statistics of a missing factorization
+
+  if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  *kkt_stats = none;
+  exitflag = linsys_factor_stats(work->linsys_solver, kkt_stats);
+
+  if (polish_stats) {
+    *polish_stats = none;
+    if (work->pol && work->pol->linsys_solver) {
+      exitflag = linsys_factor_stats(work->pol->linsys_solver, polish_stats) || exitflag;
+    }
+  }
+
+  return exitflag;
+}
+
+
+c_int osqp_adjoint_derivative(OSQPWorkspace *work,
+                              c_int          nrhs,
+                              const c_float *dx,
+                              const c_float *dy,
+                              c_float       *dq,
+                              c_float       *dl,
+                              c_float       *du) {
+
+  // Check if workspace has been initialized
+  if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  // Derivatives are defined only at a solution
+  if ((work->info->status_val != OSQP_SOLVED) &&
+      (work->info->status_val != OSQP_SOLVED_INACCURATE)) {
+# ifdef PRINTING
+    c_eprint("problem must be solved before computing derivatives");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if ((nrhs <= 0) || !dx || !dq) {
+# ifdef PRINTING
+    c_eprint("nrhs must be positive and dx, dq must be allocated");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if (work->presolve) {
+# ifdef PRINTING
+    c_eprint("derivatives are not available with presolve");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if (work->n_bnd) {
+# ifdef PRINTING
+    c_eprint("derivatives are not available with variable bounds");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  return adjoint_derivative(work, nrhs, dx, dy, dq, dl, du);
+}
+
 #endif // #ifndef EMBEDDED
 
 
@@ -762,6 +1157,14 @@ c_int osqp_update_lin_cost(OSQPWorkspace *work, const c_float *q_new) {
   osqp_tic(work->timer); // Start timer
 #endif /* ifdef PROFILING */
 
+#ifndef EMBEDDED
+  // Linear cost of the presolved problem
+  if (work->presolve) {
+    presolve_update_lin_cost(work->presolve, q_new);
+    q_new = work->presolve->q_red;
+  }
+#endif /* ifndef EMBEDDED */
+
   // Replace q by the new vector
   prea_vec_copy(q_new, work->data->q, work->data->n);
 
@@ -781,6 +1184,28 @@ c_int osqp_update_lin_cost(OSQPWorkspace *work, const c_float *q_new) {
   return 0;
 }
 
+#ifndef EMBEDDED
+
+/**
+ * Replace the variable bounds of the (possibly scaled) problem data
+ * @param work Workspace
+ * @param lb   Lower bound of the variables
+ * @param ub   Upper bound of the variables
+ */
+static void set_var_bounds(OSQPWorkspace *work,
+                           const c_float *lb,
+                           const c_float *ub) {
+  prea_vec_copy(lb, work->data->lb, work->n_bnd);
+  prea_vec_copy(ub, work->data->ub, work->n_bnd);
+
+  if (work->settings->scaling) {
+    vec_ew_prod(work->scaling->Dinv, work->data->lb, work->data->lb, work->n_bnd);
+    vec_ew_prod(work->scaling->Dinv, work->data->ub, work->data->ub, work->n_bnd);
+  }
+}
+
+#endif /* ifndef EMBEDDED */
+
 c_int osqp_update_bounds(OSQPWorkspace *work,
                          const c_float *l_new,
                          const c_float *u_new) {
@@ -798,7 +1223,11 @@ c_int osqp_update_bounds(OSQPWorkspace *work,
 #endif /* ifdef PROFILING */
 
   // Check if lower bound is smaller than upper bound
+#ifndef EMBEDDED
+  for (i = 0; i < (work->presolve ? work->presolve->m : work->data->m); i++) {
+#else /* ifndef EMBEDDED */
   for (i = 0; i < work->data->m; i++) {
+#endif /* ifndef EMBEDDED */
     if (l_new[i] > u_new[i]) {
 #ifdef PRINTING
       c_eprint("lower bound must be lower than or equal to upper bound");
@@ -807,6 +1236,24 @@ c_int osqp_update_bounds(OSQPWorkspace *work,
     }
   }
 
+#ifndef EMBEDDED
+  // Bounds of the presolved problem
+  if (work->presolve) {
+    if (presolve_update_bounds(work->presolve, l_new, u_new,
+                               work->presolve->lb, work->presolve->ub)) {
+# ifdef PRINTING
+      c_eprint("new bounds change the presolved problem, setup is required");
+# endif /* ifdef PRINTING */
+      return 1;
+    }
+    l_new = work->presolve->l_red;
+    u_new = work->presolve->u_red;
+
+    // Variable bounds from the merged singleton constraints
+    set_var_bounds(work, work->presolve->lb_red, work->presolve->ub_red);
+  }
+#endif /* ifndef EMBEDDED */
+
   // Replace l and u by the new vectors
   prea_vec_copy(l_new, work->data->l, work->data->m);
   prea_vec_copy(u_new, work->data->u, work->data->m);
@@ -838,6 +1285,11 @@ c_int osqp_update_lower_bound(OSQPWorkspace *work, const c_float *l_new) {
   // Check if workspace has been initialized
   if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
+#ifndef EMBEDDED
+  // Merged singleton constraints of the presolved problem combine both bounds
+  if (work->presolve) return osqp_update_bounds(work, l_new, work->presolve->u);
+#endif /* ifndef EMBEDDED */
+
 #ifdef PROFILING
   if (work->clear_update_time == 1) {
     work->clear_update_time = 0;
@@ -885,6 +1337,11 @@ c_int osqp_update_upper_bound(OSQPWorkspace *work, const c_float *u_new) {
   // Check if workspace has been initialized
   if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
+#ifndef EMBEDDED
+  // Merged singleton constraints of the presolved problem combine both bounds
+  if (work->presolve) return osqp_update_bounds(work, work->presolve->l, u_new);
+#endif /* ifndef EMBEDDED */
+
 #ifdef PROFILING
   if (work->clear_update_time == 1) {
     work->clear_update_time = 0;
@@ -926,6 +1383,89 @@ c_int osqp_update_upper_bound(OSQPWorkspace *work, const c_float *u_new) {
   return exitflag;
 }
 
+#ifndef EMBEDDED
+
+c_int osqp_update_var_bounds(OSQPWorkspace *work,
+                             const c_float *lb_new,
+                             const c_float *ub_new) {
+  c_int j, n, bnd;
+
+  // Check if workspace has been initialized
+  if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  n   = work->presolve ? work->presolve->n   : work->data->n;
+  bnd = work->presolve ? work->presolve->bnd : work->n_bnd;
+
+  // The splitting variables of the variable bounds are allocated at setup
+  if (!bnd) {
+# ifdef PRINTING
+    c_eprint("variable bounds must be given at setup");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+# ifdef PROFILING
+  if (work->clear_update_time == 1) {
+    work->clear_update_time = 0;
+    work->info->update_time = 0.0;
+  }
+  osqp_tic(work->timer); // Start timer
+# endif /* ifdef PROFILING */
+
+  // Check if lower bound is smaller than upper bound
+  for (j = 0; j < n; j++) {
+    if (lb_new[j] > ub_new[j]) {
+# ifdef PRINTING
+      c_eprint("lower bound must be lower than or equal to upper bound");
+# endif /* ifdef PRINTING */
+      return 1;
+    }
+  }
+
+  // Variable bounds of the presolved problem
+  if (work->presolve) {
+    if (presolve_update_bounds(work->presolve, work->presolve->l,
+                               work->presolve->u, lb_new, ub_new)) {
+# ifdef PRINTING
+      c_eprint("new bounds change the presolved problem, setup is required");
+# endif /* ifdef PRINTING */
+      return 1;
+    }
+    lb_new = work->presolve->lb_red;
+    ub_new = work->presolve->ub_red;
+  }
+
+  // Replace lb and ub by the new vectors and scale them
+  set_var_bounds(work, lb_new, ub_new);
+
+  // Reset solver information
+  reset_info(work->info);
+
+# ifdef PROFILING
+  work->info->update_time += osqp_toc(work->timer);
+# endif /* ifdef PROFILING */
+
+  return 0;
+}
+
+/**
+ * Warm start the multipliers of the variable bounds
+ * @param work Workspace
+ * @param y    Dual vector followed by the multipliers of the variable bounds
+ */
+static void warm_start_y_bnd(OSQPWorkspace *work, const c_float *y) {
+  c_float *y_bnd = work->y + work->data->m;
+
+  prea_vec_copy(y + work->data->m, y_bnd, work->n_bnd);
+
+  if (work->settings->scaling) {
+    vec_ew_prod(work->scaling->D, y_bnd, y_bnd, work->n_bnd);
+    vec_mult_scalar(y_bnd, work->scaling->c, work->n_bnd);
+  }
+}
+
+#endif /* ifndef EMBEDDED */
+
 c_int osqp_warm_start(OSQPWorkspace *work, const c_float *x, const c_float *y) {
 
   // Check if workspace has been initialized
@@ -934,6 +1474,21 @@ c_int osqp_warm_start(OSQPWorkspace *work, const c_float *x, const c_float *y) {
   // Update warm_start setting to true
   if (!work->settings->warm_start) work->settings->warm_start = 1;
 
+#ifndef EMBEDDED
+  // Do not replace the user iterates with a cached solution
+  if (work->ws_cache) work->ws_cache->skip_lookup = 1;
+#endif /* ifndef EMBEDDED */
+
+#ifndef EMBEDDED
+  // Iterates of the presolved problem
+  if (work->presolve) {
+    presolve_x(work->presolve, x);
+    presolve_y(work->presolve, y);
+    x = work->presolve->x_red;
+    y = work->presolve->y_red;
+  }
+#endif /* ifndef EMBEDDED */
+
   // Copy primal and dual variables into the iterates
   prea_vec_copy(x, work->x, work->data->n);
   prea_vec_copy(y, work->y, work->data->m);
@@ -948,6 +1503,12 @@ c_int osqp_warm_start(OSQPWorkspace *work, const c_float *x, const c_float *y) {
   // Compute Ax = z and store it in z
   mat_vec(work->data->A, work->x, work->z, 0);
 
+#ifndef EMBEDDED
+  // The splitting variables of the variable bounds are x
+  prea_vec_copy(work->x, work->z + work->data->m, work->n_bnd);
+  warm_start_y_bnd(work, y);
+#endif /* ifndef EMBEDDED */
+
   return 0;
 }
 
@@ -959,6 +1520,19 @@ c_int osqp_warm_start_x(OSQPWorkspace *work, const c_float *x) {
   // Update warm_start setting to true
   if (!work->settings->warm_start) work->settings->warm_start = 1;
 
+#ifndef EMBEDDED
+  // Do not replace the user iterates with a cached solution
+  if (work->ws_cache) work->ws_cache->skip_lookup = 1;
+#endif /* ifndef EMBEDDED */
+
+#ifndef EMBEDDED
+  // Iterate of the presolved problem
+  if (work->presolve) {
+    presolve_x(work->presolve, x);
+    x = work->presolve->x_red;
+  }
+#endif /* ifndef EMBEDDED */
+
   // Copy primal variable into the iterate x
   prea_vec_copy(x, work->x, work->data->n);
 
@@ -970,6 +1544,11 @@ c_int osqp_warm_start_x(OSQPWorkspace *work, const c_float *x) {
   // Compute Ax = z and store it in z
   mat_vec(work->data->A, work->x, work->z, 0);
 
+#ifndef EMBEDDED
+  // The splitting variables of the variable bounds are x
+  prea_vec_copy(work->x, work->z + work->data->m, work->n_bnd);
+#endif /* ifndef EMBEDDED */
+
   return 0;
 }
 
@@ -981,6 +1560,19 @@ c_int osqp_warm_start_y(OSQPWorkspace *work, const c_float *y) {
   // Update warm_start setting to true
   if (!work->settings->warm_start) work->settings->warm_start = 1;
 
+#ifndef EMBEDDED
+  // Do not replace the user iterates with a cached solution
+  if (work->ws_cache) work->ws_cache->skip_lookup = 1;
+#endif /* ifndef EMBEDDED */
+
+#ifndef EMBEDDED
+  // Iterate of the presolved problem
+  if (work->presolve) {
+    presolve_y(work->presolve, y);
+    y = work->presolve->y_red;
+  }
+#endif /* ifndef EMBEDDED */
+
   // Copy primal variable into the iterate y
   prea_vec_copy(y, work->y, work->data->m);
 
@@ -990,6 +1582,10 @@ c_int osqp_warm_start_y(OSQPWorkspace *work, const c_float *y) {
     vec_mult_scalar(work->y, work->scaling->c, work->data->m);
   }
 
+#ifndef EMBEDDED
+  warm_start_y_bnd(work, y);
+#endif /* ifndef EMBEDDED */
+
   return 0;
 }
 
@@ -1004,9 +1600,23 @@ c_int osqp_update_P(OSQPWorkspace *work,
   c_int exitflag; // Exit flag
   c_int nnzP;     // Number of nonzeros in P
 
+#ifdef PROFILING
+  OSQPTimer timer; // Timer of the factorization
+#endif /* ifdef PROFILING */
+
   // Check if workspace has been initialized
   if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
+#ifndef EMBEDDED
+  // The presolved matrices depend on the removed rows and columns
+  if (work->presolve) {
+# ifdef PRINTING
+    c_eprint("matrix updates are not available with presolve");
+# endif /* ifdef PRINTING */
+    return -1;
+  }
+#endif /* ifndef EMBEDDED */
+
 #ifdef PROFILING
   if (work->clear_update_time == 1) {
     work->clear_update_time = 0;
@@ -1053,10 +1663,26 @@ c_int osqp_update_P(OSQPWorkspace *work,
     scale_data(work);
   }
 
+# ifndef EMBEDDED
+  // Values of the block copy of A
+  if (work->A_bsr) bsr_update_values(work->A_bsr, work->data->A);
+# endif /* ifndef EMBEDDED */
+
   // Update linear system structure with new data
+  PROFILE_TIC(&timer);
   exitflag = work->linsys_solver->update_matrices(work->linsys_solver,
                                                   work->data->P,
                                                   work->data->A);
+  PROFILE_TOC(&work->info->profile, PROFILE_FACTOR, &timer);
+
+# ifndef EMBEDDED
+  // Polish and derivative factorizations are no longer valid
+  polish_free_factorization(work);
+  derivative_free_factorization(work);
+
+  // Cached solutions refer to the previous matrices
+  warm_cache_clear(work);
+# endif /* ifndef EMBEDDED */
 
   // Reset solver information
   reset_info(work->info);
@@ -1084,9 +1710,23 @@ c_int osqp_update_A(OSQPWorkspace *work,
   c_int exitflag; // Exit flag
   c_int nnzA;     // Number of nonzeros in A
 
+#ifdef PROFILING
+  OSQPTimer timer; // Timer of the factorization
+#endif /* ifdef PROFILING */
+
   // Check if workspace has been initialized
   if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
+#ifndef EMBEDDED
+  // The presolved matrices depend on the removed rows and columns
+  if (work->presolve) {
+# ifdef PRINTING
+    c_eprint("matrix updates are not available with presolve");
+# endif /* ifdef PRINTING */
+    return -1;
+  }
+#endif /* ifndef EMBEDDED */
+
 #ifdef PROFILING
   if (work->clear_update_time == 1) {
     work->clear_update_time = 0;
@@ -1132,10 +1772,26 @@ c_int osqp_update_A(OSQPWorkspace *work,
     scale_data(work);
   }
 
+# ifndef EMBEDDED
+  // Values of the block copy of A
+  if (work->A_bsr) bsr_update_values(work->A_bsr, work->data->A);
+# endif /* ifndef EMBEDDED */
+
   // Update linear system structure with new data
+  PROFILE_TIC(&timer);
   exitflag = work->linsys_solver->update_matrices(work->linsys_solver,
                                                   work->data->P,
                                                   work->data->A);
+  PROFILE_TOC(&work->info->profile, PROFILE_FACTOR, &timer);
+
+# ifndef EMBEDDED
+  // Polish and derivative factorizations are no longer valid
+  polish_free_factorization(work);
+  derivative_free_factorization(work);
+
+  // Cached solutions refer to the previous matrices
+  warm_cache_clear(work);
+# endif /* ifndef EMBEDDED */
 
   // Reset solver information
   reset_info(work->info);
@@ -1166,9 +1822,23 @@ c_int osqp_update_P_A(OSQPWorkspace *work,
   c_int exitflag;   // Exit flag
   c_int nnzP, nnzA; // Number of nonzeros in P and A
 
+#ifdef PROFILING
+  OSQPTimer timer; // Timer of the factorization
+#endif /* ifdef PROFILING */
+
   // Check if workspace has been initialized
   if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
 
+#ifndef EMBEDDED
+  // The presolved matrices depend on the removed rows and columns
+  if (work->presolve) {
+# ifdef PRINTING
+    c_eprint("matrix updates are not available with presolve");
+# endif /* ifdef PRINTING */
+    return -1;
+  }
+#endif /* ifndef EMBEDDED */
+
 #ifdef PROFILING
   if (work->clear_update_time == 1) {
     work->clear_update_time = 0;
@@ -1243,10 +1913,26 @@ c_int osqp_update_P_A(OSQPWorkspace *work,
     scale_data(work);
   }
 
+# ifndef EMBEDDED
+  // Values of the block copy of A
+  if (work->A_bsr) bsr_update_values(work->A_bsr, work->data->A);
+# endif /* ifndef EMBEDDED */
+
   // Update linear system structure with new data
+  PROFILE_TIC(&timer);
   exitflag = work->linsys_solver->update_matrices(work->linsys_solver,
                                                   work->data->P,
                                                   work->data->A);
+  PROFILE_TOC(&work->info->profile, PROFILE_FACTOR, &timer);
+
+# ifndef EMBEDDED
+  // Polish and derivative factorizations are no longer valid
+  polish_free_factorization(work);
+  derivative_free_factorization(work);
+
+  // Cached solutions refer to the previous matrices
+  warm_cache_clear(work);
+# endif /* ifndef EMBEDDED */
 
   // Reset solver information
   reset_info(work->info);
@@ -1267,6 +1953,13 @@ c_int osqp_update_P_A(OSQPWorkspace *work,
 
 c_int osqp_update_rho(OSQPWorkspace *work, c_float rho_new) {
   c_int exitflag, i;
+#ifndef EMBEDDED
+  LinSysSolver *linsys_new;
+  OSQPProfile  *profile = OSQP_NULL; // Profile of the refactorization
+#endif /* ifndef EMBEDDED */
+#if defined(PROFILING) && !defined(EMBEDDED)
+  OSQPTimer timer;
+#endif /* if defined(PROFILING) && !defined(EMBEDDED) */
 
   // Check if workspace has been initialized
   if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
@@ -1306,9 +1999,45 @@ c_int osqp_update_rho(OSQPWorkspace *work, c_float rho_new) {
     }
   }
 
+#ifndef EMBEDDED
+  if (work->n_bnd) {
+    // The ADMM step of the variable bounds is on the diagonal of the KKT
+    // matrix together with sigma
+    work->rho_bnd = work->settings->rho;
+# ifdef PROFILING
+    profile = &(work->info->profile);
+# endif /* ifdef PROFILING */
+
+    if (work->linsys_solver->update_sigma) {
+      // Numeric refactorization with the ordering of the setup
+      PROFILE_TIC(&timer);
+      exitflag = work->linsys_solver->update_sigma(work->linsys_solver,
+                                                   work->settings->sigma + work->rho_bnd,
+                                                   work->rho_vec);
+      PROFILE_TOC(profile, PROFILE_FACTOR, &timer);
+    } else {
+      // Solvers without a sigma update are set up again. The previous solver
+      // is kept if this fails.
+      exitflag = init_linsys_solver(&linsys_new, work->data->P, work->data->A,
+                                    work->settings->sigma + work->rho_bnd,
+                                    work->rho_vec, work->settings->linsys_solver,
+                                    0, work->stages, work->settings->ordering,
+                                    profile);
+      if (!exitflag) {
+        work->linsys_solver->free(work->linsys_solver);
+        work->linsys_solver = linsys_new;
+      }
+    }
+  } else {
+    // Update rho_vec in KKT matrix
+    exitflag = work->linsys_solver->update_rho_vec(work->linsys_solver,
+                                                   work->rho_vec);
+  }
+#else /* ifndef EMBEDDED */
   // Update rho_vec in KKT matrix
   exitflag = work->linsys_solver->update_rho_vec(work->linsys_solver,
                                                  work->rho_vec);
+#endif /* ifndef EMBEDDED */
 
 #ifdef PROFILING
   if (work->rho_update_from_solve == 0)
@@ -1513,6 +2242,10 @@ c_int osqp_update_delta(OSQPWorkspace *work, c_float delta_new) {
   // Update delta
   work->settings->delta = delta_new;
 
+  // Polish and derivative factorizations are no longer valid
+  polish_free_factorization(work);
+  derivative_free_factorization(work);
+
   return 0;
 }
 
@@ -1579,6 +2312,52 @@ c_int osqp_update_verbose(OSQPWorkspace *work, c_int verbose_new) {
   return 0;
 }
 
+c_int osqp_update_trace(OSQPWorkspace      *work,
+                        c_int               trace_interval_new,
+                        osqp_trace_callback trace_callback_new,
+                        void               *trace_data_new) {
+
+  // Check if workspace has been initialized
+  if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  // Check that trace_interval is nonnegative
+  if (trace_interval_new < 0) {
+# ifdef PRINTING
+    c_eprint("trace_interval must be nonnegative");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  // Update trace settings
+  work->settings->trace_interval = trace_interval_new;
+  work->settings->trace_callback = trace_callback_new;
+  work->settings->trace_data     = trace_data_new;
+
+  return 0;
+}
+
+c_int osqp_dump_trace(const OSQPWorkspace *work, const char *filename) {
+
+  // Check if workspace has been initialized
+  if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  if (!(work->trace)) {
+# ifdef PRINTING
+    c_eprint("trace recorder is disabled (trace_buffer = 0)");
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  if (trace_dump(work->trace, filename)) {
+# ifdef PRINTING
+    c_eprint("could not write the trace to %s", filename);
+# endif /* ifdef PRINTING */
+    return 1;
+  }
+
+  return 0;
+}
+
 #endif // EMBEDDED
 
 #ifdef PROFILING
@@ -1601,4 +2380,28 @@ c_int osqp_update_time_limit(OSQPWorkspace *work, c_float time_limit_new) {
 
   return 0;
 }
+
+c_int osqp_get_profile(const OSQPWorkspace *work, OSQPProfile *profile) {
+
+  // Check if workspace has been initialized
+  if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  *profile = work->info->profile;
+
+  return 0;
+}
+
+c_int osqp_reset_profile(OSQPWorkspace *work) {
+  c_int i;
+
+  // Check if workspace has been initialized
+  if (!work) return osqp_error(OSQP_WORKSPACE_NOT_INIT_ERROR);
+
+  for (i = 0; i < PROFILE_NPHASES; i++) {
+    work->info->profile.time[i]  = 0.0;
+    work->info->profile.calls[i] = 0;
+  }
+
+  return 0;
+}
 #endif /* ifdef PROFILING */
@@ -7,6 +7,42 @@
 #include "proj.h"
 #include "error.h"
 
+/**
+ * Number of rows that can be active: the constraints followed by the variable
+ * bounds. Row m + j is the identity row of the bound of variable j.
+ * @param  work Workspace
+ * @return      m + n_bnd
+ */
+static c_int polish_rows(OSQPWorkspace *work) {
+  return work->data->m + work->n_bnd;
+}
+
+/**
+ * Lower bound of row j (constraint or variable bound)
+ */
+static c_float row_l(OSQPWorkspace *work, c_int j) {
+  return j < work->data->m ? work->data->l[j] : work->data->lb[j - work->data->m];
+}
+
+/**
+ * Upper bound of row j (constraint or variable bound)
+ */
+static c_float row_u(OSQPWorkspace *work, c_int j) {
+  return j < work->data->m ? work->data->u[j] : work->data->ub[j - work->data->m];
+}
+
+/**
+ * Index of row j of A in the current reduced system Ared = vstack[Alow, Aupp]
+ * @param  work Workspace
+ * @param  j    Row of A
+ * @return      Row of Ared (-1 if inactive)
+ */
+static c_int A_to_Ared(OSQPWorkspace *work, c_int j) {
+  if (work->pol->A_to_Alow[j] != -1) return work->pol->A_to_Alow[j];
+  if (work->pol->A_to_Aupp[j] != -1) return work->pol->A_to_Aupp[j] + work->pol->n_low;
+  return -1;
+}
+
 /**
  * Form reduced matrix A that contains only rows that are active at the
  * solution.
@@ -17,7 +53,9 @@
  * @return      Number of rows in Ared, negative if error
  */
 static c_int form_Ared(OSQPWorkspace *work) {
-  c_int j, ptr;
+  c_int j, ptr, b;
+  c_int m        = work->data->m;
+  c_int m_pol    = polish_rows(work);
   c_int Ared_nnz = 0;
 
   // Initialize counters for active constraints
@@ -30,8 +68,8 @@ static c_int form_Ared(OSQPWorkspace *work) {
    * Aupp is formed in the equivalent way.
    * Ared is formed by stacking vertically Alow and Aupp.
    */
-  for (j = 0; j < work->data->m; j++) {
-    if (work->z[j] - work->data->l[j] < -work->y[j]) { // lower-active
+  for (j = 0; j < m_pol; j++) {
+    if (work->z[j] - row_l(work, j) < -work->y[j]) { // lower-active
       work->pol->Alow_to_A[work->pol->n_low] = j;
       work->pol->A_to_Alow[j]                = work->pol->n_low++;
     } else {
@@ -39,8 +77,8 @@ static c_int form_Ared(OSQPWorkspace *work) {
     }
   }
 
-  for (j = 0; j < work->data->m; j++) {
-    if (work->data->u[j] - work->z[j] < work->y[j]) { // upper-active
+  for (j = 0; j < m_pol; j++) {
+    if (row_u(work, j) - work->z[j] < work->y[j]) { // upper-active
       work->pol->Aupp_to_A[work->pol->n_upp] = j;
       work->pol->A_to_Aupp[j]                = work->pol->n_upp++;
     } else {
@@ -62,6 +100,9 @@ static c_int form_Ared(OSQPWorkspace *work) {
     if ((work->pol->A_to_Alow[work->data->A->i[j]] != -1) ||
         (work->pol->A_to_Aupp[work->data->A->i[j]] != -1)) Ared_nnz++;
   }
+  for (j = m; j < m_pol; j++) {
+    if ((work->pol->A_to_Alow[j] != -1) || (work->pol->A_to_Aupp[j] != -1)) Ared_nnz++;
+  }
 
   // Form Ared
   // Ared = vstack[Alow, Aupp]
@@ -87,6 +128,13 @@ static c_int form_Ared(OSQPWorkspace *work) {
         work->pol->Ared->x[Ared_nnz++] = work->data->A->x[ptr];
       }
     }
+
+    // Identity row of the bound of variable j
+    b = (m + j < m_pol) ? A_to_Ared(work, m + j) : -1;
+    if (b != -1) {
+      work->pol->Ared->i[Ared_nnz]   = b;
+      work->pol->Ared->x[Ared_nnz++] = 1.;
+    }
   }
 
   // Update the last element in Ared->p
@@ -111,12 +159,423 @@ static void form_rhs_red(OSQPWorkspace *work, c_float *rhs) {
   }
 
   for (j = 0; j < work->pol->n_low; j++) { // l_low
-    rhs[work->data->n + j] = work->data->l[work->pol->Alow_to_A[j]];
+    rhs[work->data->n + j] = row_l(work, work->pol->Alow_to_A[j]);
   }
 
   for (j = 0; j < work->pol->n_upp; j++) { // u_upp
     rhs[work->data->n + work->pol->n_low + j] =
-      work->data->u[work->pol->Aupp_to_A[j]];
+      row_u(work, work->pol->Aupp_to_A[j]);
+  }
+}
+
+/**
+ * Low-rank update of the cached reduced KKT factorization.
+ *
+ * The current active set differs from the factorized one by n_add rows that
+ * are active but not factorized and n_drop rows that are factorized but no
+ * longer active. The reduced KKT system is then solved as the bordered system
+ *    [K0  C] [w] = [b0]
+ *    [C'  D] [v]   [bc]
+ * where K0 is the cached factorization. An added row k contributes the column
+ * [a_k; 0] to C and -delta to D, while a dropped row in position p contributes
+ * the column e_{n+p} to C and 0 to D, which forces its multiplier to zero.
+ * Only the small Schur complement S = D - C' * K0^{-1} * C is factorized.
+ */
+typedef struct {
+  c_int    n_add;  ///< number of rows added to the factorized active set
+  c_int    n_drop; ///< number of rows dropped from the factorized active set
+  c_int   *rows;   ///< added rows (first n_add) and dropped rows (last n_drop)
+  c_int   *Ap;     ///< column pointers of the added rows stored by rows
+  c_int   *Ai;     ///< column indices of the added rows
+  c_float *Ax;     ///< values of the added rows
+  c_float *Z;      ///< Z = K0^{-1} * C stored column-wise (size (n + m_fac) x r)
+  c_float *S;      ///< LU factors of the Schur complement (size r x r)
+  c_int   *piv;    ///< row pivots of the LU factorization
+  c_float *w;      ///< work vector (size n + m_fac)
+  c_float *v;      ///< work vector (size r)
+} PolishUpdate;
+
+/**
+ * Free the memory allocated for the low-rank update
+ * @param upd Low-rank update
+ */
+static void free_polish_update(PolishUpdate *upd) {
+  if (upd->rows) c_free(upd->rows);
+  if (upd->Ap)   c_free(upd->Ap);
+  if (upd->Ai)   c_free(upd->Ai);
+  if (upd->Ax)   c_free(upd->Ax);
+  if (upd->Z)    c_free(upd->Z);
+  if (upd->S)    c_free(upd->S);
+  if (upd->piv)  c_free(upd->piv);
+  if (upd->w)    c_free(upd->w);
+  if (upd->v)    c_free(upd->v);
+}
+
+/**
+ * LU factorization with partial pivoting of a dense matrix stored
+ * column-wise. The factors overwrite the matrix.
+ * @param  S   Matrix to factorize (size r x r)
+ * @param  piv Row pivots
+ * @param  r   Dimension of S
+ * @return     Exitflag, nonzero if S is singular
+ */
+static c_int lu_factor(c_float *S, c_int *piv, c_int r) {
+  c_int i, j, k, p;
+  c_float tmp;
+
+  for (k = 0; k < r; k++) {
+    // Find pivot
+    p = k;
+    for (i = k + 1; i < r; i++) {
+      if (c_absval(S[k * r + i]) > c_absval(S[k * r + p])) p = i;
+    }
+    piv[k] = p;
+
+    if (S[k * r + p] == 0.) return 1;
+
+    // Swap rows k and p
+    if (p != k) {
+      for (j = 0; j < r; j++) {
+        tmp          = S[j * r + k];
+        S[j * r + k] = S[j * r + p];
+        S[j * r + p] = tmp;
+      }
+    }
+
+    // Eliminate entries below the pivot
+    for (i = k + 1; i < r; i++) {
+      S[k * r + i] /= S[k * r + k];
+    }
+
+    for (j = k + 1; j < r; j++) {
+      for (i = k + 1; i < r; i++) {
+        S[j * r + i] -= S[k * r + i] * S[j * r + k];
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Solve S * v = b with the LU factors computed by lu_factor.
+ * @param S   LU factors
+ * @param piv Row pivots
+ * @param r   Dimension of S
+ * @param b   Right-hand side, overwritten by the solution
+ */
+static void lu_solve(const c_float *S, const c_int *piv, c_int r, c_float *b) {
+  c_int i, j;
+  c_float tmp;
+
+  // Apply row permutation and solve with unit lower triangular factor
+  for (i = 0; i < r; i++) {
+    if (piv[i] != i) {
+      tmp        = b[i];
+      b[i]       = b[piv[i]];
+      b[piv[i]]  = tmp;
+    }
+  }
+
+  for (j = 0; j < r; j++) {
+    for (i = j + 1; i < r; i++) {
+      b[i] -= S[j * r + i] * b[j];
+    }
+  }
+
+  // Solve with upper triangular factor
+  for (j = r - 1; j >= 0; j--) {
+    b[j] /= S[j * r + j];
+    for (i = 0; i < j; i++) {
+      b[i] -= S[j * r + i] * b[j];
+    }
+  }
+}
+
+/**
+ * Store the current active set as the one of the cached factorization
+ * @param work Workspace
+ */
+static void set_factorized_rows(OSQPWorkspace *work) {
+  c_int j;
+
+  work->pol->m_fac = work->pol->n_low + work->pol->n_upp;
+
+  for (j = 0; j < polish_rows(work); j++) {
+    work->pol->A_to_Afac[j] = A_to_Ared(work, j);
+  }
+
+  for (j = 0; j < work->pol->n_low; j++) {
+    work->pol->Afac_to_A[j] = work->pol->Alow_to_A[j];
+  }
+
+  for (j = 0; j < work->pol->n_upp; j++) {
+    work->pol->Afac_to_A[work->pol->n_low + j] = work->pol->Aupp_to_A[j];
+  }
+}
+
+/**
+ * Compute the low-rank update of the cached factorization that accounts for
+ * the rows added to and dropped from the factorized active set.
+ * @param  work Workspace
+ * @param  upd  Low-rank update (n_add and n_drop already counted)
+ * @return      Exitflag, nonzero if the update cannot be computed
+ */
+static c_int compute_polish_update(OSQPWorkspace *work, PolishUpdate *upd) {
+  c_int i, j, k, ptr, r, n, nfac, nnz;
+  c_int m     = work->data->m;
+  c_int m_pol = polish_rows(work);
+  c_int *A_to_add;
+  const csc *A = work->data->A;
+  LinSysSolver *s = work->pol->linsys_solver;
+
+  n    = work->data->n;
+  nfac = n + work->pol->m_fac;
+  r    = upd->n_add + upd->n_drop;
+
+  upd->rows = (c_int *)c_malloc(r * sizeof(c_int));
+  upd->Ap   = (c_int *)c_calloc(upd->n_add + 1, sizeof(c_int));
+  upd->Z    = (c_float *)c_calloc(nfac * r, sizeof(c_float));
+  upd->S    = (c_float *)c_calloc(r * r, sizeof(c_float));
+  upd->piv  = (c_int *)c_malloc(r * sizeof(c_int));
+  upd->v    = (c_float *)c_malloc(r * sizeof(c_float));
+  A_to_add  = (c_int *)c_malloc(m_pol * sizeof(c_int));
+  if (!upd->rows || !upd->Ap || !upd->Z || !upd->S || !upd->piv ||
+      !upd->v || !A_to_add) {
+    if (A_to_add) c_free(A_to_add);
+    return 1;
+  }
+
+  // Collect added and dropped rows
+  upd->n_add  = 0;
+  upd->n_drop = 0;
+  for (j = 0; j < m_pol; j++) {
+    A_to_add[j] = -1;
+    if ((A_to_Ared(work, j) != -1) && (work->pol->A_to_Afac[j] == -1)) {
+      A_to_add[j] = upd->n_add;
+      upd->rows[upd->n_add++] = j;
+    } else if ((A_to_Ared(work, j) == -1) && (work->pol->A_to_Afac[j] != -1)) {
+      upd->rows[r - 1 - upd->n_drop++] = j;
+    }
+  }
+
+  // Extract the added rows of A and of the variable bounds
+  for (ptr = 0; ptr < A->p[n]; ptr++) {
+    if (A_to_add[A->i[ptr]] != -1) upd->Ap[A_to_add[A->i[ptr]] + 1]++;
+  }
+  for (j = m; j < m_pol; j++) {
+    if (A_to_add[j] != -1) upd->Ap[A_to_add[j] + 1]++;
+  }
+  for (i = 0; i < upd->n_add; i++) {
+    upd->Ap[i + 1] += upd->Ap[i];
+  }
+  nnz     = upd->Ap[upd->n_add];
+  upd->Ai = (c_int *)c_malloc((nnz ? nnz : 1) * sizeof(c_int));
+  upd->Ax = (c_float *)c_malloc((nnz ? nnz : 1) * sizeof(c_float));
+  if (!upd->Ai || !upd->Ax) {
+    c_free(A_to_add);
+    return 1;
+  }
+
+  for (j = 0; j < n; j++) {
+    for (ptr = A->p[j]; ptr < A->p[j + 1]; ptr++) {
+      k = A_to_add[A->i[ptr]];
+      if (k != -1) {
+        upd->Ai[upd->Ap[k]]   = j;
+        upd->Ax[upd->Ap[k]++] = A->x[ptr];
+      }
+    }
+    k = (m + j < m_pol) ? A_to_add[m + j] : -1;
+    if (k != -1) {
+      upd->Ai[upd->Ap[k]]   = j;
+      upd->Ax[upd->Ap[k]++] = 1.;
+    }
+  }
+  for (i = upd->n_add; i > 0; i--) {
+    upd->Ap[i] = upd->Ap[i - 1];
+  }
+  upd->Ap[0] = 0;
+  c_free(A_to_add);
+
+  // Form C column-wise in Z
+  for (i = 0; i < upd->n_add; i++) {
+    for (ptr = upd->Ap[i]; ptr < upd->Ap[i + 1]; ptr++) {
+      upd->Z[i * nfac + upd->Ai[ptr]] = upd->Ax[ptr];
+    }
+  }
+  for (i = upd->n_add; i < r; i++) {
+    upd->Z[i * nfac + n + work->pol->A_to_Afac[upd->rows[i]]] = 1.;
+  }
+
+  // Z = K0^{-1} * C
+  if (s->solve_multi(s, upd->Z, r)) return 1;
+
+  // Schur complement S = D - C' * Z
+  for (k = 0; k < r; k++) {
+    for (i = 0; i < upd->n_add; i++) {
+      for (ptr = upd->Ap[i]; ptr < upd->Ap[i + 1]; ptr++) {
+        upd->S[k * r + i] -= upd->Ax[ptr] * upd->Z[k * nfac + upd->Ai[ptr]];
+      }
+    }
+    for (i = upd->n_add; i < r; i++) {
+      upd->S[k * r + i] -= upd->Z[k * nfac + n + work->pol->A_to_Afac[upd->rows[i]]];
+    }
+  }
+  for (i = 0; i < upd->n_add; i++) {
+    upd->S[i * r + i] -= work->settings->delta;
+  }
+
+  return lu_factor(upd->S, upd->piv, r);
+}
+
+/**
+ * Form the stages of the variables and of the rows of Ared. The bound of a
+ * variable belongs to the stage of the variable.
+ * @param  work Workspace
+ * @return      Stages of the reduced KKT matrix, OSQP_NULL if the stages are
+ *              not given or the allocation failed (AMD ordering is used)
+ */
+static c_int* form_stages_red(OSQPWorkspace *work) {
+  c_int j, i, n = work->data->n;
+  c_int *stages;
+
+  if (!work->stages) return OSQP_NULL;
+
+  stages = c_malloc((n + work->pol->n_low + work->pol->n_upp) * sizeof(c_int));
+  if (!stages) return OSQP_NULL;
+
+  prea_int_vec_copy(work->stages, stages, n);
+  for (j = 0; j < work->pol->n_low + work->pol->n_upp; j++) {
+    i = j < work->pol->n_low ? work->pol->Alow_to_A[j] :
+                               work->pol->Aupp_to_A[j - work->pol->n_low];
+    stages[n + j] = i < work->data->m ? work->stages[n + i] :
+                                        work->stages[i - work->data->m];
+  }
+
+  return stages;
+}
+
+/**
+ * Make the cached factorization available for the current active set.
+ * The factorization is reused if the active set did not change, updated if
+ * only a few rows changed and recomputed otherwise.
+ * @param  work Workspace
+ * @param  upd  Low-rank update to be computed
+ * @return      Exitflag
+ */
+static c_int factorize_polish(OSQPWorkspace *work, PolishUpdate *upd) {
+  c_int j, active, exitflag;
+  c_int *stages;
+
+  if (work->pol->linsys_solver) {
+    // Count rows entering and leaving the factorized active set
+    for (j = 0; j < polish_rows(work); j++) {
+      active = A_to_Ared(work, j) != -1;
+      if (active && (work->pol->A_to_Afac[j] == -1)) upd->n_add++;
+      if (!active && (work->pol->A_to_Afac[j] != -1)) upd->n_drop++;
+    }
+
+    if (upd->n_add + upd->n_drop == 0) return 0;
+
+    if (upd->n_add + upd->n_drop <= POLISH_MAX_UPDATE_RANK) {
+      if (!compute_polish_update(work, upd)) return 0;
+    }
+
+    // Too many changes or update failed: recompute the factorization
+    free_polish_update(upd);
+    upd->n_add  = 0;
+    upd->n_drop = 0;
+    polish_free_factorization(work);
+  }
+
+  // Form and factorize reduced KKT
+  stages   = form_stages_red(work);
+  exitflag = init_linsys_solver(&(work->pol->linsys_solver), work->data->P,
+                                work->pol->Ared, work->settings->delta,
+                                OSQP_NULL, work->settings->linsys_solver, 1,
+                                stages, work->settings->ordering, OSQP_NULL);
+  if (stages) c_free(stages);
+
+  if (!exitflag) set_factorized_rows(work);
+
+  return exitflag;
+}
+
+/**
+ * Solve the reduced KKT system with the cached factorization and its
+ * low-rank update.
+ * @param work Workspace
+ * @param upd  Low-rank update and work vectors
+ * @param b    Right-hand side ordered as vstack[x, Alow, Aupp]; overwritten
+ *             by the solution
+ */
+static void polish_solve(OSQPWorkspace *work, PolishUpdate *upd, c_float *b) {
+  c_int i, j, k, ptr, r, n, nfac, mred;
+  c_float *w = upd->w;
+  LinSysSolver *s = work->pol->linsys_solver;
+
+  n    = work->data->n;
+  nfac = n + work->pol->m_fac;
+  mred = work->pol->n_low + work->pol->n_upp;
+  r    = upd->n_add + upd->n_drop;
+
+  if ((r == 0) && (mred == work->pol->m_fac)) {
+    // Solve directly if the rows are stored as in the factorization
+    for (i = 0; i < mred; i++) {
+      j = i < work->pol->n_low ? work->pol->Alow_to_A[i] :
+                                 work->pol->Aupp_to_A[i - work->pol->n_low];
+      if (work->pol->A_to_Afac[j] != i) break;
+    }
+    if (i == mred) {
+      s->solve(s, b);
+      return;
+    }
+  }
+
+  // Map right-hand side to the rows of the factorization
+  prea_vec_copy(b, w, n);
+  vec_set_scalar(w + n, 0., work->pol->m_fac);
+  for (i = 0; i < mred; i++) {
+    j = i < work->pol->n_low ? work->pol->Alow_to_A[i] :
+                               work->pol->Aupp_to_A[i - work->pol->n_low];
+    if (work->pol->A_to_Afac[j] != -1) w[n + work->pol->A_to_Afac[j]] = b[n + i];
+  }
+
+  // w = K0^{-1} * b0
+  s->solve(s, w);
+
+  if (r > 0) {
+    // v = S^{-1} * (bc - C' * w)
+    for (k = 0; k < upd->n_add; k++) {
+      upd->v[k] = b[n + A_to_Ared(work, upd->rows[k])];
+      for (ptr = upd->Ap[k]; ptr < upd->Ap[k + 1]; ptr++) {
+        upd->v[k] -= upd->Ax[ptr] * w[upd->Ai[ptr]];
+      }
+    }
+    for (k = upd->n_add; k < r; k++) {
+      upd->v[k] = -w[n + work->pol->A_to_Afac[upd->rows[k]]];
+    }
+    lu_solve(upd->S, upd->piv, r, upd->v);
+
+    // w = w - Z * v
+    for (k = 0; k < r; k++) {
+      for (i = 0; i < nfac; i++) {
+        w[i] -= upd->Z[k * nfac + i] * upd->v[k];
+      }
+    }
+  }
+
+  // Map solution back to the rows of Ared
+  prea_vec_copy(w, b, n);
+  for (i = 0; i < mred; i++) {
+    j = i < work->pol->n_low ? work->pol->Alow_to_A[i] :
+                               work->pol->Aupp_to_A[i - work->pol->n_low];
+    if (work->pol->A_to_Afac[j] != -1) {
+      b[n + i] = w[n + work->pol->A_to_Afac[j]];
+    } else {
+      // Added row: its multiplier is part of v
+      for (k = 0; upd->rows[k] != j; k++) ;
+      b[n + i] = upd->v[k];
+    }
   }
 }
 
@@ -126,13 +585,13 @@ static void form_rhs_red(OSQPWorkspace *work, c_float *rhs) {
  *    1. (K + dK) * dz = b - K*z
  *    2. z <- z + dz
  * @param  work Solver workspace
- * @param  p    Private variable for solving linear system
+ * @param  upd  Low-rank update of the cached factorization
  * @param  z    Initial z value
  * @param  b    RHS of the linear system
  * @return      Exitflag
  */
 static c_int iterative_refinement(OSQPWorkspace *work,
-                                  LinSysSolver  *p,
+                                  PolishUpdate  *upd,
                                   c_float       *z,
                                   c_float       *b) {
   c_int i, j, n;
@@ -167,7 +626,7 @@ static c_int iterative_refinement(OSQPWorkspace *work,
         mat_vec(work->pol->Ared, z, rhs + work->data->n, -1);
 
         // Solve linear system. Store solution in rhs
-        p->solve(p, rhs);
+        polish_solve(work, upd, rhs);
 
         // Update solution
         for (j = 0; j < n; j++) {
@@ -190,12 +649,12 @@ static void get_ypol_from_yred(OSQPWorkspace *work, c_float *yred) {
 
   // If there are no active constraints
   if (work->pol->n_low + work->pol->n_upp == 0) {
-    vec_set_scalar(work->pol->y, 0., work->data->m);
+    vec_set_scalar(work->pol->y, 0., polish_rows(work));
     return;
   }
 
   // NB: yred = vstack[ylow, yupp]
-  for (j = 0; j < work->data->m; j++) {
+  for (j = 0; j < polish_rows(work); j++) {
     if (work->pol->A_to_Alow[j] != -1) {
       // lower-active
       work->pol->y[j] = yred[work->pol->A_to_Alow[j]];
@@ -212,10 +671,12 @@ static void get_ypol_from_yred(OSQPWorkspace *work, c_float *yred) {
 c_int polish(OSQPWorkspace *work) {
   c_int mred, polish_successful, exitflag;
   c_float *rhs_red;
-  LinSysSolver *plsh;
   c_float *pol_sol; // Polished solution
+  PolishUpdate upd = { 0 };
 
 #ifdef PROFILING
+  OSQPTimer timer;
+
   osqp_tic(work->timer); // Start timer
 #endif /* ifdef PROFILING */
 
@@ -228,16 +689,24 @@ c_int polish(OSQPWorkspace *work) {
     return -1;
   }
 
-  // Form and factorize reduced KKT
-  exitflag = init_linsys_solver(&plsh, work->data->P, work->pol->Ared,
-                                work->settings->delta, OSQP_NULL,
-                                work->settings->linsys_solver, 1);
+  // Reuse, update or recompute the factorization of the reduced KKT
+  PROFILE_TIC(&timer);
+  exitflag = factorize_polish(work, &upd);
+  PROFILE_TOC(&work->info->profile, PROFILE_POLISH_FACTOR, &timer);
+  work->pol->update_rank = upd.n_add + upd.n_drop;
+
+  if (!exitflag) {
+    upd.w = (c_float *)c_malloc(sizeof(c_float) *
+                                (work->data->n + work->pol->m_fac));
+    if (!upd.w) exitflag = -1;
+  }
 
   if (exitflag) {
     // Polishing failed
     work->info->status_polish = -1;
 
     // Memory clean-up
+    free_polish_update(&upd);
     if (work->pol->Ared) csc_spfree(work->pol->Ared);
 
     return 1;
@@ -250,6 +719,7 @@ c_int polish(OSQPWorkspace *work) {
     work->info->status_polish = -1;
 
     // Memory clean-up
+    free_polish_update(&upd);
     csc_spfree(work->pol->Ared);
 
     return -1;
@@ -262,6 +732,7 @@ c_int polish(OSQPWorkspace *work) {
     work->info->status_polish = -1;
 
     // Memory clean-up
+    free_polish_update(&upd);
     csc_spfree(work->pol->Ared);
     c_free(rhs_red);
   
@@ -269,26 +740,29 @@ c_int polish(OSQPWorkspace *work) {
   }
 
   // Solve the reduced KKT system
-  plsh->solve(plsh, pol_sol);
+  polish_solve(work, &upd, pol_sol);
 
   // Perform iterative refinement to compensate for the regularization error
-  exitflag = iterative_refinement(work, plsh, pol_sol, rhs_red);
+  PROFILE_TIC(&timer);
+  exitflag = iterative_refinement(work, &upd, pol_sol, rhs_red);
+  PROFILE_TOC(&work->info->profile, PROFILE_POLISH_REFINE, &timer);
 
   if (exitflag) {
     // Polishing failed
     work->info->status_polish = -1;
 
     // Memory clean-up
+    free_polish_update(&upd);
     csc_spfree(work->pol->Ared);
     c_free(rhs_red);
     c_free(pol_sol);
   
     return -1;
   }
-
   // Store the polished solution (x,z,y)
   prea_vec_copy(pol_sol, work->pol->x, work->data->n);   // pol->x
   mat_vec(work->data->A, work->pol->x, work->pol->z, 0); // pol->z
+  prea_vec_copy(work->pol->x, work->pol->z + work->data->m, work->n_bnd);
   get_ypol_from_yred(work, pol_sol + work->data->n);     // pol->y
 
   // Ensure (z,y) satisfies normal cone constraint
@@ -323,8 +797,8 @@ c_int polish(OSQPWorkspace *work) {
     // Update (x, z, y) in ADMM iterations
     // NB: z needed for warm starting
     prea_vec_copy(work->pol->x, work->x, work->data->n);
-    prea_vec_copy(work->pol->z, work->z, work->data->m);
-    prea_vec_copy(work->pol->y, work->y, work->data->m);
+    prea_vec_copy(work->pol->z, work->z, polish_rows(work));
+    prea_vec_copy(work->pol->y, work->y, polish_rows(work));
 
     // Print summary
 #ifdef PRINTING
@@ -339,7 +813,8 @@ c_int polish(OSQPWorkspace *work) {
   }
 
   // Memory clean-up
-  plsh->free(plsh);
+  // NB: The factorization is kept for the next call
+  free_polish_update(&upd);
 
   // Checks that they are not NULL are already performed earlier
   csc_spfree(work->pol->Ared);
@@ -348,3 +823,10 @@ c_int polish(OSQPWorkspace *work) {
 
   return 0;
 }
+
+void polish_free_factorization(OSQPWorkspace *work) {
+  if (work->pol && work->pol->linsys_solver) {
+    work->pol->linsys_solver->free(work->pol->linsys_solver);
+    work->pol->linsys_solver = OSQP_NULL;
+  }
+}
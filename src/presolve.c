@@ -0,0 +1,773 @@
+#include "presolve.h"
+#include "lin_alg.h"
+#include "constants.h"
+#include "cs.h"
+
+#define PRESOLVE_ROW_KEEP  (0) ///< constraint of the presolved problem
+#define PRESOLVE_ROW_FREE  (1) ///< removed constraint with infinite bounds
+#define PRESOLVE_ROW_EMPTY (2) ///< removed constraint with nonzero elements only in fixed variables
+#define PRESOLVE_ROW_BOUND (3) ///< singleton constraint merged into the bounds of its variable
+#define PRESOLVE_ROW_PARALLEL (4) ///< constraint merged into the first row of its group of parallel rows
+
+
+/**
+ * Bounds bl <= z <= bu given by l <= a * z <= u
+ */
+static void scaled_bounds(c_float  l,
+                          c_float  u,
+                          c_float  a,
+                          c_float *bl,
+                          c_float *bu) {
+  c_float inf = OSQP_INFTY * MIN_SCALING;
+
+  if (a > 0) {
+    *bl = (l < -inf) ? -OSQP_INFTY : l / a;
+    *bu = (u > inf)  ?  OSQP_INFTY : u / a;
+  } else {
+    *bl = (u > inf)  ? -OSQP_INFTY : u / a;
+    *bu = (l < -inf) ?  OSQP_INFTY : l / a;
+  }
+}
+
+/**
+ * Hash of the element in column j with value v of a row normalized by its
+ * first element
+ */
+static unsigned int hash_element(c_int j, c_float v) {
+  unsigned int h = (unsigned int)j * 2654435761u;
+  union {
+    double             d;
+    unsigned long long bits;
+  } val;
+
+  val.bits = 0;
+  val.d    = (v == 0.0) ? 0.0 : (double)v; // -0 and +0 have the same hash
+  h ^= (unsigned int)(val.bits ^ (val.bits >> 32));
+  h *= 0x45d9f3bu;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ * Find the groups of parallel rows of A, i.e., rows that are scalar multiples
+ * of each other, and store the first row of the group of each row in par_rep
+ * and the ratio to it in par_scale.
+ *
+ * The rows are normalized by their first element and hashed in an
+ * open-addressing table. Rows with the same hash are compared on a row-major
+ * copy of A, hence the cost is linear in the number of nonzero elements.
+ * Normalized rows must match exactly. Singleton rows are handled as variable
+ * bounds and are not grouped.
+ * @param  presolve Presolve structure
+ * @return          Exitflag: 1 if memory allocation failed
+ */
+static c_int find_parallel_rows(OSQPPresolve *presolve) {
+  c_int i, j, k, e, ptr, size, exitflag = 0;
+  c_int m   = presolve->m;
+  c_int nnz = presolve->A->p[presolve->n];
+  c_int *rp, *rj, *table;
+  c_float *rx, *first;
+  unsigned int *hash;
+
+  for (i = 0; i < m; i++) {
+    presolve->par_rep[i]   = -1;
+    presolve->par_scale[i] = 1.0;
+  }
+  if (m < 2) return 0;
+
+  // Table size: power of two at least twice the number of rows
+  for (size = 2; size < 2 * m; size *= 2) ;
+
+  rp    = c_malloc((m + 1) * sizeof(c_int));
+  rj    = c_malloc((nnz ? nnz : 1) * sizeof(c_int));
+  rx    = c_malloc((nnz ? nnz : 1) * sizeof(c_float));
+  first = c_malloc(m * sizeof(c_float));
+  hash  = c_malloc(m * sizeof(unsigned int));
+  table = c_malloc(size * sizeof(c_int));
+  if (!rp || !rj || !rx || !first || !hash || !table) {
+    exitflag = 1;
+    goto exit;
+  }
+
+  // Row-major copy of A. The columns of each row are sorted. The table
+  // stores the next position of each row.
+  rp[0] = 0;
+  for (i = 0; i < m; i++) {
+    rp[i + 1] = rp[i] + presolve->row_nnz[i];
+    table[i]  = rp[i];
+  }
+  for (j = 0; j < presolve->n; j++) {
+    for (ptr = presolve->A->p[j]; ptr < presolve->A->p[j + 1]; ptr++) {
+      k     = table[presolve->A->i[ptr]]++;
+      rj[k] = j;
+      rx[k] = presolve->A->x[ptr];
+    }
+  }
+
+  // Hash of the normalized rows. Rows with less than two elements or a zero
+  // first element are not grouped.
+  for (i = 0; i < m; i++) {
+    hash[i]  = 2166136261u;
+    first[i] = (presolve->row_nnz[i] < 2) ? 0.0 : rx[rp[i]];
+    if (first[i] == 0.0) continue;
+    for (k = rp[i]; k < rp[i + 1]; k++) {
+      hash[i] = (hash[i] ^ hash_element(rj[k], rx[k] / first[i])) * 16777619u;
+    }
+  }
+
+  // Group the rows with equal normalized elements
+  for (k = 0; k < size; k++) table[k] = -1;
+  for (i = 0; i < m; i++) {
+    if (first[i] == 0.0) continue;
+
+    for (k = hash[i] & (unsigned int)(size - 1); ; k = (k + 1) & (size - 1)) {
+      e = table[k];
+      if (e < 0) {
+        table[k] = i;
+        break;
+      }
+      if ((hash[e] != hash[i]) ||
+          (presolve->row_nnz[e] != presolve->row_nnz[i])) continue;
+
+      for (ptr = 0; ptr < presolve->row_nnz[i]; ptr++) {
+        if ((rj[rp[e] + ptr] != rj[rp[i] + ptr]) ||
+            (rx[rp[e] + ptr] / first[e] != rx[rp[i] + ptr] / first[i])) break;
+      }
+      if (ptr == presolve->row_nnz[i]) {
+        presolve->par_rep[e]   = e;
+        presolve->par_rep[i]   = e;
+        presolve->par_scale[i] = first[i] / first[e];
+        break;
+      }
+    }
+  }
+
+exit:
+  c_free(rp);
+  c_free(rj);
+  c_free(rx);
+  c_free(first);
+  c_free(hash);
+  c_free(table);
+
+  return exitflag;
+}
+
+
+/**
+ * Find the reductions given the bounds l and u and the variable bounds lb and
+ * ub.
+ *
+ * row_type, row_l, row_u, fixed, x_fix, lo, hi, lo_row and hi_row are the
+ * outputs. cnt is a workspace of size m.
+ */
+static void analyze(const OSQPPresolve *presolve,
+                    const c_float      *l,
+                    const c_float      *u,
+                    const c_float      *lb,
+                    const c_float      *ub,
+                    c_int              *row_type,
+                    c_float            *row_l,
+                    c_float            *row_u,
+                    c_int              *fixed,
+                    c_float            *x_fix,
+                    c_float            *lo,
+                    c_float            *hi,
+                    c_int              *lo_row,
+                    c_int              *hi_row,
+                    c_int              *cnt) {
+  c_int   i, j, r, ptr, nfixed = 0, last = -1;
+  c_int   n   = presolve->n;
+  c_int   m   = presolve->m;
+  c_float inf = OSQP_INFTY * MIN_SCALING;
+  c_float bl, bu;
+
+  for (j = 0; j < n; j++) {
+    lo[j]     = lb[j];
+    hi[j]     = ub[j];
+    lo_row[j] = -1;
+    hi_row[j] = -1;
+    fixed[j]  = 0;
+    x_fix[j]  = 0.0;
+  }
+
+  // Bounds of the parallel rows merged into the first row of their group
+  prea_vec_copy(l, row_l, m);
+  prea_vec_copy(u, row_u, m);
+  for (i = 0; i < m; i++) {
+    r = presolve->par_rep[i];
+    if ((r < 0) || (r == i)) continue;
+    scaled_bounds(l[i], u[i], presolve->par_scale[i], &bl, &bu);
+    row_l[r] = c_max(row_l[r], bl);
+    row_u[r] = c_min(row_u[r], bu);
+  }
+
+  // Groups with inconsistent bounds keep all their rows so that the solver
+  // detects the infeasibility
+  for (i = 0; i < m; i++) {
+    r = presolve->par_rep[i];
+    row_type[i] = ((r >= 0) && (r != i) && (row_l[r] <= row_u[r])) ?
+                  PRESOLVE_ROW_PARALLEL : PRESOLVE_ROW_KEEP;
+  }
+  for (i = 0; i < m; i++) {
+    if (row_l[i] > row_u[i]) {
+      row_l[i] = l[i];
+      row_u[i] = u[i];
+    }
+  }
+
+  // Free constraints and bounds of the variables from singleton constraints
+  for (i = 0; i < m; i++) {
+    if (row_type[i] == PRESOLVE_ROW_PARALLEL) continue;
+
+    if ((row_l[i] < -inf) && (row_u[i] > inf)) {
+      row_type[i] = PRESOLVE_ROW_FREE;
+    } else if ((presolve->row_nnz[i] == 1) && (presolve->row_coef[i] != 0.0)) {
+      row_type[i] = PRESOLVE_ROW_BOUND;
+      j = presolve->row_var[i];
+      scaled_bounds(l[i], u[i], presolve->row_coef[i], &bl, &bu);
+
+      if (bl > lo[j]) {
+        lo[j]     = bl;
+        lo_row[j] = i;
+      }
+      if (bu < hi[j]) {
+        hi[j]     = bu;
+        hi_row[j] = i;
+      }
+    } else {
+      row_type[i] = PRESOLVE_ROW_KEEP;
+    }
+  }
+
+  // Variables with inconsistent bounds keep their singleton constraints so
+  // that the solver detects the infeasibility
+  for (i = 0; i < m; i++) {
+    if (row_type[i] == PRESOLVE_ROW_BOUND) {
+      j = presolve->row_var[i];
+      if (lo[j] > hi[j]) row_type[i] = PRESOLVE_ROW_KEEP;
+    }
+  }
+  for (j = 0; j < n; j++) {
+    if (lo[j] > hi[j]) {
+      lo[j]     = lb[j];
+      hi[j]     = ub[j];
+      lo_row[j] = -1;
+      hi_row[j] = -1;
+    } else if ((lo[j] == hi[j]) && (lo[j] > -inf) && (hi[j] < inf)) {
+      fixed[j] = 1;
+      x_fix[j] = lo[j];
+      nfixed++;
+      last = j;
+    }
+  }
+
+  // The presolved problem needs at least one variable
+  if (nfixed && (nfixed == n)) {
+    fixed[last] = 0;
+    x_fix[last] = 0.0;
+  }
+
+  // Constraints with nonzero elements only in fixed variables are removed if
+  // they are satisfied
+  for (i = 0; i < m; i++) {
+    cnt[i]               = 0;
+    presolve->vec_m[i]   = 0.0;
+  }
+  for (j = 0; j < n; j++) {
+    for (ptr = presolve->A->p[j]; ptr < presolve->A->p[j + 1]; ptr++) {
+      i = presolve->A->i[ptr];
+      if (fixed[j]) presolve->vec_m[i] += presolve->A->x[ptr] * x_fix[j];
+      else cnt[i]++;
+    }
+  }
+  for (i = 0; i < m; i++) {
+    if ((row_type[i] == PRESOLVE_ROW_KEEP) && (cnt[i] == 0) &&
+        (row_l[i] <= presolve->vec_m[i]) && (presolve->vec_m[i] <= row_u[i])) {
+      row_type[i] = PRESOLVE_ROW_EMPTY;
+    }
+  }
+}
+
+/**
+ * Compute q_red, l_red, u_red, lb_red, ub_red and the objective value of the
+ * fixed variables
+ */
+static void presolve_vectors(OSQPPresolve *presolve) {
+  c_int   i, j, b;
+  c_float inf = OSQP_INFTY * MIN_SCALING;
+
+  // Contributions of the fixed variables (P is upper triangular)
+  mat_vec(presolve->P, presolve->x_fix, presolve->vec_n, 0);
+  mat_tpose_vec(presolve->P, presolve->x_fix, presolve->vec_n, 1, 1);
+  mat_vec(presolve->A, presolve->x_fix, presolve->vec_m, 0);
+
+  presolve->obj_offset = 0.0;
+  for (j = 0; j < presolve->n; j++) {
+    if (presolve->var_map[j] >= 0) {
+      presolve->q_red[presolve->var_map[j]] = presolve->q[j] + presolve->vec_n[j];
+    } else {
+      presolve->obj_offset += (presolve->q[j] + 0.5 * presolve->vec_n[j]) *
+                              presolve->x_fix[j];
+    }
+  }
+
+  for (i = 0; i < presolve->m; i++) {
+    if (presolve->row_type[i] == PRESOLVE_ROW_KEEP) {
+      b = presolve->con_map[i];
+      presolve->l_red[b] = (presolve->row_l[i] < -inf) ? presolve->row_l[i] :
+                           presolve->row_l[i] - presolve->vec_m[i];
+      presolve->u_red[b] = (presolve->row_u[i] > inf) ? presolve->row_u[i] :
+                           presolve->row_u[i] - presolve->vec_m[i];
+    }
+  }
+
+  if (presolve->bnd_red) {
+    for (j = 0; j < presolve->n; j++) {
+      b = presolve->var_map[j];
+      if (b >= 0) {
+        presolve->lb_red[b] = presolve->lo[j];
+        presolve->ub_red[b] = presolve->hi[j];
+      }
+    }
+  }
+}
+
+/**
+ * Extract the rows and columns of M that are kept in the presolved problem
+ */
+static csc* reduce_matrix(const OSQPPresolve *presolve,
+                          const csc          *M,
+                          c_int               nrows,
+                          const c_int        *row_map) {
+  c_int j, ptr, nz = 0;
+  csc  *R;
+
+  for (j = 0; j < presolve->n; j++) {
+    if (presolve->var_map[j] < 0) continue;
+    for (ptr = M->p[j]; ptr < M->p[j + 1]; ptr++) {
+      if (row_map[M->i[ptr]] >= 0) nz++;
+    }
+  }
+
+  R = csc_spalloc(nrows, presolve->n_red, nz, 1, 0);
+  if (!R) return OSQP_NULL;
+
+  nz = 0;
+  for (j = 0; j < presolve->n; j++) {
+    if (presolve->var_map[j] < 0) continue;
+    R->p[presolve->var_map[j]] = nz;
+    for (ptr = M->p[j]; ptr < M->p[j + 1]; ptr++) {
+      if (row_map[M->i[ptr]] >= 0) {
+        R->i[nz] = row_map[M->i[ptr]];
+        R->x[nz] = M->x[ptr];
+        nz++;
+      }
+    }
+  }
+  R->p[presolve->n_red] = nz;
+
+  return R;
+}
+
+/**
+ * Set the multiplier of the active bound of variable j given the multiplier
+ * yb of its bounds in the presolved problem. The active bound is either a
+ * singleton constraint, stored in y, or a variable bound, stored in y_bnd
+ * (OSQP_NULL if the original problem has no variable bounds).
+ */
+static void bound_multiplier(const OSQPPresolve *presolve,
+                             c_float            *y,
+                             c_float            *y_bnd,
+                             c_int               j,
+                             c_float             yb) {
+  c_int i = -1;
+
+  if (yb < 0) i = presolve->lo_row[j];
+  else if (yb > 0) i = presolve->hi_row[j];
+  else return;
+
+  if (i >= 0) y[i] = yb / presolve->row_coef[i];
+  else if (y_bnd) y_bnd[j] = yb;
+}
+
+
+c_int presolve_init(OSQPWorkspace   *work,
+                    const OSQPData  *data,
+                    const c_int     *stages,
+                    OSQPData       **data_red) {
+  c_int i, j, ptr, exitflag = 0;
+  c_int n = data->n;
+  c_int m = data->m;
+  c_int *cnt;
+  OSQPPresolve *presolve;
+  OSQPData     *red;
+
+  presolve = c_calloc(1, sizeof(OSQPPresolve));
+  if (!presolve) return 1;
+  work->presolve = presolve;
+
+  presolve->n        = n;
+  presolve->m        = m;
+  presolve->P        = copy_csc_mat(data->P);
+  presolve->A        = copy_csc_mat(data->A);
+  presolve->q        = vec_copy(data->q, n);
+  presolve->l        = vec_copy(data->l, m);
+  presolve->u        = vec_copy(data->u, m);
+  presolve->lb       = c_malloc(n * sizeof(c_float));
+  presolve->ub       = c_malloc(n * sizeof(c_float));
+  presolve->q_red    = c_malloc(n * sizeof(c_float));
+  presolve->l_red    = c_malloc(m * sizeof(c_float));
+  presolve->u_red    = c_malloc(m * sizeof(c_float));
+  presolve->lb_red   = c_malloc(n * sizeof(c_float));
+  presolve->ub_red   = c_malloc(n * sizeof(c_float));
+  presolve->x_red    = c_malloc(n * sizeof(c_float));
+  presolve->y_red    = c_malloc((m + n) * sizeof(c_float));
+  presolve->var_map  = c_malloc(n * sizeof(c_int));
+  presolve->con_map  = c_malloc(m * sizeof(c_int));
+  presolve->row_type = c_malloc(m * sizeof(c_int));
+  presolve->row_nnz  = c_malloc(m * sizeof(c_int));
+  presolve->row_var  = c_malloc(m * sizeof(c_int));
+  presolve->row_coef = c_malloc(m * sizeof(c_float));
+  presolve->par_rep  = c_malloc(m * sizeof(c_int));
+  presolve->par_scale = c_malloc(m * sizeof(c_float));
+  presolve->row_l    = c_malloc(m * sizeof(c_float));
+  presolve->row_u    = c_malloc(m * sizeof(c_float));
+  presolve->lo_row   = c_malloc(n * sizeof(c_int));
+  presolve->hi_row   = c_malloc(n * sizeof(c_int));
+  presolve->lo       = c_malloc(n * sizeof(c_float));
+  presolve->hi       = c_malloc(n * sizeof(c_float));
+  presolve->x_fix    = c_malloc(n * sizeof(c_float));
+  presolve->vec_n    = c_malloc(n * sizeof(c_float));
+  presolve->vec_m    = c_malloc(m * sizeof(c_float));
+  cnt                = c_malloc(m * sizeof(c_int));
+  if (!(presolve->P) || !(presolve->A) || !(presolve->q) ||
+      !(presolve->lb) || !(presolve->ub) || !(presolve->q_red) ||
+      !(presolve->lb_red) || !(presolve->ub_red) ||
+      !(presolve->x_red) || !(presolve->y_red) || !(presolve->var_map) ||
+      !(presolve->lo_row) || !(presolve->hi_row) || !(presolve->lo) ||
+      !(presolve->hi) || !(presolve->x_fix) || !(presolve->vec_n)) {
+    c_free(cnt);
+    return 1;
+  }
+  if (m && (!(presolve->l) || !(presolve->u) ||
+            !(presolve->l_red) || !(presolve->u_red) || !(presolve->con_map) ||
+            !(presolve->row_type) || !(presolve->row_nnz) ||
+            !(presolve->row_var) || !(presolve->row_coef) ||
+            !(presolve->par_rep) || !(presolve->par_scale) ||
+            !(presolve->row_l) || !(presolve->row_u) ||
+            !(presolve->vec_m) || !cnt)) {
+    c_free(cnt);
+    return 1;
+  }
+
+  // Variable bounds. A missing lower or upper bound is infinite.
+  presolve->bnd = (data->lb || data->ub);
+  if (data->lb) prea_vec_copy(data->lb, presolve->lb, n);
+  else vec_set_scalar(presolve->lb, -OSQP_INFTY, n);
+  if (data->ub) prea_vec_copy(data->ub, presolve->ub, n);
+  else vec_set_scalar(presolve->ub, OSQP_INFTY, n);
+
+  // Number of elements of each row and the only element of singleton rows
+  for (i = 0; i < m; i++) presolve->row_nnz[i] = 0;
+  for (j = 0; j < n; j++) {
+    for (ptr = data->A->p[j]; ptr < data->A->p[j + 1]; ptr++) {
+      i = data->A->i[ptr];
+      presolve->row_nnz[i]++;
+      presolve->row_var[i]  = j;
+      presolve->row_coef[i] = data->A->x[ptr];
+    }
+  }
+
+  // Duplicate and parallel rows
+  if (find_parallel_rows(presolve)) {
+    c_free(cnt);
+    return 1;
+  }
+
+  analyze(presolve, presolve->l, presolve->u, presolve->lb, presolve->ub,
+          presolve->row_type, presolve->row_l, presolve->row_u,
+          presolve->var_map, presolve->x_fix, presolve->lo, presolve->hi,
+          presolve->lo_row, presolve->hi_row, cnt);
+  c_free(cnt);
+
+  // Indices of the variables and constraints in the presolved problem
+  presolve->n_red = 0;
+  for (j = 0; j < n; j++) {
+    presolve->var_map[j] = presolve->var_map[j] ? -1 : presolve->n_red++;
+  }
+  presolve->m_red   = 0;
+  presolve->bnd_red = presolve->bnd;
+  for (i = 0; i < m; i++) {
+    presolve->con_map[i] = (presolve->row_type[i] == PRESOLVE_ROW_KEEP) ?
+                           presolve->m_red++ : -1;
+
+    // Singleton constraints become variable bounds of the presolved problem
+    if (presolve->row_type[i] == PRESOLVE_ROW_BOUND) presolve->bnd_red = 1;
+  }
+
+  // Stages of the presolved problem
+  if (stages) {
+    presolve->stages = c_malloc((presolve->n_red + presolve->m_red) * sizeof(c_int));
+    if (!(presolve->stages)) return 1;
+    for (j = 0; j < n; j++) {
+      if (presolve->var_map[j] >= 0) presolve->stages[presolve->var_map[j]] = stages[j];
+    }
+    for (i = 0; i < m; i++) {
+      if (presolve->row_type[i] == PRESOLVE_ROW_KEEP) {
+        presolve->stages[presolve->n_red + presolve->con_map[i]] = stages[n + i];
+      }
+    }
+  }
+
+  presolve_vectors(presolve);
+
+  // Presolved problem data
+  red = c_calloc(1, sizeof(OSQPData));
+  if (!red) return 1;
+  *data_red = red;
+  red->n    = presolve->n_red;
+  red->m    = presolve->m_red;
+  red->P    = reduce_matrix(presolve, presolve->P, presolve->n_red,
+                            presolve->var_map);
+  red->A    = reduce_matrix(presolve, presolve->A, presolve->m_red,
+                            presolve->con_map);
+  red->q    = presolve->q_red;
+  red->l    = presolve->l_red;
+  red->u    = presolve->u_red;
+  if (presolve->bnd_red) {
+    red->lb = presolve->lb_red;
+    red->ub = presolve->ub_red;
+  }
+  if (!(red->P) || !(red->A)) exitflag = 1;
+
+  return exitflag;
+}
+
+void presolve_free_data(OSQPData *data_red) {
+  if (data_red) {
+    if (data_red->P) csc_spfree(data_red->P);
+    if (data_red->A) csc_spfree(data_red->A);
+    c_free(data_red);
+  }
+}
+
+void presolve_update_lin_cost(OSQPPresolve  *presolve,
+                              const c_float *q_new) {
+  prea_vec_copy(q_new, presolve->q, presolve->n);
+  presolve_vectors(presolve);
+}
+
+c_int presolve_update_bounds(OSQPPresolve  *presolve,
+                             const c_float *l_new,
+                             const c_float *u_new,
+                             const c_float *lb_new,
+                             const c_float *ub_new) {
+  c_int i, j, changed = 0;
+  c_int n = presolve->n;
+  c_int m = presolve->m;
+  c_int   *ints   = c_malloc((2 * m + 3 * n) * sizeof(c_int));
+  c_float *floats = c_malloc((2 * m + 3 * n) * sizeof(c_float));
+  c_int   *row_type, *fixed, *lo_row, *hi_row, *cnt;
+  c_float *row_l, *row_u, *x_fix, *lo, *hi;
+
+  if (!ints || !floats) {
+    c_free(ints);
+    c_free(floats);
+    return 1;
+  }
+  row_type = ints;
+  cnt      = ints + m;
+  fixed    = ints + 2 * m;
+  lo_row   = fixed + n;
+  hi_row   = lo_row + n;
+  row_l    = floats;
+  row_u    = floats + m;
+  x_fix    = floats + 2 * m;
+  lo       = x_fix + n;
+  hi       = lo + n;
+
+  analyze(presolve, l_new, u_new, lb_new, ub_new, row_type, row_l, row_u,
+          fixed, x_fix, lo, hi, lo_row, hi_row, cnt);
+
+  // The removed constraints and the fixed variables must not change
+  for (i = 0; i < m; i++) {
+    if (row_type[i] != presolve->row_type[i]) changed = 1;
+  }
+  for (j = 0; j < n; j++) {
+    if ((fixed[j] != (presolve->var_map[j] < 0)) ||
+        (x_fix[j] != presolve->x_fix[j])) changed = 1;
+  }
+
+  if (!changed) {
+    prea_vec_copy(l_new, presolve->l, m);
+    prea_vec_copy(u_new, presolve->u, m);
+    prea_vec_copy(row_l, presolve->row_l, m);
+    prea_vec_copy(row_u, presolve->row_u, m);
+    prea_vec_copy(lb_new, presolve->lb, n);
+    prea_vec_copy(ub_new, presolve->ub, n);
+    prea_vec_copy(lo, presolve->lo, n);
+    prea_vec_copy(hi, presolve->hi, n);
+    prea_int_vec_copy(lo_row, presolve->lo_row, n);
+    prea_int_vec_copy(hi_row, presolve->hi_row, n);
+    presolve_vectors(presolve);
+  }
+
+  c_free(ints);
+  c_free(floats);
+
+  return changed;
+}
+
+void presolve_x(OSQPPresolve  *presolve,
+                const c_float *x) {
+  c_int j;
+
+  for (j = 0; j < presolve->n; j++) {
+    if (presolve->var_map[j] >= 0) presolve->x_red[presolve->var_map[j]] = x[j];
+  }
+}
+
+void presolve_y(OSQPPresolve  *presolve,
+                const c_float *y) {
+  c_int    i, j;
+  c_float *y_bnd = presolve->y_red + presolve->m_red;
+
+  for (i = 0; i < presolve->m; i++) {
+    if (presolve->row_type[i] == PRESOLVE_ROW_KEEP) {
+      presolve->y_red[presolve->con_map[i]] = y[i];
+    }
+  }
+
+  // Multipliers of the merged parallel rows
+  for (i = 0; i < presolve->m; i++) {
+    j = presolve->par_rep[i];
+    if ((presolve->row_type[i] == PRESOLVE_ROW_PARALLEL) &&
+        (presolve->con_map[j] >= 0)) {
+      presolve->y_red[presolve->con_map[j]] += presolve->par_scale[i] * y[i];
+    }
+  }
+  if (!(presolve->bnd_red)) return;
+
+  // Multipliers of the variable bounds and of the merged singleton constraints
+  for (j = 0; j < presolve->n; j++) {
+    if (presolve->var_map[j] >= 0) {
+      y_bnd[presolve->var_map[j]] = presolve->bnd ? y[presolve->m + j] : 0.0;
+    }
+  }
+  for (i = 0; i < presolve->m; i++) {
+    j = presolve->row_var[i];
+    if ((presolve->row_type[i] == PRESOLVE_ROW_BOUND) &&
+        (presolve->var_map[j] >= 0)) {
+      y_bnd[presolve->var_map[j]] += presolve->row_coef[i] * y[i];
+    }
+  }
+}
+
+void postsolve_solution(OSQPWorkspace *work) {
+  c_int   i, j, k;
+  c_float t, bl, bu;
+  OSQPPresolve *presolve = work->presolve;
+  OSQPSolution *solution = work->solution;
+  c_float      *y_red    = presolve->y_red;
+
+  // The multipliers of the variable bounds follow the ones of the constraints
+  prea_vec_copy(solution->x, presolve->x_red, presolve->n_red);
+  prea_vec_copy(solution->y, y_red,
+                presolve->m_red + (presolve->bnd_red ? presolve->n_red : 0));
+
+  for (j = 0; j < presolve->n; j++) {
+    solution->x[j] = (presolve->var_map[j] >= 0) ?
+                     presolve->x_red[presolve->var_map[j]] : presolve->x_fix[j];
+  }
+  // Multipliers of the constraints. The multiplier of a group of parallel rows
+  // goes to the row that gives its active bound.
+  for (i = 0; i < presolve->m; i++) {
+    solution->y[i]     = 0.0;
+    presolve->vec_m[i] = (presolve->row_type[i] == PRESOLVE_ROW_KEEP) ?
+                         y_red[presolve->con_map[i]] : 0.0;
+  }
+  for (i = 0; i < presolve->m; i++) {
+    if (presolve->row_type[i] == PRESOLVE_ROW_KEEP) k = i;
+    else if (presolve->row_type[i] == PRESOLVE_ROW_PARALLEL) k = presolve->par_rep[i];
+    else continue;
+    if (presolve->vec_m[k] == 0.0) continue;
+
+    t = (k == i) ? 1.0 : presolve->par_scale[i];
+    scaled_bounds(presolve->l[i], presolve->u[i], t, &bl, &bu);
+    if (((presolve->vec_m[k] < 0) && (bl == presolve->row_l[k])) ||
+        ((presolve->vec_m[k] > 0) && (bu == presolve->row_u[k]))) {
+      solution->y[i]     = presolve->vec_m[k] / t;
+      presolve->vec_m[k] = 0.0;
+    }
+  }
+  for (i = 0; i < presolve->m; i++) {
+    if (presolve->row_type[i] == PRESOLVE_ROW_KEEP) solution->y[i] += presolve->vec_m[i];
+  }
+  if (solution->y_bnd) vec_set_scalar(solution->y_bnd, 0.0, presolve->n);
+
+  // Multipliers of the variable bounds of the presolved problem
+  if (presolve->bnd_red) {
+    for (j = 0; j < presolve->n; j++) {
+      if (presolve->var_map[j] >= 0) {
+        bound_multiplier(presolve, solution->y, solution->y_bnd, j,
+                         y_red[presolve->m_red + presolve->var_map[j]]);
+      }
+    }
+  }
+
+  // Multipliers of the fixed variables from the stationarity condition
+  // P x + q + A' y + y_bnd = 0
+  if (presolve->n_red < presolve->n) {
+    mat_vec(presolve->P, solution->x, presolve->vec_n, 0);
+    mat_tpose_vec(presolve->P, solution->x, presolve->vec_n, 1, 1);
+    vec_add_scaled(presolve->vec_n, presolve->vec_n, presolve->q,
+                   presolve->n, 1.0);
+    mat_tpose_vec(presolve->A, solution->y, presolve->vec_n, 1, 0);
+
+    for (j = 0; j < presolve->n; j++) {
+      if (presolve->var_map[j] < 0) {
+        bound_multiplier(presolve, solution->y, solution->y_bnd, j,
+                         -presolve->vec_n[j]);
+      }
+    }
+  }
+}
+
+void presolve_free(OSQPPresolve *presolve) {
+  if (presolve) {
+    if (presolve->P) csc_spfree(presolve->P);
+    if (presolve->A) csc_spfree(presolve->A);
+    c_free(presolve->q);
+    c_free(presolve->l);
+    c_free(presolve->u);
+    c_free(presolve->lb);
+    c_free(presolve->ub);
+    c_free(presolve->q_red);
+    c_free(presolve->l_red);
+    c_free(presolve->u_red);
+    c_free(presolve->lb_red);
+    c_free(presolve->ub_red);
+    c_free(presolve->x_red);
+    c_free(presolve->y_red);
+    c_free(presolve->var_map);
+    c_free(presolve->con_map);
+    c_free(presolve->row_type);
+    c_free(presolve->row_nnz);
+    c_free(presolve->row_var);
+    c_free(presolve->row_coef);
+    c_free(presolve->par_rep);
+    c_free(presolve->par_scale);
+    c_free(presolve->row_l);
+    c_free(presolve->row_u);
+    c_free(presolve->lo_row);
+    c_free(presolve->hi_row);
+    c_free(presolve->lo);
+    c_free(presolve->hi);
+    c_free(presolve->x_fix);
+    c_free(presolve->vec_n);
+    c_free(presolve->vec_m);
+    c_free(presolve->stages);
+    c_free(presolve);
+  }
+}
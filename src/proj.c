@@ -26,4 +26,14 @@ void project_normalcone(OSQPWorkspace *work, c_float *z, c_float *y) {
                             work->data->u[i]);
     y[i] = work->z_prev[i] - z[i];
   }
+
+#ifndef EMBEDDED
+  // Variable bounds stored after the constraints
+  for (i = m; i < m + work->n_bnd; i++) {
+    work->z_prev[i] = z[i] + y[i];
+    z[i]            = c_min(c_max(work->z_prev[i], work->data->lb[i - m]),
+                            work->data->ub[i - m]);
+    y[i] = work->z_prev[i] - z[i];
+  }
+#endif /* ifndef EMBEDDED */
 }
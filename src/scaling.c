@@ -1,4 +1,5 @@
 #include "scaling.h"
+#include "util.h"
 
 #if EMBEDDED != 1
 
@@ -58,6 +59,12 @@ c_int scale_data(OSQPWorkspace *work) {
   c_float c_temp;     // Cost function scaling
   c_float inf_norm_q; // Infinity norm of q
 
+#ifdef PROFILING
+  OSQPTimer timer;
+#endif /* ifdef PROFILING */
+
+  PROFILE_TIC(&timer);
+
   n = work->data->n;
   m = work->data->m;
 
@@ -152,6 +159,16 @@ c_int scale_data(OSQPWorkspace *work) {
   vec_ew_prod(work->scaling->E, work->data->l, work->data->l, work->data->m);
   vec_ew_prod(work->scaling->E, work->data->u, work->data->u, work->data->m);
 
+#ifndef EMBEDDED
+  // Scale the variable bounds lb, ub. The scaled variables are Dinv x.
+  if (work->n_bnd) {
+    vec_ew_prod(work->scaling->Dinv, work->data->lb, work->data->lb, work->data->n);
+    vec_ew_prod(work->scaling->Dinv, work->data->ub, work->data->ub, work->data->n);
+  }
+#endif /* ifndef EMBEDDED */
+
+  PROFILE_TOC(&work->info->profile, PROFILE_SCALING, &timer);
+
   return 0;
 }
 
@@ -171,6 +188,14 @@ c_int unscale_data(OSQPWorkspace *work) {
   vec_ew_prod(work->scaling->Einv, work->data->l, work->data->l, work->data->m);
   vec_ew_prod(work->scaling->Einv, work->data->u, work->data->u, work->data->m);
 
+#ifndef EMBEDDED
+  // Unscale variable bounds
+  if (work->n_bnd) {
+    vec_ew_prod(work->scaling->D, work->data->lb, work->data->lb, work->data->n);
+    vec_ew_prod(work->scaling->D, work->data->ub, work->data->ub, work->data->n);
+  }
+#endif /* ifndef EMBEDDED */
+
   return 0;
 }
 
@@ -188,5 +213,17 @@ c_int unscale_solution(OSQPWorkspace *work) {
               work->data->m);
   vec_mult_scalar(work->solution->y, work->scaling->cinv, work->data->m);
 
+#ifndef EMBEDDED
+  // multipliers of the variable bounds, whose rows are scaled by Dinv
+  if (work->n_bnd) {
+    vec_ew_prod(work->scaling->Dinv,
+                work->solution->y + work->data->m,
+                work->solution->y + work->data->m,
+                work->n_bnd);
+    vec_mult_scalar(work->solution->y + work->data->m, work->scaling->cinv,
+                    work->n_bnd);
+  }
+#endif /* ifndef EMBEDDED */
+
   return 0;
 }
@@ -0,0 +1,93 @@
+#include <stdio.h>
+
+#include "trace.h"
+#include "util.h"
+
+c_int trace_init(OSQPWorkspace *work) {
+  c_int size = work->settings->trace_buffer;
+  OSQPTrace *t;
+
+  if (!size) return 0;
+
+  t = c_calloc(1, sizeof(OSQPTrace));
+  if (!t) return 1;
+  work->trace = t;
+
+  t->size    = size;
+  t->records = c_malloc(size * sizeof(OSQPTraceRecord));
+  if (!(t->records)) return 1;
+
+  return 0;
+}
+
+void trace_iteration(OSQPWorkspace *work, c_int iter) {
+  OSQPTraceRecord record;
+  OSQPTrace *t = work->trace;
+
+  record.iter    = iter;
+  record.obj_val = work->info->obj_val;
+  record.pri_res = work->info->pri_res;
+  record.dua_res = work->info->dua_res;
+  record.rho     = work->settings->rho;
+#ifdef PROFILING
+  record.time    = osqp_toc(work->timer);
+#else /* ifdef PROFILING */
+  record.time    = 0.0;
+#endif /* ifdef PROFILING */
+
+  // Store the record in the ring buffer
+  if (t) {
+    t->records[t->next] = record;
+    t->next = (t->next + 1) % t->size;
+    if (t->count < t->size) t->count++;
+  }
+
+  if (work->settings->trace_callback) {
+    work->settings->trace_callback(&record, work->settings->trace_data);
+  }
+}
+
+c_int trace_dump(const OSQPTrace *trace, const char *filename) {
+  c_int k, ok;
+  c_float values[5];
+  unsigned char sizes[2];
+  const OSQPTraceRecord *r;
+  FILE *f;
+
+  f = fopen(filename, "wb");
+  if (!f) return 1;
+
+  // Header
+  sizes[0] = (unsigned char)sizeof(c_int);
+  sizes[1] = (unsigned char)sizeof(c_float);
+  ok = (fwrite("OSQPTRC1", 1, 8, f) == 8) &&
+       (fwrite(sizes, 1, 2, f) == 2) &&
+       (fwrite(&(trace->count), sizeof(c_int), 1, f) == 1);
+
+  // Records from the oldest to the newest
+  for (k = 0; ok && k < trace->count; k++) {
+    r = &(trace->records[(trace->next - trace->count + k + trace->size) %
+                         trace->size]);
+    values[0] = r->obj_val;
+    values[1] = r->pri_res;
+    values[2] = r->dua_res;
+    values[3] = r->rho;
+    values[4] = r->time;
+    ok = (fwrite(&(r->iter), sizeof(c_int), 1, f) == 1) &&
+         (fwrite(values, sizeof(c_float), 5, f) == 5);
+  }
+
+  if (fclose(f)) ok = 0;
+
+  return !ok;
+}
+
+void trace_free(OSQPWorkspace *work) {
+  OSQPTrace *t = work->trace;
+
+  if (t) {
+    if (t->records) c_free(t->records);
+    c_free(t);
+    work->trace = OSQP_NULL;
+  }
+}
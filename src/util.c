@@ -75,19 +75,44 @@ void print_setup_header(const OSQPWorkspace *work) {
 
   // Print variables and constraints
   c_print("problem:  ");
-  c_print("variables n = %i, constraints m = %i\n          ",
-                                    (int)data->n,
-          (int)data->m);
+  if (work->presolve) {
+    c_print("variables n = %i, constraints m = %i\n          ",
+            (int)work->presolve->n, (int)work->presolve->m);
+    c_print("presolved n = %i, m = %i\n          ",
+            (int)data->n, (int)data->m);
+  } else {
+    c_print("variables n = %i, constraints m = %i\n          ",
+            (int)data->n, (int)data->m);
+  }
   c_print("nnz(P) + nnz(A) = %i\n", (int)nnz);
+  if (work->n_bnd) {
+    c_print("          variable bounds handled outside the KKT matrix\n");
+  }
+  if (work->A_bsr) {
+    c_print("          A stored in %ix%i blocks\n",
+            (int)work->A_bsr->bs, (int)work->A_bsr->bs);
+  }
 
   // Print Settings
   c_print("settings: ");
   c_print("linear system solver = %s",
           LINSYS_SOLVER_NAME[settings->linsys_solver]);
 
+  if (settings->linsys_solver_lib) {
+    c_print(" (%s)", settings->linsys_solver_lib);
+  }
+
   if (work->linsys_solver->nthreads != 1) {
     c_print(" (%d threads)", (int)work->linsys_solver->nthreads);
   }
+
+  if (settings->ordering == USER_ORDERING) {
+    c_print(" (user ordering)");
+  } else {
+    if (work->stages) c_print(" (stage ordering)");
+    if (settings->ordering != AMD_ORDERING)
+      c_print(" (%s ordering)", ORDERING_NAME[settings->ordering]);
+  }
   c_print(",\n          ");
 
   c_print("eps_abs = %.1e, eps_rel = %.1e,\n          ",
@@ -107,6 +132,10 @@ void print_setup_header(const OSQPWorkspace *work) {
       (int)settings->check_termination);
   else c_print("          check_termination: off,\n");
 
+  if (settings->trace_interval) c_print(
+      "          trace: on (interval %i, buffer %i),\n",
+      (int)settings->trace_interval, (int)settings->trace_buffer);
+
 # ifdef PROFILING
   if (settings->time_limit) c_print("          time_limit: %.2e sec,\n",
                                     settings->time_limit);
@@ -121,6 +150,11 @@ void print_setup_header(const OSQPWorkspace *work) {
   if (settings->warm_start) c_print("          warm start: on, ");
   else c_print("          warm start: off, ");
 
+  if (settings->warm_start_cache) c_print("warm start cache: %i, ",
+                                          (int)settings->warm_start_cache);
+
+  if (settings->presolve) c_print("presolve: on, ");
+
   if (settings->polish) c_print("polish: on, ");
   else c_print("polish: off, ");
 
@@ -248,9 +282,20 @@ OSQPSettings* copy_settings(const OSQPSettings *settings) {
   new->eps_dual_inf = settings->eps_dual_inf;
   new->alpha = settings->alpha;
   new->linsys_solver = settings->linsys_solver;
+  new->linsys_solver_lib = settings->linsys_solver_lib;
+  new->stages = settings->stages;
+  new->ordering = settings->ordering;
+  new->perm = settings->perm;
   new->delta = settings->delta;
   new->polish = settings->polish;
   new->polish_refine_iter = settings->polish_refine_iter;
+  new->warm_start_cache = settings->warm_start_cache;
+  new->presolve = settings->presolve;
+  new->var_bounds = settings->var_bounds;
+  new->trace_interval = settings->trace_interval;
+  new->trace_buffer = settings->trace_buffer;
+  new->trace_callback = settings->trace_callback;
+  new->trace_data = settings->trace_data;
   new->verbose = settings->verbose;
   new->scaled_termination = settings->scaled_termination;
   new->check_termination = settings->check_termination;
@@ -313,31 +358,96 @@ c_float osqp_toc(OSQPTimer *t)
 // Linux
 # else  /* ifdef IS_WINDOWS */
 
+/* time between two readings of the monotonic clock */
+static c_float timespec_diff(const struct timespec *tic,
+                             const struct timespec *toc) {
+  struct timespec temp;
+
+  if ((toc->tv_nsec - tic->tv_nsec) < 0) {
+    temp.tv_sec  = toc->tv_sec - tic->tv_sec - 1;
+    temp.tv_nsec = 1e9 + toc->tv_nsec - tic->tv_nsec;
+  } else {
+    temp.tv_sec  = toc->tv_sec - tic->tv_sec;
+    temp.tv_nsec = toc->tv_nsec - tic->tv_nsec;
+  }
+  return (c_float)temp.tv_sec + (c_float)temp.tv_nsec / 1e9;
+}
+
+#  ifdef OSQP_TSC
+#   include <cpuid.h>
+#   include <pthread.h>
+#   include <x86intrin.h>
+
+/* seconds per tick of the time stamp counter, negative if the processor has
+   no invariant time stamp counter. It is set by tsc_calibrate through
+   pthread_once, so timers of several threads calibrate once and read it
+   after the calibration. */
+static double tsc_seconds_per_tick = -1.;
+static pthread_once_t tsc_once = PTHREAD_ONCE_INIT;
+
+/* calibrate the time stamp counter against the monotonic clock */
+static void tsc_calibrate(void) {
+  unsigned int eax, ebx, ecx, edx;
+  struct timespec t0, t1;
+  uint64_t c0, c1;
+
+  // The invariant time stamp counter runs at a constant rate in all power
+  // states and is synchronized across the cores
+  if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) return;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  c0 = __rdtsc();
+  do {
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    c1 = __rdtsc();
+  } while (timespec_diff(&t0, &t1) < TSC_CALIBRATION_TIME);
+
+  tsc_seconds_per_tick = (c1 > c0) ?
+                         (double)timespec_diff(&t0, &t1) / (double)(c1 - c0) : -1.;
+}
+#  endif /* ifdef OSQP_TSC */
+
 /* read current time */
 void osqp_tic(OSQPTimer *t)
 {
+#  ifdef OSQP_TSC
+  pthread_once(&tsc_once, tsc_calibrate);
+  if (tsc_seconds_per_tick > 0.) {
+    t->tsc_tic = __rdtsc();
+    return;
+  }
+#  endif /* ifdef OSQP_TSC */
   clock_gettime(CLOCK_MONOTONIC, &t->tic);
 }
 
 /* return time passed since last call to tic on this timer */
 c_float osqp_toc(OSQPTimer *t)
 {
-  struct timespec temp;
-
-  clock_gettime(CLOCK_MONOTONIC, &t->toc);
-
-  if ((t->toc.tv_nsec - t->tic.tv_nsec) < 0) {
-    temp.tv_sec  = t->toc.tv_sec - t->tic.tv_sec - 1;
-    temp.tv_nsec = 1e9 + t->toc.tv_nsec - t->tic.tv_nsec;
-  } else {
-    temp.tv_sec  = t->toc.tv_sec - t->tic.tv_sec;
-    temp.tv_nsec = t->toc.tv_nsec - t->tic.tv_nsec;
+#  ifdef OSQP_TSC
+  pthread_once(&tsc_once, tsc_calibrate);
+  if (tsc_seconds_per_tick > 0.) {
+    return (c_float)((double)(__rdtsc() - t->tsc_tic) * tsc_seconds_per_tick);
   }
-  return (c_float)temp.tv_sec + (c_float)temp.tv_nsec / 1e9;
+#  endif /* ifdef OSQP_TSC */
+  clock_gettime(CLOCK_MONOTONIC, &t->toc);
+  return timespec_diff(&t->tic, &t->toc);
 }
 
 # endif /* ifdef IS_WINDOWS */
 
+const char *PROFILE_PHASE_NAME[] = {
+  "scaling", "kkt form", "ordering", "factor", "linsys solve", "projection",
+  "residuals", "infeasibility", "rho update", "polish factor",
+  "polish refine"
+};
+
+void osqp_profile_add(OSQPProfile *profile, enum profile_phase phase, c_float time) {
+  if (profile) {
+    profile->time[phase] += time;
+    profile->calls[phase]++;
+  }
+}
+
 #endif // If Profiling end
 
 
@@ -0,0 +1,153 @@
+#include "warm_cache.h"
+#include "lin_alg.h"
+#include "osqp.h"
+
+/**
+ * Hash of the position of an element in the vector (q, l, u, lb, ub). The bits
+ * of the hash give the signs of the element in the random projection.
+ */
+static unsigned int hash_index(c_int i) {
+  unsigned int h = (unsigned int)i * 2654435761u;
+
+  h ^= h >> 16;
+  h *= 0x45d9f3bu;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ * Add the elements of v to the fingerprint key. Infinite bounds do not
+ * contribute.
+ */
+static void add_to_key(c_float *key, const c_float *v, c_int len, c_int offset) {
+  c_int i, j;
+  unsigned int h;
+
+  for (i = 0; i < len; i++) {
+    if (c_absval(v[i]) > OSQP_INFTY * MIN_SCALING) continue;
+    h = hash_index(offset + i);
+    for (j = 0; j < WARM_START_CACHE_DIM; j++) {
+      key[j] += ((h >> j) & 1u) ? v[i] : -v[i];
+    }
+  }
+}
+
+c_int warm_cache_init(OSQPWorkspace *work) {
+  c_int size = work->settings->warm_start_cache;
+  c_int n    = work->data->n;
+  c_int m    = work->data->m + work->n_bnd; // multipliers of the variable bounds
+  OSQPWarmStartCache *c;
+
+  if (!size) return 0;
+
+  c = c_calloc(1, sizeof(OSQPWarmStartCache));
+  if (!c) return 1;
+  work->ws_cache = c;
+
+  c->size = size;
+  c->key  = c_malloc(WARM_START_CACHE_DIM * sizeof(c_float));
+  c->keys = c_malloc(size * WARM_START_CACHE_DIM * sizeof(c_float));
+  c->x    = c_malloc(size * n * sizeof(c_float));
+  c->y    = c_malloc(size * m * sizeof(c_float));
+  c->rho  = c_malloc(size * sizeof(c_float));
+  if (!(c->key) || !(c->keys) || !(c->x) || !(c->rho)) return 1;
+  if (m && !(c->y)) return 1;
+
+  return 0;
+}
+
+c_int warm_cache_lookup(OSQPWorkspace *work) {
+  c_int i, j, best, n, m;
+  c_float dist, best_dist, diff, ratio;
+  OSQPWarmStartCache *c = work->ws_cache;
+
+  n = work->data->n;
+  m = work->data->m;
+
+  // Fingerprint of the current problem vectors
+  vec_set_scalar(c->key, 0., WARM_START_CACHE_DIM);
+  add_to_key(c->key, work->data->q, n, 0);
+  add_to_key(c->key, work->data->l, m, n);
+  add_to_key(c->key, work->data->u, m, n + m);
+  if (work->n_bnd) {
+    add_to_key(c->key, work->data->lb, n, n + 2 * m);
+    add_to_key(c->key, work->data->ub, n, 2 * n + 2 * m);
+  }
+
+  // Size of the stored dual solutions
+  m += work->n_bnd;
+
+  // Keep the iterates set by the user or the previous solution
+  if (c->skip_lookup || !c->count || !work->settings->warm_start) {
+    c->skip_lookup = 0;
+    return 0;
+  }
+
+  // Nearest stored fingerprint
+  best      = 0;
+  best_dist = OSQP_INFTY;
+  for (i = 0; i < c->count; i++) {
+    dist = 0.;
+    for (j = 0; j < WARM_START_CACHE_DIM; j++) {
+      diff  = c->keys[i * WARM_START_CACHE_DIM + j] - c->key[j];
+      dist += diff * diff;
+    }
+    if (dist < best_dist) {
+      best      = i;
+      best_dist = dist;
+    }
+  }
+
+  // Warm start the iterates. The stored solutions are scaled.
+  prea_vec_copy(c->x + best * n, work->x, n);
+  prea_vec_copy(c->y + best * m, work->y, m);
+  mat_vec(work->data->A, work->x, work->z, 0);
+  prea_vec_copy(work->x, work->z + work->data->m, work->n_bnd);
+
+  // Use the stored rho if it differs enough to justify a new factorization
+  ratio = c->rho[best] / work->settings->rho;
+  if ((ratio > work->settings->adaptive_rho_tolerance) ||
+      (ratio < 1. / work->settings->adaptive_rho_tolerance)) {
+    return osqp_update_rho(work, c->rho[best]);
+  }
+
+  return 0;
+}
+
+void warm_cache_insert(OSQPWorkspace *work) {
+  c_int n, m;
+  OSQPWarmStartCache *c = work->ws_cache;
+
+  n = work->data->n;
+  m = work->data->m + work->n_bnd;
+
+  prea_vec_copy(c->key, c->keys + c->next * WARM_START_CACHE_DIM,
+                WARM_START_CACHE_DIM);
+  prea_vec_copy(work->x, c->x + c->next * n, n);
+  prea_vec_copy(work->y, c->y + c->next * m, m);
+  c->rho[c->next] = work->settings->rho;
+
+  c->next = (c->next + 1) % c->size;
+  if (c->count < c->size) c->count++;
+}
+
+void warm_cache_clear(OSQPWorkspace *work) {
+  if (work->ws_cache) {
+    work->ws_cache->count = 0;
+    work->ws_cache->next  = 0;
+  }
+}
+
+void warm_cache_free(OSQPWorkspace *work) {
+  OSQPWarmStartCache *c = work->ws_cache;
+
+  if (c) {
+    if (c->key)  c_free(c->key);
+    if (c->keys) c_free(c->keys);
+    if (c->x)    c_free(c->x);
+    if (c->y)    c_free(c->y);
+    if (c->rho)  c_free(c->rho);
+    c_free(c);
+    work->ws_cache = OSQP_NULL;
+  }
+}
@@ -1,3 +1,6 @@
+#include <stdio.h>   // Reading the trace dump
+#include <string.h>
+
 #include "osqp.h"    // OSQP API
 #include "auxil.h"   // Needed for cold_start()
 #include "cs.h"      // CSC data structure
@@ -851,6 +854,95 @@ static const char* test_basic_qp_time_limit()
 
   return 0;
 }
+
+static const char* test_basic_qp_profile()
+{
+  c_int exitflag, i;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+  OSQPProfile profile; // Profile of the solver phases
+
+  // Populate data
+  data = generate_problem_basic_qp();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->polish = 1;
+
+  // Setup workspace
+  exitflag = osqp_setup(&work, data, settings);
+
+  // Setup correct
+  mu_assert("Basic QP test profile: Setup error!", exitflag == 0);
+
+  // The setup phases are recorded
+  osqp_get_profile(work, &profile);
+  mu_assert("Basic QP test profile: Error in setup phases!",
+            profile.calls[PROFILE_SCALING] == 1 &&
+            profile.calls[PROFILE_KKT_FORM] == 1 &&
+            profile.calls[PROFILE_ORDERING] == 1 &&
+            profile.calls[PROFILE_FACTOR] == 1 &&
+            profile.calls[PROFILE_LINSYS_SOLVE] == 0);
+
+  // Solve Problem
+  osqp_solve(work);
+
+  // The iteration phases are recorded once per iteration with
+  // PROFILE_ITERATIONS and not recorded otherwise
+  osqp_get_profile(work, &profile);
+#ifdef PROFILE_ITERATIONS
+  mu_assert("Basic QP test profile: Error in iteration phases!",
+            profile.calls[PROFILE_LINSYS_SOLVE] == work->info->iter &&
+            profile.calls[PROFILE_PROJECTION] == work->info->iter);
+#else /* ifdef PROFILE_ITERATIONS */
+  mu_assert("Basic QP test profile: Iteration phases timed!",
+            profile.calls[PROFILE_LINSYS_SOLVE] == 0 &&
+            profile.calls[PROFILE_PROJECTION] == 0);
+#endif /* ifdef PROFILE_ITERATIONS */
+  mu_assert("Basic QP test profile: Error in other phases!",
+            profile.calls[PROFILE_RESIDUALS] >= 1 &&
+            profile.calls[PROFILE_POLISH_FACTOR] == 1 &&
+            profile.calls[PROFILE_POLISH_REFINE] == 1);
+
+  for (i = 0; i < PROFILE_NPHASES; i++) {
+    mu_assert("Basic QP test profile: Negative phase time!",
+              profile.time[i] >= 0.);
+  }
+
+  // The phases are cumulative over the solves
+  osqp_solve(work);
+  osqp_get_profile(work, &profile);
+  mu_assert("Basic QP test profile: Error in cumulative phases!",
+            profile.calls[PROFILE_POLISH_REFINE] == 2);
+#ifdef PROFILE_ITERATIONS
+  mu_assert("Basic QP test profile: Error in cumulative iteration phases!",
+            profile.calls[PROFILE_LINSYS_SOLVE] > work->info->iter);
+#endif /* ifdef PROFILE_ITERATIONS */
+
+  // Reset the profile
+  osqp_reset_profile(work);
+  osqp_get_profile(work, &profile);
+  for (i = 0; i < PROFILE_NPHASES; i++) {
+    mu_assert("Basic QP test profile: Error in reset profile!",
+              profile.calls[i] == 0 && profile.time[i] == 0.);
+  }
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
 #endif // PROFILING
 
 
@@ -918,6 +1010,1173 @@ static const char* test_basic_qp_warm_start()
 }
 
 
+static const char* test_basic_qp_polish_reuse()
+{
+  c_int exitflag;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work, *work_new; // Workspaces
+  OSQPData *data, data_new;       // Data
+  basic_qp_sols_data *sols_data;
+
+  // Cached factorization of the reduced KKT matrix
+  LinSysSolver   *linsys_solver;
+  OSQPFactorStats kkt_stats, stats, stats_reuse;
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->polish = 1;
+  settings->eps_abs = 1e-05;
+  settings->eps_rel = 1e-05;
+  settings->verbose = 1;
+
+  // Setup workspace and solve to factorize the reduced KKT
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test polish reuse: Setup error!", exitflag == 0);
+  osqp_solve(work);
+  mu_assert("Basic QP test polish reuse: Polishing failed!",
+            work->info->status_polish == 1);
+  linsys_solver = work->pol->linsys_solver;
+  osqp_get_factor_stats(work, &kkt_stats, &stats);
+  mu_assert("Basic QP test polish reuse: Reduced KKT matrix not factored!",
+            linsys_solver && (stats.dim > 0));
+
+  // Solve again: the reduced KKT factorization is reused
+  osqp_solve(work);
+  mu_assert("Basic QP test polish reuse: Polishing failed after reuse!",
+            work->info->status_polish == 1);
+  osqp_get_factor_stats(work, &kkt_stats, &stats_reuse);
+  mu_assert("Basic QP test polish reuse: Reduced KKT matrix factored again!",
+            (work->pol->linsys_solver == linsys_solver) &&
+            (work->pol->update_rank == 0) &&
+            (stats_reuse.dim == stats.dim) &&
+            (stats_reuse.nnz_KKT == stats.nnz_KKT) &&
+            (stats_reuse.nnz_L == stats.nnz_L));
+  mu_assert("Basic QP test polish reuse: Error in primal solution!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test polish reuse: Error in dual solution!",
+            vec_norm_inf_diff(work->solution->y, sols_data->y_test,
+                              data->m) < TESTS_TOL);
+
+  // Change the active set and solve with the updated factorization
+  osqp_update_lin_cost(work, sols_data->q_new);
+  osqp_update_bounds(work, sols_data->l_new, sols_data->u_new);
+  osqp_solve(work);
+  osqp_get_factor_stats(work, &kkt_stats, &stats_reuse);
+  mu_assert("Basic QP test polish reuse: Reduced KKT matrix not updated!",
+            (work->pol->linsys_solver == linsys_solver) &&
+            (work->pol->update_rank > 0) &&
+            (stats_reuse.dim == stats.dim) &&
+            (stats_reuse.nnz_L == stats.nnz_L));
+
+  // Solve the same problem from scratch
+  data_new   = *data;
+  data_new.q = sols_data->q_new;
+  data_new.l = sols_data->l_new;
+  data_new.u = sols_data->u_new;
+  exitflag   = osqp_setup(&work_new, &data_new, settings);
+  mu_assert("Basic QP test polish reuse: Setup error!", exitflag == 0);
+  osqp_solve(work_new);
+
+  mu_assert("Basic QP test polish reuse: Error in polish status after update!",
+            work->info->status_polish == work_new->info->status_polish);
+  mu_assert("Basic QP test polish reuse: Error in primal solution after update!",
+            vec_norm_inf_diff(work->solution->x, work_new->solution->x,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test polish reuse: Error in dual solution after update!",
+            vec_norm_inf_diff(work->solution->y, work_new->solution->y,
+                              data->m) < TESTS_TOL);
+
+  // Cleanup solvers
+  osqp_cleanup(work);
+  osqp_cleanup(work_new);
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_basic_qp_warm_start_cache()
+{
+  c_int exitflag, iter;
+
+  // Cold started variables
+  c_float x0[2] = { 0.0, 0.0, };
+  c_float y0[4] = { 0.0, 0.0, 0.0, 0.0, };
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+  basic_qp_sols_data *sols_data;
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->eps_abs           = 1e-05;
+  settings->eps_rel           = 1e-05;
+  settings->adaptive_rho      = 0;
+  settings->check_termination = 1;
+  settings->warm_start_cache  = 2;
+
+  // Setup workspace with wrong settings->warm_start_cache
+  settings->warm_start_cache = -1;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test warm start cache: Setup should result in error due to negative settings->warm_start_cache",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+  settings->warm_start_cache = 2;
+
+  // Setup workspace
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test warm start cache: Setup error!", exitflag == 0);
+
+  // Solve the original problem and cache its solution
+  osqp_solve(work);
+  iter = work->info->iter;
+
+  // Solve a problem with different vectors
+  osqp_update_lin_cost(work, sols_data->q_new);
+  osqp_update_bounds(work, sols_data->l_new, sols_data->u_new);
+  osqp_solve(work);
+
+  // Go back to the original problem: it is warm started from its solution
+  osqp_update_lin_cost(work, data->q);
+  osqp_update_bounds(work, data->l, data->u);
+  osqp_solve(work);
+
+  mu_assert("Basic QP test warm start cache: Error in solver status!",
+            work->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test warm start cache: Cached solution not used!",
+            work->info->iter < iter);
+  mu_assert("Basic QP test warm start cache: Error in primal solution!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test warm start cache: Error in dual solution!",
+            vec_norm_inf_diff(work->solution->y, sols_data->y_test,
+                              data->m) < TESTS_TOL);
+
+  // Iterates set by the user are not replaced by the cached solution
+  osqp_warm_start(work, x0, y0);
+  osqp_solve(work);
+  mu_assert("Basic QP test warm start cache: User warm start not used!",
+            work->info->iter == iter);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+
+/* Records received by the trace callback */
+typedef struct {
+  c_int count;     ///< number of records
+  c_int last_iter; ///< iteration of the last record
+  c_int wrong;     ///< boolean, a record was not at the trace interval
+} basic_qp_trace_data;
+
+static void basic_qp_trace_callback(const OSQPTraceRecord *record, void *data)
+{
+  basic_qp_trace_data *trace_data = (basic_qp_trace_data *)data;
+
+  if ((record->iter % 5 != 0) || (record->iter <= trace_data->last_iter))
+    trace_data->wrong = 1;
+  trace_data->last_iter = record->iter;
+  trace_data->count++;
+}
+
+static const char* test_basic_qp_trace()
+{
+  c_int exitflag, count;
+  c_int header_int[1], record_iter;
+  char magic[8];
+  unsigned char sizes[2];
+  FILE *f;
+  basic_qp_trace_data trace_data = { 0, 0, 0 };
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+
+  // Populate data
+  data = generate_problem_basic_qp();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->adaptive_rho   = 0;
+  settings->trace_interval = 5;
+  settings->trace_buffer   = 3;
+  settings->trace_callback = basic_qp_trace_callback;
+  settings->trace_data     = &trace_data;
+
+  // Setup workspace with wrong settings->trace_interval
+  settings->trace_interval = -1;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test trace: Setup should result in error due to negative settings->trace_interval",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+  settings->trace_interval = 5;
+
+  // Setup workspace
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test trace: Setup error!", exitflag == 0);
+
+  // Solve Problem
+  osqp_solve(work);
+
+  // The callback receives a record every 5 iterations
+  mu_assert("Basic QP test trace: Error in number of records!",
+            trace_data.count == work->info->iter / 5);
+  mu_assert("Basic QP test trace: Error in record iterations!",
+            !trace_data.wrong && trace_data.count >= 3);
+
+  // The recorder keeps the last 3 records
+  mu_assert("Basic QP test trace: Error in number of stored records!",
+            work->trace->count == 3);
+
+  // Dump the records and read back the header and the oldest record
+  exitflag = osqp_dump_trace(work, "basic_qp_trace.bin");
+  mu_assert("Basic QP test trace: Error in dump!", exitflag == 0);
+
+  f = fopen("basic_qp_trace.bin", "rb");
+  mu_assert("Basic QP test trace: Dump file not found!", f != OSQP_NULL);
+  count = (fread(magic, 1, 8, f) == 8) &&
+          (fread(sizes, 1, 2, f) == 2) &&
+          (fread(header_int, sizeof(c_int), 1, f) == 1) &&
+          (fread(&record_iter, sizeof(c_int), 1, f) == 1);
+  fclose(f);
+  remove("basic_qp_trace.bin");
+  mu_assert("Basic QP test trace: Error in dump header!",
+            count && !memcmp(magic, "OSQPTRC1", 8) &&
+            (sizes[0] == sizeof(c_int)) && (sizes[1] == sizeof(c_float)) &&
+            (header_int[0] == 3));
+  mu_assert("Basic QP test trace: Error in oldest record!",
+            record_iter == trace_data.last_iter - 10);
+
+  // Disable the trace
+  count = trace_data.count;
+  osqp_update_trace(work, 0, OSQP_NULL, OSQP_NULL);
+  osqp_solve(work);
+  mu_assert("Basic QP test trace: Trace not disabled!",
+            trace_data.count == count);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_basic_qp_dense()
+{
+  c_int exitflag, i, ptr;
+  c_float *P_dense, *A_dense;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+  OSQPDenseData dense_data;
+  basic_qp_sols_data *sols_data;
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // Dense column-major copies of P and A
+  P_dense = (c_float *)c_calloc(data->n * data->n, sizeof(c_float));
+  A_dense = (c_float *)c_calloc(data->m * data->n, sizeof(c_float));
+  for (i = 0; i < data->n; i++) {
+    for (ptr = data->P->p[i]; ptr < data->P->p[i + 1]; ptr++)
+      P_dense[i * data->n + data->P->i[ptr]] = data->P->x[ptr];
+    for (ptr = data->A->p[i]; ptr < data->A->p[i + 1]; ptr++)
+      A_dense[i * data->m + data->A->i[ptr]] = data->A->x[ptr];
+  }
+  dense_data.n  = data->n;
+  dense_data.m  = data->m;
+  dense_data.P  = P_dense;
+  dense_data.A  = A_dense;
+  dense_data.q  = data->q;
+  dense_data.l  = data->l;
+  dense_data.u  = data->u;
+  dense_data.lb = OSQP_NULL;
+  dense_data.ub = OSQP_NULL;
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->max_iter   = 2000;
+  settings->alpha      = 1.6;
+  settings->polish     = 1;
+  settings->verbose    = 1;
+  settings->warm_start = 0;
+
+  // The linear system solver of the settings is kept
+  exitflag = osqp_setup_dense(&work, &dense_data, settings);
+  mu_assert("Basic QP test dense: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test dense: Linear system solver substituted!",
+            work->settings->linsys_solver == QDLDL_SOLVER);
+  osqp_solve(work);
+  mu_assert("Basic QP test dense: Error in solver status with QDLDL!",
+            work->info->status_val == sols_data->status_test);
+  osqp_cleanup(work);
+
+  // Setup workspace with the dense normal equations solver
+  settings->linsys_solver = NORMAL_SOLVER;
+  exitflag = osqp_setup_dense(&work, &dense_data, settings);
+  mu_assert("Basic QP test dense: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test dense: Dense data not detected!",
+            work->dense_data == 1);
+  mu_assert("Basic QP test dense: Wrong linear system solver!",
+            work->settings->linsys_solver == NORMAL_SOLVER);
+
+  // Solve Problem
+  osqp_solve(work);
+
+  mu_assert("Basic QP test dense: Error in solver status!",
+            work->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test dense: Error in primal solution!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test dense: Error in dual solution!",
+            vec_norm_inf_diff(work->solution->y, sols_data->y_test,
+                              data->m) < TESTS_TOL);
+  mu_assert("Basic QP test dense: Error in objective value!",
+            c_absval(work->info->obj_val - sols_data->obj_value_test) <
+            TESTS_TOL);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(P_dense);
+  c_free(A_dense);
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_basic_qp_stages()
+{
+  c_int exitflag;
+
+  // Stages of the variables and constraints
+  c_int stages[6] = { 0, 1, 0, 0, 1, 1, };
+  c_int stages_wrong[6] = { 0, 1, 0, -1, 1, 1, };
+  c_int stages_sparse[6] = { 0, 5, 0, 0, 5, 5, };
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+  basic_qp_sols_data *sols_data;
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->max_iter   = 2000;
+  settings->alpha      = 1.6;
+  settings->polish     = 1;
+  settings->verbose    = 1;
+  settings->warm_start = 0;
+
+  // Setup workspace with wrong stages
+  settings->stages = stages_wrong;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test stages: Setup should result in error due to negative stage",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+
+  // Setup workspace
+  settings->stages = stages;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test stages: Setup error!", exitflag == 0);
+
+  // Solve Problem
+  osqp_solve(work);
+
+  mu_assert("Basic QP test stages: Error in solver status!",
+            work->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test stages: Error in polish status!",
+            work->info->status_polish == 1);
+  mu_assert("Basic QP test stages: Error in primal solution!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test stages: Error in dual solution!",
+            vec_norm_inf_diff(work->solution->y, sols_data->y_test,
+                              data->m) < TESTS_TOL);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // More stages than rows of the reduced KKT matrix of polish
+  settings->stages = stages_sparse;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test stages: Setup error with sparse stage numbers!",
+            exitflag == 0);
+  osqp_solve(work);
+  mu_assert("Basic QP test stages: Error in polish status with sparse stage numbers!",
+            work->info->status_polish == 1);
+  mu_assert("Basic QP test stages: Error in primal solution with sparse stage numbers!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  osqp_cleanup(work);
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_basic_qp_ordering()
+{
+  c_int exitflag, ord, Lnnz;
+
+  // User ordering of the variables and constraints
+  c_int perm[6]       = { 5, 2, 0, 3, 1, 4, };
+  c_int perm_wrong[6] = { 5, 2, 0, 3, 2, 4, };
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+  basic_qp_sols_data *sols_data;
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->max_iter   = 2000;
+  settings->alpha      = 1.6;
+  settings->polish     = 1;
+  settings->verbose    = 1;
+  settings->warm_start = 0;
+
+  // Setup workspace with a user ordering that is not a permutation
+  settings->ordering = USER_ORDERING;
+  settings->perm     = perm_wrong;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test ordering: Setup should result in error due to repeated index",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+  settings->perm = perm;
+
+  for (ord = AMD_ORDERING; ord <= USER_ORDERING; ord++) {
+    settings->ordering = (enum ordering_type)ord;
+
+    // Setup workspace
+    exitflag = osqp_setup(&work, data, settings);
+    mu_assert("Basic QP test ordering: Setup error!", exitflag == 0);
+
+    // Fill of the factor with the ordering of the workspace
+    Lnnz = osqp_kkt_fill(work, settings->ordering);
+    mu_assert("Basic QP test ordering: Error in the fill of the factor!",
+              Lnnz >= work->data->A->p[data->n]);
+    mu_assert("Basic QP test ordering: The user ordering needs a user permutation!",
+              (ord == USER_ORDERING) || (osqp_kkt_fill(work, USER_ORDERING) < 0));
+
+    // Solve Problem
+    osqp_solve(work);
+
+    mu_assert("Basic QP test ordering: Error in solver status!",
+              work->info->status_val == sols_data->status_test);
+    mu_assert("Basic QP test ordering: Error in polish status!",
+              work->info->status_polish == 1);
+    mu_assert("Basic QP test ordering: Error in primal solution!",
+              vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                                data->n) < TESTS_TOL);
+    mu_assert("Basic QP test ordering: Error in dual solution!",
+              vec_norm_inf_diff(work->solution->y, sols_data->y_test,
+                                data->m) < TESTS_TOL);
+
+    // Cleanup solver
+    osqp_cleanup(work);
+  }
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+static const char* test_basic_qp_factor_stats()
+{
+  c_int exitflag;
+  OSQPFactorStats kkt_stats, polish_stats;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+
+  // Populate data
+  data = generate_problem_basic_qp();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->max_iter   = 2000;
+  settings->alpha      = 1.6;
+  settings->polish     = 1;
+  settings->verbose    = 1;
+  settings->warm_start = 0;
+
+  // Setup workspace
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test factor stats: Setup error!", exitflag == 0);
+
+  // Statistics of the KKT factorization before polishing
+  exitflag = osqp_get_factor_stats(work, &kkt_stats, &polish_stats);
+  mu_assert("Basic QP test factor stats: Error in the statistics!", exitflag == 0);
+  mu_assert("Basic QP test factor stats: Error in the KKT dimension!",
+            kkt_stats.dim == work->data->n + work->data->m);
+  mu_assert("Basic QP test factor stats: Error in the nonzeros of L!",
+            kkt_stats.nnz_L == osqp_kkt_fill(work, settings->ordering));
+  mu_assert("Basic QP test factor stats: Error in the fill ratio!",
+            kkt_stats.fill >= 1.);
+  mu_assert("Basic QP test factor stats: Error in the elimination tree height!",
+            kkt_stats.etree_height >= 1 && kkt_stats.etree_height <= kkt_stats.dim);
+  mu_assert("Basic QP test factor stats: Polish factorization should not exist!",
+            polish_stats.dim == 0);
+
+  // Solve Problem
+  osqp_solve(work);
+  mu_assert("Basic QP test factor stats: Error in polish status!",
+            work->info->status_polish == 1);
+
+  // Statistics of the polish factorization
+  exitflag = osqp_get_factor_stats(work, &kkt_stats, &polish_stats);
+  mu_assert("Basic QP test factor stats: Error in the statistics!", exitflag == 0);
+  mu_assert("Basic QP test factor stats: Error in the polish KKT dimension!",
+            polish_stats.dim >= work->data->n &&
+            polish_stats.dim <= kkt_stats.dim);
+  mu_assert("Basic QP test factor stats: Error in the polish fill ratio!",
+            polish_stats.fill >= 1.);
+  mu_assert("Basic QP test factor stats: Error in the polish flops!",
+            polish_stats.flops >= 0. && polish_stats.etree_height >= 1);
+
+  // Cleanup
+  osqp_cleanup(work);
+  clean_problem_basic_qp(data);
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_basic_qp_decomposed()
+{
+  c_int exitflag, i, j, ptr, b;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPDecomposition *decomp; // Decomposition
+  OSQPData *data;            // Data
+  OSQPData data2;            // Two independent copies of the problem
+  basic_qp_sols_data *sols_data;
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // Block diagonal P and A with two copies of the problem
+  data2.n = 2 * data->n;
+  data2.m = 2 * data->m;
+  data2.P = csc_spalloc(data2.n, data2.n, 2 * data->P->p[data->n], 1, 0);
+  data2.A = csc_spalloc(data2.m, data2.n, 2 * data->A->p[data->n], 1, 0);
+  data2.q = (c_float *)c_malloc(data2.n * sizeof(c_float));
+  data2.l = (c_float *)c_malloc(data2.m * sizeof(c_float));
+  data2.u = (c_float *)c_malloc(data2.m * sizeof(c_float));
+  data2.P->p[0] = 0;
+  data2.A->p[0] = 0;
+  for (b = 0; b < 2; b++) {
+    for (j = 0; j < data->n; j++) {
+      data2.P->p[b * data->n + j + 1] = data2.P->p[b * data->n + j] +
+                                        data->P->p[j + 1] - data->P->p[j];
+      data2.A->p[b * data->n + j + 1] = data2.A->p[b * data->n + j] +
+                                        data->A->p[j + 1] - data->A->p[j];
+      for (ptr = data->P->p[j]; ptr < data->P->p[j + 1]; ptr++) {
+        i = data2.P->p[b * data->n + j] + ptr - data->P->p[j];
+        data2.P->i[i] = b * data->n + data->P->i[ptr];
+        data2.P->x[i] = data->P->x[ptr];
+      }
+      for (ptr = data->A->p[j]; ptr < data->A->p[j + 1]; ptr++) {
+        i = data2.A->p[b * data->n + j] + ptr - data->A->p[j];
+        data2.A->i[i] = b * data->m + data->A->i[ptr];
+        data2.A->x[i] = data->A->x[ptr];
+      }
+      data2.q[b * data->n + j] = data->q[j];
+    }
+    for (i = 0; i < data->m; i++) {
+      data2.l[b * data->m + i] = data->l[i];
+      data2.u[b * data->m + i] = data->u[i];
+    }
+  }
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->max_iter   = 2000;
+  settings->alpha      = 1.6;
+  settings->polish     = 1;
+  settings->verbose    = 1;
+  settings->warm_start = 0;
+
+  // Setup decomposition
+  exitflag = osqp_setup_decomposed(&decomp, &data2, settings);
+  mu_assert("Basic QP test decomposed: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test decomposed: Wrong number of subproblems!",
+            decomp->ncomp == 2);
+
+  // Solve Problem
+  exitflag = osqp_solve_decomposed(decomp);
+  mu_assert("Basic QP test decomposed: Solve error!", exitflag == 0);
+
+  mu_assert("Basic QP test decomposed: Error in solver status!",
+            decomp->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test decomposed: Error in polish status!",
+            decomp->info->status_polish == 1);
+  for (b = 0; b < 2; b++) {
+    mu_assert("Basic QP test decomposed: Error in primal solution!",
+              vec_norm_inf_diff(decomp->solution->x + b * data->n,
+                                sols_data->x_test, data->n) < TESTS_TOL);
+    mu_assert("Basic QP test decomposed: Error in dual solution!",
+              vec_norm_inf_diff(decomp->solution->y + b * data->m,
+                                sols_data->y_test, data->m) < TESTS_TOL);
+  }
+  mu_assert("Basic QP test decomposed: Error in objective value!",
+            c_absval(decomp->info->obj_val - 2 * sols_data->obj_value_test) <
+            TESTS_TOL);
+
+  // Cleanup solver
+  osqp_cleanup_decomposed(decomp);
+
+  // Cleanup data
+  csc_spfree(data2.P);
+  csc_spfree(data2.A);
+  c_free(data2.q);
+  c_free(data2.l);
+  c_free(data2.u);
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_basic_qp_presolve()
+{
+  c_int exitflag;
+  c_float x[2], y[4], obj_val;
+
+  // Constraints x1 + x2 = 1, 1 <= 2 x1 + 2 x2 <= 3 and -1 <= -x1 - x2 <= -0.9,
+  // which are all parallel, and bounds 0 <= x <= 0.7
+  c_float A_x[6] = { 1.0, 2.0, -1.0, 1.0, 2.0, -1.0 };
+  c_int   A_i[6] = { 0, 1, 2, 0, 1, 2 };
+  c_int   A_p[3] = { 0, 3, 6 };
+  c_float l[3]   = { 1.0, 1.0, -1.0 };
+  c_float u[3]   = { 1.0, 3.0, -0.9 };
+  c_float lb[2]  = { 0.0, 0.0 };
+  c_float ub[2]  = { 0.7, 0.7 };
+  c_float y_par[3] = { -2.9, 0.0, 0.0 };
+  c_float y_bnd[2] = { 0.0, 0.2 };
+  OSQPData *data_par; // Data with parallel constraints
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+  basic_qp_sols_data *sols_data;
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->max_iter   = 2000;
+  settings->alpha      = 1.6;
+  settings->polish     = 1;
+  settings->verbose    = 1;
+  settings->warm_start = 0;
+  settings->presolve   = 1;
+
+  // Setup workspace. The singleton constraints are merged into the bounds of
+  // the variables and the free constraint is removed.
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test presolve: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test presolve: Wrong presolved problem!",
+            (work->data->n == 2) && (work->data->m == 1) && (work->n_bnd == 2));
+
+  // Solve Problem
+  osqp_solve(work);
+
+  mu_assert("Basic QP test presolve: Error in solver status!",
+            work->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test presolve: Error in primal solution!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test presolve: Error in dual solution!",
+            vec_norm_inf_diff(work->solution->y, sols_data->y_test,
+                              data->m) < TESTS_TOL);
+  mu_assert("Basic QP test presolve: Error in objective value!",
+            c_absval(work->info->obj_val - sols_data->obj_value_test) <
+            TESTS_TOL);
+
+  // Bounds that change the removed constraints require a new setup
+  exitflag = osqp_update_bounds(work, sols_data->l_new, sols_data->u_new);
+  mu_assert("Basic QP test presolve: Update bounds should result in error!",
+            exitflag == 1);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // Fix the first variable
+  data->l[1] = 0.4;
+  data->u[1] = 0.4;
+
+  // Solve without presolve
+  settings->presolve = 0;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test presolve: Setup error!", exitflag == 0);
+  osqp_solve(work);
+  prea_vec_copy(work->solution->x, x, data->n);
+  prea_vec_copy(work->solution->y, y, data->m);
+  obj_val = work->info->obj_val;
+  osqp_cleanup(work);
+
+  // Solve with presolve
+  settings->presolve = 1;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test presolve: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test presolve: Wrong presolved problem!",
+            (work->data->n == 1) && (work->data->m == 1) && (work->n_bnd == 1));
+  osqp_solve(work);
+
+  mu_assert("Basic QP test presolve: Error in solver status!",
+            work->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test presolve: Error in primal solution with fixed variable!",
+            vec_norm_inf_diff(work->solution->x, x, data->n) < TESTS_TOL);
+  mu_assert("Basic QP test presolve: Error in dual solution with fixed variable!",
+            vec_norm_inf_diff(work->solution->y, y, data->m) < TESTS_TOL);
+  mu_assert("Basic QP test presolve: Error in objective value with fixed variable!",
+            c_absval(work->info->obj_val - obj_val) < TESTS_TOL);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // Parallel constraints
+  data_par     = (OSQPData *)c_calloc(1, sizeof(OSQPData));
+  data_par->n  = data->n;
+  data_par->m  = 3;
+  data_par->P  = data->P;
+  data_par->q  = data->q;
+  data_par->A  = csc_matrix(3, data->n, 6, A_x, A_i, A_p);
+  data_par->l  = l;
+  data_par->u  = u;
+  data_par->lb = lb;
+  data_par->ub = ub;
+
+  // Setup workspace. The parallel constraints are merged into the first one.
+  settings->var_bounds = 1;
+  exitflag = osqp_setup(&work, data_par, settings);
+  mu_assert("Basic QP test presolve: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test presolve: Parallel constraints not merged!",
+            (work->data->n == 2) && (work->data->m == 1));
+
+  // Solve Problem
+  osqp_solve(work);
+
+  // The solution is the one of the basic QP
+  mu_assert("Basic QP test presolve: Error in solver status!",
+            work->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test presolve: Error in primal solution with parallel constraints!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data_par->n) < TESTS_TOL);
+  mu_assert("Basic QP test presolve: Error in dual solution with parallel constraints!",
+            vec_norm_inf_diff(work->solution->y, y_par, data_par->m) < TESTS_TOL);
+  mu_assert("Basic QP test presolve: Error in bound multipliers with parallel constraints!",
+            vec_norm_inf_diff(work->solution->y_bnd, y_bnd, data_par->n) < TESTS_TOL);
+  mu_assert("Basic QP test presolve: Error in objective value with parallel constraints!",
+            c_absval(work->info->obj_val - sols_data->obj_value_test) <
+            TESTS_TOL);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+  c_free(data_par->A);
+  c_free(data_par);
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_basic_qp_var_bounds()
+{
+  c_int exitflag;
+  c_float lb[2]     = { 0.0, 0.0 };
+  c_float ub[2]     = { 0.7, 0.7 };
+  c_float ub_new[2] = { 0.7, 0.6 };
+  c_float x_new[2]  = { 0.4, 0.6 };
+
+  // Equality constraint x1 + x2 = 1 of the basic QP
+  c_float A_x[2] = { 1.0, 1.0 };
+  c_int   A_i[2] = { 0, 0 };
+  c_int   A_p[3] = { 0, 1, 2 };
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+  OSQPData *data_bnd;  // Data with variable bounds
+  basic_qp_sols_data *sols_data;
+  LinSysSolver *linsys_solver;            // Solver before the rho update
+  OSQPFactorStats stats, stats_rho;       // Factorization before and after
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // The singleton constraints of the basic QP become variable bounds and the
+  // free constraint is dropped
+  data_bnd     = (OSQPData *)c_calloc(1, sizeof(OSQPData));
+  data_bnd->n  = data->n;
+  data_bnd->m  = 1;
+  data_bnd->P  = data->P;
+  data_bnd->q  = data->q;
+  data_bnd->A  = csc_matrix(1, data->n, 2, A_x, A_i, A_p);
+  data_bnd->l  = data->l;
+  data_bnd->u  = data->u;
+  data_bnd->lb = lb;
+  data_bnd->ub = ub;
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->max_iter   = 2000;
+  settings->alpha      = 1.6;
+  settings->polish     = 1;
+  settings->verbose    = 1;
+  settings->warm_start = 0;
+
+  // The variable bounds are ignored without the var_bounds setting
+  exitflag = osqp_setup(&work, data_bnd, settings);
+  mu_assert("Basic QP test var bounds: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test var bounds: Variable bounds not ignored!",
+            work->n_bnd == 0);
+  osqp_cleanup(work);
+
+  // Setup workspace. The variable bounds are not rows of the KKT matrix.
+  settings->var_bounds = 1;
+  exitflag = osqp_setup(&work, data_bnd, settings);
+  mu_assert("Basic QP test var bounds: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test var bounds: Wrong number of variable bounds!",
+            work->n_bnd == data->n);
+
+  // Solve Problem
+  osqp_solve(work);
+
+  mu_assert("Basic QP test var bounds: Error in solver status!",
+            work->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test var bounds: Error in polish status!",
+            work->info->status_polish == 1);
+  mu_assert("Basic QP test var bounds: Error in primal solution!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test var bounds: Error in dual solution!",
+            c_absval(work->solution->y[0] - sols_data->y_test[0]) < TESTS_TOL);
+  mu_assert("Basic QP test var bounds: Error in multipliers of the variable bounds!",
+            vec_norm_inf_diff(work->solution->y_bnd, sols_data->y_test + 1,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test var bounds: Error in objective value!",
+            c_absval(work->info->obj_val - sols_data->obj_value_test) <
+            TESTS_TOL);
+
+  // Update the variable bounds
+  exitflag = osqp_update_var_bounds(work, lb, ub_new);
+  mu_assert("Basic QP test var bounds: Error in bounds update!", exitflag == 0);
+  osqp_solve(work);
+  mu_assert("Basic QP test var bounds: Error in primal solution after update!",
+            vec_norm_inf_diff(work->solution->x, x_new, data->n) < TESTS_TOL);
+
+  // Changing rho factorizes the KKT matrix with the new ADMM step of the
+  // bounds. The solver and its ordering are kept.
+  linsys_solver = work->linsys_solver;
+  osqp_get_factor_stats(work, &stats, OSQP_NULL);
+  exitflag = osqp_update_rho(work, 0.7);
+  mu_assert("Basic QP test var bounds: Error in rho update!", exitflag == 0);
+  osqp_get_factor_stats(work, &stats_rho, OSQP_NULL);
+  mu_assert("Basic QP test var bounds: Linear system solver set up again!",
+            work->linsys_solver == linsys_solver &&
+            stats_rho.nnz_KKT == stats.nnz_KKT &&
+            stats_rho.nnz_L == stats.nnz_L);
+  osqp_solve(work);
+  mu_assert("Basic QP test var bounds: Error in primal solution after rho update!",
+            vec_norm_inf_diff(work->solution->x, x_new, data->n) < TESTS_TOL);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // Presolve merges the singleton constraints into the variable bounds
+  settings->presolve = 1;
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Basic QP test var bounds: Setup error!", exitflag == 0);
+  mu_assert("Basic QP test var bounds: Wrong presolved problem!",
+            (work->data->m == 1) && (work->n_bnd == data->n));
+
+  // The problem has no variable bounds
+  exitflag = osqp_update_var_bounds(work, lb, ub_new);
+  mu_assert("Basic QP test var bounds: Update bounds should result in error!",
+            exitflag == 1);
+
+  osqp_solve(work);
+  mu_assert("Basic QP test var bounds: Error in primal solution with presolve!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  mu_assert("Basic QP test var bounds: Error in dual solution with presolve!",
+            vec_norm_inf_diff(work->solution->y, sols_data->y_test,
+                              data->m) < TESTS_TOL);
+
+  // Cleanup solver
+  osqp_cleanup(work);
+
+  // Cleanup data
+  c_free(data_bnd->A);
+  c_free(data_bnd);
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_basic_qp_problem_io()
+{
+  c_int exitflag, same, len, p_bad;
+  char  buf[4096];
+  FILE *f;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+  OSQPSettings *settings_read;
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+  OSQPData *data_read; // Data read from the files
+  basic_qp_sols_data *sols_data;
+
+  // Objective constant and sense, written and read back
+  OSQPObjective objective, objective_read;
+
+  // Populate data
+  data = generate_problem_basic_qp();
+  sols_data = generate_problem_basic_qp_sols_data();
+
+  // Define Solver settings as default
+  osqp_set_default_settings(settings);
+  settings->max_iter = 2000;
+  settings->alpha    = 1.6;
+  settings->polish   = 1;
+  settings->verbose  = 0;
+
+  objective.constant = 2.5;
+  objective.maximize = 1;
+
+  // The binary file keeps the data, settings and objective bit for bit
+  exitflag = osqp_write_problem("basic_qp_problem.bin", data, settings, &objective);
+  mu_assert("Basic QP test problem io: Error in writing the binary file!",
+            exitflag == 0);
+  exitflag = osqp_read_problem("basic_qp_problem.bin", &data_read, &settings_read,
+                               &objective_read);
+  mu_assert("Basic QP test problem io: Error in reading the binary file!",
+            exitflag == 0);
+  mu_assert("Basic QP test problem io: Wrong dimensions in the binary file!",
+            (data_read->n == data->n) && (data_read->m == data->m) &&
+            (data_read->P->p[data->n] == data->P->p[data->n]) &&
+            (data_read->A->p[data->n] == data->A->p[data->n]));
+  same = !memcmp(data_read->P->x, data->P->x, data->P->p[data->n] * sizeof(c_float)) &&
+         !memcmp(data_read->A->i, data->A->i, data->A->p[data->n] * sizeof(c_int)) &&
+         !memcmp(data_read->A->x, data->A->x, data->A->p[data->n] * sizeof(c_float)) &&
+         !memcmp(data_read->q, data->q, data->n * sizeof(c_float)) &&
+         !memcmp(data_read->l, data->l, data->m * sizeof(c_float)) &&
+         !memcmp(data_read->u, data->u, data->m * sizeof(c_float));
+  mu_assert("Basic QP test problem io: Wrong data in the binary file!", same);
+  mu_assert("Basic QP test problem io: Wrong settings in the binary file!",
+            settings_read &&
+            (settings_read->max_iter == settings->max_iter) &&
+            (settings_read->alpha == settings->alpha) &&
+            (settings_read->rho == settings->rho) &&
+            (settings_read->verbose == 0));
+  mu_assert("Basic QP test problem io: Wrong objective in the binary file!",
+            (objective_read.constant == objective.constant) &&
+            (objective_read.maximize == objective.maximize));
+  osqp_free_problem(data_read, settings_read);
+
+  // Truncated and corrupted binary files are rejected
+  f = fopen("basic_qp_problem.bin", "rb");
+  mu_assert("Basic QP test problem io: Error in opening the binary file!", f);
+  len = (c_int)fread(buf, 1, sizeof(buf), f);
+  fclose(f);
+
+  f = fopen("basic_qp_problem_bad.bin", "wb");
+  fwrite(buf, 1, (size_t)(len / 2), f);
+  fclose(f);
+  exitflag = osqp_read_problem("basic_qp_problem_bad.bin", &data_read, &settings_read,
+                               OSQP_NULL);
+  mu_assert("Basic QP test problem io: Reading a truncated file should result in error!",
+            exitflag == 1);
+
+  // Second column pointer of P past its number of elements: the header (12
+  // bytes) and the dimensions are followed by the column pointers of P
+  p_bad = data->P->p[data->n] + 2;
+  memcpy(buf + 12 + 5 * sizeof(c_int), &p_bad, sizeof(c_int));
+  f = fopen("basic_qp_problem_bad.bin", "wb");
+  fwrite(buf, 1, (size_t)len, f);
+  fclose(f);
+  exitflag = osqp_read_problem("basic_qp_problem_bad.bin", &data_read, OSQP_NULL,
+                               OSQP_NULL);
+  mu_assert("Basic QP test problem io: Reading a corrupted column pointer should result in error!",
+            exitflag == 1);
+
+  // Number of elements of P larger than the file
+  p_bad = (c_int)1 << 30;
+  memcpy(buf + 12 + 2 * sizeof(c_int), &p_bad, sizeof(c_int));
+  f = fopen("basic_qp_problem_bad.bin", "wb");
+  fwrite(buf, 1, (size_t)len, f);
+  fclose(f);
+  exitflag = osqp_read_problem("basic_qp_problem_bad.bin", &data_read, OSQP_NULL,
+                               OSQP_NULL);
+  mu_assert("Basic QP test problem io: Reading a corrupted number of elements should result in error!",
+            exitflag == 1);
+  remove("basic_qp_problem_bad.bin");
+
+  // The QPS file keeps the data and the objective, written as a
+  // maximization with the right-hand side of the objective row
+  exitflag = osqp_write_qps("basic_qp_problem.qps", data, &objective);
+  mu_assert("Basic QP test problem io: Error in writing the QPS file!",
+            exitflag == 0);
+  exitflag = osqp_read_qps("basic_qp_problem.qps", &data_read, &objective_read);
+  mu_assert("Basic QP test problem io: Error in reading the QPS file!",
+            exitflag == 0);
+  mu_assert("Basic QP test problem io: Wrong dimensions in the QPS file!",
+            (data_read->n == data->n) && (data_read->m == data->m) &&
+            !data_read->lb && !data_read->ub);
+  mu_assert("Basic QP test problem io: Wrong data in the QPS file!",
+            is_eq_csc(data_read->P, data->P, TESTS_TOL) &&
+            is_eq_csc(data_read->A, data->A, TESTS_TOL) &&
+            (vec_norm_inf_diff(data_read->q, data->q, data->n) < TESTS_TOL) &&
+            (vec_norm_inf_diff(data_read->l, data->l, data->m) < TESTS_TOL) &&
+            (vec_norm_inf_diff(data_read->u, data->u, data->m) < TESTS_TOL));
+  mu_assert("Basic QP test problem io: Wrong objective in the QPS file!",
+            (objective_read.constant == objective.constant) &&
+            (objective_read.maximize == objective.maximize));
+
+  // Solve the problem read back
+  exitflag = osqp_setup(&work, data_read, settings);
+  mu_assert("Basic QP test problem io: Setup error!", exitflag == 0);
+  osqp_solve(work);
+  mu_assert("Basic QP test problem io: Error in solver status!",
+            work->info->status_val == sols_data->status_test);
+  mu_assert("Basic QP test problem io: Error in primal solution!",
+            vec_norm_inf_diff(work->solution->x, sols_data->x_test,
+                              data->n) < TESTS_TOL);
+  osqp_cleanup(work);
+  osqp_free_problem(data_read, OSQP_NULL);
+
+  // Neither file is the other's format
+  exitflag = osqp_read_problem("basic_qp_problem.qps", &data_read, OSQP_NULL,
+                               OSQP_NULL);
+  mu_assert("Basic QP test problem io: Reading a QPS file as binary should result in error!",
+            exitflag == 1);
+
+  remove("basic_qp_problem.bin");
+  remove("basic_qp_problem.qps");
+
+  // Cleanup data
+  clean_problem_basic_qp(data);
+  clean_problem_basic_qp_sols_data(sols_data);
+
+  // Cleanup
+  c_free(settings);
+
+  return 0;
+}
+
+
 static const char* test_basic_qp()
 {
   mu_run_test(test_basic_qp_solve);
@@ -929,8 +2188,20 @@ static const char* test_basic_qp()
   mu_run_test(test_basic_qp_update_rho);
 #ifdef PROFILING
   mu_run_test(test_basic_qp_time_limit);
+  mu_run_test(test_basic_qp_profile);
 #endif
   mu_run_test(test_basic_qp_warm_start);
+  mu_run_test(test_basic_qp_polish_reuse);
+  mu_run_test(test_basic_qp_warm_start_cache);
+  mu_run_test(test_basic_qp_trace);
+  mu_run_test(test_basic_qp_dense);
+  mu_run_test(test_basic_qp_stages);
+  mu_run_test(test_basic_qp_ordering);
+  mu_run_test(test_basic_qp_factor_stats);
+  mu_run_test(test_basic_qp_decomposed);
+  mu_run_test(test_basic_qp_presolve);
+  mu_run_test(test_basic_qp_var_bounds);
+  mu_run_test(test_basic_qp_problem_io);
 
   return 0;
 }
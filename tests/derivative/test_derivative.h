@@ -0,0 +1,173 @@
+#include "osqp.h"    // OSQP API
+#include "util.h"    // Utilities for testing
+#include "minunit.h" // Basic testing script header
+
+/* Problem
+ *    minimize    1/2 x' P x + q' x
+ *    subject to  l <= A x <= u
+ * with an active equality constraint, a lower-active constraint and two
+ * inactive constraints at the solution.
+ */
+#define DERIVATIVE_N (3)
+#define DERIVATIVE_M (4)
+#define DERIVATIVE_NRHS (2)
+#define DERIVATIVE_H (1e-05) // Finite differences step
+
+static c_float derivative_P_x[4] = { 2.0, 0.5, 1.0, 1.0, };
+static c_int   derivative_P_i[4] = { 0, 0, 1, 2, };
+static c_int   derivative_P_p[4] = { 0, 1, 3, 4, };
+static c_float derivative_A_x[7] = { 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, };
+static c_int   derivative_A_i[7] = { 0, 1, 0, 2, 3, 0, 3, };
+static c_int   derivative_A_p[4] = { 0, 2, 5, 7, };
+static c_float derivative_q[3]   = { -2.0, 1.0, -1.0, };
+static c_float derivative_l[4]   = { 1.0, -1.0, 0.1, -5.0, };
+static c_float derivative_u[4]   = { 1.0, 1.0, 2.0, 5.0, };
+
+// Gradients of the loss dx'x + dy'y stored column-wise
+static c_float derivative_dx[6]  = { 1.0, -2.0, 0.5, 0.0, 1.0, 0.0, };
+static c_float derivative_dy[8]  = { 0.0, 0.0, 0.0, 0.0, 0.3, -1.0, 2.0, 0.5, };
+
+/**
+ * Solve the problem and evaluate the losses dx'x + dy'y for all columns
+ */
+static c_int derivative_loss(OSQPWorkspace *work, c_float *loss) {
+  c_int i;
+
+  osqp_solve(work);
+  if (work->info->status_val != OSQP_SOLVED) return 1;
+
+  for (i = 0; i < DERIVATIVE_NRHS; i++) {
+    loss[i] = vec_prod(derivative_dx + i * DERIVATIVE_N, work->solution->x, DERIVATIVE_N) +
+              vec_prod(derivative_dy + i * DERIVATIVE_M, work->solution->y, DERIVATIVE_M);
+  }
+  return 0;
+}
+
+static const char* test_derivative_finite_differences()
+{
+  c_int exitflag, i, j;
+  c_float q[DERIVATIVE_N], l[DERIVATIVE_M], u[DERIVATIVE_M];
+  c_float dq[DERIVATIVE_N * DERIVATIVE_NRHS];
+  c_float dl[DERIVATIVE_M * DERIVATIVE_NRHS], du[DERIVATIVE_M * DERIVATIVE_NRHS];
+  c_float loss_p[DERIVATIVE_NRHS], loss_m[DERIVATIVE_NRHS], fd, grad;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+
+  // Populate data
+  data = (OSQPData *)c_calloc(1, sizeof(OSQPData));
+  data->n = DERIVATIVE_N;
+  data->m = DERIVATIVE_M;
+  data->P = csc_matrix(data->n, data->n, 4, derivative_P_x, derivative_P_i, derivative_P_p);
+  data->q = derivative_q;
+  data->A = csc_matrix(data->m, data->n, 7, derivative_A_x, derivative_A_i, derivative_A_p);
+  data->l = derivative_l;
+  data->u = derivative_u;
+
+  // Define solver settings
+  osqp_set_default_settings(settings);
+  settings->polish  = 1;
+  settings->eps_abs = 1e-09;
+  settings->eps_rel = 1e-09;
+  settings->verbose = 0;
+
+  // Setup workspace
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Derivative test: Setup error!", exitflag == 0);
+
+  // Derivatives are not available before solving
+  mu_assert("Derivative test: Missing solution not caught!",
+            osqp_adjoint_derivative(work, DERIVATIVE_NRHS, derivative_dx,
+                                    derivative_dy, dq, dl, du) != 0);
+
+  // Solve and compute derivatives for all the gradients at once
+  osqp_solve(work);
+  mu_assert("Derivative test: Error in solver status!",
+            work->info->status_val == OSQP_SOLVED);
+  exitflag = osqp_adjoint_derivative(work, DERIVATIVE_NRHS, derivative_dx,
+                                     derivative_dy, dq, dl, du);
+  mu_assert("Derivative test: Error in computing derivatives!", exitflag == 0);
+
+  // Compare with central finite differences on q
+  for (j = 0; j < DERIVATIVE_N; j++) {
+    prea_vec_copy(derivative_q, q, DERIVATIVE_N);
+    q[j] += DERIVATIVE_H;
+    osqp_update_lin_cost(work, q);
+    mu_assert("Derivative test: Solve error!", derivative_loss(work, loss_p) == 0);
+    q[j] -= 2 * DERIVATIVE_H;
+    osqp_update_lin_cost(work, q);
+    mu_assert("Derivative test: Solve error!", derivative_loss(work, loss_m) == 0);
+
+    for (i = 0; i < DERIVATIVE_NRHS; i++) {
+      fd = (loss_p[i] - loss_m[i]) / (2 * DERIVATIVE_H);
+      mu_assert("Derivative test: Error in derivative with respect to q!",
+                c_absval(fd - dq[i * DERIVATIVE_N + j]) < TESTS_TOL);
+    }
+  }
+  osqp_update_lin_cost(work, derivative_q);
+
+  // Compare with central finite differences on l and u. Equality
+  // constraints are perturbed on both sides.
+  for (j = 0; j < DERIVATIVE_M; j++) {
+    prea_vec_copy(derivative_l, l, DERIVATIVE_M);
+    prea_vec_copy(derivative_u, u, DERIVATIVE_M);
+    if (l[j] == u[j]) {
+      l[j] += DERIVATIVE_H;
+      u[j] += DERIVATIVE_H;
+    } else {
+      l[j] += DERIVATIVE_H;
+    }
+    osqp_update_bounds(work, l, u);
+    mu_assert("Derivative test: Solve error!", derivative_loss(work, loss_p) == 0);
+    if (l[j] == u[j]) u[j] -= 2 * DERIVATIVE_H;
+    l[j] -= 2 * DERIVATIVE_H;
+    osqp_update_bounds(work, l, u);
+    mu_assert("Derivative test: Solve error!", derivative_loss(work, loss_m) == 0);
+
+    for (i = 0; i < DERIVATIVE_NRHS; i++) {
+      fd   = (loss_p[i] - loss_m[i]) / (2 * DERIVATIVE_H);
+      grad = dl[i * DERIVATIVE_M + j];
+      if (derivative_l[j] == derivative_u[j]) grad += du[i * DERIVATIVE_M + j];
+      mu_assert("Derivative test: Error in derivative with respect to l!",
+                c_absval(fd - grad) < TESTS_TOL);
+    }
+
+    // Upper bound of inequality constraints
+    if (derivative_l[j] != derivative_u[j]) {
+      prea_vec_copy(derivative_l, l, DERIVATIVE_M);
+      u[j] = derivative_u[j] + DERIVATIVE_H;
+      osqp_update_bounds(work, l, u);
+      mu_assert("Derivative test: Solve error!", derivative_loss(work, loss_p) == 0);
+      u[j] = derivative_u[j] - DERIVATIVE_H;
+      osqp_update_bounds(work, l, u);
+      mu_assert("Derivative test: Solve error!", derivative_loss(work, loss_m) == 0);
+
+      for (i = 0; i < DERIVATIVE_NRHS; i++) {
+        fd = (loss_p[i] - loss_m[i]) / (2 * DERIVATIVE_H);
+        mu_assert("Derivative test: Error in derivative with respect to u!",
+                  c_absval(fd - du[i * DERIVATIVE_M + j]) < TESTS_TOL);
+      }
+    }
+  }
+
+  // Clean workspace
+  osqp_cleanup(work);
+  c_free(data->A);
+  c_free(data->P);
+  c_free(data);
+  c_free(settings);
+
+  return 0;
+}
+
+
+static const char* test_derivative()
+{
+  mu_run_test(test_derivative_finite_differences);
+
+  return 0;
+}
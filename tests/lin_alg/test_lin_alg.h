@@ -255,6 +255,65 @@ static const char* test_mat_vec_multiplication() {
   return 0;
 }
 
+static const char* test_bsr_mat_vec_multiplication() {
+  c_int bs;
+  c_float *Ax, *ATy;
+  bsr *A;
+
+  lin_alg_sols_data *data = generate_problem_lin_alg_sols_data();
+
+  // Allocate vectors
+  Ax  = (c_float *)c_malloc(data->test_mat_vec_m * sizeof(c_float));
+  ATy = (c_float *)c_malloc(data->test_mat_vec_n * sizeof(c_float));
+
+  // The products must not depend on the block size, including the padding of
+  // the last block row and column
+  for (bs = 2; bs <= 5; bs++) {
+    A = csc_to_bsr(data->test_mat_vec_A, bs);
+    mu_assert("Linear algebra tests: error in block compressed-row conversion",
+              A != OSQP_NULL);
+
+    // Matrix-vector multiplication:  y = Ax
+    bsr_mat_vec(A, data->test_mat_vec_x, Ax, 0);
+    mu_assert(
+      "Linear algebra tests: error in block matrix-vector multiplication",
+      vec_norm_inf_diff(Ax, data->test_mat_vec_Ax,
+                        data->test_mat_vec_m) < TESTS_TOL);
+
+    // Cumulative matrix-vector multiplication:  y += Ax
+    prea_vec_copy(data->test_mat_vec_y, Ax, data->test_mat_vec_m);
+    bsr_mat_vec(A, data->test_mat_vec_x, Ax, 1);
+    mu_assert(
+      "Linear algebra tests: error in block cumulative matrix-vector multiplication",
+      vec_norm_inf_diff(Ax, data->test_mat_vec_Ax_cum,
+                        data->test_mat_vec_m) < TESTS_TOL);
+
+    // Matrix-transpose-vector multiplication:  x = A'*y
+    bsr_mat_tpose_vec(A, data->test_mat_vec_y, ATy, 0);
+    mu_assert(
+      "Linear algebra tests: error in block matrix-transpose-vector multiplication",
+      vec_norm_inf_diff(ATy, data->test_mat_vec_ATy,
+                        data->test_mat_vec_n) < TESTS_TOL);
+
+    // Cumulative matrix-transpose-vector multiplication:  x += A'*y
+    prea_vec_copy(data->test_mat_vec_x, ATy, data->test_mat_vec_n);
+    bsr_mat_tpose_vec(A, data->test_mat_vec_y, ATy, 1);
+    mu_assert(
+      "Linear algebra tests: error in block cumulative matrix-transpose-vector multiplication",
+      vec_norm_inf_diff(ATy, data->test_mat_vec_ATy_cum,
+                        data->test_mat_vec_n) < TESTS_TOL);
+
+    bsr_spfree(A);
+  }
+
+  // cleanup
+  c_free(Ax);
+  c_free(ATy);
+  clean_problem_lin_alg_sols_data(data);
+
+  return 0;
+}
+
 static const char* test_extract_upper_triangular() {
   c_float *inf_norm_cols_test;
   lin_alg_sols_data *data = generate_problem_lin_alg_sols_data();
@@ -308,6 +367,7 @@ static const char* test_lin_alg()
   mu_run_test(test_vec_operations);
   mu_run_test(test_mat_operations);
   mu_run_test(test_mat_vec_multiplication);
+  mu_run_test(test_bsr_mat_vec_multiplication);
   mu_run_test(test_extract_upper_triangular);
   mu_run_test(test_quad_form_upper_triang);
 
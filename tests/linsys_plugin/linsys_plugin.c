@@ -0,0 +1,220 @@
+/*
+ * Dense linear system solver plugin used to test the plugin interface.
+ * It factorizes the full KKT matrix with LU decomposition and partial
+ * pivoting, so it is meant only for small problems.
+ */
+#include <stdlib.h>
+
+#include "linsys_plugin.h"
+
+#ifdef _WIN32
+# define PLUGIN_EXPORT __declspec(dllexport)
+#else
+# define PLUGIN_EXPORT
+#endif
+
+typedef struct {
+  LinSysSolver base;    ///< linear system solver functions (must be first)
+  c_int        n;       ///< number of QP variables
+  c_int        m;       ///< number of QP constraints
+  c_int        polish;  ///< polishing flag
+  c_float      sigma;   ///< scalar parameter
+  c_float     *P;       ///< dense symmetric P (n x n, column-major)
+  c_float     *A;       ///< dense A (m x n, column-major)
+  c_float     *rho_inv; ///< inverse of rho_vec (delta in polish)
+  c_float     *LU;      ///< LU factors of the KKT matrix (column-major)
+  c_int       *piv;     ///< row pivots
+  c_float     *sol;     ///< solution of the KKT system
+} dense_solver;
+
+
+static void free_dense(LinSysSolver *self) {
+  dense_solver *s = (dense_solver *)self;
+
+  if (s) {
+    free(s->P);
+    free(s->A);
+    free(s->rho_inv);
+    free(s->LU);
+    free(s->piv);
+    free(s->sol);
+    free(s);
+  }
+}
+
+static void copy_matrices(dense_solver *s, const csc *P, const csc *A) {
+  c_int i, j, k;
+
+  for (k = 0; k < s->n * s->n; k++) s->P[k] = 0.;
+  for (k = 0; k < s->m * s->n; k++) s->A[k] = 0.;
+
+  // P is upper triangular
+  for (j = 0; j < s->n; j++) {
+    for (k = P->p[j]; k < P->p[j + 1]; k++) {
+      i = P->i[k];
+      s->P[j * s->n + i] = P->x[k];
+      s->P[i * s->n + j] = P->x[k];
+    }
+  }
+
+  for (j = 0; j < s->n; j++) {
+    for (k = A->p[j]; k < A->p[j + 1]; k++) {
+      s->A[j * s->m + A->i[k]] = A->x[k];
+    }
+  }
+}
+
+/* Form the KKT matrix
+ *    [P + sigma I    A'            ]
+ *    [A              -diag(rho_inv)]
+ * and compute its LU factorization */
+static c_int factor_dense(dense_solver *s) {
+  c_int i, j, k, p;
+  c_int N = s->n + s->m;
+  c_float *K = s->LU;
+  c_float t;
+
+  for (j = 0; j < s->n; j++) {
+    for (i = 0; i < s->n; i++) K[j * N + i] = s->P[j * s->n + i];
+    K[j * N + j] += s->sigma;
+    for (i = 0; i < s->m; i++) {
+      K[j * N + s->n + i]   = s->A[j * s->m + i];
+      K[(s->n + i) * N + j] = s->A[j * s->m + i];
+    }
+  }
+  for (j = 0; j < s->m; j++) {
+    for (i = 0; i < s->m; i++) K[(s->n + j) * N + s->n + i] = 0.;
+    K[(s->n + j) * N + s->n + j] = -s->rho_inv[j];
+  }
+
+  for (k = 0; k < N; k++) {
+    p = k;
+    for (i = k + 1; i < N; i++) {
+      if (c_absval(K[k * N + i]) > c_absval(K[k * N + p])) p = i;
+    }
+    if (K[k * N + p] == 0.) return 1;
+    s->piv[k] = p;
+    if (p != k) {
+      for (j = 0; j < N; j++) {
+        t            = K[j * N + k];
+        K[j * N + k] = K[j * N + p];
+        K[j * N + p] = t;
+      }
+    }
+    for (i = k + 1; i < N; i++) K[k * N + i] /= K[k * N + k];
+    for (j = k + 1; j < N; j++) {
+      for (i = k + 1; i < N; i++) K[j * N + i] -= K[k * N + i] * K[j * N + k];
+    }
+  }
+
+  return 0;
+}
+
+static c_int solve_dense(LinSysSolver *self, c_float *b) {
+  dense_solver *s = (dense_solver *)self;
+  c_int i, j, k;
+  c_int N = s->n + s->m;
+  c_float t;
+
+  for (i = 0; i < N; i++) s->sol[i] = b[i];
+
+  for (k = 0; k < N; k++) {
+    t                 = s->sol[k];
+    s->sol[k]         = s->sol[s->piv[k]];
+    s->sol[s->piv[k]] = t;
+  }
+  for (j = 0; j < N; j++) {
+    for (i = j + 1; i < N; i++) s->sol[i] -= s->LU[j * N + i] * s->sol[j];
+  }
+  for (j = N - 1; j >= 0; j--) {
+    s->sol[j] /= s->LU[j * N + j];
+    for (i = 0; i < j; i++) s->sol[i] -= s->LU[j * N + i] * s->sol[j];
+  }
+
+  if (s->polish) {
+    for (i = 0; i < N; i++) b[i] = s->sol[i];
+  } else {
+    for (i = 0; i < s->n; i++) b[i] = s->sol[i];
+    for (i = 0; i < s->m; i++) b[s->n + i] += s->rho_inv[i] * s->sol[s->n + i];
+  }
+
+  return 0;
+}
+
+static c_int solve_multi_dense(LinSysSolver *self, c_float *B, c_int nrhs) {
+  dense_solver *s = (dense_solver *)self;
+  c_int i;
+
+  for (i = 0; i < nrhs; i++) solve_dense(self, B + i * (s->n + s->m));
+
+  return 0;
+}
+
+static c_int update_matrices_dense(LinSysSolver *self, const csc *P, const csc *A) {
+  dense_solver *s = (dense_solver *)self;
+
+  copy_matrices(s, P, A);
+  return factor_dense(s);
+}
+
+static c_int update_rho_vec_dense(LinSysSolver *self, const c_float *rho_vec) {
+  dense_solver *s = (dense_solver *)self;
+  c_int i;
+
+  for (i = 0; i < s->m; i++) s->rho_inv[i] = 1. / rho_vec[i];
+  return factor_dense(s);
+}
+
+
+PLUGIN_EXPORT c_int osqp_linsys_plugin_abi(void) {
+  return OSQP_LINSYS_PLUGIN_ABI;
+}
+
+PLUGIN_EXPORT c_int osqp_linsys_plugin_init(LinSysSolver  **sp,
+                                            const csc      *P,
+                                            const csc      *A,
+                                            c_float         sigma,
+                                            const c_float  *rho_vec,
+                                            c_int           polish) {
+  c_int i, N;
+  dense_solver *s = calloc(1, sizeof(dense_solver));
+
+  *sp = OSQP_NULL;
+  if (!s) return OSQP_MEM_ALLOC_ERROR;
+
+  s->n      = P->n;
+  s->m      = A->m;
+  s->polish = polish;
+  s->sigma  = sigma;
+  N         = s->n + s->m;
+
+  s->base.solve           = &solve_dense;
+  s->base.solve_multi     = &solve_multi_dense;
+  s->base.free            = &free_dense;
+  s->base.update_matrices = &update_matrices_dense;
+  s->base.update_rho_vec  = &update_rho_vec_dense;
+  s->base.nthreads        = 1;
+
+  s->P       = calloc(s->n * s->n + 1, sizeof(c_float));
+  s->A       = calloc(s->m * s->n + 1, sizeof(c_float));
+  s->rho_inv = calloc(s->m + 1, sizeof(c_float));
+  s->LU      = calloc(N * N, sizeof(c_float));
+  s->piv     = calloc(N, sizeof(c_int));
+  s->sol     = calloc(N, sizeof(c_float));
+  if (!s->P || !s->A || !s->rho_inv || !s->LU || !s->piv || !s->sol) {
+    free_dense((LinSysSolver *)s);
+    return OSQP_MEM_ALLOC_ERROR;
+  }
+
+  // In polish mode the (2,2) block is -sigma I
+  for (i = 0; i < s->m; i++) s->rho_inv[i] = polish ? sigma : 1. / rho_vec[i];
+
+  copy_matrices(s, P, A);
+  if (factor_dense(s)) {
+    free_dense((LinSysSolver *)s);
+    return OSQP_LINSYS_SOLVER_INIT_ERROR;
+  }
+
+  *sp = (LinSysSolver *)s;
+  return 0;
+}
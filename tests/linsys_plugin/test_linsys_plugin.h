@@ -0,0 +1,168 @@
+#include "osqp.h"    // OSQP API
+#include "util.h"    // Utilities for testing
+#include "minunit.h" // Basic testing script header
+
+static c_float linsys_plugin_P_x[3] = { 4.0, 1.0, 2.0, };
+static c_int   linsys_plugin_P_i[3] = { 0, 0, 1, };
+static c_int   linsys_plugin_P_p[3] = { 0, 1, 3, };
+static c_float linsys_plugin_q[2]   = { 1.0, 1.0, };
+static c_float linsys_plugin_A_x[4] = { 1.0, 1.0, 1.0, 1.0, };
+static c_int   linsys_plugin_A_i[4] = { 0, 1, 0, 2, };
+static c_int   linsys_plugin_A_p[3] = { 0, 2, 4, };
+static c_float linsys_plugin_l[3]   = { 1.0, 0.0, 0.0, };
+static c_float linsys_plugin_u[3]   = { 1.0, 0.7, 0.7, };
+static c_float linsys_plugin_lb[2]  = { 0.0, 0.0, };
+static c_float linsys_plugin_ub[2]  = { 0.7, 0.7, };
+
+static OSQPData* linsys_plugin_problem()
+{
+  OSQPData *data = (OSQPData *)c_calloc(1, sizeof(OSQPData));
+
+  data->n = 2;
+  data->m = 3;
+  data->P = csc_matrix(data->n, data->n, 3, linsys_plugin_P_x,
+                       linsys_plugin_P_i, linsys_plugin_P_p);
+  data->q = linsys_plugin_q;
+  data->A = csc_matrix(data->m, data->n, 4, linsys_plugin_A_x,
+                       linsys_plugin_A_i, linsys_plugin_A_p);
+  data->l = linsys_plugin_l;
+  data->u = linsys_plugin_u;
+
+  return data;
+}
+
+static const char* test_linsys_plugin_load_error()
+{
+  c_int exitflag;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work; // Workspace
+  OSQPData *data;      // Data
+
+  // Populate data
+  data = linsys_plugin_problem();
+
+  // Define solver settings as default
+  osqp_set_default_settings(settings);
+  settings->linsys_solver = PLUGIN_SOLVER;
+  settings->verbose       = 0;
+
+  // Setup workspace without plugin library
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Linsys plugin test: Setup should result in error due to missing settings->linsys_solver_lib",
+            exitflag == OSQP_SETTINGS_VALIDATION_ERROR);
+
+  // Setup workspace with a library that does not exist
+  settings->linsys_solver_lib = "libosqp_missing_plugin";
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Linsys plugin test: Setup should result in error due to missing plugin library",
+            exitflag == OSQP_LINSYS_SOLVER_LOAD_ERROR);
+  osqp_cleanup(work);
+
+  // Cleanup
+  c_free(data->A);
+  c_free(data->P);
+  c_free(data);
+  c_free(settings);
+
+  return 0;
+}
+
+#ifdef OSQP_TEST_PLUGIN
+static const char* test_linsys_plugin_solve()
+{
+  c_int exitflag;
+
+  // Problem settings
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings));
+
+  // Structures
+  OSQPWorkspace *work, *work_plugin; // Workspaces
+  OSQPData *data;                    // Data
+
+  // Populate data
+  data = linsys_plugin_problem();
+
+  // Define solver settings
+  osqp_set_default_settings(settings);
+  settings->polish  = 1;
+  settings->eps_abs = 1e-05;
+  settings->eps_rel = 1e-05;
+  settings->verbose = 0;
+
+  // Reference solution with QDLDL
+  exitflag = osqp_setup(&work, data, settings);
+  mu_assert("Linsys plugin test: Setup error!", exitflag == 0);
+  osqp_solve(work);
+
+  // Solve with the plugin
+  settings->linsys_solver     = PLUGIN_SOLVER;
+  settings->linsys_solver_lib = OSQP_TEST_PLUGIN;
+  exitflag = osqp_setup(&work_plugin, data, settings);
+  mu_assert("Linsys plugin test: Setup error with plugin!", exitflag == 0);
+  mu_assert("Linsys plugin test: Wrong linear system solver type!",
+            work_plugin->linsys_solver->type == PLUGIN_SOLVER);
+  osqp_solve(work_plugin);
+
+  mu_assert("Linsys plugin test: Error in solver status!",
+            work_plugin->info->status_val == OSQP_SOLVED);
+  mu_assert("Linsys plugin test: Error in polish status!",
+            work_plugin->info->status_polish == work->info->status_polish);
+  mu_assert("Linsys plugin test: Error in primal solution!",
+            vec_norm_inf_diff(work_plugin->solution->x, work->solution->x,
+                              data->n) < TESTS_TOL);
+  mu_assert("Linsys plugin test: Error in dual solution!",
+            vec_norm_inf_diff(work_plugin->solution->y, work->solution->y,
+                              data->m) < TESTS_TOL);
+
+  // Update the matrices in the plugin and solve again
+  exitflag = osqp_update_P_A(work_plugin, linsys_plugin_P_x, OSQP_NULL, 3,
+                             linsys_plugin_A_x, OSQP_NULL, 4);
+  mu_assert("Linsys plugin test: Error in matrices update!", exitflag == 0);
+  osqp_solve(work_plugin);
+  mu_assert("Linsys plugin test: Error in primal solution after update!",
+            vec_norm_inf_diff(work_plugin->solution->x, work->solution->x,
+                              data->n) < TESTS_TOL);
+  osqp_cleanup(work_plugin);
+
+  // With variable bounds, the plugin has no sigma update and is set up again
+  // when rho changes
+  data->lb             = linsys_plugin_lb;
+  data->ub             = linsys_plugin_ub;
+  settings->var_bounds = 1;
+  exitflag = osqp_setup(&work_plugin, data, settings);
+  mu_assert("Linsys plugin test: Setup error with variable bounds!", exitflag == 0);
+  exitflag = osqp_update_rho(work_plugin, 0.7);
+  mu_assert("Linsys plugin test: Error in rho update!", exitflag == 0);
+  mu_assert("Linsys plugin test: Missing solver after rho update!",
+            work_plugin->linsys_solver != OSQP_NULL);
+  osqp_solve(work_plugin);
+  mu_assert("Linsys plugin test: Error in primal solution with variable bounds!",
+            vec_norm_inf_diff(work_plugin->solution->x, work->solution->x,
+                              data->n) < TESTS_TOL);
+
+  // Cleanup
+  osqp_cleanup(work);
+  osqp_cleanup(work_plugin);
+  c_free(data->A);
+  c_free(data->P);
+  c_free(data);
+  c_free(settings);
+
+  return 0;
+}
+#endif /* ifdef OSQP_TEST_PLUGIN */
+
+
+static const char* test_linsys_plugin()
+{
+  mu_run_test(test_linsys_plugin_load_error);
+#ifdef OSQP_TEST_PLUGIN
+  mu_run_test(test_linsys_plugin_solve);
+#endif /* ifdef OSQP_TEST_PLUGIN */
+
+  return 0;
+}
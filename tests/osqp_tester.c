@@ -20,6 +20,8 @@
 #include "primal_infeasibility/test_primal_infeasibility.h"
 #include "unconstrained/test_unconstrained.h"
 #include "update_matrices/test_update_matrices.h"
+#include "derivative/test_derivative.h"
+#include "linsys_plugin/test_linsys_plugin.h"
 
 
 int tests_run = 0;
@@ -36,6 +38,8 @@ static const char* all_tests() {
   mu_run_test(test_primal_dual_infeasibility);
   mu_run_test(test_unconstrained);
   mu_run_test(test_update_matrices);
+  mu_run_test(test_derivative);
+  mu_run_test(test_linsys_plugin);
   return 0;
 }
 
@@ -27,7 +27,8 @@ static const char* test_solveKKT() {
 
   // Form and factorize KKT matrix
   exitflag = init_linsys_solver(&s, data->test_solve_KKT_Pu, data->test_solve_KKT_A,
-                                settings->sigma, rho_vec, LINSYS_SOLVER, 0);
+                                settings->sigma, rho_vec, LINSYS_SOLVER, 0, OSQP_NULL, AMD_ORDERING,
+                                OSQP_NULL);
 
   // Solve  KKT x = b via LDL given factorization
   s->solve(s, data->test_solve_KKT_rhs);
@@ -47,7 +48,144 @@ static const char* test_solveKKT() {
   return 0;
 }
 
+static const char* test_solveKKT_multi_rhs(enum linsys_solver_type linsys_solver) {
+  c_int i, j, m, n_plus_m, exitflag = 0;
+  c_float *rho_vec, *B;
+  c_float scal[3] = { 1.0, -1.0, 2.0 };
+  LinSysSolver *s;  // Private structure to form KKT factorization
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings)); // Settings
+  solve_linsys_sols_data *data = generate_problem_solve_linsys_sols_data();
+
+  // Settings
+  settings->rho   = data->test_solve_KKT_rho;
+  settings->sigma = data->test_solve_KKT_sigma;
+
+  // Set rho_vec
+  m       = data->test_solve_KKT_A->m;
+  rho_vec = (c_float*) c_calloc(m, sizeof(c_float));
+  vec_add_scalar(rho_vec, settings->rho, m);
+
+  // Form and factorize KKT matrix
+  exitflag = init_linsys_solver(&s, data->test_solve_KKT_Pu, data->test_solve_KKT_A,
+                                settings->sigma, rho_vec, linsys_solver, 0, OSQP_NULL, AMD_ORDERING,
+                                OSQP_NULL);
+  mu_assert("Linear systems solve tests: error in forming KKT system!",
+            exitflag == 0);
+
+  // Right-hand sides are scaled copies of the same vector
+  n_plus_m = data->test_solve_KKT_m + data->test_solve_KKT_n;
+  B = (c_float*) c_malloc(3 * n_plus_m * sizeof(c_float));
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < n_plus_m; j++) {
+      B[i * n_plus_m + j] = scal[i] * data->test_solve_KKT_rhs[j];
+    }
+  }
+
+  // Solve KKT X = B given factorization
+  exitflag = s->solve_multi(s, B, 3);
+  mu_assert("Linear systems solve tests: error in solving KKT system with multiple right-hand sides!",
+            exitflag == 0);
+
+  for (i = 0; i < 3; i++) {
+    vec_mult_scalar(B + i * n_plus_m, 1. / scal[i], n_plus_m);
+    mu_assert(
+      "Linear systems solve tests: error in solving KKT system with multiple right-hand sides!",
+      vec_norm_inf_diff(B + i * n_plus_m, data->test_solve_KKT_x, n_plus_m) < TESTS_TOL);
+  }
+
+  // Cleanup
+  s->free(s);
+  c_free(B);
+  c_free(settings);
+  c_free(rho_vec);
+  clean_problem_solve_linsys_sols_data(data);
+
+  return 0;
+}
+
+static const char* test_solveKKT_multi() {
+  return test_solveKKT_multi_rhs(QDLDL_SOLVER);
+}
+
+static const char* test_solveKKT_normal() {
+  c_int i, m, n_plus_m, exitflag = 0;
+  c_float *rho_vec, *b, *b_ref;
+  LinSysSolver *s, *s_ref;
+  OSQPSettings *settings = (OSQPSettings *)c_malloc(sizeof(OSQPSettings)); // Settings
+  solve_linsys_sols_data *data = generate_problem_solve_linsys_sols_data();
+
+  // Settings
+  settings->rho   = data->test_solve_KKT_rho;
+  settings->sigma = data->test_solve_KKT_sigma;
+
+  // Set rho_vec
+  m        = data->test_solve_KKT_A->m;
+  n_plus_m = data->test_solve_KKT_m + data->test_solve_KKT_n;
+  rho_vec  = (c_float*) c_calloc(m, sizeof(c_float));
+  vec_add_scalar(rho_vec, settings->rho, m);
+
+  // Form and factorize reduced matrix
+  exitflag = init_linsys_solver(&s, data->test_solve_KKT_Pu, data->test_solve_KKT_A,
+                                settings->sigma, rho_vec, NORMAL_SOLVER, 0, OSQP_NULL, AMD_ORDERING,
+                                OSQP_NULL);
+  mu_assert("Linear systems solve tests: error in forming normal equations!",
+            exitflag == 0);
+
+  b     = (c_float*) c_malloc(n_plus_m * sizeof(c_float));
+  b_ref = (c_float*) c_malloc(n_plus_m * sizeof(c_float));
+  prea_vec_copy(data->test_solve_KKT_rhs, b, n_plus_m);
+  s->solve(s, b);
+  mu_assert(
+    "Linear systems solve tests: error in solving KKT system with normal equations!",
+    vec_norm_inf_diff(b, data->test_solve_KKT_x, n_plus_m) < TESTS_TOL);
+
+  // Two different values of rho (the constraints are regrouped), then
+  // scale both values (only the stored products are rescaled)
+  for (i = 0; i < m; i++) rho_vec[i] = (i % 2) ? 10. * settings->rho : settings->rho;
+  exitflag = s->update_rho_vec(s, rho_vec);
+  mu_assert("Linear systems solve tests: error in updating rho_vec with normal equations!",
+            exitflag == 0);
+  vec_mult_scalar(rho_vec, 0.5, m);
+  exitflag = s->update_rho_vec(s, rho_vec);
+  mu_assert("Linear systems solve tests: error in updating rho_vec with normal equations!",
+            exitflag == 0);
+
+  // Compare with the full KKT system
+  exitflag = init_linsys_solver(&s_ref, data->test_solve_KKT_Pu, data->test_solve_KKT_A,
+                                settings->sigma, rho_vec, QDLDL_SOLVER, 0, OSQP_NULL, AMD_ORDERING,
+                                OSQP_NULL);
+  prea_vec_copy(data->test_solve_KKT_rhs, b, n_plus_m);
+  prea_vec_copy(data->test_solve_KKT_rhs, b_ref, n_plus_m);
+  s->solve(s, b);
+  s_ref->solve(s_ref, b_ref);
+  mu_assert(
+    "Linear systems solve tests: error in solving KKT system with normal equations after rho update!",
+    vec_norm_inf_diff(b, b_ref, n_plus_m) < TESTS_TOL);
+
+  // Cleanup
+  s->free(s);
+  s_ref->free(s_ref);
+  c_free(b);
+  c_free(b_ref);
+  c_free(settings);
+  c_free(rho_vec);
+  clean_problem_solve_linsys_sols_data(data);
+
+  return test_solveKKT_multi_rhs(NORMAL_SOLVER);
+}
+
 #ifdef ENABLE_MKL_PARDISO
+static const char* test_solveKKT_multi_pardiso() {
+  const char *msg;
+
+  mu_assert("Linear system solve test: error in loading Pardiso shared library",
+            load_linsys_solver(MKL_PARDISO_SOLVER, OSQP_NULL) == 0);
+  msg = test_solveKKT_multi_rhs(MKL_PARDISO_SOLVER);
+  unload_linsys_solver(MKL_PARDISO_SOLVER);
+
+  return msg;
+}
+
 static char* test_solveKKT_pardiso() {
   c_int m, exitflag = 0;
   c_float *rho_vec;
@@ -66,13 +204,14 @@ static char* test_solveKKT_pardiso() {
   vec_add_scalar(rho_vec, settings->rho, m);
 
   // Load Pardiso shared library
-  exitflag = load_linsys_solver(MKL_PARDISO_SOLVER);
+  exitflag = load_linsys_solver(MKL_PARDISO_SOLVER, OSQP_NULL);
   mu_assert("Linear system solve test: error in loading Pardiso shared library",
             exitflag == 0);
 
   // Form and factorize KKT matrix
   exitflag = init_linsys_solver(&s, data->test_solve_KKT_Pu, data->test_solve_KKT_A,
-                                settings->sigma, rho_vec, MKL_PARDISO_SOLVER, 0);
+                                settings->sigma, rho_vec, MKL_PARDISO_SOLVER, 0, OSQP_NULL, AMD_ORDERING,
+                                OSQP_NULL);
 
   // Solve  KKT x = b via LDL given factorization
   s->solve(s, data->test_solve_KKT_rhs);
@@ -99,8 +238,11 @@ static char* test_solveKKT_pardiso() {
 static const char* test_solve_linsys()
 {
   mu_run_test(test_solveKKT);
+  mu_run_test(test_solveKKT_multi);
+  mu_run_test(test_solveKKT_normal);
 #ifdef ENABLE_MKL_PARDISO
   mu_run_test(test_solveKKT_pardiso);
+  mu_run_test(test_solveKKT_multi_pardiso);
 #endif
 
   return 0;